@@ -39,9 +39,10 @@
 #undef min
 #undef max
 
-#if defined(_UWP)
 #include <fcntl.h>
 #include <io.h>
+
+#if defined(_UWP)
 #include <winrt/Windows.ApplicationModel.h>
 #include <winrt/Windows.Devices.Enumeration.h>
 #include <winrt/Windows.Foundation.Collections.h>
@@ -56,6 +57,7 @@
 #include <dirent.h>
 #include <errno.h>
 #include <limits.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -570,6 +572,60 @@ bool FileSystem::WriteFileToString(const char* filename, const std::string_view&
 	return true;
 }
 
+void* FileSystem::MapFileReadOnly(const char* filename, size_t* size)
+{
+#if defined(_UWP)
+	return nullptr;
+#else
+	// Going through OpenFDFile keeps Android content URIs working.
+	const int fd = OpenFDFile(filename, O_RDONLY, 0);
+	if (fd < 0)
+		return nullptr;
+
+	void* ptr = nullptr;
+
+#ifdef _WIN32
+	const HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+	LARGE_INTEGER file_size;
+	if (file != INVALID_HANDLE_VALUE && GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0 &&
+		static_cast<u64>(file_size.QuadPart) <= std::numeric_limits<size_t>::max())
+	{
+		const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping)
+		{
+			// The view keeps the mapping object alive.
+			ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+			*size = static_cast<size_t>(file_size.QuadPart);
+		}
+	}
+	_close(fd);
+#else
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0 && static_cast<u64>(st.st_size) <= std::numeric_limits<size_t>::max())
+	{
+		ptr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (ptr == MAP_FAILED)
+			ptr = nullptr;
+		else
+			*size = static_cast<size_t>(st.st_size);
+	}
+	close(fd);
+#endif
+
+	return ptr;
+#endif
+}
+
+void FileSystem::UnmapFile(void* ptr, size_t size)
+{
+#if defined(_WIN32) && !defined(_UWP)
+	UnmapViewOfFile(ptr);
+#elif !defined(_WIN32)
+	munmap(ptr, size);
+#endif
+}
+
 #ifdef _WIN32
 
 static u32 TranslateWin32Attributes(u32 Win32Attributes)
@@ -145,6 +145,11 @@ namespace FileSystem
 	bool WriteBinaryFile(const char* filename, const void* data, size_t data_length);
 	bool WriteFileToString(const char* filename, const std::string_view& sv);
 
+	/// Maps a whole file read-only. Returns nullptr if the file is empty or can't be mapped,
+	/// the mapping stays valid after the file is closed. Release it with UnmapFile().
+	void* MapFileReadOnly(const char* filename, size_t* size);
+	void UnmapFile(void* ptr, size_t size);
+
 	/// creates a directory in the local filesystem
 	/// if the directory already exists, the return value will be true.
 	/// if Recursive is specified, all parent directories will be created
@@ -54,6 +54,14 @@ public:
 	virtual void SetBlockSize(uint bytes) {}
 	virtual void SetDataOffset(int bytes) {}
 
+	// Hint that the given sectors are likely to be read soon. Readers with a cache
+	// load them in the background, the others ignore it.
+	virtual void Prefetch(uint sector, uint count) {}
+
+	// Returns the given sectors in place if the reader has them in memory, so they can be
+	// used without a read. The pointer stays valid until the reader is closed.
+	virtual const u8* GetSectorData(uint sector, uint count) { return nullptr; }
+
 	uint GetBlockSize() const { return m_blocksize; }
 
 	const std::string& GetFilename() const
@@ -112,6 +120,51 @@ public:
 #endif
 };
 
+// Serves reads of uncompressed images from a read-only mapping of the file (CdvdMapImages).
+// Reads are a memcpy, or no copy at all through GetSectorData(), and the sectors
+// following sequential reads are hinted to the kernel so the page faults hit the page cache.
+class MappedFileReader : public AsyncFileReader
+{
+	DeclareNoncopyableObject( MappedFileReader );
+
+	u8* m_data;
+	size_t m_size;
+
+	// End of the previous read, used to detect sequential access
+	u64 m_lastReadEnd;
+	// End of the range last hinted with Advise()
+	u64 m_advisedEnd;
+	// Read result stored by BeginRead
+	int m_result;
+
+	// Hint that [offset, offset + size) is going to be read
+	void Advise(u64 offset, u64 size);
+	// Returns the mapped sectors, or null if they are past the end of the file
+	const u8* MapSectors(uint sector, uint count);
+
+public:
+	MappedFileReader();
+	virtual ~MappedFileReader() override;
+
+	virtual bool Open(std::string fileName) override;
+
+	virtual int ReadSync(void* pBuffer, uint sector, uint count) override;
+
+	virtual void BeginRead(void* pBuffer, uint sector, uint count) override;
+	virtual int FinishRead(void) override;
+	virtual void CancelRead(void) override;
+
+	virtual void Close(void) override;
+
+	virtual uint GetBlockCount(void) const override;
+
+	virtual void SetBlockSize(uint bytes) override { m_blocksize = bytes; }
+	virtual void SetDataOffset(int bytes) override { m_dataoffset = bytes; }
+
+	virtual void Prefetch(uint sector, uint count) override;
+	virtual const u8* GetSectorData(uint sector, uint count) override;
+};
+
 class MultipartFileReader : public AsyncFileReader
 {
 	DeclareNoncopyableObject( MultipartFileReader );
@@ -147,6 +200,9 @@ public:
 
 	virtual void SetBlockSize(uint bytes) override;
 
+	virtual void Prefetch(uint sector, uint count) override;
+	virtual const u8* GetSectorData(uint sector, uint count) override;
+
 	static AsyncFileReader* DetectMultipart(AsyncFileReader* reader);
 };
 
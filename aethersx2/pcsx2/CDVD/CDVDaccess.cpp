@@ -32,6 +32,7 @@
 #include "IsoFS/IsoFS.h"
 #include "IsoFS/IsoFSCDVD.h"
 #include "CDVDisoReader.h"
+#include "DiscAccessProfile.h"
 
 #include "common/FileSystem.h"
 #include "common/StringUtil.h"
@@ -371,6 +372,9 @@ bool DoCDVDopen()
 
 	int cdtype = DoCDVDdetectDiskType();
 
+	if (m_CurrentSourceType == CDVD_SourceType::Iso && cdtype != CDVD_TYPE_NODISC)
+		DiscAccessProfile::Open();
+
 	if (!EmuConfig.CdvdDumpBlocks || (cdtype == CDVD_TYPE_NODISC))
 	{
 		blockDumpFile.Close();
@@ -435,6 +439,8 @@ void DoCDVDclose()
 	CheckNullCDVD();
 	//blockDumpFile.Close();
 
+	DiscAccessProfile::Close();
+
 	if (CDVD->close != NULL)
 		CDVD->close();
 
@@ -445,6 +451,7 @@ s32 DoCDVDreadSector(u8* buffer, u32 lsn, int mode)
 {
 	CheckNullCDVD();
 	int ret = CDVD->readSector(buffer, lsn, mode);
+	DiscAccessProfile::RecordRead(lsn, 1);
 
 	if (ret == 0 && blockDumpFile.IsOpened())
 	{
@@ -487,6 +494,7 @@ s32 DoCDVDreadTrack(u32 lsn, int mode)
 
 	//DevCon.Warning("CDVD readTrack(lsn=%d,mode=%d)",params lsn, lastReadSize);
 	lastLSN = lsn;
+	DiscAccessProfile::RecordRead(lsn, 1);
 	return CDVD->readTrack(lsn, mode);
 }
 
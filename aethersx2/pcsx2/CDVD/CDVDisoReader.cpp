@@ -40,6 +40,12 @@ void CALLBACK ISOclose()
 	iso.Close();
 }
 
+void ISOprefetch(u32 lsn, u32 count)
+{
+	if (iso.IsOpened())
+		iso.Prefetch(lsn, count);
+}
+
 s32 CALLBACK ISOopen(const char* pTitle)
 {
 	ISOclose(); // just in case
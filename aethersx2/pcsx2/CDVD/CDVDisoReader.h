@@ -21,4 +21,7 @@
 #include "IopCommon.h"
 #include "IsoFileFormats.h"
 
+// Asks the reader of the open image to load the given sectors in the background.
+extern void ISOprefetch(u32 lsn, u32 count);
+
 #endif
@@ -40,6 +40,12 @@ struct CsoHeader
 
 static const u32 CSO_READ_BUFFER_SIZE = 256 * 1024;
 
+struct CsoFileReader::Decoder
+{
+	z_stream stream;
+	std::unique_ptr<u8[]> readBuffer;
+};
+
 bool CsoFileReader::CanHandle(const std::string& fileName, const std::string& displayName)
 {
 	bool supported = false;
@@ -145,11 +151,11 @@ bool CsoFileReader::InitializeBuffers()
 	// We might read a bit of alignment too, so be prepared.
 	if (m_frameSize + (1 << m_indexShift) < CSO_READ_BUFFER_SIZE)
 	{
-		m_readBuffer = new u8[CSO_READ_BUFFER_SIZE];
+		m_readBufferSize = CSO_READ_BUFFER_SIZE;
 	}
 	else
 	{
-		m_readBuffer = new u8[m_frameSize + (1 << m_indexShift)];
+		m_readBufferSize = m_frameSize + (1 << m_indexShift);
 	}
 
 	const u32 indexSize = numFrames + 1;
@@ -160,17 +166,46 @@ bool CsoFileReader::InitializeBuffers()
 		return false;
 	}
 
-	m_z_stream = new z_stream;
-	m_z_stream->zalloc = Z_NULL;
-	m_z_stream->zfree = Z_NULL;
-	m_z_stream->opaque = Z_NULL;
-	if (inflateInit2(m_z_stream, -15) != Z_OK)
+	// Make sure zlib works before any read depends on it.
+	Decoder* decoder = AcquireDecoder();
+	if (!decoder)
+		return false;
+	ReleaseDecoder(decoder);
+
+	return true;
+}
+
+CsoFileReader::Decoder* CsoFileReader::AcquireDecoder()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_decoderMutex);
+		if (!m_decoders.empty())
+		{
+			Decoder* decoder = m_decoders.back();
+			m_decoders.pop_back();
+			return decoder;
+		}
+	}
+
+	Decoder* decoder = new Decoder;
+	decoder->stream.zalloc = Z_NULL;
+	decoder->stream.zfree = Z_NULL;
+	decoder->stream.opaque = Z_NULL;
+	if (inflateInit2(&decoder->stream, -15) != Z_OK)
 	{
 		Console.Error("Unable to initialize zlib for CSO decompression.");
-		return false;
+		delete decoder;
+		return nullptr;
 	}
 
-	return true;
+	decoder->readBuffer.reset(new u8[m_readBufferSize]);
+	return decoder;
+}
+
+void CsoFileReader::ReleaseDecoder(Decoder* decoder)
+{
+	std::lock_guard<std::mutex> lock(m_decoderMutex);
+	m_decoders.push_back(decoder);
 }
 
 void CsoFileReader::Close2()
@@ -182,17 +217,12 @@ void CsoFileReader::Close2()
 		fclose(m_src);
 		m_src = NULL;
 	}
-	if (m_z_stream)
-	{
-		inflateEnd(m_z_stream);
-		m_z_stream = NULL;
-	}
-
-	if (m_readBuffer)
+	for (Decoder* decoder : m_decoders)
 	{
-		delete[] m_readBuffer;
-		m_readBuffer = NULL;
+		inflateEnd(&decoder->stream);
+		delete decoder;
 	}
+	m_decoders.clear();
 	if (m_index)
 	{
 		delete[] m_index;
@@ -235,6 +265,7 @@ int CsoFileReader::ReadChunk(void *dst, s64 chunkID)
 	if (!compressed)
 	{
 		// Just read directly, easy.
+		std::lock_guard<std::mutex> lock(m_srcMutex);
 		if (FileSystem::FSeek64(m_src, frameRawPos, SEEK_SET) != 0)
 		{
 			Console.Error("Unable to seek to uncompressed CSO data.");
@@ -244,26 +275,37 @@ int CsoFileReader::ReadChunk(void *dst, s64 chunkID)
 	}
 	else
 	{
-		if (FileSystem::FSeek64(m_src, frameRawPos, SEEK_SET) != 0)
-		{
-			Console.Error("Unable to seek to compressed CSO data.");
+		Decoder* decoder = AcquireDecoder();
+		if (!decoder)
 			return 0;
+
+		u32 readRawBytes;
+		{
+			std::lock_guard<std::mutex> lock(m_srcMutex);
+			if (FileSystem::FSeek64(m_src, frameRawPos, SEEK_SET) != 0)
+			{
+				Console.Error("Unable to seek to compressed CSO data.");
+				ReleaseDecoder(decoder);
+				return 0;
+			}
+			// This might be less bytes than frameRawSize in case of padding on the last frame.
+			// This is because the index positions must be aligned.
+			readRawBytes = fread(decoder->readBuffer.get(), 1, std::min<u64>(frameRawSize, m_readBufferSize), m_src);
 		}
-		// This might be less bytes than frameRawSize in case of padding on the last frame.
-		// This is because the index positions must be aligned.
-		const u32 readRawBytes = fread(m_readBuffer, 1, frameRawSize, m_src);
 
-		m_z_stream->next_in = m_readBuffer;
-		m_z_stream->avail_in = readRawBytes;
-		m_z_stream->next_out = static_cast<Bytef*>(dst);
-		m_z_stream->avail_out = m_frameSize;
+		z_stream* stream = &decoder->stream;
+		stream->next_in = decoder->readBuffer.get();
+		stream->avail_in = readRawBytes;
+		stream->next_out = static_cast<Bytef*>(dst);
+		stream->avail_out = m_frameSize;
 
-		int status = inflate(m_z_stream, Z_FINISH);
-		bool success = status == Z_STREAM_END && m_z_stream->total_out == m_frameSize;
+		int status = inflate(stream, Z_FINISH);
+		bool success = status == Z_STREAM_END && stream->total_out == m_frameSize;
 
 		if (!success)
 			Console.Error("Unable to decompress CSO frame using zlib.");
-		inflateReset(m_z_stream);
+		inflateReset(stream);
+		ReleaseDecoder(decoder);
 
 		return success ? m_frameSize : 0;
 	}
@@ -27,6 +27,9 @@
 #include "ThreadedFileReader.h"
 #include "ChunksCache.h"
 
+#include <mutex>
+#include <vector>
+
 struct CsoHeader;
 typedef struct z_stream_s z_stream;
 
@@ -41,11 +44,10 @@ public:
 		: m_frameSize(0)
 		, m_frameShift(0)
 		, m_indexShift(0)
-		, m_readBuffer(0)
+		, m_readBufferSize(0)
 		, m_index(0)
 		, m_totalSize(0)
 		, m_src(0)
-		, m_z_stream(0)
 	{
 		m_blocksize = 2048;
 	};
@@ -57,6 +59,7 @@ public:
 
 	Chunk ChunkForOffset(u64 offset) override;
 	int ReadChunk(void *dst, s64 chunkID) override;
+	bool CanReadChunksConcurrently() const override { return true; }
 
 	void Close2(void) override;
 
@@ -73,13 +76,21 @@ private:
 	bool DecompressFrame(Bytef* dst, u32 frame, u32 readBufferSize);
 	bool DecompressFrame(u32 frame, u32 readBufferSize);
 
+	/// zlib stream and compressed frame buffer, one per concurrent ReadChunk
+	struct Decoder;
+	Decoder* AcquireDecoder();
+	void ReleaseDecoder(Decoder* decoder);
+
 	u32 m_frameSize;
 	u8 m_frameShift;
 	u8 m_indexShift;
-	u8* m_readBuffer;;
+	u32 m_readBufferSize;
 	u32* m_index;
 	u64 m_totalSize;
 	// The actual source cso file handle.
 	FILE* m_src;
-	z_stream* m_z_stream;
+	/// Serializes seek + read on m_src, inflating happens outside of it
+	std::mutex m_srcMutex;
+	std::mutex m_decoderMutex;
+	std::vector<Decoder*> m_decoders;
 };
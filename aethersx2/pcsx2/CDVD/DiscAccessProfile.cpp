@@ -0,0 +1,271 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "IopCommon.h"
+#include "DiscAccessProfile.h"
+#include "CDVDisoReader.h"
+#include "IsoFS/IsoFS.h"
+#include "IsoFS/IsoFSCDVD.h"
+#include "Config.h"
+
+#include "common/FileSystem.h"
+#include "common/StringUtil.h"
+
+#include <map>
+#include <mutex>
+#include <vector>
+#include <zlib.h>
+
+namespace DiscAccessProfile
+{
+	static constexpr u32 PROFILE_MAGIC = 0x50414344; // 'DCAP'
+	static constexpr u32 PROFILE_VERSION = 1;
+
+	// Reads this close to the end of the previous range extend it, prefetching a few unread
+	// sectors is cheaper than keeping track of another range.
+	static constexpr u32 MERGE_GAP_SECTORS = 16;
+	static constexpr u32 MAX_RANGES = 16384;
+	// Sessions which read less than this (BIOS browser, quick disc swaps) keep the old profile.
+	static constexpr u32 MIN_SAVE_SECTORS = 256;
+
+	struct Range
+	{
+		u32 lsn;
+		u32 count;
+	};
+
+	struct ProfileHeader
+	{
+		u32 magic;
+		u32 version;
+		u32 blocks; // of the image the profile was recorded on
+		u32 ranges;
+		u32 crc; // of the ranges
+	};
+
+	static std::mutex s_mutex;
+	static bool s_recording = false;
+	static std::string s_serial;
+	static u32 s_blocks = 0;
+	static u32 s_limitSectors = 0;
+	static u32 s_recordedSectors = 0;
+	// In first access order
+	static std::vector<Range> s_ranges;
+	// Sectors covered by s_ranges, start -> end (exclusive), used to skip re-reads
+	static std::map<u32, u32> s_covered;
+
+	static std::string GetProfileFileName(const std::string& serial)
+	{
+		std::string name(serial);
+		FileSystem::SanitizeFileName(name);
+		return Path::CombineStdString(EmuFolders::Cache, name + ".discprofile");
+	}
+
+	// Same as cdvdReloadElfInfo() without the logging, the serial isn't known yet when the
+	// image is opened and the profile is needed before the game starts reading.
+	static std::string ReadDiscSerial()
+	{
+		try
+		{
+			IsoFSCDVD isofs;
+			IsoFile file(isofs, L"SYSTEM.CNF;1");
+
+			while (!file.eof())
+			{
+				const ParsedAssignmentString parts(fromUTF8(file.readLine().c_str()));
+				if (parts.lvalue != L"BOOT2" && parts.lvalue != L"BOOT")
+					continue;
+
+				// "cdrom0:\SLUS_123.45;1" is SLUS-12345
+				wxString fname = parts.rvalue.AfterLast('\\').AfterLast('/').AfterLast(':').BeforeFirst(';');
+				if (fname.Matches(L"????_???.??*"))
+					fname = fname(0, 4) + L"-" + fname(5, 3) + fname(9, 2);
+
+				return StringUtil::wxStringToUTF8String(fname);
+			}
+		}
+		catch (Exception::BaseException&)
+		{
+			// No SYSTEM.CNF or a broken image, either way there is nothing to key a profile on.
+		}
+
+		return {};
+	}
+
+	static std::vector<Range> LoadProfile(const std::string& filename, u32 blocks)
+	{
+		std::optional<std::vector<u8>> data(FileSystem::ReadBinaryFile(filename.c_str()));
+		if (!data.has_value() || data->size() < sizeof(ProfileHeader))
+			return {};
+
+		ProfileHeader header;
+		std::memcpy(&header, data->data(), sizeof(header));
+
+		const u8* payload = data->data() + sizeof(header);
+		const size_t size = data->size() - sizeof(header);
+		if (header.magic != PROFILE_MAGIC || header.version != PROFILE_VERSION || header.blocks != blocks ||
+			header.ranges > MAX_RANGES || size != header.ranges * sizeof(Range) ||
+			header.crc != static_cast<u32>(crc32(0L, payload, static_cast<uInt>(size))))
+		{
+			Console.Warning("Disc access profile '%s' is outdated or corrupted, ignoring it.", filename.c_str());
+			return {};
+		}
+
+		std::vector<Range> ranges(header.ranges);
+		std::memcpy(ranges.data(), payload, size);
+		return ranges;
+	}
+
+	static void SaveProfile(const std::string& filename)
+	{
+		ProfileHeader header;
+		header.magic = PROFILE_MAGIC;
+		header.version = PROFILE_VERSION;
+		header.blocks = s_blocks;
+		header.ranges = static_cast<u32>(s_ranges.size());
+		header.crc = static_cast<u32>(crc32(0L, reinterpret_cast<const Bytef*>(s_ranges.data()), static_cast<uInt>(s_ranges.size() * sizeof(Range))));
+
+		std::vector<u8> data(sizeof(header) + s_ranges.size() * sizeof(Range));
+		std::memcpy(data.data(), &header, sizeof(header));
+		std::memcpy(data.data() + sizeof(header), s_ranges.data(), s_ranges.size() * sizeof(Range));
+
+		if (!FileSystem::WriteBinaryFile(filename.c_str(), data.data(), data.size()))
+			Console.Warning("Failed to write disc access profile '%s'.", filename.c_str());
+	}
+
+	static void Reset()
+	{
+		s_recording = false;
+		s_serial.clear();
+		s_blocks = 0;
+		s_recordedSectors = 0;
+		s_ranges.clear();
+		s_covered.clear();
+	}
+} // namespace DiscAccessProfile
+
+void DiscAccessProfile::Open()
+{
+	std::unique_lock<std::mutex> lock(s_mutex);
+	Reset();
+
+	if (EmuConfig.Cdvd.PrefetchMB == 0)
+		return;
+
+	cdvdTD td;
+	if (CDVD->getTD(0, &td) != 0 || td.lsn == 0)
+		return;
+
+	// Reads SYSTEM.CNF through the CDVD, don't hold the lock over it
+	lock.unlock();
+	std::string serial(ReadDiscSerial());
+	lock.lock();
+
+	if (serial.empty())
+		return;
+
+	s_serial = std::move(serial);
+	s_blocks = td.lsn;
+	s_limitSectors = EmuConfig.Cdvd.PrefetchMB * (_1mb / 2048);
+	s_recording = true;
+
+	const std::vector<Range> ranges(LoadProfile(GetProfileFileName(s_serial), s_blocks));
+	if (ranges.empty())
+		return;
+
+	// The reader stops accepting ranges once its cache is half full, the first ones
+	// are the boot sequence and matter most.
+	u32 sectors = 0;
+	for (const Range& range : ranges)
+	{
+		const u32 count = std::min(range.count, s_limitSectors - sectors);
+		if (count == 0)
+			break;
+
+		ISOprefetch(range.lsn, count);
+		sectors += count;
+	}
+
+	Console.WriteLn("Disc access profile: prefetching %u KB in %zu ranges for %s.",
+		sectors * 2, ranges.size(), s_serial.c_str());
+}
+
+void DiscAccessProfile::Close()
+{
+	std::lock_guard<std::mutex> lock(s_mutex);
+	if (s_recording && s_recordedSectors >= MIN_SAVE_SECTORS)
+	{
+		DevCon.WriteLn("Disc access profile: saving %u KB in %zu ranges for %s.",
+			s_recordedSectors * 2, s_ranges.size(), s_serial.c_str());
+		SaveProfile(GetProfileFileName(s_serial));
+	}
+
+	Reset();
+}
+
+void DiscAccessProfile::RecordRead(u32 lsn, u32 count)
+{
+	std::lock_guard<std::mutex> lock(s_mutex);
+	if (!s_recording || lsn >= s_blocks)
+		return;
+
+	u32 end = lsn + std::min(count, s_blocks - lsn);
+
+	// Skip the part which is already in the profile
+	auto next = s_covered.upper_bound(lsn);
+	if (next != s_covered.begin())
+	{
+		const u32 coveredEnd = std::prev(next)->second;
+		if (coveredEnd >= end)
+			return;
+		lsn = std::max(lsn, coveredEnd);
+	}
+
+	Range* last = s_ranges.empty() ? nullptr : &s_ranges.back();
+	const u32 lastEnd = last ? last->lsn + last->count : 0;
+	if (last && lsn >= lastEnd && lsn - lastEnd <= MERGE_GAP_SECTORS)
+	{
+		lsn = lastEnd;
+		if (s_recordedSectors + (end - lsn) > s_limitSectors)
+			return;
+		last->count += end - lsn;
+	}
+	else
+	{
+		if (s_ranges.size() >= MAX_RANGES || s_recordedSectors + (end - lsn) > s_limitSectors)
+			return;
+		s_ranges.push_back({lsn, end - lsn});
+	}
+
+	s_recordedSectors += end - lsn;
+
+	// Merge [lsn, end) into the covered sectors
+	u32 start = lsn;
+	next = s_covered.lower_bound(start);
+	if (next != s_covered.begin() && std::prev(next)->second >= start)
+	{
+		--next;
+		start = next->first;
+		end = std::max(end, next->second);
+		next = s_covered.erase(next);
+	}
+	while (next != s_covered.end() && next->first <= end)
+	{
+		end = std::max(end, next->second);
+		next = s_covered.erase(next);
+	}
+	s_covered.emplace(start, end);
+}
@@ -0,0 +1,34 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Records which sectors of a disc image get read, per game serial, and prefetches them
+// the next time the game is booted (EmuConfig.Cdvd.PrefetchMB).
+//
+// Ranges are kept in the order they were first read and saved to the cache folder when
+// the image is closed, so the reader can start decompressing the boot and loading data
+// before the game asks for it. Prefetch hit rates are logged by the reader on close.
+namespace DiscAccessProfile
+{
+	// Looks up the serial of the image which was just opened, prefetches the ranges
+	// recorded last time and starts recording.
+	void Open();
+
+	// Saves the ranges recorded since Open(), if there are enough of them.
+	void Close();
+
+	void RecordRead(u32 lsn, u32 count);
+} // namespace DiscAccessProfile
@@ -15,9 +15,13 @@
 
 #include "PrecompiledHeader.h"
 #include <wx/stdpaths.h>
+#include <climits>
+#include <cstddef>
 #include <fstream>
 #include "common/FileSystem.h"
+#include "common/PersistentThread.h"
 #include "common/StringUtil.h"
+#include "common/Timer.h"
 #include "Config.h"
 #include "ChunksCache.h"
 #include "GzippedFileReader.h"
@@ -28,68 +32,208 @@
 #define GZIP_ID "PCSX2.index.gzip.v1|"
 #define GZIP_ID_LEN (sizeof(GZIP_ID) - 1) /* sizeof includes the \0 terminator */
 
-// File format is:
+static constexpr char GZIP_INDEX_MAGIC[8] = {'P', 'C', 'S', 'X', '2', 'G', 'Z', 'I'};
+static constexpr u32 GZIP_INDEX_VERSION = 2;
+
+// Index file formats:
+// v1 (still read, no longer written):
 // - [GZIP_ID_LEN] GZIP_ID (no \0)
-// - [sizeof(Access)] index (should be allocated, contains various sizes)
-// - [rest] the indexed data points (should be allocated, index->list should then point to it)
-static Access* ReadIndexFromFile(const char* filename)
+// - [sizeof(GzipIndexV1Access)] index as it was laid out in memory (the list pointer is garbage)
+// - [have * sizeof(GzipIndexV1Point)] the access points, each with its raw 32K window
+// v2:
+// - GzipIndexHeader, compressed_size detects an index which belongs to a different file
+// - [point_count] GzipIndexPoint
+// - the windows, deflated. Points refer to them by file offset, so a memory-mapped index is used in place.
+#pragma pack(push, 1)
+struct GzipIndexHeader
+{
+	char magic[8];
+	u32 version;
+	u32 point_count;
+	s64 span;
+	s64 uncompressed_size;
+	s64 compressed_size;
+};
+
+struct GzipIndexPoint
+{
+	s64 out;
+	s64 in;
+	s32 bits;
+	u32 window_size;
+	s64 window_offset;
+};
+
+struct GzipIndexV1Access
+{
+	s32 have;
+	s32 size;
+	void* list;
+	s32 span;
+	s64 uncompressed_size;
+};
+
+struct GzipIndexV1Point
 {
-	auto fp = FileSystem::OpenManagedCFile(filename, "rb");
-	s64 size;
-	if (!fp || (size = FileSystem::FSize64(fp.get())) <= 0)
+	s64 out;
+	s64 in;
+	s32 bits;
+	u8 window[WINSIZE];
+};
+#pragma pack(pop)
+
+// The windows of the returned index are left to the caller.
+static Access* AllocIndex(int points, s32 span, s64 uncompressed_size)
+{
+	Access* index = (Access*)malloc(sizeof(Access));
+	if (!index)
+		return nullptr;
+
+	index->list = (Point*)malloc(sizeof(Point) * points);
+	if (!index->list)
 	{
-		Console.Error("Error: Can't open index file: '%s'", filename);
-		return 0;
+		free(index);
+		return nullptr;
 	}
 
-	char fileId[GZIP_ID_LEN + 1] = {0};
-	if (std::fread(fileId, GZIP_ID_LEN, 1, fp.get()) != 1 || std::memcmp(fileId, GZIP_ID, 4) != 0)
+	index->have = points;
+	index->size = points;
+	index->span = span;
+	index->uncompressed_size = uncompressed_size;
+	index->owns_windows = 0;
+	return index;
+}
+
+static Access* ParseIndexV1(const u8* data, size_t size, const char* filename)
+{
+	GzipIndexV1Access header;
+	if (size < GZIP_ID_LEN + sizeof(header))
 	{
-		Console.Error("Error: Incompatible gzip index, please delete it manually: '%s'", filename);
+		Console.Error("Error: unexpected size of gzip index, please delete it manually: '%s'.", filename);
 		return nullptr;
 	}
 
-	std::unique_ptr<Access> index = std::make_unique<Access>();
-	const s64 datasize = size - GZIP_ID_LEN - sizeof(Access);
-
-	if (std::fread(index.get(), sizeof(Access), 1, fp.get()) != 1 ||
-		datasize != static_cast<s64>(index->have) * static_cast<s64>(sizeof(Point)))
+	std::memcpy(&header, data + GZIP_ID_LEN, sizeof(header));
+	const size_t datasize = size - GZIP_ID_LEN - sizeof(header);
+	if (header.have <= 0 || header.span <= 0 || datasize != static_cast<size_t>(header.have) * sizeof(GzipIndexV1Point))
 	{
 		Console.Error("Error: unexpected size of gzip index, please delete it manually: '%s'.", filename);
 		return nullptr;
 	}
 
-	std::unique_ptr<char[]> buffer = std::make_unique<char[]>(datasize);
-	if (std::fread(buffer.get(), datasize, 1, fp.get()) != 1)
+	Access* index = AllocIndex(header.have, header.span, header.uncompressed_size);
+	if (!index)
+		return nullptr;
+
+	const u8* entries = data + GZIP_ID_LEN + sizeof(header);
+	for (int i = 0; i < header.have; i++)
 	{
-		Console.Error("Error: failed to read gzip index, please delete it manually: '%s'.", filename);
+		const u8* entry = entries + i * sizeof(GzipIndexV1Point);
+		Point& point = index->list[i];
+		std::memcpy(&point.out, entry + offsetof(GzipIndexV1Point, out), sizeof(point.out));
+		std::memcpy(&point.in, entry + offsetof(GzipIndexV1Point, in), sizeof(point.in));
+		std::memcpy(&point.bits, entry + offsetof(GzipIndexV1Point, bits), sizeof(point.bits));
+		point.window_size = WINSIZE;
+		point.window = entry + offsetof(GzipIndexV1Point, window);
+	}
+
+	return index;
+}
+
+static Access* ParseIndex(const u8* data, size_t size, s64 compressed_size, const char* filename)
+{
+	GzipIndexHeader header;
+	std::memcpy(&header, data, sizeof(header));
+
+	if (header.version != GZIP_INDEX_VERSION)
+	{
+		Console.Warning("Gzip index version %u is not supported, it will be rebuilt: '%s'", header.version, filename);
+		return nullptr;
+	}
+
+	if (header.compressed_size != compressed_size)
+	{
+		Console.Warning("Gzip index doesn't match the compressed file, it will be rebuilt: '%s'", filename);
 		return nullptr;
 	}
 
-	index->list = reinterpret_cast<Point*>(buffer.release()); // adjust list pointer
-	return index.release();
+	if (header.point_count == 0 || header.point_count > static_cast<u32>(INT_MAX / sizeof(Point)) ||
+		header.span <= 0 || header.span > INT_MAX || header.uncompressed_size <= 0 ||
+		(size - sizeof(header)) / sizeof(GzipIndexPoint) < header.point_count)
+	{
+		Console.Error("Error: corrupted gzip index, it will be rebuilt: '%s'", filename);
+		return nullptr;
+	}
+
+	Access* index = AllocIndex(static_cast<int>(header.point_count), static_cast<s32>(header.span), header.uncompressed_size);
+	if (!index)
+		return nullptr;
+
+	const u8* table = data + sizeof(header);
+	for (u32 i = 0; i < header.point_count; i++)
+	{
+		GzipIndexPoint entry;
+		std::memcpy(&entry, table + i * sizeof(entry), sizeof(entry));
+
+		if (entry.bits < 0 || entry.bits > 7 || entry.window_size == 0 || entry.window_size > WINSIZE ||
+			entry.window_offset < 0 || static_cast<u64>(entry.window_offset) > size ||
+			size - static_cast<size_t>(entry.window_offset) < entry.window_size ||
+			(i > 0 && entry.out < index->list[i - 1].out))
+		{
+			Console.Error("Error: corrupted gzip index, it will be rebuilt: '%s'", filename);
+			free_index(index);
+			return nullptr;
+		}
+
+		Point& point = index->list[i];
+		point.out = entry.out;
+		point.in = entry.in;
+		point.bits = entry.bits;
+		point.window_size = entry.window_size;
+		point.window = data + entry.window_offset;
+	}
+
+	return index;
 }
 
-static void WriteIndexToFile(Access* index, const char* filename)
+static void WriteIndexToFile(const Access* index, const char* filename, s64 compressed_size, bool replace)
 {
 	if (FileSystem::FileExists(filename))
 	{
-		Console.Warning("WARNING: Won't write index - file name exists (please delete it manually): '%s'", filename);
-		return;
+		if (!replace)
+		{
+			Console.Warning("WARNING: Won't write index - file name exists (please delete it manually): '%s'", filename);
+			return;
+		}
+
+		FileSystem::DeleteFilePath(filename);
 	}
 
 	auto fp = FileSystem::OpenManagedCFile(filename, "wb");
 	if (!fp)
 		return;
 
-	bool success = (std::fwrite(GZIP_ID, GZIP_ID_LEN, 1, fp.get()) == 1);
+	GzipIndexHeader header = {};
+	std::memcpy(header.magic, GZIP_INDEX_MAGIC, sizeof(header.magic));
+	header.version = GZIP_INDEX_VERSION;
+	header.point_count = static_cast<u32>(index->have);
+	header.span = index->span;
+	header.uncompressed_size = index->uncompressed_size;
+	header.compressed_size = compressed_size;
 
-	Point* tmp = index->list;
-	index->list = 0; // current pointer is useless on disk, normalize it as 0.
-	success = success && (std::fwrite((char*)index, sizeof(Access), 1, fp.get()) == 1);
-	index->list = tmp;
+	bool success = (std::fwrite(&header, sizeof(header), 1, fp.get()) == 1);
 
-	success = success && (std::fwrite((char*)index->list, sizeof(Point) * index->have, 1, fp.get()) == 1);
+	s64 window_offset = sizeof(header) + sizeof(GzipIndexPoint) * index->have;
+	for (int i = 0; success && i < index->have; i++)
+	{
+		const Point& point = index->list[i];
+		const GzipIndexPoint entry = {point.out, point.in, point.bits, point.window_size, window_offset};
+		success = (std::fwrite(&entry, sizeof(entry), 1, fp.get()) == 1);
+		window_offset += point.window_size;
+	}
+
+	for (int i = 0; success && i < index->have; i++)
+		success = (std::fwrite(index->list[i].window, index->list[i].window_size, 1, fp.get()) == 1);
 
 	// Verify
 	if (!success)
@@ -102,6 +246,90 @@ static void WriteIndexToFile(Access* index, const char* filename)
 	}
 }
 
+// The uncompressed size is only known for sure once the whole file went through inflate.
+// Until then: the gzip trailer holds it modulo 4GB, and the ISO9660 volume descriptor
+// (or failing that the compressed size) tells which multiple of 4GB to add.
+static s64 EstimateUncompressedSize(std::FILE* fp, s64 compressed_size)
+{
+	static constexpr s64 FOUR_GB = s64(1) << 32;
+	static constexpr u32 SCAN_SIZE = 17 * 2352;
+
+	u8 trailer[4];
+	if (compressed_size < 18 || FileSystem::FSeek64(fp, compressed_size - 4, SEEK_SET) != 0 ||
+		std::fread(trailer, sizeof(trailer), 1, fp) != 1)
+	{
+		return -1;
+	}
+
+	const s64 isize = static_cast<s64>(trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | (static_cast<u32>(trailer[3]) << 24));
+
+	// Inflate the beginning of the image, far enough to see sector 16 with raw sectors.
+	std::unique_ptr<u8[]> head(new u8[SCAN_SIZE]);
+	u8 input[16 * 1024];
+	u32 have = 0;
+
+	z_stream strm = {};
+	if (FileSystem::FSeek64(fp, 0, SEEK_SET) == 0 && inflateInit2(&strm, 47) == Z_OK)
+	{
+		strm.next_out = head.get();
+		strm.avail_out = SCAN_SIZE;
+		while (strm.avail_out > 0)
+		{
+			if (strm.avail_in == 0)
+			{
+				strm.avail_in = static_cast<uInt>(std::fread(input, 1, sizeof(input), fp));
+				strm.next_in = input;
+				if (strm.avail_in == 0)
+					break;
+			}
+
+			if (inflate(&strm, Z_NO_FLUSH) != Z_OK)
+				break;
+		}
+
+		have = SCAN_SIZE - strm.avail_out;
+		inflateEnd(&strm);
+	}
+
+	// Primary volume descriptor of 2048 byte, raw mode 2 and raw mode 1 sector images.
+	static constexpr struct
+	{
+		u32 offset;
+		u32 sector_size;
+	} layouts[] = {{16 * 2048, 2048}, {16 * 2352 + 24, 2352}, {16 * 2352 + 16, 2352}};
+
+	s64 volume_size = 0;
+	for (const auto& layout : layouts)
+	{
+		const u8* pvd = head.get() + layout.offset;
+		if (layout.offset + 84 <= have && pvd[0] == 1 && std::memcmp(pvd + 1, "CD001", 5) == 0)
+		{
+			u32 blocks;
+			std::memcpy(&blocks, pvd + 80, sizeof(blocks));
+			volume_size = static_cast<s64>(blocks) * layout.sector_size;
+			break;
+		}
+	}
+
+	s64 size = isize;
+	if (volume_size > 0)
+	{
+		for (s64 candidate = isize + FOUR_GB; candidate <= volume_size + FOUR_GB; candidate += FOUR_GB)
+		{
+			if (std::abs(candidate - volume_size) < std::abs(size - volume_size))
+				size = candidate;
+		}
+	}
+	else
+	{
+		// Deflate never makes data noticeably bigger.
+		while (size < compressed_size - compressed_size / 1000 - 1024)
+			size += FOUR_GB;
+	}
+
+	return size;
+}
+
 static wxString INDEX_TEMPLATE_KEY(L"$(f)");
 // template:
 // must contain one and only one instance of '$(f)' (without the quotes)
@@ -192,26 +420,32 @@ GzippedFileReader::GzippedFileReader(void)
 	: mBytesRead(0)
 	, m_pIndex(0)
 	, m_zstates(0)
+	, m_zstatesCount(0)
 	, m_src(0)
+	, m_span(0)
+	, m_indexBuilding(false)
+	, m_indexMapping(nullptr)
+	, m_indexMappingSize(0)
 	, m_cache(GZFILE_CACHE_SIZE_MB)
 {
 	m_blocksize = 2048;
 	AsyncPrefetchReset();
 };
 
-void GzippedFileReader::InitZstates()
+void GzippedFileReader::InitZstates(s64 uncompressedSize)
 {
 	if (m_zstates)
 	{
 		delete[] m_zstates;
 		m_zstates = 0;
+		m_zstatesCount = 0;
 	}
-	if (!m_pIndex)
+	if (uncompressedSize <= 0 || m_span <= 0)
 		return;
 
 	// having another extra element helps avoiding logic for last (so 2+ instead of 1+)
-	int size = 2 + m_pIndex->uncompressed_size / m_pIndex->span;
-	m_zstates = new Czstate[size]();
+	m_zstatesCount = 2 + uncompressedSize / m_span;
+	m_zstates = new Czstate[m_zstatesCount]();
 }
 
 #ifndef _WIN32
@@ -301,9 +535,74 @@ bool GzippedFileReader::CanHandle(const std::string& fileName, const std::string
 	return StringUtil::EndsWith(fileName, ".gz");
 }
 
+bool GzippedFileReader::LoadIndexFile(const std::string& filename, s64 compressedSize, bool* replace)
+{
+	const u8* data;
+	size_t size = 0;
+
+	m_indexMapping = FileSystem::MapFileReadOnly(filename.c_str(), &size);
+	if (m_indexMapping)
+	{
+		m_indexMappingSize = size;
+		data = static_cast<const u8*>(m_indexMapping);
+	}
+	else
+	{
+		std::optional<std::vector<u8>> contents(FileSystem::ReadBinaryFile(filename.c_str()));
+		if (!contents || contents->empty())
+		{
+			Console.Error("Error: Can't open index file: '%s'", filename.c_str());
+			return false;
+		}
+
+		m_indexFileData = std::move(*contents);
+		data = m_indexFileData.data();
+		size = m_indexFileData.size();
+	}
+
+	Access* index = nullptr;
+	if (size >= sizeof(GzipIndexHeader) && std::memcmp(data, GZIP_INDEX_MAGIC, sizeof(GZIP_INDEX_MAGIC)) == 0)
+	{
+		index = ParseIndex(data, size, compressedSize, filename.c_str());
+		// It's one of ours, an outdated or broken one can be replaced
+		*replace = !index;
+	}
+	else if (size >= GZIP_ID_LEN && std::memcmp(data, GZIP_ID, GZIP_ID_LEN) == 0)
+	{
+		index = ParseIndexV1(data, size, filename.c_str());
+	}
+	else
+	{
+		Console.Error("Error: Incompatible gzip index, please delete it manually: '%s'", filename.c_str());
+	}
+
+	if (!index)
+	{
+		UnloadIndexFile();
+		return false;
+	}
+
+	m_pIndex = index;
+	m_span = index->span;
+	m_uncompressedSize.store(index->uncompressed_size);
+	return true;
+}
+
+void GzippedFileReader::UnloadIndexFile()
+{
+	if (m_indexMapping)
+	{
+		FileSystem::UnmapFile(m_indexMapping, m_indexMappingSize);
+		m_indexMapping = nullptr;
+		m_indexMappingSize = 0;
+	}
+
+	std::vector<u8>().swap(m_indexFileData);
+}
+
 bool GzippedFileReader::OkIndex()
 {
-	if (m_pIndex)
+	if (m_pIndex || m_indexBuilding)
 		return true;
 
 	// Try to read index from disk
@@ -311,43 +610,138 @@ bool GzippedFileReader::OkIndex()
 	if (indexfile.empty())
 		return false; // iso2indexname(...) will print errors if it can't apply the template
 
-	if (FileSystem::FileExists(indexfile.c_str()) && (m_pIndex = ReadIndexFromFile(indexfile.c_str())))
+	const s64 compressedSize = FileSystem::FSize64(m_src);
+	const s32 span = static_cast<s32>(EmuConfig.Cdvd.GzipIndexSpanKB * 1024);
+	bool replace = false;
+
+	if (FileSystem::FileExists(indexfile.c_str()) && LoadIndexFile(indexfile, compressedSize, &replace))
 	{
 		Console.WriteLn(Color_Green, "OK: Gzip quick access index read from disk: '%s'", indexfile.c_str());
-		if (m_pIndex->span != GZFILE_SPAN_DEFAULT)
+		if (m_span != span)
 		{
-			Console.Warning("Note: This index has %1.1f MB intervals, while the current default for new indexes is %1.1f MB.",
-							(float)m_pIndex->span / 1024 / 1024, (float)GZFILE_SPAN_DEFAULT / 1024 / 1024);
-			Console.Warning("It will work fine, but if you want to generate a new index with default intervals, delete this index file.");
+			Console.Warning("Note: This index has %1.1f MB intervals, while the current setting for new indexes is %1.1f MB.",
+							(float)m_span / 1024 / 1024, (float)span / 1024 / 1024);
+			Console.Warning("It will work fine, but if you want to generate a new index with these intervals, delete this index file.");
 			Console.Warning("(smaller intervals mean bigger index file and quicker but more frequent decompressions)");
 		}
-		InitZstates();
+		InitZstates(m_uncompressedSize.load());
 		return true;
 	}
 
-	// No valid index file. Generate an index
-	Console.Warning("This may take a while (but only once). Scanning compressed file to generate a quick access index...");
+	// No valid index file. Build one in the background, reads are served from the access points found so far.
+	const s64 estimatedSize = EstimateUncompressedSize(m_src, compressedSize);
+	if (estimatedSize <= 0)
+	{
+		Console.Error("ERROR: '%s' is not a valid gzip file.", m_filename.c_str());
+		return false;
+	}
+
+	Console.Warning("Scanning compressed file in the background to generate a quick access index (only once), reads may be slow until it's done...");
+
+	m_span = span;
+	m_uncompressedSize.store(estimatedSize);
+	m_indexBuilding = true;
+	m_indexCancel.store(false);
+	m_indexThread = std::thread(&GzippedFileReader::BuildIndex, this, indexfile, compressedSize, replace);
+
+	InitZstates(estimatedSize);
+	return true;
+}
 
-	Access* index;
-	FILE* infile = FileSystem::OpenCFile(m_filename.c_str(), "rb");
-	int len = build_index(infile, GZFILE_SPAN_DEFAULT, &index);
-	printf("\n"); // build_index prints progress without \n's
-	fclose(infile);
+void GzippedFileReader::BuildIndex(std::string indexfile, s64 compressedSize, bool replace)
+{
+	Threading::SetNameOfCurrentThread("Gzip Index");
 
-	if (len >= 0)
+	Common::Timer timer;
+	Access* index = nullptr;
+	int len = Z_ERRNO;
+
+	// Our own handle, m_src belongs to the reads.
+	if (std::FILE* infile = FileSystem::OpenCFile(m_filename.c_str(), "rb"))
 	{
-		m_pIndex = index;
-		WriteIndexToFile((Access*)m_pIndex, indexfile.c_str());
+		const build_callbacks callbacks = {this, &GzippedFileReader::OnIndexPoint, &GzippedFileReader::IsIndexBuildCancelled};
+		len = build_index(infile, m_span, &index, &callbacks);
+		std::fclose(infile);
 	}
-	else
+
+	if (len > 0)
+	{
+		Console.WriteLn(Color_Green, "OK: Gzip quick access index generated in %.1f seconds (%d access points).", timer.GetTimeSeconds(), len);
+		if (index->uncompressed_size != m_uncompressedSize.load())
+		{
+			Console.Warning("Warning: the uncompressed image is %lld bytes instead of the estimated %lld, please reopen it.",
+							static_cast<long long>(index->uncompressed_size), static_cast<long long>(m_uncompressedSize.load()));
+		}
+	}
+	else if (len != BUILD_INDEX_CANCELLED)
 	{
 		Console.Error("ERROR (%d): index could not be generated for file '%s'", len, m_filename.c_str());
-		free_index(index);
-		InitZstates();
-		return false;
 	}
 
-	InitZstates();
+	{
+		std::lock_guard<std::mutex> lock(m_indexMutex);
+		if (len > 0)
+		{
+			m_pIndex = index;
+			m_uncompressedSize.store(index->uncompressed_size);
+		}
+		m_indexBuilding = false;
+	}
+	m_indexCondition.notify_all();
+
+	// Nothing modifies the index from here on, and Close() waits for this thread before freeing it.
+	if (len > 0)
+		WriteIndexToFile(index, indexfile.c_str(), compressedSize, replace);
+}
+
+void GzippedFileReader::OnIndexPoint(void* ctx, const Point* point)
+{
+	GzippedFileReader* reader = static_cast<GzippedFileReader*>(ctx);
+
+	// build_index() may reallocate its list or free it on error, the reads get their own copy.
+	std::unique_ptr<u8[]> window(new u8[point->window_size]);
+	std::memcpy(window.get(), point->window, point->window_size);
+
+	{
+		std::lock_guard<std::mutex> lock(reader->m_indexMutex);
+		Point copy = *point;
+		copy.window = window.get();
+		reader->m_partialIndex.push_back(copy);
+		reader->m_partialWindows.push_back(std::move(window));
+	}
+	reader->m_indexCondition.notify_all();
+}
+
+int GzippedFileReader::IsIndexBuildCancelled(void* ctx)
+{
+	return static_cast<GzippedFileReader*>(ctx)->m_indexCancel.load(std::memory_order_relaxed) ? 1 : 0;
+}
+
+bool GzippedFileReader::FindAccessPoint(s64 offset, Point* point)
+{
+	std::unique_lock<std::mutex> lock(m_indexMutex);
+
+	// The first access point shows up as soon as the build gets past the gzip header.
+	m_indexCondition.wait(lock, [this]() { return m_pIndex || !m_indexBuilding || !m_partialIndex.empty(); });
+
+	if (m_pIndex)
+	{
+		// Reads happen on a single thread, nothing refers to the partial copies anymore.
+		if (!m_partialIndex.empty())
+		{
+			std::vector<Point>().swap(m_partialIndex);
+			std::vector<std::unique_ptr<u8[]>>().swap(m_partialWindows);
+		}
+
+		*point = *find_point(m_pIndex->list, m_pIndex->have, offset);
+		return true;
+	}
+
+	if (m_partialIndex.empty())
+		return false;
+
+	// Past the last access point found so far, extract() decompresses sequentially from it.
+	*point = *find_point(m_partialIndex.data(), static_cast<int>(m_partialIndex.size()), offset);
 	return true;
 }
 
@@ -395,7 +789,7 @@ int GzippedFileReader::ReadSync(void* pBuffer, uint sector, uint count)
 // If we have a valid and adequate zstate for this span, use it, else, use the index
 s64 GzippedFileReader::GetOptimalExtractionStart(s64 offset)
 {
-	int span = m_pIndex->span;
+	int span = m_span;
 	Czstate& cstate = m_zstates[offset / span];
 	s64 stateOffset = cstate.state.isValid ? cstate.state.out_offset : 0;
 	if (stateOffset && stateOffset <= offset)
@@ -411,7 +805,7 @@ s64 GzippedFileReader::GetOptimalExtractionStart(s64 offset)
 
 int GzippedFileReader::_ReadSync(void* pBuffer, s64 offset, uint bytesToRead)
 {
-	if (!OkIndex())
+	if (!m_src || !m_zstates)
 		return -1;
 
 	// Without all the caching, chunking and states, this would be enough:
@@ -441,14 +835,23 @@ int GzippedFileReader::_ReadSync(void* pBuffer, s64 offset, uint bytesToRead)
 	// Not available from cache. Decompress from optimal starting
 	// point in GZFILE_READ_CHUNK_SIZE chunks and cache each chunk.
 	PTT s = NOW();
+
+	int span = m_span;
+	// The size estimated while the index is being built may fall short, the states are only a cache.
+	if ((offset + maxInChunk) / span + 2 > m_zstatesCount)
+		InitZstates(std::max(m_uncompressedSize.load(), offset + maxInChunk));
+
 	s64 extractOffset = GetOptimalExtractionStart(offset); // guaranteed in GZFILE_READ_CHUNK_SIZE boundaries
 	int size = offset + maxInChunk - extractOffset;
-	unsigned char* extracted = (unsigned char*)malloc(size);
-
-	int span = m_pIndex->span;
 	int spanix = extractOffset / span;
+
+	Point start;
+	if (!FindAccessPoint(extractOffset, &start))
+		return -1;
+
+	unsigned char* extracted = (unsigned char*)malloc(size);
 	AsyncPrefetchCancel();
-	res = extract(m_src, m_pIndex, extractOffset, extracted, size, &(m_zstates[spanix].state));
+	res = extract(m_src, &start, extractOffset, extracted, size, &(m_zstates[spanix].state));
 	if (res < 0)
 	{
 		free(extracted);
@@ -501,14 +904,25 @@ int GzippedFileReader::_ReadSync(void* pBuffer, s64 offset, uint bytesToRead)
 
 void GzippedFileReader::Close()
 {
+	if (m_indexThread.joinable())
+	{
+		m_indexCancel.store(true);
+		m_indexThread.join();
+	}
+	m_indexBuilding = false;
+	std::vector<Point>().swap(m_partialIndex);
+	std::vector<std::unique_ptr<u8[]>>().swap(m_partialWindows);
+
 	m_filename.clear();
 	if (m_pIndex)
 	{
 		free_index((Access*)m_pIndex);
 		m_pIndex = 0;
 	}
+	UnloadIndexFile();
+	m_uncompressedSize.store(0);
 
-	InitZstates(); // results in delete because no index
+	InitZstates(0); // results in delete
 	m_cache.Clear();
 
 	if (m_src)
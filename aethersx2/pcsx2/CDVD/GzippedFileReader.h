@@ -21,7 +21,14 @@ typedef struct zstate Zstate;
 #include "ChunksCache.h"
 #include "zlib_indexed.h"
 
-#define GZFILE_SPAN_DEFAULT (1048576L * 4)  /* distance between direct access points when creating a new index */
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// The distance between access points of new indexes is EmuConfig.Cdvd.GzipIndexSpanKB.
 #define GZFILE_READ_CHUNK_SIZE (256 * 1024) /* zlib extraction chunks size (at 0-based boundaries) */
 #define GZFILE_CACHE_SIZE_MB 200            /* cache size for extracted data. must be at least GZFILE_READ_CHUNK_SIZE (in MB)*/
 
@@ -49,7 +56,7 @@ public:
 	{
 		// type and formula copied from FlatFileReader
 		// FIXME? : Shouldn't it be uint and (size - m_dataoffset) / m_blocksize ?
-		return (int)((m_pIndex ? m_pIndex->uncompressed_size : 0) / m_blocksize);
+		return (int)(m_uncompressedSize.load(std::memory_order_relaxed) / m_blocksize);
 	};
 
 	virtual void SetBlockSize(uint bytes) { m_blocksize = bytes; }
@@ -70,16 +77,42 @@ private:
 		Zstate state;
 	};
 
-	bool OkIndex(); // Verifies that we have an index, or try to create one
+	bool OkIndex(); // Loads the index from disk, or starts building one in the background
+	bool LoadIndexFile(const std::string& filename, s64 compressedSize, bool* replace);
+	void UnloadIndexFile();
+	void BuildIndex(std::string indexfile, s64 compressedSize, bool replace);
+	static void OnIndexPoint(void* ctx, const Point* point);
+	static int IsIndexBuildCancelled(void* ctx);
+	// Gets the access point to extract offset from, waits for the first one while the index is being built
+	bool FindAccessPoint(s64 offset, Point* point);
 	s64 GetOptimalExtractionStart(s64 offset);
 	int _ReadSync(void* pBuffer, s64 offset, uint bytesToRead);
-	void InitZstates();
+	void InitZstates(s64 uncompressedSize);
 
 	int mBytesRead;   // Temp sync read result when simulating async read
-	Access* m_pIndex; // Quick access index
+	Access* m_pIndex; // Quick access index, null until the background build is done
 	Czstate* m_zstates;
+	int m_zstatesCount;
 	FILE* m_src;
 
+	// Either from the index, or estimated from the gzip trailer while the index is being built
+	std::atomic<s64> m_uncompressedSize{0};
+	s32 m_span;
+
+	std::thread m_indexThread;
+	std::mutex m_indexMutex;
+	std::condition_variable m_indexCondition;
+	bool m_indexBuilding;
+	std::atomic<bool> m_indexCancel{false};
+	// Access points found so far by the background build, with their own copy of the windows
+	std::vector<Point> m_partialIndex;
+	std::vector<std::unique_ptr<u8[]>> m_partialWindows;
+
+	// Backing storage of an index read from disk, its windows point in there
+	void* m_indexMapping;
+	size_t m_indexMappingSize;
+	std::vector<u8> m_indexFileData;
+
 	ChunksCache m_cache;
 
 #ifdef _WIN32
@@ -54,6 +54,14 @@ int InputIsoFile::ReadSync(u8* dst, uint lsn)
 	return m_reader->ReadSync(dst + m_blockofs, lsn, 1);
 }
 
+void InputIsoFile::Prefetch(uint lsn, uint count)
+{
+	if (lsn >= m_blocks)
+		return;
+
+	m_reader->Prefetch(lsn, std::min(count, m_blocks - lsn));
+}
+
 void InputIsoFile::BeginRead2(uint lsn)
 {
 	m_current_lsn = lsn;
@@ -82,6 +90,11 @@ void InputIsoFile::BeginRead2(uint lsn)
 		m_read_count = std::min(ReadUnit, m_blocks - m_read_lsn);
 	}
 
+	// Mapped images are copied straight from the mapping, no read needed
+	m_read_ptr = m_reader->GetSectorData(m_read_lsn, m_read_count);
+	if (m_read_ptr)
+		return;
+
 	m_reader->BeginRead(m_readbuffer, m_read_lsn, m_read_count);
 	m_read_inprogress = true;
 }
@@ -148,7 +161,8 @@ int InputIsoFile::FinishRead3(u8* dst, uint mode)
 	length = end - _offset;
 
 	uint read_offset = (m_current_lsn - m_read_lsn) * m_blocksize;
-	memcpy(dst + diff, m_readbuffer + ndiff + read_offset, length);
+	const u8* src = m_read_ptr ? m_read_ptr : m_readbuffer;
+	memcpy(dst + diff, src + ndiff + read_offset, length);
 
 	if (m_type == ISOTYPE_CD && diff >= 12)
 	{
@@ -184,6 +198,7 @@ void InputIsoFile::_init()
 	ReadUnit = 0;
 	m_current_lsn = -1;
 	m_read_lsn = -1;
+	m_read_ptr = nullptr;
 	m_reader = NULL;
 }
 
@@ -212,8 +227,23 @@ bool InputIsoFile::Open(std::string srcfile, bool testOnly)
 	m_reader = CompressedFileReader::GetNewReader(m_filename);
 	isCompressed = m_reader != NULL;
 
-	// If it wasn't compressed, let's open it has a FlatFileReader.
-	if (!isCompressed)
+	// If it wasn't compressed, map it if enabled. Not when it is shared for writing,
+	// a mapped image which gets truncated crashes instead of failing the read.
+	bool isMapped = false;
+	if (!isCompressed && EmuConfig.CdvdMapImages && !EmuConfig.CdvdShareWrite)
+	{
+		m_reader = new MappedFileReader();
+		isMapped = m_reader->Open(m_filename);
+		if (!isMapped)
+		{
+			Console.Warning("isoFile: failed to map %s, using regular reads.", m_filename.c_str());
+			delete m_reader;
+			m_reader = NULL;
+		}
+	}
+
+	// Otherwise let's open it has a FlatFileReader.
+	if (!m_reader)
 	{
 		// Allow write sharing of the iso based on the ini settings.
 		// Mostly useful for romhacking, where the disc is frequently
@@ -221,7 +251,8 @@ bool InputIsoFile::Open(std::string srcfile, bool testOnly)
 		m_reader = new FlatFileReader(EmuConfig.CdvdShareWrite);
 	}
 
-	m_reader->Open(m_filename);
+	if (!isMapped)
+		m_reader->Open(m_filename);
 
 	// It might actually be a blockdump file.
 	// Check that before continuing with the FlatFileReader.
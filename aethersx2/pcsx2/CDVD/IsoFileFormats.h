@@ -64,6 +64,8 @@ protected:
 	uint m_read_lsn;
 	uint m_read_count;
 	u8 m_readbuffer[MaxReadUnit * CD_FRAMESIZE_RAW];
+	// Sectors of the current read when the reader has them in memory, used instead of m_readbuffer
+	const u8* m_read_ptr;
 
 public:
 	InputIsoFile();
@@ -86,6 +88,7 @@ public:
 	bool Detect(bool readType = true);
 
 	int ReadSync(u8* dst, uint lsn);
+	void Prefetch(uint lsn, uint count);
 
 	void BeginRead2(uint lsn);
 	int FinishRead3(u8* dest, uint mode);
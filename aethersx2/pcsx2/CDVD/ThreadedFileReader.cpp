@@ -15,25 +15,19 @@
 
 #include "PrecompiledHeader.h"
 #include "ThreadedFileReader.h"
+#include "Config.h"
 
-// Make sure buffer size is bigger than the cutoff where PCSX2 emulates a seek
-// If buffers are smaller than that, we can't keep up with linear reads
-static constexpr u32 MINIMUM_SIZE = 128 * 1024;
+#include "common/Timer.h"
 
-ThreadedFileReader::ThreadedFileReader()
-{
-	m_readThread = std::thread([](ThreadedFileReader* r){ r->Loop(); }, this);
-}
+#include <algorithm>
+
+static constexpr u32 MINIMUM_CACHE_SIZE = 4 * _1mb;
+
+ThreadedFileReader::ThreadedFileReader() = default;
 
 ThreadedFileReader::~ThreadedFileReader()
 {
-	m_quit = true;
-	(void)std::lock_guard<std::mutex>{m_mtx};
-	m_condition.notify_one();
-	m_readThread.join();
-	for (auto& buffer : m_buffer)
-		if (buffer.ptr)
-			free(buffer.ptr);
+	StopWorkers();
 }
 
 size_t ThreadedFileReader::CopyBlocks(void* dst, const void* src, size_t size) const
@@ -64,288 +58,351 @@ void ThreadedFileReader::Loop()
 
 	while (true)
 	{
-		while (!m_requestSize && !m_quit)
-			m_condition.wait(lock);
+		while (m_queue.empty() && m_prefetchQueue.empty() && !m_quit)
+			m_workCondition.wait(lock);
 
 		if (m_quit)
 			return;
 
-		u64 requestOffset = m_requestOffset;
-		u32 requestSize = m_requestSize;
-		void* ptr = m_requestPtr.load(std::memory_order_relaxed);
+		std::deque<s64>& queue = m_queue.empty() ? m_prefetchQueue : m_queue;
+		const s64 chunkID = queue.front();
+		queue.pop_front();
+
+		auto it = m_cache.find(chunkID);
+		if (it == m_cache.end() || it->second.state != ChunkState::Queued)
+			continue;
+
+		// References to unordered_map elements survive rehashing, and entries which are
+		// being read are never evicted, so this stays valid while the lock is released
+		CacheEntry& entry = it->second;
+		entry.state = ChunkState::Reading;
+		const u32 length = entry.length;
 
-		m_running = true;
 		lock.unlock();
+		const Common::Timer::Value start = Common::Timer::GetCurrentValue();
+		std::unique_ptr<u8[]> data(new u8[length]);
+		const int amt = ReadChunk(data.get(), chunkID);
+		const u64 readNs = static_cast<u64>(Common::Timer::ConvertValueToNanoseconds(Common::Timer::GetCurrentValue() - start));
+		lock.lock();
 
-		bool ok = true;
+		m_stats.readNs += readNs;
+		m_stats.chunksRead++;
 
-		if (ptr)
-		{
-			ok = Decompress(ptr, requestOffset, requestSize);
-		}
+		entry.data = std::move(data);
+		entry.size = (amt > 0) ? std::min(static_cast<u32>(amt), length) : 0;
+		entry.state = (amt > 0) ? ChunkState::Ready : ChunkState::Failed;
+		m_doneCondition.notify_all();
+	}
+}
 
-		m_requestPtr.store(nullptr, std::memory_order_release);
-		m_condition.notify_one();
+void ThreadedFileReader::StartWorkers()
+{
+	const Chunk first = ChunkForOffset(0);
+	const u32 chunkSize = (first.chunkID >= 0) ? first.length : 0;
 
-		if (ok)
-		{
-			// Readahead
-			Chunk chunk = ChunkForOffset(requestOffset + requestSize);
-			if (chunk.chunkID >= 0)
-			{
-				int buffersFilled = 0;
-				Buffer* buf = GetBlockPtr(chunk);
-				// Cancel readahead if a new request comes in
-				while (buf && !m_requestPtr.load(std::memory_order_acquire))
-				{
-					u32 bufsize = buf->size.load(std::memory_order_relaxed);
-					chunk = ChunkForOffset(buf->offset + bufsize);
-					if (chunk.chunkID < 0)
-						break;
-					if (buf->offset + bufsize != chunk.offset || chunk.length + bufsize > buf->cap)
-					{
-						buffersFilled++;
-						if (buffersFilled >= 2)
-							break;
-						buf = GetBlockPtr(chunk);
-					}
-					else
-					{
-						int amt = ReadChunk(static_cast<char*>(buf->ptr) + bufsize, chunk.chunkID);
-						if (amt <= 0)
-							break;
-						buf->size.store(bufsize + amt, std::memory_order_release);
-					}
-				}
-			}
-		}
+	m_readAheadBytes = EmuConfig.Cdvd.ReadAheadKB * 1024;
+	// Keep room for a full read-ahead window on top of the chunks being consumed,
+	// otherwise read-ahead would evict the data it is supposed to provide
+	m_cacheBudget = std::max<size_t>({static_cast<size_t>(EmuConfig.Cdvd.CacheSizeMB) * _1mb,
+		static_cast<size_t>(m_readAheadBytes) * 2 + static_cast<size_t>(chunkSize) * 4, MINIMUM_CACHE_SIZE});
 
-		lock.lock();
-		if (requestSize == m_requestSize && requestOffset == m_requestOffset && !m_requestPtr)
-		{
-			// If no one's added more work, mark this one as done
-			m_requestSize = 0;
-		}
+	const u32 threads = CanReadChunksConcurrently() ? std::max(EmuConfig.Cdvd.DecompressThreads, 1u) : 1u;
 
-		m_running = false;
-		m_condition.notify_one(); // For things waiting on m_running == false
+	m_quit = false;
+	for (u32 i = 0; i < threads; i++)
+		m_workers.emplace_back([](ThreadedFileReader* r) { r->Loop(); }, this);
+}
+
+void ThreadedFileReader::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mtx);
+		m_quit = true;
+		m_queue.clear();
+		m_prefetchQueue.clear();
 	}
+	m_workCondition.notify_all();
+
+	for (std::thread& thread : m_workers)
+		thread.join();
+	m_workers.clear();
 }
 
-ThreadedFileReader::Buffer* ThreadedFileReader::GetBlockPtr(const Chunk& block)
+void ThreadedFileReader::QueueChunk(const Chunk& chunk, bool readahead, std::unique_lock<std::mutex>& lock)
 {
-	for (int i = 0; i < static_cast<int>(ArraySize(m_buffer)); i++)
+	auto it = m_cache.find(chunk.chunkID);
+	if (it != m_cache.end())
 	{
-		u32 size = m_buffer[i].size.load(std::memory_order_relaxed);
-		u64 offset = m_buffer[i].offset;
-		if (size && offset <= block.offset && offset + size >= block.offset + block.length)
+		CacheEntry& entry = it->second;
+		m_lru.splice(m_lru.begin(), m_lru, entry.lru);
+		if (readahead)
+			return;
+
+		if (entry.state == ChunkState::Ready)
 		{
-			m_nextBuffer = (i + 1) % ArraySize(m_buffer);
-			return m_buffer + i;
+			m_stats.hits++;
+			if (entry.readahead)
+				m_stats.readaheadHits++;
+			if (entry.prefetch)
+				m_stats.prefetchHits++;
 		}
+		else
+		{
+			m_stats.misses++;
+			if (entry.state == ChunkState::Queued)
+			{
+				// Someone is waiting for it now, move it ahead of the read-ahead jobs
+				auto job = std::find(m_queue.begin(), m_queue.end(), chunk.chunkID);
+				if (job != m_queue.end())
+					m_queue.erase(job);
+				m_queue.push_front(chunk.chunkID);
+			}
+		}
+
+		entry.readahead = false;
+		entry.prefetch = false;
+		return;
 	}
 
-	Buffer& buf = m_buffer[m_nextBuffer];
+	CacheEntry& entry = m_cache[chunk.chunkID];
+	entry.offset = chunk.offset;
+	entry.length = chunk.length;
+	entry.readahead = readahead;
+	m_lru.push_front(chunk.chunkID);
+	entry.lru = m_lru.begin();
+	m_cacheBytes += chunk.length;
+
+	if (readahead)
 	{
-		// This can be called from both the read thread threads in ReadSync
-		// Calls from ReadSync are done with the lock already held to keep the read thread out
-		// Therefore we should only lock on the read thread
-		std::unique_lock<std::mutex> lock(m_mtx, std::defer_lock);
-		if (std::this_thread::get_id() == m_readThread.get_id())
-			lock.lock();
-		u32 size = std::max(block.length, MINIMUM_SIZE);
-		if (buf.cap < size)
-		{
-			buf.ptr = realloc(buf.ptr, size);
-			buf.cap = size;
-		}
-		buf.size.store(0, std::memory_order_relaxed);
+		m_queue.push_back(chunk.chunkID);
 	}
-	int size = ReadChunk(buf.ptr, block.chunkID);
-	if (size > 0)
+	else
 	{
-		buf.offset = block.offset;
-		buf.size.store(size, std::memory_order_release);
-		m_nextBuffer = (m_nextBuffer + 1) % ArraySize(m_buffer);
-		return &buf;
+		m_stats.misses++;
+		m_queue.push_front(chunk.chunkID);
 	}
-	return nullptr;
+
+	m_workCondition.notify_one();
 }
 
-bool ThreadedFileReader::Decompress(void* target, u64 begin, u32 size)
+void ThreadedFileReader::DropQueuedReadAhead(std::unique_lock<std::mutex>& lock)
 {
-	char* write = static_cast<char*>(target);
-	u32 remaining = size;
-	u64 off = begin;
-	while (remaining)
+	for (auto job = m_queue.begin(); job != m_queue.end();)
 	{
-		Chunk chunk = ChunkForOffset(off);
-		if (m_internalBlockSize || chunk.offset != off || chunk.length > remaining)
+		auto it = m_cache.find(*job);
+		if (it == m_cache.end() || (it->second.readahead && it->second.state == ChunkState::Queued))
 		{
-			Buffer* buf = GetBlockPtr(chunk);
-			if (!buf)
-				return false;
-			u32 bufoff = off - buf->offset;
-			u32 bufsize = buf->size.load(std::memory_order_relaxed);
-			if (bufsize <= bufoff)
-				return false;
-			u32 len = std::min(bufsize - bufoff, remaining);
-			write += CopyBlocks(write, static_cast<char*>(buf->ptr) + bufoff, len);
-			remaining -= len;
-			off += len;
+			if (it != m_cache.end())
+			{
+				m_cacheBytes -= it->second.length;
+				m_lru.erase(it->second.lru);
+				m_cache.erase(it);
+			}
+			job = m_queue.erase(job);
 		}
 		else
 		{
-			int amt = ReadChunk(write, chunk.chunkID);
-			if (amt < static_cast<int>(chunk.length))
-				return false;
-			write += chunk.length;
-			remaining -= chunk.length;
-			off += chunk.length;
+			++job;
 		}
 	}
-	m_amtRead += write - static_cast<char*>(target);
-	return true;
 }
 
-bool ThreadedFileReader::TryCachedRead(void*& buffer, u64& offset, u32& size, const std::lock_guard<std::mutex>&)
+void ThreadedFileReader::EvictChunks(std::unique_lock<std::mutex>& lock)
 {
-	// Run through twice so that if m_buffer[1] contains the first half and m_buffer[0] contains the second half it still works
-	m_amtRead = 0;
-	u64 end = 0;
-	bool allDone = false;
-	for (int i = 0; i < static_cast<int>(ArraySize(m_buffer) * 2); i++)
+	for (auto it = m_lru.end(); m_cacheBytes > m_cacheBudget && it != m_lru.begin();)
 	{
-		Buffer& buf = m_buffer[i % ArraySize(m_buffer)];
-		u32 bufsize = buf.size.load(std::memory_order_acquire);
-		if (!bufsize)
+		--it;
+
+		auto entry = m_cache.find(*it);
+		if (entry->second.state == ChunkState::Queued || entry->second.state == ChunkState::Reading)
 			continue;
-		if (buf.offset <= offset && buf.offset + bufsize > offset)
-		{
-			u32 off = offset - buf.offset;
-			u32 cpysize = std::min(size, bufsize - off);
-			size_t read = CopyBlocks(buffer, static_cast<char*>(buf.ptr) + off, cpysize);
-			m_amtRead += read;
-			size -= cpysize;
-			offset += cpysize;
-			buffer = static_cast<char*>(buffer) + read;
-			if (size == 0)
-				end = buf.offset + bufsize;
-		}
-		// Do buffers contain the current and next block?
-		if (end > 0 && buf.offset == end)
-			allDone = true;
+
+		m_cacheBytes -= entry->second.length;
+		m_cache.erase(entry);
+		it = m_lru.erase(it);
 	}
-	return allDone;
 }
 
-bool ThreadedFileReader::Open(std::string fileName)
+void ThreadedFileReader::ScheduleRead(u64 offset, u32 size, std::unique_lock<std::mutex>& lock)
 {
-	CancelAndWaitUntilStopped();
-	return Open2(std::move(fileName));
+	const u64 end = offset + size;
+	Chunk chunk = ChunkForOffset(offset);
+	if (chunk.chunkID < 0 || m_workers.empty())
+		return;
+
+	// A request starting where the previous one ended (give or take a chunk) is a stream,
+	// anything else is a seek and the read-ahead queued for the old position is useless
+	const bool sequential = (offset >= m_lastReadEnd && offset <= m_lastReadEnd + chunk.length);
+	m_lastReadEnd = end;
+	if (!sequential)
+		DropQueuedReadAhead(lock);
+
+	// Demand jobs go to the front of the queue, push them last to first so that
+	// the first chunk of the request ends up first in line
+	std::vector<Chunk> demand;
+	for (; chunk.chunkID >= 0 && chunk.offset < end; chunk = ChunkForOffset(chunk.offset + chunk.length))
+		demand.push_back(chunk);
+	for (auto it = demand.rbegin(); it != demand.rend(); ++it)
+		QueueChunk(*it, false, lock);
+
+	u32 readAheadChunks = 1;
+	if (sequential && chunk.chunkID >= 0 && chunk.length > 0)
+		readAheadChunks = std::max(1u, (m_readAheadBytes + chunk.length - 1) / chunk.length);
+
+	for (u32 i = 0; i < readAheadChunks && chunk.chunkID >= 0; i++, chunk = ChunkForOffset(chunk.offset + chunk.length))
+		QueueChunk(chunk, true, lock);
+
+	EvictChunks(lock);
 }
 
-int ThreadedFileReader::ReadSync(void* pBuffer, uint sector, uint count)
+int ThreadedFileReader::CompleteRead(void* dst, u64 offset, u32 size, std::unique_lock<std::mutex>& lock)
 {
-	u32 blocksize = InternalBlockSize();
-	u64 offset = (u64)sector * (u64)blocksize + m_dataoffset;
-	u32 size = count * blocksize;
+	if (m_workers.empty())
+		return 0;
+
+	char* write = static_cast<char*>(dst);
+	u64 waited = 0;
+
+	while (size > 0)
 	{
-		std::lock_guard<std::mutex> l(m_mtx);
-		if (TryCachedRead(pBuffer, offset, size, l))
-			return m_amtRead;
+		const Chunk chunk = ChunkForOffset(offset);
+		if (chunk.chunkID < 0)
+			break;
 
-		if (size > 0 && !m_running)
+		auto it = m_cache.find(chunk.chunkID);
+		if (it == m_cache.end())
 		{
-			// Don't wait for read thread to start back up
-			if (Decompress(pBuffer, offset, size))
-			{
-				offset += size;
-				size = 0;
-			}
+			// Evicted before we got to it
+			QueueChunk(chunk, false, lock);
+			continue;
 		}
 
-		if (size == 0)
+		CacheEntry& entry = it->second;
+		if (entry.state == ChunkState::Queued || entry.state == ChunkState::Reading)
 		{
-			// For readahead
-			m_requestOffset = offset - 1;
-			m_requestSize = 1;
-			m_requestPtr.store(nullptr, std::memory_order_relaxed);
+			const Common::Timer::Value start = Common::Timer::GetCurrentValue();
+			m_doneCondition.wait(lock);
+			waited += static_cast<u64>(Common::Timer::ConvertValueToNanoseconds(Common::Timer::GetCurrentValue() - start));
+			continue;
 		}
-		else
+
+		if (entry.state == ChunkState::Failed)
 		{
-			m_requestOffset = offset;
-			m_requestSize = size;
-			m_requestPtr.store(pBuffer, std::memory_order_relaxed);
+			// Don't keep the failure around, the next request gets to try again
+			m_cacheBytes -= entry.length;
+			m_lru.erase(entry.lru);
+			m_cache.erase(it);
+			break;
 		}
-		m_requestCancelled.store(false, std::memory_order_relaxed);
+
+		const u64 bufoff = offset - entry.offset;
+		if (entry.size <= bufoff)
+			break;
+
+		const u32 len = static_cast<u32>(std::min<u64>(entry.size - bufoff, size));
+		write += CopyBlocks(write, entry.data.get() + bufoff, len);
+		size -= len;
+		offset += len;
 	}
-	m_condition.notify_one();
-	if (size == 0)
-		return m_amtRead;
-	return FinishRead();
+
+	m_stats.waitNs += waited;
+	m_stats.maxWaitNs = std::max(m_stats.maxWaitNs, waited);
+
+	return static_cast<int>(write - static_cast<char*>(dst));
 }
 
-void ThreadedFileReader::CancelAndWaitUntilStopped(void)
+ThreadedFileReader::Stats ThreadedFileReader::GetStats()
 {
-	m_requestCancelled.store(true, std::memory_order_relaxed);
+	std::lock_guard<std::mutex> lock(m_mtx);
+	return m_stats;
+}
+
+bool ThreadedFileReader::Open(std::string fileName)
+{
+	StopWorkers();
+
+	m_cache.clear();
+	m_lru.clear();
+	m_cacheBytes = 0;
+	m_requestPtr = nullptr;
+	m_lastReadEnd = 0;
+	m_prefetchBytes = 0;
+	m_stats = {};
+
+	if (!Open2(std::move(fileName)))
+		return false;
+
+	StartWorkers();
+	return true;
+}
+
+int ThreadedFileReader::ReadSync(void* pBuffer, uint sector, uint count)
+{
+	const u32 blocksize = InternalBlockSize();
+	const u64 offset = (u64)sector * (u64)blocksize + m_dataoffset;
+	const u32 size = count * blocksize;
+
 	std::unique_lock<std::mutex> lock(m_mtx);
-	while (m_running)
-		m_condition.wait(lock);
+	ScheduleRead(offset, size, lock);
+	return CompleteRead(pBuffer, offset, size, lock);
 }
 
 void ThreadedFileReader::BeginRead(void* pBuffer, uint sector, uint count)
 {
-	s32 blocksize = InternalBlockSize();
-	u64 offset = (u64)sector * (u64)blocksize + m_dataoffset;
-	u32 size = count * blocksize;
-	{
-		std::lock_guard<std::mutex> l(m_mtx);
-		if (TryCachedRead(pBuffer, offset, size, l))
-			return;
-		if (size == 0)
-		{
-			// For readahead
-			m_requestOffset = offset - 1;
-			m_requestSize = 1;
-			m_requestPtr.store(nullptr, std::memory_order_relaxed);
-		}
-		else
-		{
-			m_requestOffset = offset;
-			m_requestSize = size;
-			m_requestPtr.store(pBuffer, std::memory_order_relaxed);
-		}
-		m_requestCancelled.store(false, std::memory_order_relaxed);
-	}
-	m_condition.notify_one();
+	const u32 blocksize = InternalBlockSize();
+
+	std::unique_lock<std::mutex> lock(m_mtx);
+	m_requestPtr = pBuffer;
+	m_requestOffset = (u64)sector * (u64)blocksize + m_dataoffset;
+	m_requestSize = count * blocksize;
+	ScheduleRead(m_requestOffset, m_requestSize, lock);
 }
 
 int ThreadedFileReader::FinishRead(void)
 {
-	if (m_requestPtr.load(std::memory_order_acquire) == nullptr)
-		return m_amtRead;
 	std::unique_lock<std::mutex> lock(m_mtx);
-	while (m_requestPtr)
-		m_condition.wait(lock);
-	return m_amtRead;
+	if (!m_requestPtr)
+		return 0;
+
+	void* ptr = m_requestPtr;
+	m_requestPtr = nullptr;
+	return CompleteRead(ptr, m_requestOffset, m_requestSize, lock);
 }
 
 void ThreadedFileReader::CancelRead(void)
 {
-	if (m_requestPtr.load(std::memory_order_acquire) == nullptr)
-		return;
-	m_requestCancelled.store(true, std::memory_order_release);
-	std::unique_lock<std::mutex> lock(m_mtx);
-	while (m_requestPtr.load(std::memory_order_relaxed))
-		m_condition.wait(lock);
+	// Chunks already queued still land in the cache, they are likely to be asked for again
+	std::lock_guard<std::mutex> lock(m_mtx);
+	m_requestPtr = nullptr;
 }
 
 void ThreadedFileReader::Close(void)
 {
-	CancelAndWaitUntilStopped();
-	for (auto& buf : m_buffer)
-		buf.size.store(0, std::memory_order_relaxed);
+	StopWorkers();
+
+	if (m_stats.hits || m_stats.misses)
+	{
+		DevCon.WriteLn("ISO decompression cache: %llu hits (%llu from read-ahead), %llu misses, %.2f ms spent waiting (worst %.2f ms)",
+			static_cast<unsigned long long>(m_stats.hits), static_cast<unsigned long long>(m_stats.readaheadHits),
+			static_cast<unsigned long long>(m_stats.misses), static_cast<double>(m_stats.waitNs) / 1000000.0,
+			static_cast<double>(m_stats.maxWaitNs) / 1000000.0);
+	}
+
+	if (m_stats.prefetched)
+	{
+		// Every prefetched chunk which got used is a chunk the emulator didn't have to wait for
+		const double avgReadMs = m_stats.chunksRead ? static_cast<double>(m_stats.readNs) / m_stats.chunksRead / 1000000.0 : 0.0;
+		DevCon.WriteLn("ISO prefetch: %llu of %llu chunks used (%.1f%%), about %.2f ms of decompression saved",
+			static_cast<unsigned long long>(m_stats.prefetchHits), static_cast<unsigned long long>(m_stats.prefetched),
+			static_cast<double>(m_stats.prefetchHits) * 100.0 / static_cast<double>(m_stats.prefetched),
+			static_cast<double>(m_stats.prefetchHits) * avgReadMs);
+	}
+
+	m_cache.clear();
+	m_lru.clear();
+	m_cacheBytes = 0;
+	m_requestPtr = nullptr;
+	m_stats = {};
 	Close2();
 }
 
@@ -358,3 +415,37 @@ void ThreadedFileReader::SetDataOffset(int bytes)
 {
 	m_dataoffset = bytes;
 }
+
+void ThreadedFileReader::Prefetch(uint sector, uint count)
+{
+	const u32 blocksize = InternalBlockSize();
+	const u64 offset = (u64)sector * (u64)blocksize + m_dataoffset;
+	const u64 end = offset + (u64)count * blocksize;
+
+	std::unique_lock<std::mutex> lock(m_mtx);
+	if (m_workers.empty())
+		return;
+
+	// Leave the other half of the cache to demand reads and read-ahead, prefetched
+	// chunks would otherwise evict each other before they get used
+	for (Chunk chunk = ChunkForOffset(offset); chunk.chunkID >= 0 && chunk.offset < end; chunk = ChunkForOffset(chunk.offset + chunk.length))
+	{
+		if (m_cache.find(chunk.chunkID) != m_cache.end())
+			continue;
+		if (m_prefetchBytes + chunk.length > m_cacheBudget / 2)
+			break;
+
+		CacheEntry& entry = m_cache[chunk.chunkID];
+		entry.offset = chunk.offset;
+		entry.length = chunk.length;
+		entry.prefetch = true;
+		m_lru.push_front(chunk.chunkID);
+		entry.lru = m_lru.begin();
+		m_cacheBytes += chunk.length;
+		m_prefetchBytes += chunk.length;
+		m_prefetchQueue.push_back(chunk.chunkID);
+		m_stats.prefetched++;
+	}
+
+	m_workCondition.notify_all();
+}
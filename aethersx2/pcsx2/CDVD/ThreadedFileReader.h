@@ -18,13 +18,21 @@
 #include "AsyncFileReader.h"
 #include "common/PersistentThread.h"
 
-#include <thread>
-#include <mutex>
-#include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 /// A file reader for use with compressed formats
-/// Calls decompression code on a separate thread to make a synchronous decompression API async
+/// Calls decompression code on a pool of worker threads to make a synchronous decompression API async
+/// Decompressed chunks are kept in an LRU cache (EmuConfig.Cdvd.CacheSizeMB), sequential reads
+/// queue up to EmuConfig.Cdvd.ReadAheadKB of the following chunks ahead of time
+/// Prefetch() requests are decompressed when the workers have nothing else to do,
+/// up to half of the cache
 class ThreadedFileReader : public AsyncFileReader
 {
 	ThreadedFileReader(ThreadedFileReader&&) = delete;
@@ -46,6 +54,9 @@ protected:
 	virtual Chunk ChunkForOffset(u64 offset) = 0;
 	/// Synchronously read the given block into `dst`
 	virtual int ReadChunk(void* dst, s64 chunkID) = 0;
+	/// Return true if ReadChunk can be called from several threads at once
+	/// Otherwise a single worker thread is used
+	virtual bool CanReadChunksConcurrently() const { return false; }
 	/// AsyncFileReader open but ThreadedFileReader needs prep work first
 	virtual bool Open2(std::string fileName) = 0;
 	/// AsyncFileReader close but ThreadedFileReader needs prep work first
@@ -54,38 +65,87 @@ protected:
 	ThreadedFileReader();
 	~ThreadedFileReader();
 
+public:
+	struct Stats
+	{
+		/// Chunks which were already decompressed when requested
+		u64 hits;
+		/// Chunks which had to be queued (or were still in flight) when requested
+		u64 misses;
+		/// Hits on chunks loaded by read-ahead
+		u64 readaheadHits;
+		/// Chunks queued by Prefetch()
+		u64 prefetched;
+		/// Hits on chunks loaded by Prefetch()
+		u64 prefetchHits;
+		/// Time the workers spent in ReadChunk
+		u64 readNs;
+		u64 chunksRead;
+		/// Time spent waiting for workers in FinishRead/ReadSync
+		u64 waitNs;
+		u64 maxWaitNs;
+	};
+
+	Stats GetStats();
+
 private:
-	int m_amtRead;
-	/// Pointer to read into
-	/// If null when m_requestSize > 0, indicates a request for readahead only
-	std::atomic<void*> m_requestPtr{nullptr};
-	/// Request offset in (internal block) bytes from the beginning of the file
-	u64 m_requestOffset = 0;
-	/// Request size in (internal block) bytes
-	/// In addition to marking the request size, the loop thread uses this variable to decide whether there's work to do (size of 0 means no work)
-	u32 m_requestSize = 0;
-	/// Used to cancel requests early
-	/// Note: It might take a while for the cancellation request to be noticed, wait until `m_requestPtr` is cleared to ensure it's not being written to
-	std::atomic<bool> m_requestCancelled{false};
-	struct Buffer
+	enum class ChunkState : u8
+	{
+		Queued,
+		Reading,
+		Ready,
+		Failed,
+	};
+
+	struct CacheEntry
 	{
-		void* ptr = nullptr;
+		std::unique_ptr<u8[]> data;
 		u64 offset = 0;
-		std::atomic<u32> size{0};
-		u32 cap = 0;
+		/// Allocated size (chunk length)
+		u32 length = 0;
+		/// Valid bytes once Ready
+		u32 size = 0;
+		ChunkState state = ChunkState::Queued;
+		/// Queued by read-ahead and not yet requested
+		bool readahead = false;
+		/// Queued by Prefetch() and not yet requested
+		bool prefetch = false;
+		std::list<s64>::iterator lru;
 	};
-	/// 2 buffers for readahead (current block, next block)
-	Buffer m_buffer[2];
-	u32 m_nextBuffer = 0;
 
-	std::thread m_readThread;
+	std::unordered_map<s64, CacheEntry> m_cache;
+	/// Most recently used at the front
+	std::list<s64> m_lru;
+	/// Sum of the lengths of every cache entry, in flight ones included
+	size_t m_cacheBytes = 0;
+	size_t m_cacheBudget = 0;
+	u32 m_readAheadBytes = 0;
+	/// Bytes queued by Prefetch() since Open
+	size_t m_prefetchBytes = 0;
+
+	/// Demand reads are pushed to the front, read-ahead to the back
+	std::deque<s64> m_queue;
+	/// Prefetch() jobs, only picked up while m_queue is empty
+	std::deque<s64> m_prefetchQueue;
+	std::vector<std::thread> m_workers;
 	std::mutex m_mtx;
-	std::condition_variable m_condition;
-	/// True to tell the thread to exit
+	/// Signalled when work is queued
+	std::condition_variable m_workCondition;
+	/// Signalled when a chunk is done
+	std::condition_variable m_doneCondition;
+	/// True to tell the workers to exit
 	bool m_quit = false;
-	/// True if the thread is currently doing something other than waiting
-	/// View while holding `m_mtx`.  If false, you may touch decompression functions from other threads
-	bool m_running = false;
+
+	/// Pending BeginRead request, pointer is null if there is none
+	void* m_requestPtr = nullptr;
+	/// Request offset in (internal block) bytes from the beginning of the file
+	u64 m_requestOffset = 0;
+	/// Request size in (internal block) bytes
+	u32 m_requestSize = 0;
+	/// End of the previous request, used to detect sequential access
+	u64 m_lastReadEnd = 0;
+
+	Stats m_stats = {};
 
 	/// Get the internal block size
 	u32 InternalBlockSize() const { return m_internalBlockSize ? m_internalBlockSize : m_blocksize; }
@@ -94,19 +154,22 @@ private:
 	/// Returns the number of external block bytes copied
 	size_t CopyBlocks(void* dst, const void* src, size_t size) const;
 
-	/// Main loop of read thread
+	/// Main loop of the worker threads
 	void Loop();
+	void StartWorkers();
+	void StopWorkers();
 
-	/// Load the given block into one of the `m_buffer` buffers if necessary and return a pointer to its contents if successful
-	Buffer* GetBlockPtr(const Chunk& block);
-	/// Decompress from offset to size into
-	bool Decompress(void* ptr, u64 offset, u32 size);
-	/// Cancel any inflight read and wait until the thread is no longer doing anything
-	void CancelAndWaitUntilStopped(void);
-	/// Attempt to read from the cache
-	/// Adjusts pointer, offset, and size if successful
-	/// Returns true if no additional reads are necessary
-	bool TryCachedRead(void*& buffer, u64& offset, u32& size, const std::lock_guard<std::mutex>&);
+	/// Queue the chunk if it isn't cached or in flight, and mark it as most recently used
+	void QueueChunk(const Chunk& chunk, bool readahead, std::unique_lock<std::mutex>& lock);
+	/// Drop read-ahead jobs nobody started on yet
+	void DropQueuedReadAhead(std::unique_lock<std::mutex>& lock);
+	/// Evict least recently used chunks until the cache fits in its budget
+	void EvictChunks(std::unique_lock<std::mutex>& lock);
+	/// Queue every chunk of the request and the read-ahead behind it
+	void ScheduleRead(u64 offset, u32 size, std::unique_lock<std::mutex>& lock);
+	/// Wait for the chunks of the request and copy them to `dst`
+	/// Returns the number of external block bytes copied
+	int CompleteRead(void* dst, u64 offset, u32 size, std::unique_lock<std::mutex>& lock);
 
 public:
 	bool Open(std::string fileName) final override;
@@ -117,4 +180,5 @@ public:
 	void Close(void) final override;
 	void SetBlockSize(uint bytes) final override;
 	void SetDataOffset(int bytes) final override;
+	void Prefetch(uint sector, uint count) final override;
 };
@@ -49,6 +49,14 @@ Comments) 1950 to 1952 in the files http://tools.ietf.org/html/rfc1950
       (Thanks to Mark Adler for suggesting the approach)
   - build_index(...) - added progress prints
   - CHUNK changed from 16k to 512k
+
+ 1.1++ PCSX2 background indexing
+  - point: the 32K window is kept deflated and referenced by pointer, so that an index
+      loaded from disk can point straight into a memory-mapped file. The on-disk format
+      is handled by GzippedFileReader, point and access are no longer packed.
+  - build_index(...) - progress prints replaced by optional callbacks which receive each
+      new access point as soon as it exists and can cancel the build.
+  - extract(...) - takes the access point to start from instead of the whole index, see find_point().
  */
 
 /* Illustrate the use of Z_BLOCK, inflatePrime(), and inflateSetDictionary()
@@ -115,22 +123,15 @@ Comments) 1950 to 1952 in the files http://tools.ietf.org/html/rfc1950
 #define WINSIZE 32768U    /* sliding window size */
 #define CHUNK (64 * 1024) /* file input buffer size */
 
-#ifdef _WIN32
-#pragma pack(push, indexData, 1)
-#endif
-
 /* access point entry */
 struct point
 {
-	s64 out;                  /* corresponding offset in uncompressed data */
-	s64 in;                   /* offset in input file of first full byte */
-	int bits;                      /* number of bits (1-7) from byte at in - 1, or 0 */
-	unsigned char window[WINSIZE]; /* preceding 32K of uncompressed data */
-}
-#ifndef _WIN32
-__attribute__((packed))
-#endif
-;
+	s64 out;                     /* corresponding offset in uncompressed data */
+	s64 in;                      /* offset in input file of first full byte */
+	int bits;                    /* number of bits (1-7) from byte at in - 1, or 0 */
+	unsigned window_size;        /* size of window, WINSIZE if it is stored uncompressed */
+	const unsigned char* window; /* preceding 32K of uncompressed data, deflated (zlib format) */
+};
 
 typedef struct point Point;
 
@@ -143,34 +144,57 @@ struct access
 
 	s32 span;                   /* once the index is built, holds the span size used to build it */
 	s64 uncompressed_size; /* filled by build_index */
-}
-#ifndef _WIN32
-__attribute__((packed))
-#endif
-;
+	int owns_windows;      /* windows were allocated by addpoint() and are freed with the index */
+};
 
 typedef struct access Access;
 
-#ifdef _WIN32
-#pragma pack(pop, indexData)
-#endif
+/* optional build_index() hooks */
+struct build_callbacks
+{
+	void* ctx;
+	/* called for each access point as soon as it is added, the point is only valid during the call */
+	void (*point_added)(void* ctx, const struct point* point);
+	/* polled between input chunks, returning nonzero stops the build with BUILD_INDEX_CANCELLED */
+	int (*cancelled)(void* ctx);
+};
+
+#define BUILD_INDEX_CANCELLED (-100)
 
 /* Deallocate an index built by build_index() */
 local void free_index(struct access* index)
 {
 	if (index != NULL)
 	{
+		if (index->owns_windows)
+		{
+			for (int i = 0; i < index->have; i++)
+				free((void*)index->list[i].window);
+		}
 		free(index->list);
 		free(index);
 	}
 }
 
+/* Return the last access point at or before offset (or the first one) */
+local const struct point* find_point(const struct point* list, int have, s64 offset)
+{
+	const struct point* here = list;
+	int ret = have;
+	while (--ret > 0 && here[1].out <= offset)
+		here++;
+	return here;
+}
+
 /* Add an entry to the access point list.  If out of memory, deallocate the
    existing list and return NULL. */
 local struct access* addpoint(struct access* index, int bits,
 							  s64 in, s64 out, unsigned left, unsigned char* window)
 {
 	struct point* next;
+	unsigned char ordered[WINSIZE];
+	unsigned char* packed;
+	uLongf packed_size;
 
 	/* if list is empty, create it (start with eight points) */
 	if (index == NULL)
@@ -186,6 +210,7 @@ local struct access* addpoint(struct access* index, int bits,
 		}
 		index->size = 8;
 		index->have = 0;
+		index->owns_windows = 1;
 	}
 
 	/* if list is full, make it bigger */
@@ -201,15 +226,37 @@ local struct access* addpoint(struct access* index, int bits,
 		index->list = next;
 	}
 
+	/* unwrap the sliding window and deflate it, keep it as is if it doesn't shrink */
+	if (left)
+		memcpy(ordered, window + WINSIZE - left, left);
+	if (left < WINSIZE)
+		memcpy(ordered + left, window, WINSIZE - left);
+
+	packed_size = compressBound(WINSIZE);
+	packed = (unsigned char*)malloc(packed_size);
+	if (packed == NULL)
+	{
+		free_index(index);
+		return NULL;
+	}
+	if (compress2(packed, &packed_size, ordered, WINSIZE, Z_BEST_SPEED) != Z_OK || packed_size >= WINSIZE)
+	{
+		memcpy(packed, ordered, WINSIZE);
+		packed_size = WINSIZE;
+	}
+	{
+		unsigned char* shrunk = (unsigned char*)realloc(packed, packed_size);
+		if (shrunk != NULL)
+			packed = shrunk;
+	}
+
 	/* fill in entry and increment how many we have */
 	next = index->list + index->have;
 	next->bits = bits;
 	next->in = in;
 	next->out = out;
-	if (left)
-		memcpy(next->window, window + WINSIZE - left, left);
-	if (left < WINSIZE)
-		memcpy(next->window + left, window, WINSIZE - left);
+	next->window_size = (unsigned)packed_size;
+	next->window = packed;
 	index->have++;
 
 	/* return list, possibly reallocated */
@@ -223,11 +270,12 @@ local struct access* addpoint(struct access* index, int bits,
    of the first zlib or gzip stream in the file is ignored.  build_index()
    returns the number of access points on success (>= 1), Z_MEM_ERROR for out
    of memory, Z_DATA_ERROR for an error in the input file, or Z_ERRNO for a
-   file read error.  On success, *built points to the resulting index. */
-local int build_index(FILE* in, s64 span, struct access** built)
+   file read error.  On success, *built points to the resulting index.
+   callbacks may be NULL. */
+local int build_index(FILE* in, s64 span, struct access** built, const struct build_callbacks* callbacks)
 {
 	int ret;
-	s64 totin, totout, totPrinted; /* our own total counters to avoid 4GB limit */
+	s64 totin, totout;             /* our own total counters to avoid 4GB limit */
 	s64 last;                      /* totout value of last access point */
 	struct access* index;               /* access points being generated */
 	z_stream strm;
@@ -247,11 +295,17 @@ local int build_index(FILE* in, s64 span, struct access** built)
 	/* inflate the input, maintain a sliding window, and build an index -- this
        also validates the integrity of the compressed data using the check
        information at the end of the gzip or zlib stream */
-	totin = totout = last = totPrinted = 0;
+	totin = totout = last = 0;
 	index = NULL; /* will be allocated by first addpoint() */
 	strm.avail_out = 0;
 	do
 	{
+		if (callbacks && callbacks->cancelled && callbacks->cancelled(callbacks->ctx))
+		{
+			ret = BUILD_INDEX_CANCELLED;
+			goto build_index_error;
+		}
+
 		/* get some compressed data from input file */
 		strm.avail_in = fread(input, 1, CHUNK, in);
 		if (ferror(in))
@@ -310,18 +364,16 @@ local int build_index(FILE* in, s64 span, struct access** built)
 					goto build_index_error;
 				}
 				last = totout;
+				if (callbacks && callbacks->point_added)
+					callbacks->point_added(callbacks->ctx, &index->list[index->have - 1]);
 			}
 		} while (strm.avail_in != 0);
-		if (totin / (50 * 1024 * 1024) != totPrinted / (50 * 1024 * 1024))
-		{
-			printf("%dMB ", (int)(totin / (1024 * 1024)));
-			totPrinted = totin;
-		}
 	} while (ret != Z_STREAM_END);
 
 	if (index == NULL)
 	{
 		// Could happen if the start of the stream in Z_STREAM_END
+		(void)inflateEnd(&strm);
 		return 0;
 	}
 
@@ -355,18 +407,17 @@ static inline s64 getInOffset(zstate* state)
 	return state->in_offset;
 }
 
-/* Use the index to read len bytes from offset into buf, return bytes read or
+/* Use the access point here (see find_point()) to read len bytes from offset into buf, return bytes read or
    negative for error (Z_DATA_ERROR or Z_MEM_ERROR).  If data is requested past
    the end of the uncompressed data, then extract() will return a value less
    than len, indicating how much as actually read into buf.  This function
    should not return a data error unless the file was modified since the index
    was generated.  extract() may also return Z_ERRNO if there is an error on
    reading or seeking the input file. */
-local int extract(FILE* in, struct access* index, s64 offset,
+local int extract(FILE* in, const struct point* here, s64 offset,
 				  unsigned char* buf, int len, zstate* state)
 {
 	int ret, skip;
-	struct point* here;
 	unsigned char input[CHUNK];
 	unsigned char discard[WINSIZE];
 	int isEnd = 0;
@@ -393,12 +444,6 @@ local int extract(FILE* in, struct access* index, s64 offset,
 	}
 	else
 	{
-		/* find where in stream to start */
-		here = index->list;
-		ret = index->have;
-		while (--ret && here[1].out <= offset)
-			here++;
-
 		/* initialize file and inflate state to start there */
 		state->strm.zalloc = Z_NULL;
 		state->strm.zfree = Z_NULL;
@@ -421,7 +466,21 @@ local int extract(FILE* in, struct access* index, s64 offset,
 			}
 			inflatePrime(&state->strm, here->bits, ret >> (8 - here->bits));
 		}
-		inflateSetDictionary(&state->strm, here->window, WINSIZE);
+		if (here->window_size == WINSIZE)
+		{
+			inflateSetDictionary(&state->strm, here->window, WINSIZE);
+		}
+		else
+		{
+			/* discard isn't in use yet, borrow it for the unpacked window */
+			uLongf window_size = WINSIZE;
+			if (uncompress(discard, &window_size, here->window, here->window_size) != Z_OK || window_size != WINSIZE)
+			{
+				ret = Z_DATA_ERROR;
+				goto extract_ret;
+			}
+			inflateSetDictionary(&state->strm, discard, WINSIZE);
+		}
 
 		/* skip uncompressed bytes until offset reached, then satisfy request */
 		offset -= here->out;
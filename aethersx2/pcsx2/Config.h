@@ -281,8 +281,8 @@ struct Pcsx2Config
 		BITFIELD32()
 		bool
 			Enabled : 1, // universal toggle for the profiler.
-			RecBlocks_EE : 1, // Enables per-block profiling for the EE recompiler [unimplemented]
-			RecBlocks_IOP : 1, // Enables per-block profiling for the IOP recompiler [unimplemented]
+			RecBlocks_EE : 1, // Enables per-block profiling for the EE recompiler
+			RecBlocks_IOP : 1, // Enables per-block profiling for the IOP recompiler
 			RecBlocks_VU0 : 1, // Enables per-block profiling for the VU0 recompiler [unimplemented]
 			RecBlocks_VU1 : 1; // Enables per-block profiling for the VU1 recompiler [unimplemented]
 		BITFIELD_END
@@ -416,7 +416,9 @@ struct Pcsx2Config
 			UserHacks_MergePPSprite : 1,
 			UserHacks_WildHack : 1,
 			FXAA : 1,
-			PreloadTexture : 1;
+			PreloadTexture : 1,
+			TextureHashCache : 1,
+			SWExtraThreadsTiles : 1;
 		BITFIELD_END
 
 		int VsyncQueueSize{2};
@@ -454,6 +456,7 @@ struct Pcsx2Config
 		int SWBlending{1};
 		int SWExtraThreads{2};
 		int SWExtraThreadsHeight{4};
+		int TextureDecodeThreads{0};
 		int TVShader{ 0 };
 
 		GSOptions();
@@ -495,6 +498,7 @@ struct Pcsx2Config
 				   OpEqu(HWMipmap) &&
 				   OpEqu(SWBlending) &&
 				   OpEqu(SWExtraThreads) &&
+				   OpEqu(TextureDecodeThreads) &&
 				   OpEqu(TVShader);
 		}
 
@@ -635,11 +639,14 @@ struct Pcsx2Config
 			WaitLoop : 1, // enables constant loop detection and fast-forwarding
 			vuFlagHack : 1, // microVU specific flag hack
 			vuThread : 1, // Enable Threaded VU1
-			vu1Instant : 1; // Enable Instant VU1 (Without MTVU only)
+			vu1Instant : 1, // Enable Instant VU1 (Without MTVU only)
+			iopThread : 1, // Run the IOP on its own thread
+			ipuThread : 1; // Run IPU commands on their own thread
 		BITFIELD_END
 
 		s8 EECycleRate; // EE cycle rate selector (1.0, 1.5, 2.0)
 		u8 EECycleSkip; // EE Cycle skip factor (0, 1, 2, or 3)
+		uint IopThreadMaxSkew; // EE cycles the EE may run past the IOP with iopThread
 
 		SpeedhackOptions();
 		void LoadSave(SettingsWrapper& conf);
@@ -649,7 +656,7 @@ struct Pcsx2Config
 
 		bool operator==(const SpeedhackOptions& right) const
 		{
-			return OpEqu(bitset) && OpEqu(EECycleRate) && OpEqu(EECycleSkip);
+			return OpEqu(bitset) && OpEqu(EECycleRate) && OpEqu(EECycleSkip) && OpEqu(IopThreadMaxSkew);
 		}
 
 		bool operator!=(const SpeedhackOptions& right) const
@@ -711,6 +718,51 @@ struct Pcsx2Config
 		}
 	};
 
+	// ------------------------------------------------------------------------
+	struct RewindOptions
+	{
+		bool Enabled{false};
+
+		uint Frequency{10}; // frames between two snapshots
+		uint BufferSizeMB{256}; // memory budget of the compressed snapshot ring
+
+		void LoadSave(SettingsWrapper& wrap);
+		void SanityCheck();
+
+		bool operator==(const RewindOptions& right) const
+		{
+			return OpEqu(Enabled) && OpEqu(Frequency) && OpEqu(BufferSizeMB);
+		}
+
+		bool operator!=(const RewindOptions& right) const
+		{
+			return !this->operator==(right);
+		}
+	};
+
+	// ------------------------------------------------------------------------
+	struct CdvdOptions
+	{
+		uint ReadAheadKB{1024}; // decompressed data fetched ahead of sequential reads (CSO/CHD)
+		uint CacheSizeMB{64}; // LRU cache of decompressed chunks
+		uint DecompressThreads{2}; // decoders for formats which support concurrent reads
+		uint GzipIndexSpanKB{1024}; // distance between access points of new .gz indexes
+		uint PrefetchMB{32}; // data read per game which is loaded ahead of time on the next boot, 0 to disable
+
+		void LoadSave(SettingsWrapper& wrap);
+		void SanityCheck();
+
+		bool operator==(const CdvdOptions& right) const
+		{
+			return OpEqu(ReadAheadKB) && OpEqu(CacheSizeMB) && OpEqu(DecompressThreads) && OpEqu(GzipIndexSpanKB) && OpEqu(PrefetchMB);
+		}
+
+		bool operator!=(const CdvdOptions& right) const
+		{
+			return !this->operator==(right);
+		}
+	};
+
 	// ------------------------------------------------------------------------
 	struct FilenameOptions
 	{
@@ -745,6 +797,7 @@ struct Pcsx2Config
 		CdvdVerboseReads : 1, // enables cdvd read activity verbosely dumped to the console
 		CdvdDumpBlocks : 1, // enables cdvd block dumping
 		CdvdShareWrite : 1, // allows the iso to be modified while it's loaded
+		CdvdMapImages : 1, // reads uncompressed images through a memory mapping (ignored with CdvdShareWrite)
 		EnablePatches : 1, // enables patch detection and application
 		EnableCheats : 1, // enables cheat detection and application
 		EnableIPC : 1, // enables inter-process communication
@@ -758,6 +811,8 @@ struct Pcsx2Config
 		// enables simulated ejection of memory cards when loading savestates
 		McdEnableEjection : 1,
 		McdFolderAutoManage : 1,
+		// keeps file memory cards in RAM and writes them back in the background
+		McdWriteBack : 1,
 
 		MultitapPort0_Enabled : 1,
 		MultitapPort1_Enabled : 1,
@@ -778,6 +833,8 @@ struct Pcsx2Config
 	ProfilerOptions Profiler;
 	DebugOptions Debugger;
 	FramerateOptions Framerate;
+	RewindOptions Rewind;
+	CdvdOptions Cdvd;
 	SPU2Options SPU2;
 
 	TraceLogFilters Trace;
@@ -854,6 +911,8 @@ namespace EmuFolders
 // ------------ CPU / Recompiler Options ---------------
 
 #define THREAD_VU1 (EmuConfig.Cpu.Recompiler.EnableVU1 && EmuConfig.Speedhacks.vuThread)
+#define THREAD_IOP (EmuConfig.Speedhacks.iopThread)
+#define THREAD_IPU (EmuConfig.Speedhacks.ipuThread)
 #define INSTANT_VU1 (EmuConfig.Speedhacks.vu1Instant)
 #define CHECK_EEREC (EmuConfig.Cpu.Recompiler.EnableEE)
 #define CHECK_CACHE (EmuConfig.Cpu.Recompiler.EnableEECache)
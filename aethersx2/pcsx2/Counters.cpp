@@ -29,6 +29,7 @@
 #include "PerformanceMetrics.h"
 #include "VMManager.h"
 #include "Patch.h"
+#include "Rewind.h"
 
 #include "ps2/HwInternal.h"
 #include "Sio.h"
@@ -435,6 +436,7 @@ static __fi void frameLimitUpdateCore()
 #else
 	VMManager::Internal::VSyncOnCPUThread();
 #endif
+	Rewind::OnVSync();
 	Cpu->CheckExecutionState();
 }
 
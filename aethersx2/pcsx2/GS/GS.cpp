@@ -172,8 +172,8 @@ static bool DoGSOpen(GSRendererType renderer, u8* basemem)
 			break;
 
 		case HostDisplay::RenderAPI::None:
+			// SW still rasterizes into local memory without a device, anything else falls back to null below.
 			dev = std::make_unique<GSDeviceNull>();
-			use_software = false; // force null renderer below
 			break;
 
 		default:
@@ -621,6 +621,21 @@ void GSsetFrameSkip(int frameskip)
 	s_gs->SetFrameSkip(frameskip);
 }
 
+void GSSetDrawTimings(std::vector<GSDrawTiming>* timings)
+{
+	s_gs->m_draw_timings = timings;
+}
+
+bool GSGetSelectorTicks(std::unordered_map<uint64, uint64>& ticks)
+{
+	GSRendererSW* sw = dynamic_cast<GSRendererSW*>(s_gs.get());
+	if (!sw)
+		return false;
+
+	sw->GetSelectorTicks(ticks);
+	return true;
+}
+
 void GSgetInternalResolution(int* width, int* height)
 {
 	GSRenderer* gs = s_gs.get();
@@ -650,7 +665,7 @@ void GSgetStats(std::string& info)
 
 		const double fps = GetVerticalFrequency();
 		const double fillrate = pm.Get(GSPerfMon::Fillrate);
-		info = format("%s SW | %d S | %d P | %d D | %.2f U | %.2f D | %.2f mpps | %d%% WCPU",
+		info = format("%s SW | %d S | %d P | %d D | %.2f U | %.2f D | %.2f mpps | %d%% WCPU | %d Q %d PK %d SPIN",
 			api_name,
 			(int)pm.Get(GSPerfMon::SyncPoint),
 			(int)pm.Get(GSPerfMon::Prim),
@@ -658,18 +673,22 @@ void GSgetStats(std::string& info)
 			pm.Get(GSPerfMon::Swizzle) / 1024,
 			pm.Get(GSPerfMon::Unswizzle) / 1024,
 			fps * fillrate / (1024 * 1024),
-			static_cast<int>(std::lround(sum)));
+			static_cast<int>(std::lround(sum)),
+			(int)pm.Get(GSPerfMon::QueuePush),
+			(int)pm.Get(GSPerfMon::QueuePark),
+			(int)pm.Get(GSPerfMon::QueueSpin));
 	}
 	else
 	{
-		info = format("%s HW | %d P | %d D | %d DC | %d RB | %d TC | %d TU",
+		info = format("%s HW | %d P | %d D | %d DC | %d RB | %d TC | %d TU | %d TH",
 			api_name,
 			(int)pm.Get(GSPerfMon::Prim),
 			(int)pm.Get(GSPerfMon::Draw),
 			(int)std::ceil(pm.Get(GSPerfMon::DrawCalls)),
 			(int)std::ceil(pm.Get(GSPerfMon::Readbacks)),
 			(int)std::ceil(pm.Get(GSPerfMon::TextureCopies)),
-			(int)std::ceil(pm.Get(GSPerfMon::TextureUploads)));
+			(int)std::ceil(pm.Get(GSPerfMon::TextureUploads)),
+			(int)std::ceil(pm.Get(GSPerfMon::TextureHashHits)));
 	}
 }
 
@@ -724,8 +743,11 @@ void GSLoadConfigFromApp(Pcsx2Config::GSOptions* config)
 	config->SWBlending = theApp.GetConfigI("accurate_blending_unit");
 	config->SWExtraThreads = theApp.GetConfigI("extrathreads");
 	config->SWExtraThreadsHeight = theApp.GetConfigI("extrathreads_height");
+	config->SWExtraThreadsTiles = theApp.GetConfigB("extrathreads_tiles");
 	config->TVShader = theApp.GetConfigI("TVShader");
 	config->PreloadTexture = theApp.GetConfigB("preload_texture");
+	config->TextureHashCache = theApp.GetConfigB("texture_hash_cache");
+	config->TextureDecodeThreads = theApp.GetConfigI("texture_decode_threads");
 }
 
 #endif
@@ -778,6 +800,7 @@ void GSUpdateConfig(const Pcsx2Config::GSOptions& new_config)
 			 GSConfig.SWBlending != old_config.SWBlending ||
 			 GSConfig.SWExtraThreads != old_config.SWExtraThreads ||
 			 GSConfig.SWExtraThreadsHeight != old_config.SWExtraThreadsHeight || 
+			 GSConfig.SWExtraThreadsTiles != old_config.SWExtraThreadsTiles ||
 			 GSConfig.TVShader != old_config.TVShader)
 	{
 		DoReopenGS(false);
@@ -1270,6 +1293,7 @@ void GSApp::Init()
 	m_default_configuration["dump"]                                       = "0";
 	m_default_configuration["extrathreads"]                               = "2";
 	m_default_configuration["extrathreads_height"]                        = "4";
+	m_default_configuration["extrathreads_tiles"]                         = "0";
 	m_default_configuration["filter"]                                     = std::to_string(static_cast<int8>(BiFiltering::PS2));
 	m_default_configuration["force_texture_clear"]                        = "0";
 	m_default_configuration["fxaa"]                                       = "0";
@@ -1324,6 +1348,8 @@ void GSApp::Init()
 	m_default_configuration["shaderfx"]                                   = "0";
 	m_default_configuration["shaderfx_conf"]                              = "shaders/GS_FX_Settings.ini";
 	m_default_configuration["shaderfx_glsl"]                              = "shaders/GS.fx";
+	m_default_configuration["texture_decode_threads"]                     = "0";
+	m_default_configuration["texture_hash_cache"]                         = "0";
 	m_default_configuration["throttle_present_rate"]                      = "0";
 	m_default_configuration["TVShader"]                                   = "0";
 	m_default_configuration["upscale_multiplier"]                         = "1";
@@ -1730,6 +1730,7 @@ enum class GSVideoMode : uint8
 extern Pcsx2Config::GSOptions GSConfig;
 
 struct HostKeyEvent;
+struct GSDrawTiming;
 class HostDisplay;
 
 #ifdef ENABLE_ACCURATE_BUFFER_EMULATION
@@ -1764,6 +1765,10 @@ void GSendRecording();
 void GSsetGameCRC(uint32 crc, int options);
 void GSsetFrameSkip(int frameskip);
 
+// Replay/benchmark helpers. Timings are appended for every flushed draw while the vector is set.
+void GSSetDrawTimings(std::vector<GSDrawTiming>* timings);
+bool GSGetSelectorTicks(std::unordered_map<uint64, uint64>& ticks);
+
 void GSgetInternalResolution(int* width, int* height);
 void GSgetStats(std::string& info);
 
@@ -19,28 +19,14 @@
 #include "GSTables.h"
 #include "GSVector.h"
 
+MULTI_ISA_UNSHARED_START
+
 class GSBlock
 {
-#if _M_SSE >= 0x501
-	static const GSVector8i m_r16mask;
-#else
 	static const GSVector4i m_r16mask;
-#endif
 	static const GSVector4i m_r8mask;
 	static const GSVector4i m_r4mask;
 
-#if _M_SSE >= 0x501
-	static const GSVector8i m_xxxa;
-	static const GSVector8i m_xxbx;
-	static const GSVector8i m_xgxx;
-	static const GSVector8i m_rxxx;
-#else
-	static const GSVector4i m_xxxa;
-	static const GSVector4i m_xxbx;
-	static const GSVector4i m_xgxx;
-	static const GSVector4i m_rxxx;
-#endif
-
 	static const GSVector4i m_uw8hmask0;
 	static const GSVector4i m_uw8hmask1;
 	static const GSVector4i m_uw8hmask2;
@@ -489,9 +475,10 @@ public:
 #if _M_SSE >= 0x501
 
 		const GSVector8i* s = (const GSVector8i*)src;
+		const GSVector8i mask = GSVector8i::broadcast128(m_r16mask);
 
-		GSVector8i v0 = s[i * 2 + 0].shuffle8(m_r16mask);
-		GSVector8i v1 = s[i * 2 + 1].shuffle8(m_r16mask);
+		GSVector8i v0 = s[i * 2 + 0].shuffle8(mask);
+		GSVector8i v1 = s[i * 2 + 1].shuffle8(mask);
 
 		GSVector8i::sw128(v0, v1);
 		GSVector8i::sw32(v0, v1);
@@ -1009,7 +996,11 @@ public:
 	template <bool AEM, class V>
 	__forceinline static V Expand16to32(const V& c, const V& TA0, const V& TA1)
 	{
-		return ((c & m_rxxx) << 3) | ((c & m_xgxx) << 6) | ((c & m_xxbx) << 9) | (AEM ? TA0.blend8(TA1, c.template sra16<15>()).andnot(c == V::zero()) : TA0.blend(TA1, c.template sra16<15>()));
+		const V rxxx = V::cxpr(0x0000001f);
+		const V xgxx = V::cxpr(0x000003e0);
+		const V xxbx = V::cxpr(0x00007c00);
+
+		return ((c & rxxx) << 3) | ((c & xgxx) << 6) | ((c & xxbx) << 9) | (AEM ? TA0.blend8(TA1, c.template sra16<15>()).andnot(c == V::zero()) : TA0.blend(TA1, c.template sra16<15>()));
 	}
 
 	template <bool AEM>
@@ -1636,11 +1627,12 @@ public:
 
 		GSVector8i TA0(TEXA.TA0 << 24);
 		GSVector8i TA1(TEXA.TA1 << 24);
+		GSVector8i mask = GSVector8i::broadcast128(m_r16mask);
 
 		for (int i = 0; i < 4; i++, dst += dstpitch * 2)
 		{
-			GSVector8i v0 = s[i * 2 + 0].shuffle8(m_r16mask);
-			GSVector8i v1 = s[i * 2 + 1].shuffle8(m_r16mask);
+			GSVector8i v0 = s[i * 2 + 0].shuffle8(mask);
+			GSVector8i v1 = s[i * 2 + 1].shuffle8(mask);
 
 			GSVector8i::sw128(v0, v1);
 			GSVector8i::sw32(v0, v1);
@@ -1871,3 +1863,7 @@ public:
 
 	// TODO: ReadAndExpandBlock4HH_16
 };
+
+MULTI_ISA_UNSHARED_END
+
+using GS_ISA_NAMESPACE::GSBlock;
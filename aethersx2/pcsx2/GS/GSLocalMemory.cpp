@@ -15,45 +15,9 @@
 
 #include "PrecompiledHeader.h"
 #include "GSLocalMemory.h"
+#include "GSUtil.h"
 #include "GS.h"
 
-template <typename Fn>
-static void foreachBlock(const GSOffset& off, GSLocalMemory* mem, const GSVector4i& r, uint8* dst, int dstpitch, int bpp, Fn&& fn)
-{
-	ASSERT(off.isBlockAligned(r));
-	GSOffset::BNHelper bn = off.bnMulti(r.left, r.top);
-	int right = r.right >> off.blockShiftX();
-	int bottom = r.bottom >> off.blockShiftY();
-
-	int offset = dstpitch << off.blockShiftY();
-	int xAdd = (1 << off.blockShiftX()) * (bpp / 8);
-
-	for (; bn.blkY() < bottom; bn.nextBlockY(), dst += offset)
-	{
-		for (int x = 0; bn.blkX() < right; bn.nextBlockX(), x += xAdd)
-		{
-			const uint8* src = mem->BlockPtr(bn.value());
-			uint8* read_dst = dst + x;
-			fn(read_dst, src);
-		}
-	}
-}
-
-//
-
-constexpr GSSwizzleInfo GSLocalMemory::swizzle32;
-constexpr GSSwizzleInfo GSLocalMemory::swizzle32Z;
-constexpr GSSwizzleInfo GSLocalMemory::swizzle16;
-constexpr GSSwizzleInfo GSLocalMemory::swizzle16S;
-constexpr GSSwizzleInfo GSLocalMemory::swizzle16Z;
-constexpr GSSwizzleInfo GSLocalMemory::swizzle16SZ;
-constexpr GSSwizzleInfo GSLocalMemory::swizzle8;
-constexpr GSSwizzleInfo GSLocalMemory::swizzle4;
-
-//
-
-GSLocalMemory::psm_t GSLocalMemory::m_psm[64];
-
 //
 
 GSLocalMemory::GSLocalMemory()
@@ -81,239 +45,18 @@ GSLocalMemory::GSLocalMemory()
 
 	memset(m_vm8, 0, m_vmsize);
 
-	for (size_t i = 0; i < countof(m_psm); i++)
+	SetupPSMTable();
+
+#ifdef GS_MULTI_ISA
+	switch (GSUtil::GetBestVectorISA())
 	{
-		m_psm[i].info = GSLocalMemory::swizzle32;
-		m_psm[i].rp = &GSLocalMemory::ReadPixel32;
-		m_psm[i].rpa = &GSLocalMemory::ReadPixel32;
-		m_psm[i].wp = &GSLocalMemory::WritePixel32;
-		m_psm[i].wpa = &GSLocalMemory::WritePixel32;
-		m_psm[i].rt = &GSLocalMemory::ReadTexel32;
-		m_psm[i].rta = &GSLocalMemory::ReadTexel32;
-		m_psm[i].wfa = &GSLocalMemory::WritePixel32;
-		m_psm[i].wi = &GSLocalMemory::WriteImage<PSM_PSMCT32, 8, 8, 32>;
-		m_psm[i].ri = &GSLocalMemory::ReadImageX; // TODO
-		m_psm[i].rtx = &GSLocalMemory::ReadTexture32;
-		m_psm[i].rtxP = &GSLocalMemory::ReadTexture32;
-		m_psm[i].rtxb = &GSLocalMemory::ReadTextureBlock32;
-		m_psm[i].rtxbP = &GSLocalMemory::ReadTextureBlock32;
-		m_psm[i].bpp = m_psm[i].trbpp = 32;
-		m_psm[i].pal = 0;
-		m_psm[i].bs = GSVector2i(8, 8);
-		m_psm[i].pgs = GSVector2i(64, 32);
-		m_psm[i].msk = 0xff;
-		m_psm[i].depth = 0;
+		case GSVectorISA::AVX2: SetupTransferFunctions<GSVectorISA::AVX2>(); break;
+		case GSVectorISA::AVX: SetupTransferFunctions<GSVectorISA::AVX>(); break;
+		default: SetupTransferFunctions<GSVectorISA::SSE4>(); break;
 	}
-
-	m_psm[PSM_PSGPU24].info = GSLocalMemory::swizzle16;
-	m_psm[PSM_PSMCT16].info = GSLocalMemory::swizzle16;
-	m_psm[PSM_PSMCT16S].info = GSLocalMemory::swizzle16S;
-	m_psm[PSM_PSMT8].info = GSLocalMemory::swizzle8;
-	m_psm[PSM_PSMT4].info = GSLocalMemory::swizzle4;
-	m_psm[PSM_PSMZ32].info = GSLocalMemory::swizzle32Z;
-	m_psm[PSM_PSMZ24].info = GSLocalMemory::swizzle32Z;
-	m_psm[PSM_PSMZ16].info = GSLocalMemory::swizzle16Z;
-	m_psm[PSM_PSMZ16S].info = GSLocalMemory::swizzle16SZ;
-
-	m_psm[PSM_PSMCT24].rp = &GSLocalMemory::ReadPixel24;
-	m_psm[PSM_PSMCT16].rp = &GSLocalMemory::ReadPixel16;
-	m_psm[PSM_PSMCT16S].rp = &GSLocalMemory::ReadPixel16S;
-	m_psm[PSM_PSMT8].rp = &GSLocalMemory::ReadPixel8;
-	m_psm[PSM_PSMT4].rp = &GSLocalMemory::ReadPixel4;
-	m_psm[PSM_PSMT8H].rp = &GSLocalMemory::ReadPixel8H;
-	m_psm[PSM_PSMT4HL].rp = &GSLocalMemory::ReadPixel4HL;
-	m_psm[PSM_PSMT4HH].rp = &GSLocalMemory::ReadPixel4HH;
-	m_psm[PSM_PSMZ32].rp = &GSLocalMemory::ReadPixel32Z;
-	m_psm[PSM_PSMZ24].rp = &GSLocalMemory::ReadPixel24Z;
-	m_psm[PSM_PSMZ16].rp = &GSLocalMemory::ReadPixel16Z;
-	m_psm[PSM_PSMZ16S].rp = &GSLocalMemory::ReadPixel16SZ;
-
-	m_psm[PSM_PSMCT24].rpa = &GSLocalMemory::ReadPixel24;
-	m_psm[PSM_PSMCT16].rpa = &GSLocalMemory::ReadPixel16;
-	m_psm[PSM_PSMCT16S].rpa = &GSLocalMemory::ReadPixel16;
-	m_psm[PSM_PSMT8].rpa = &GSLocalMemory::ReadPixel8;
-	m_psm[PSM_PSMT4].rpa = &GSLocalMemory::ReadPixel4;
-	m_psm[PSM_PSMT8H].rpa = &GSLocalMemory::ReadPixel8H;
-	m_psm[PSM_PSMT4HL].rpa = &GSLocalMemory::ReadPixel4HL;
-	m_psm[PSM_PSMT4HH].rpa = &GSLocalMemory::ReadPixel4HH;
-	m_psm[PSM_PSMZ32].rpa = &GSLocalMemory::ReadPixel32;
-	m_psm[PSM_PSMZ24].rpa = &GSLocalMemory::ReadPixel24;
-	m_psm[PSM_PSMZ16].rpa = &GSLocalMemory::ReadPixel16;
-	m_psm[PSM_PSMZ16S].rpa = &GSLocalMemory::ReadPixel16;
-
-	m_psm[PSM_PSMCT32].wp = &GSLocalMemory::WritePixel32;
-	m_psm[PSM_PSMCT24].wp = &GSLocalMemory::WritePixel24;
-	m_psm[PSM_PSMCT16].wp = &GSLocalMemory::WritePixel16;
-	m_psm[PSM_PSMCT16S].wp = &GSLocalMemory::WritePixel16S;
-	m_psm[PSM_PSMT8].wp = &GSLocalMemory::WritePixel8;
-	m_psm[PSM_PSMT4].wp = &GSLocalMemory::WritePixel4;
-	m_psm[PSM_PSMT8H].wp = &GSLocalMemory::WritePixel8H;
-	m_psm[PSM_PSMT4HL].wp = &GSLocalMemory::WritePixel4HL;
-	m_psm[PSM_PSMT4HH].wp = &GSLocalMemory::WritePixel4HH;
-	m_psm[PSM_PSMZ32].wp = &GSLocalMemory::WritePixel32Z;
-	m_psm[PSM_PSMZ24].wp = &GSLocalMemory::WritePixel24Z;
-	m_psm[PSM_PSMZ16].wp = &GSLocalMemory::WritePixel16Z;
-	m_psm[PSM_PSMZ16S].wp = &GSLocalMemory::WritePixel16SZ;
-
-	m_psm[PSM_PSMCT32].wpa = &GSLocalMemory::WritePixel32;
-	m_psm[PSM_PSMCT24].wpa = &GSLocalMemory::WritePixel24;
-	m_psm[PSM_PSMCT16].wpa = &GSLocalMemory::WritePixel16;
-	m_psm[PSM_PSMCT16S].wpa = &GSLocalMemory::WritePixel16;
-	m_psm[PSM_PSMT8].wpa = &GSLocalMemory::WritePixel8;
-	m_psm[PSM_PSMT4].wpa = &GSLocalMemory::WritePixel4;
-	m_psm[PSM_PSMT8H].wpa = &GSLocalMemory::WritePixel8H;
-	m_psm[PSM_PSMT4HL].wpa = &GSLocalMemory::WritePixel4HL;
-	m_psm[PSM_PSMT4HH].wpa = &GSLocalMemory::WritePixel4HH;
-	m_psm[PSM_PSMZ32].wpa = &GSLocalMemory::WritePixel32;
-	m_psm[PSM_PSMZ24].wpa = &GSLocalMemory::WritePixel24;
-	m_psm[PSM_PSMZ16].wpa = &GSLocalMemory::WritePixel16;
-	m_psm[PSM_PSMZ16S].wpa = &GSLocalMemory::WritePixel16;
-
-	m_psm[PSM_PSMCT24].rt = &GSLocalMemory::ReadTexel24;
-	m_psm[PSM_PSMCT16].rt = &GSLocalMemory::ReadTexel16;
-	m_psm[PSM_PSMCT16S].rt = &GSLocalMemory::ReadTexel16S;
-	m_psm[PSM_PSMT8].rt = &GSLocalMemory::ReadTexel8;
-	m_psm[PSM_PSMT4].rt = &GSLocalMemory::ReadTexel4;
-	m_psm[PSM_PSMT8H].rt = &GSLocalMemory::ReadTexel8H;
-	m_psm[PSM_PSMT4HL].rt = &GSLocalMemory::ReadTexel4HL;
-	m_psm[PSM_PSMT4HH].rt = &GSLocalMemory::ReadTexel4HH;
-	m_psm[PSM_PSMZ32].rt = &GSLocalMemory::ReadTexel32Z;
-	m_psm[PSM_PSMZ24].rt = &GSLocalMemory::ReadTexel24Z;
-	m_psm[PSM_PSMZ16].rt = &GSLocalMemory::ReadTexel16Z;
-	m_psm[PSM_PSMZ16S].rt = &GSLocalMemory::ReadTexel16SZ;
-
-	m_psm[PSM_PSMCT24].rta = &GSLocalMemory::ReadTexel24;
-	m_psm[PSM_PSMCT16].rta = &GSLocalMemory::ReadTexel16;
-	m_psm[PSM_PSMCT16S].rta = &GSLocalMemory::ReadTexel16;
-	m_psm[PSM_PSMT8].rta = &GSLocalMemory::ReadTexel8;
-	m_psm[PSM_PSMT4].rta = &GSLocalMemory::ReadTexel4;
-	m_psm[PSM_PSMT8H].rta = &GSLocalMemory::ReadTexel8H;
-	m_psm[PSM_PSMT4HL].rta = &GSLocalMemory::ReadTexel4HL;
-	m_psm[PSM_PSMT4HH].rta = &GSLocalMemory::ReadTexel4HH;
-	m_psm[PSM_PSMZ24].rta = &GSLocalMemory::ReadTexel24;
-	m_psm[PSM_PSMZ16].rta = &GSLocalMemory::ReadTexel16;
-	m_psm[PSM_PSMZ16S].rta = &GSLocalMemory::ReadTexel16;
-
-	m_psm[PSM_PSMCT24].wfa = &GSLocalMemory::WritePixel24;
-	m_psm[PSM_PSMCT16].wfa = &GSLocalMemory::WriteFrame16;
-	m_psm[PSM_PSMCT16S].wfa = &GSLocalMemory::WriteFrame16;
-	m_psm[PSM_PSMZ24].wfa = &GSLocalMemory::WritePixel24;
-	m_psm[PSM_PSMZ16].wfa = &GSLocalMemory::WriteFrame16;
-	m_psm[PSM_PSMZ16S].wfa = &GSLocalMemory::WriteFrame16;
-
-	m_psm[PSM_PSMCT24].wi = &GSLocalMemory::WriteImage24; // TODO
-	m_psm[PSM_PSMCT16].wi = &GSLocalMemory::WriteImage<PSM_PSMCT16, 16, 8, 16>;
-	m_psm[PSM_PSMCT16S].wi = &GSLocalMemory::WriteImage<PSM_PSMCT16S, 16, 8, 16>;
-	m_psm[PSM_PSMT8].wi = &GSLocalMemory::WriteImage<PSM_PSMT8, 16, 16, 8>;
-	m_psm[PSM_PSMT4].wi = &GSLocalMemory::WriteImage<PSM_PSMT4, 32, 16, 4>;
-	m_psm[PSM_PSMT8H].wi = &GSLocalMemory::WriteImage8H; // TODO
-	m_psm[PSM_PSMT4HL].wi = &GSLocalMemory::WriteImage4HL; // TODO
-	m_psm[PSM_PSMT4HH].wi = &GSLocalMemory::WriteImage4HH; // TODO
-	m_psm[PSM_PSMZ32].wi = &GSLocalMemory::WriteImage<PSM_PSMZ32, 8, 8, 32>;
-	m_psm[PSM_PSMZ24].wi = &GSLocalMemory::WriteImage24Z; // TODO
-	m_psm[PSM_PSMZ16].wi = &GSLocalMemory::WriteImage<PSM_PSMZ16, 16, 8, 16>;
-	m_psm[PSM_PSMZ16S].wi = &GSLocalMemory::WriteImage<PSM_PSMZ16S, 16, 8, 16>;
-
-	m_psm[PSM_PSMCT24].rtx = &GSLocalMemory::ReadTexture24;
-	m_psm[PSM_PSGPU24].rtx = &GSLocalMemory::ReadTextureGPU24;
-	m_psm[PSM_PSMCT16].rtx = &GSLocalMemory::ReadTexture16;
-	m_psm[PSM_PSMCT16S].rtx = &GSLocalMemory::ReadTexture16;
-	m_psm[PSM_PSMT8].rtx = &GSLocalMemory::ReadTexture8;
-	m_psm[PSM_PSMT4].rtx = &GSLocalMemory::ReadTexture4;
-	m_psm[PSM_PSMT8H].rtx = &GSLocalMemory::ReadTexture8H;
-	m_psm[PSM_PSMT4HL].rtx = &GSLocalMemory::ReadTexture4HL;
-	m_psm[PSM_PSMT4HH].rtx = &GSLocalMemory::ReadTexture4HH;
-	m_psm[PSM_PSMZ32].rtx = &GSLocalMemory::ReadTexture32;
-	m_psm[PSM_PSMZ24].rtx = &GSLocalMemory::ReadTexture24;
-	m_psm[PSM_PSMZ16].rtx = &GSLocalMemory::ReadTexture16;
-	m_psm[PSM_PSMZ16S].rtx = &GSLocalMemory::ReadTexture16;
-
-	m_psm[PSM_PSMCT24].rtxP = &GSLocalMemory::ReadTexture24;
-	m_psm[PSM_PSMCT16].rtxP = &GSLocalMemory::ReadTexture16;
-	m_psm[PSM_PSMCT16S].rtxP = &GSLocalMemory::ReadTexture16;
-	m_psm[PSM_PSMT8].rtxP = &GSLocalMemory::ReadTexture8P;
-	m_psm[PSM_PSMT4].rtxP = &GSLocalMemory::ReadTexture4P;
-	m_psm[PSM_PSMT8H].rtxP = &GSLocalMemory::ReadTexture8HP;
-	m_psm[PSM_PSMT4HL].rtxP = &GSLocalMemory::ReadTexture4HLP;
-	m_psm[PSM_PSMT4HH].rtxP = &GSLocalMemory::ReadTexture4HHP;
-	m_psm[PSM_PSMZ32].rtxP = &GSLocalMemory::ReadTexture32;
-	m_psm[PSM_PSMZ24].rtxP = &GSLocalMemory::ReadTexture24;
-	m_psm[PSM_PSMZ16].rtxP = &GSLocalMemory::ReadTexture16;
-	m_psm[PSM_PSMZ16S].rtxP = &GSLocalMemory::ReadTexture16;
-
-	m_psm[PSM_PSMCT24].rtxb = &GSLocalMemory::ReadTextureBlock24;
-	m_psm[PSM_PSMCT16].rtxb = &GSLocalMemory::ReadTextureBlock16;
-	m_psm[PSM_PSMCT16S].rtxb = &GSLocalMemory::ReadTextureBlock16;
-	m_psm[PSM_PSMT8].rtxb = &GSLocalMemory::ReadTextureBlock8;
-	m_psm[PSM_PSMT4].rtxb = &GSLocalMemory::ReadTextureBlock4;
-	m_psm[PSM_PSMT8H].rtxb = &GSLocalMemory::ReadTextureBlock8H;
-	m_psm[PSM_PSMT4HL].rtxb = &GSLocalMemory::ReadTextureBlock4HL;
-	m_psm[PSM_PSMT4HH].rtxb = &GSLocalMemory::ReadTextureBlock4HH;
-	m_psm[PSM_PSMZ32].rtxb = &GSLocalMemory::ReadTextureBlock32;
-	m_psm[PSM_PSMZ24].rtxb = &GSLocalMemory::ReadTextureBlock24;
-	m_psm[PSM_PSMZ16].rtxb = &GSLocalMemory::ReadTextureBlock16;
-	m_psm[PSM_PSMZ16S].rtxb = &GSLocalMemory::ReadTextureBlock16;
-
-	m_psm[PSM_PSMCT24].rtxbP = &GSLocalMemory::ReadTextureBlock24;
-	m_psm[PSM_PSMCT16].rtxbP = &GSLocalMemory::ReadTextureBlock16;
-	m_psm[PSM_PSMCT16S].rtxbP = &GSLocalMemory::ReadTextureBlock16;
-	m_psm[PSM_PSMT8].rtxbP = &GSLocalMemory::ReadTextureBlock8P;
-	m_psm[PSM_PSMT4].rtxbP = &GSLocalMemory::ReadTextureBlock4P;
-	m_psm[PSM_PSMT8H].rtxbP = &GSLocalMemory::ReadTextureBlock8HP;
-	m_psm[PSM_PSMT4HL].rtxbP = &GSLocalMemory::ReadTextureBlock4HLP;
-	m_psm[PSM_PSMT4HH].rtxbP = &GSLocalMemory::ReadTextureBlock4HHP;
-	m_psm[PSM_PSMZ32].rtxbP = &GSLocalMemory::ReadTextureBlock32;
-	m_psm[PSM_PSMZ24].rtxbP = &GSLocalMemory::ReadTextureBlock24;
-	m_psm[PSM_PSMZ16].rtxbP = &GSLocalMemory::ReadTextureBlock16;
-	m_psm[PSM_PSMZ16S].rtxbP = &GSLocalMemory::ReadTextureBlock16;
-
-	m_psm[PSM_PSGPU24].bpp = 16;
-	m_psm[PSM_PSMCT16].bpp = m_psm[PSM_PSMCT16S].bpp = 16;
-	m_psm[PSM_PSMT8].bpp = 8;
-	m_psm[PSM_PSMT4].bpp = 4;
-	m_psm[PSM_PSMZ16].bpp = m_psm[PSM_PSMZ16S].bpp = 16;
-
-	m_psm[PSM_PSMCT24].trbpp = 24;
-	m_psm[PSM_PSGPU24].trbpp = 16;
-	m_psm[PSM_PSMCT16].trbpp = m_psm[PSM_PSMCT16S].trbpp = 16;
-	m_psm[PSM_PSMT8].trbpp = m_psm[PSM_PSMT8H].trbpp = 8;
-	m_psm[PSM_PSMT4].trbpp = m_psm[PSM_PSMT4HL].trbpp = m_psm[PSM_PSMT4HH].trbpp = 4;
-	m_psm[PSM_PSMZ24].trbpp = 24;
-	m_psm[PSM_PSMZ16].trbpp = m_psm[PSM_PSMZ16S].trbpp = 16;
-
-	m_psm[PSM_PSMT8].pal = m_psm[PSM_PSMT8H].pal = 256;
-	m_psm[PSM_PSMT4].pal = m_psm[PSM_PSMT4HL].pal = m_psm[PSM_PSMT4HH].pal = 16;
-
-	for (size_t i = 0; i < countof(m_psm); i++)
-		m_psm[i].fmt = 3;
-	m_psm[PSM_PSMCT32].fmt = m_psm[PSM_PSMZ32].fmt = 0;
-	m_psm[PSM_PSMCT24].fmt = m_psm[PSM_PSMZ24].fmt = 1;
-	m_psm[PSM_PSMCT16].fmt = m_psm[PSM_PSMZ16].fmt = 2;
-	m_psm[PSM_PSMCT16S].fmt = m_psm[PSM_PSMZ16S].fmt = 2;
-
-
-	m_psm[PSM_PSGPU24].bs = GSVector2i(16, 8);
-	m_psm[PSM_PSMCT16].bs = m_psm[PSM_PSMCT16S].bs = GSVector2i(16, 8);
-	m_psm[PSM_PSMT8].bs = GSVector2i(16, 16);
-	m_psm[PSM_PSMT4].bs = GSVector2i(32, 16);
-	m_psm[PSM_PSMZ16].bs = m_psm[PSM_PSMZ16S].bs = GSVector2i(16, 8);
-
-	m_psm[PSM_PSGPU24].pgs = GSVector2i(64, 64);
-	m_psm[PSM_PSMCT16].pgs = m_psm[PSM_PSMCT16S].pgs = GSVector2i(64, 64);
-	m_psm[PSM_PSMT8].pgs = GSVector2i(128, 64);
-	m_psm[PSM_PSMT4].pgs = GSVector2i(128, 128);
-	m_psm[PSM_PSMZ16].pgs = m_psm[PSM_PSMZ16S].pgs = GSVector2i(64, 64);
-
-	m_psm[PSM_PSMCT24].msk = 0x3f;
-	m_psm[PSM_PSMZ24].msk = 0x3f;
-	m_psm[PSM_PSMT8H].msk = 0xc0;
-	m_psm[PSM_PSMT4HL].msk = 0x40;
-	m_psm[PSM_PSMT4HH].msk = 0x80;
-
-	m_psm[PSM_PSMZ32].depth  = 1;
-	m_psm[PSM_PSMZ24].depth  = 1;
-	m_psm[PSM_PSMZ16].depth  = 1;
-	m_psm[PSM_PSMZ16S].depth = 1;
+#else
+	SetupTransferFunctions<GS_CURRENT_ISA>();
+#endif
 }
 
 GSLocalMemory::~GSLocalMemory()
@@ -520,1028 +263,6 @@ std::vector<GSVector2i>* GSLocalMemory::GetPage2TileMap(const GIFRegTEX0& TEX0)
 	return p2t;
 }
 
-////////////////////
-
-template <int psm, int bsx, int bsy, int alignment>
-void GSLocalMemory::WriteImageColumn(int l, int r, int y, int h, const uint8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
-{
-	uint32 bp = BITBLTBUF.DBP;
-	uint32 bw = BITBLTBUF.DBW;
-
-	const int csy = bsy / 4;
-
-	for (int offset = srcpitch * csy; h >= csy; h -= csy, y += csy, src += offset)
-	{
-		for (int x = l; x < r; x += bsx)
-		{
-			switch (psm)
-			{
-				case PSM_PSMCT32: GSBlock::WriteColumn32<alignment, 0xffffffff>(y, BlockPtr32(x, y, bp, bw), &src[x * 4], srcpitch); break;
-				case PSM_PSMCT16: GSBlock::WriteColumn16<alignment>(y, BlockPtr16(x, y, bp, bw), &src[x * 2], srcpitch); break;
-				case PSM_PSMCT16S: GSBlock::WriteColumn16<alignment>(y, BlockPtr16S(x, y, bp, bw), &src[x * 2], srcpitch); break;
-				case PSM_PSMT8: GSBlock::WriteColumn8<alignment>(y, BlockPtr8(x, y, bp, bw), &src[x], srcpitch); break;
-				case PSM_PSMT4: GSBlock::WriteColumn4<alignment>(y, BlockPtr4(x, y, bp, bw), &src[x >> 1], srcpitch); break;
-				case PSM_PSMZ32: GSBlock::WriteColumn32<alignment, 0xffffffff>(y, BlockPtr32Z(x, y, bp, bw), &src[x * 4], srcpitch); break;
-				case PSM_PSMZ16: GSBlock::WriteColumn16<alignment>(y, BlockPtr16Z(x, y, bp, bw), &src[x * 2], srcpitch); break;
-				case PSM_PSMZ16S: GSBlock::WriteColumn16<alignment>(y, BlockPtr16SZ(x, y, bp, bw), &src[x * 2], srcpitch); break;
-				// TODO
-				default: __assume(0);
-			}
-		}
-	}
-}
-
-template <int psm, int bsx, int bsy, int alignment>
-void GSLocalMemory::WriteImageBlock(int l, int r, int y, int h, const uint8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
-{
-	uint32 bp = BITBLTBUF.DBP;
-	uint32 bw = BITBLTBUF.DBW;
-
-	for (int offset = srcpitch * bsy; h >= bsy; h -= bsy, y += bsy, src += offset)
-	{
-		for (int x = l; x < r; x += bsx)
-		{
-			switch (psm)
-			{
-				case PSM_PSMCT32: GSBlock::WriteBlock32<alignment, 0xffffffff>(BlockPtr32(x, y, bp, bw), &src[x * 4], srcpitch); break;
-				case PSM_PSMCT16: GSBlock::WriteBlock16<alignment>(BlockPtr16(x, y, bp, bw), &src[x * 2], srcpitch); break;
-				case PSM_PSMCT16S: GSBlock::WriteBlock16<alignment>(BlockPtr16S(x, y, bp, bw), &src[x * 2], srcpitch); break;
-				case PSM_PSMT8: GSBlock::WriteBlock8<alignment>(BlockPtr8(x, y, bp, bw), &src[x], srcpitch); break;
-				case PSM_PSMT4: GSBlock::WriteBlock4<alignment>(BlockPtr4(x, y, bp, bw), &src[x >> 1], srcpitch); break;
-				case PSM_PSMZ32: GSBlock::WriteBlock32<alignment, 0xffffffff>(BlockPtr32Z(x, y, bp, bw), &src[x * 4], srcpitch); break;
-				case PSM_PSMZ16: GSBlock::WriteBlock16<alignment>(BlockPtr16Z(x, y, bp, bw), &src[x * 2], srcpitch); break;
-				case PSM_PSMZ16S: GSBlock::WriteBlock16<alignment>(BlockPtr16SZ(x, y, bp, bw), &src[x * 2], srcpitch); break;
-				// TODO
-				default: __assume(0);
-			}
-		}
-	}
-}
-
-template <int psm, int bsx, int bsy>
-void GSLocalMemory::WriteImageLeftRight(int l, int r, int y, int h, const uint8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
-{
-	uint32 bp = BITBLTBUF.DBP;
-	uint32 bw = BITBLTBUF.DBW;
-
-	for (; h > 0; y++, h--, src += srcpitch)
-	{
-		for (int x = l; x < r; x++)
-		{
-			switch (psm)
-			{
-				case PSM_PSMCT32: WritePixel32(x, y, *(uint32*)&src[x * 4], bp, bw); break;
-				case PSM_PSMCT16: WritePixel16(x, y, *(uint16*)&src[x * 2], bp, bw); break;
-				case PSM_PSMCT16S: WritePixel16S(x, y, *(uint16*)&src[x * 2], bp, bw); break;
-				case PSM_PSMT8: WritePixel8(x, y, src[x], bp, bw); break;
-				case PSM_PSMT4: WritePixel4(x, y, src[x >> 1] >> ((x & 1) << 2), bp, bw); break;
-				case PSM_PSMZ32: WritePixel32Z(x, y, *(uint32*)&src[x * 4], bp, bw); break;
-				case PSM_PSMZ16: WritePixel16Z(x, y, *(uint16*)&src[x * 2], bp, bw); break;
-				case PSM_PSMZ16S: WritePixel16SZ(x, y, *(uint16*)&src[x * 2], bp, bw); break;
-				// TODO
-				default: __assume(0);
-			}
-		}
-	}
-}
-
-template <int psm, int bsx, int bsy, int trbpp>
-void GSLocalMemory::WriteImageTopBottom(int l, int r, int y, int h, const uint8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
-{
-	alignas(32) uint8 buff[64]; // merge buffer for one column
-
-	uint32 bp = BITBLTBUF.DBP;
-	uint32 bw = BITBLTBUF.DBW;
-
-	const int csy = bsy / 4;
-
-	// merge incomplete column
-
-	int y2 = y & (csy - 1);
-
-	if (y2 > 0)
-	{
-		int h2 = std::min(h, csy - y2);
-
-		for (int x = l; x < r; x += bsx)
-		{
-			uint8* dst = NULL;
-
-			switch (psm)
-			{
-				case PSM_PSMCT32: dst = BlockPtr32(x, y, bp, bw); break;
-				case PSM_PSMCT16: dst = BlockPtr16(x, y, bp, bw); break;
-				case PSM_PSMCT16S: dst = BlockPtr16S(x, y, bp, bw); break;
-				case PSM_PSMT8: dst = BlockPtr8(x, y, bp, bw); break;
-				case PSM_PSMT4: dst = BlockPtr4(x, y, bp, bw); break;
-				case PSM_PSMZ32: dst = BlockPtr32Z(x, y, bp, bw); break;
-				case PSM_PSMZ16: dst = BlockPtr16Z(x, y, bp, bw); break;
-				case PSM_PSMZ16S: dst = BlockPtr16SZ(x, y, bp, bw); break;
-				// TODO
-				default: __assume(0);
-			}
-
-			switch (psm)
-			{
-				case PSM_PSMCT32:
-				case PSM_PSMZ32:
-					GSBlock::ReadColumn32(y, dst, buff, 32);
-					memcpy(&buff[32], &src[x * 4], 32);
-					GSBlock::WriteColumn32<32, 0xffffffff>(y, dst, buff, 32);
-					break;
-				case PSM_PSMCT16:
-				case PSM_PSMCT16S:
-				case PSM_PSMZ16:
-				case PSM_PSMZ16S:
-					GSBlock::ReadColumn16(y, dst, buff, 32);
-					memcpy(&buff[32], &src[x * 2], 32);
-					GSBlock::WriteColumn16<32>(y, dst, buff, 32);
-					break;
-				case PSM_PSMT8:
-					GSBlock::ReadColumn8(y, dst, buff, 16);
-					for (int i = 0, j = y2; i < h2; i++, j++)
-						memcpy(&buff[j * 16], &src[i * srcpitch + x], 16);
-					GSBlock::WriteColumn8<32>(y, dst, buff, 16);
-					break;
-				case PSM_PSMT4:
-					GSBlock::ReadColumn4(y, dst, buff, 16);
-					for (int i = 0, j = y2; i < h2; i++, j++)
-						memcpy(&buff[j * 16], &src[i * srcpitch + (x >> 1)], 16);
-					GSBlock::WriteColumn4<32>(y, dst, buff, 16);
-					break;
-				// TODO
-				default:
-					__assume(0);
-			}
-		}
-
-		src += srcpitch * h2;
-		y += h2;
-		h -= h2;
-	}
-
-	// write whole columns
-
-	{
-		int h2 = h & ~(csy - 1);
-
-		if (h2 > 0)
-		{
-			size_t addr = (size_t)&src[l * trbpp >> 3];
-
-			if ((addr & 31) == 0 && (srcpitch & 31) == 0)
-			{
-				WriteImageColumn<psm, bsx, bsy, 32>(l, r, y, h2, src, srcpitch, BITBLTBUF);
-			}
-			else if ((addr & 15) == 0 && (srcpitch & 15) == 0)
-			{
-				WriteImageColumn<psm, bsx, bsy, 16>(l, r, y, h2, src, srcpitch, BITBLTBUF);
-			}
-			else
-			{
-				WriteImageColumn<psm, bsx, bsy, 0>(l, r, y, h2, src, srcpitch, BITBLTBUF);
-			}
-
-			src += srcpitch * h2;
-			y += h2;
-			h -= h2;
-		}
-	}
-
-	// merge incomplete column
-
-	if (h >= 1)
-	{
-		for (int x = l; x < r; x += bsx)
-		{
-			uint8* dst = NULL;
-
-			switch (psm)
-			{
-			case PSM_PSMCT32: dst = BlockPtr32(x, y, bp, bw); break;
-			case PSM_PSMCT16: dst = BlockPtr16(x, y, bp, bw); break;
-			case PSM_PSMCT16S: dst = BlockPtr16S(x, y, bp, bw); break;
-			case PSM_PSMT8: dst = BlockPtr8(x, y, bp, bw); break;
-			case PSM_PSMT4: dst = BlockPtr4(x, y, bp, bw); break;
-			case PSM_PSMZ32: dst = BlockPtr32Z(x, y, bp, bw); break;
-			case PSM_PSMZ16: dst = BlockPtr16Z(x, y, bp, bw); break;
-			case PSM_PSMZ16S: dst = BlockPtr16SZ(x, y, bp, bw); break;
-			// TODO
-			default: __assume(0);
-			}
-
-			switch (psm)
-			{
-				case PSM_PSMCT32:
-				case PSM_PSMZ32:
-					GSBlock::ReadColumn32(y, dst, buff, 32);
-					memcpy(&buff[0], &src[x * 4], 32);
-					GSBlock::WriteColumn32<32, 0xffffffff>(y, dst, buff, 32);
-					break;
-				case PSM_PSMCT16:
-				case PSM_PSMCT16S:
-				case PSM_PSMZ16:
-				case PSM_PSMZ16S:
-					GSBlock::ReadColumn16(y, dst, buff, 32);
-					memcpy(&buff[0], &src[x * 2], 32);
-					GSBlock::WriteColumn16<32>(y, dst, buff, 32);
-					break;
-				case PSM_PSMT8:
-					GSBlock::ReadColumn8(y, dst, buff, 16);
-					for (int i = 0; i < h; i++)
-						memcpy(&buff[i * 16], &src[i * srcpitch + x], 16);
-					GSBlock::WriteColumn8<32>(y, dst, buff, 16);
-					break;
-				case PSM_PSMT4:
-					GSBlock::ReadColumn4(y, dst, buff, 16);
-					for (int i = 0; i < h; i++)
-						memcpy(&buff[i * 16], &src[i * srcpitch + (x >> 1)], 16);
-					GSBlock::WriteColumn4<32>(y, dst, buff, 16);
-					break;
-				// TODO
-				default:
-					__assume(0);
-			}
-		}
-	}
-}
-
-template <int psm, int bsx, int bsy, int trbpp>
-void GSLocalMemory::WriteImage(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
-{
-	if (TRXREG.RRW == 0)
-		return;
-
-	int l = (int)TRXPOS.DSAX;
-	int r = l + (int)TRXREG.RRW;
-
-	// finish the incomplete row first
-
-	if (tx != l)
-	{
-		int n = std::min(len, (r - tx) * trbpp >> 3);
-		WriteImageX(tx, ty, src, n, BITBLTBUF, TRXPOS, TRXREG);
-		src += n;
-		len -= n;
-	}
-
-	int la = (l + (bsx - 1)) & ~(bsx - 1);
-	int ra = r & ~(bsx - 1);
-	int srcpitch = (r - l) * trbpp >> 3;
-	int h = len / srcpitch;
-
-	if (ra - la >= bsx && h > 0) // "transfer width" >= "block width" && there is at least one full row
-	{
-		const uint8* s = &src[-l * trbpp >> 3];
-
-		src += srcpitch * h;
-		len -= srcpitch * h;
-
-		// left part
-
-		if (l < la)
-		{
-			WriteImageLeftRight<psm, bsx, bsy>(l, la, ty, h, s, srcpitch, BITBLTBUF);
-		}
-
-		// right part
-
-		if (ra < r)
-		{
-			WriteImageLeftRight<psm, bsx, bsy>(ra, r, ty, h, s, srcpitch, BITBLTBUF);
-		}
-
-		// horizontally aligned part
-
-		if (la < ra)
-		{
-			// top part
-
-			{
-				int h2 = std::min(h, bsy - (ty & (bsy - 1)));
-
-				if (h2 < bsy)
-				{
-					WriteImageTopBottom<psm, bsx, bsy, trbpp>(la, ra, ty, h2, s, srcpitch, BITBLTBUF);
-
-					s += srcpitch * h2;
-					ty += h2;
-					h -= h2;
-				}
-			}
-
-			// horizontally and vertically aligned part
-
-			{
-				int h2 = h & ~(bsy - 1);
-
-				if (h2 > 0)
-				{
-					size_t addr = (size_t)&s[la * trbpp >> 3];
-
-					if ((addr & 31) == 0 && (srcpitch & 31) == 0)
-					{
-						WriteImageBlock<psm, bsx, bsy, 32>(la, ra, ty, h2, s, srcpitch, BITBLTBUF);
-					}
-					else if ((addr & 15) == 0 && (srcpitch & 15) == 0)
-					{
-						WriteImageBlock<psm, bsx, bsy, 16>(la, ra, ty, h2, s, srcpitch, BITBLTBUF);
-					}
-					else
-					{
-						WriteImageBlock<psm, bsx, bsy, 0>(la, ra, ty, h2, s, srcpitch, BITBLTBUF);
-					}
-
-					s += srcpitch * h2;
-					ty += h2;
-					h -= h2;
-				}
-			}
-
-			// bottom part
-
-			if (h > 0)
-			{
-				WriteImageTopBottom<psm, bsx, bsy, trbpp>(la, ra, ty, h, s, srcpitch, BITBLTBUF);
-
-				// s += srcpitch * h;
-				ty += h;
-				// h -= h;
-			}
-		}
-	}
-
-	// the rest
-
-	if (len > 0)
-	{
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
-	}
-}
-
-
-static bool IsTopLeftAligned(int dsax, int tx, int ty, int bw, int bh)
-{
-	return ((dsax & (bw - 1)) == 0 && (tx & (bw - 1)) == 0 && dsax == tx && (ty & (bh - 1)) == 0);
-}
-
-void GSLocalMemory::WriteImage24(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
-{
-	if (TRXREG.RRW == 0)
-		return;
-
-	uint32 bp = BITBLTBUF.DBP;
-	uint32 bw = BITBLTBUF.DBW;
-
-	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW * 3;
-	int th = len / srcpitch;
-
-	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
-
-	if (!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
-	{
-		// TODO
-
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
-	}
-	else
-	{
-		th += ty;
-
-		for (int y = ty; y < th; y += 8, src += srcpitch * 8)
-		{
-			for (int x = tx; x < tw; x += 8)
-			{
-				GSBlock::UnpackAndWriteBlock24(src + (x - tx) * 3, srcpitch, BlockPtr32(x, y, bp, bw));
-			}
-		}
-
-		ty = th;
-	}
-}
-
-void GSLocalMemory::WriteImage8H(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
-{
-	if (TRXREG.RRW == 0)
-		return;
-
-	uint32 bp = BITBLTBUF.DBP;
-	uint32 bw = BITBLTBUF.DBW;
-
-	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW;
-	int th = len / srcpitch;
-
-	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
-
-	if (!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
-	{
-		// TODO
-
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
-	}
-	else
-	{
-		th += ty;
-
-		for (int y = ty; y < th; y += 8, src += srcpitch * 8)
-		{
-			for (int x = tx; x < tw; x += 8)
-			{
-				GSBlock::UnpackAndWriteBlock8H(src + (x - tx), srcpitch, BlockPtr32(x, y, bp, bw));
-			}
-		}
-
-		ty = th;
-	}
-}
-
-void GSLocalMemory::WriteImage4HL(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
-{
-	if (TRXREG.RRW == 0)
-		return;
-
-	uint32 bp = BITBLTBUF.DBP;
-	uint32 bw = BITBLTBUF.DBW;
-
-	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW / 2;
-	int th = len / srcpitch;
-
-	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
-
-	if (!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
-	{
-		// TODO
-
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
-	}
-	else
-	{
-		th += ty;
-
-		for (int y = ty; y < th; y += 8, src += srcpitch * 8)
-		{
-			for (int x = tx; x < tw; x += 8)
-			{
-				GSBlock::UnpackAndWriteBlock4HL(src + (x - tx) / 2, srcpitch, BlockPtr32(x, y, bp, bw));
-			}
-		}
-
-		ty = th;
-	}
-}
-
-void GSLocalMemory::WriteImage4HH(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
-{
-	if (TRXREG.RRW == 0)
-		return;
-
-	uint32 bp = BITBLTBUF.DBP;
-	uint32 bw = BITBLTBUF.DBW;
-
-	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW / 2;
-	int th = len / srcpitch;
-
-	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
-
-	if (!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
-	{
-		// TODO
-
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
-	}
-	else
-	{
-		th += ty;
-
-		for (int y = ty; y < th; y += 8, src += srcpitch * 8)
-		{
-			for (int x = tx; x < tw; x += 8)
-			{
-				GSBlock::UnpackAndWriteBlock4HH(src + (x - tx) / 2, srcpitch, BlockPtr32(x, y, bp, bw));
-			}
-		}
-
-		ty = th;
-	}
-}
-
-void GSLocalMemory::WriteImage24Z(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
-{
-	if (TRXREG.RRW == 0)
-		return;
-
-	uint32 bp = BITBLTBUF.DBP;
-	uint32 bw = BITBLTBUF.DBW;
-
-	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW * 3;
-	int th = len / srcpitch;
-
-	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
-
-	if (!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
-	{
-		// TODO
-
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
-	}
-	else
-	{
-		th += ty;
-
-		for (int y = ty; y < th; y += 8, src += srcpitch * 8)
-		{
-			for (int x = tx; x < tw; x += 8)
-			{
-				GSBlock::UnpackAndWriteBlock24(src + (x - tx) * 3, srcpitch, BlockPtr32Z(x, y, bp, bw));
-			}
-		}
-
-		ty = th;
-	}
-}
-
-/// Helper for WriteImageX and ReadImageX
-/// `len` is in pixels, unlike WriteImageX/ReadImageX where it's bytes
-/// `xinc` is the amount to increment `x` by per iteration
-/// Calls `paGetter` on a starting (x, y) to get some sort of pixel address helper for each line,
-///  then `fn` on the helper and an x offset once for every `xinc` pixels along that line
-template <typename PAGetter, typename Fn>
-static void readWriteHelperImpl(int& tx, int& ty, int len, int xinc, int sx, int w, PAGetter&& paGetter, Fn&& fn)
-{
-	int y = ty;
-	int ex = sx + w;
-	int remX = ex - tx;
-
-	ASSERT(remX >= 0);
-
-	auto pa = paGetter(tx, y);
-
-	while (len > 0)
-	{
-		int stop = std::min(remX, len);
-		len -= stop;
-		remX -= stop;
-
-		for (int x = 0; x < stop; x += xinc)
-			fn(pa, x);
-
-		if (remX == 0)
-		{
-			y++;
-			remX = w;
-			pa = paGetter(sx, y);
-		}
-	}
-
-	tx = ex - remX;
-	ty = y;
-}
-
-/// Helper for WriteImageX and ReadImageX
-/// `len` is in pixels, unlike WriteImageX/ReadImageX where it's bytes
-/// `xinc` is the amount to increment `x` by per iteration
-/// Calls `fn` with a `PAHelper` representing the current line and an int representing the x offset in that line
-template <typename Fn>
-static void readWriteHelper(int& tx, int& ty, int len, int xinc, int sx, int w, const GSOffset& off, Fn&& fn)
-{
-	readWriteHelperImpl(tx, ty, len, xinc, sx, w, [&](int x, int y){ return off.paMulti(x, y); }, std::forward<Fn>(fn));
-}
-
-/// Helper for WriteImageX and ReadImageX
-/// `len` is in pixels, unlike WriteImageX/ReadImageX where it's bytes
-/// `xinc` is the amount to increment `x` by per iteration
-/// Calls `fn` with a `PAPtrHelper` representing the current line and an int representing the x offset in that line
-template <typename VM, typename Fn>
-static void readWriteHelper(VM* vm, int& tx, int& ty, int len, int xinc, int sx, int w, const GSOffset& off, Fn&& fn)
-{
-	readWriteHelperImpl(tx, ty, len, xinc, sx, w, [&](int x, int y){ return off.paMulti(vm, x, y); }, std::forward<Fn>(fn));
-}
-
-void GSLocalMemory::WriteImageX(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
-{
-	if (len <= 0)
-		return;
-
-	const uint8* pb = (uint8*)src;
-	const uint16* pw = (uint16*)src;
-	const uint32* pd = (uint32*)src;
-
-	uint32 bp = BITBLTBUF.DBP;
-	uint32 bw = BITBLTBUF.DBW;
-
-	int sx = TRXPOS.DSAX;
-	int w = TRXREG.RRW;
-
-	GSOffset off = GetOffset(bp, bw, BITBLTBUF.DPSM);
-
-	switch (BITBLTBUF.DPSM)
-	{
-		case PSM_PSMCT32:
-		case PSM_PSMZ32:
-			readWriteHelper(m_vm32, tx, ty, len / 4, 1, sx, w, off.assertSizesMatch(swizzle32), [&](auto& pa, int x)
-			{
-				*pa.value(x) = *pd;
-				pd++;
-			});
-			break;
-
-		case PSM_PSMCT24:
-		case PSM_PSMZ24:
-			readWriteHelper(m_vm32, tx, ty, len / 3, 1, sx, w, off.assertSizesMatch(swizzle32), [&](auto& pa, int x)
-			{
-				WritePixel24(pa.value(x), *(uint32*)pb);
-				pb += 3;
-			});
-			break;
-
-		case PSM_PSMCT16:
-		case PSM_PSMCT16S:
-		case PSM_PSMZ16:
-		case PSM_PSMZ16S:
-			readWriteHelper(m_vm16, tx, ty, len / 2, 1, sx, w, off.assertSizesMatch(swizzle16), [&](auto& pa, int x)
-			{
-				*pa.value(x) = *pw;
-				pw++;
-			});
-			break;
-
-		case PSM_PSMT8:
-			readWriteHelper(m_vm8, tx, ty, len, 1, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT8), [&](auto& pa, int x)
-			{
-				*pa.value(x) = *pb;
-				pb++;
-			});
-			break;
-
-		case PSM_PSMT4:
-			readWriteHelper(tx, ty, len * 2, 2, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT4), [&](GSOffset::PAHelper& pa, int x)
-			{
-				WritePixel4(pa.value(x), *pb & 0xf);
-				WritePixel4(pa.value(x + 1), *pb >> 4);
-				pb++;
-			});
-			break;
-
-		case PSM_PSMT8H:
-			readWriteHelper(m_vm32, tx, ty, len, 1, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT8H), [&](auto& pa, int x)
-			{
-				WritePixel8H(pa.value(x), *pb);
-				pb++;
-			});
-			break;
-
-		case PSM_PSMT4HL:
-			readWriteHelper(m_vm32, tx, ty, len * 2, 2, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT4HL), [&](auto& pa, int x)
-			{
-				WritePixel4HL(pa.value(x), *pb & 0xf);
-				WritePixel4HL(pa.value(x + 1), *pb >> 4);
-				pb++;
-			});
-			break;
-
-		case PSM_PSMT4HH:
-			readWriteHelper(m_vm32, tx, ty, len * 2, 2, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT4HH), [&](auto& pa, int x)
-			{
-				WritePixel4HH(pa.value(x), *pb & 0xf);
-				WritePixel4HH(pa.value(x + 1), *pb >> 4);
-				pb++;
-			});
-			break;
-	}
-}
-
-//
-
-void GSLocalMemory::ReadImageX(int& tx, int& ty, uint8* dst, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG) const
-{
-	if (len <= 0)
-		return;
-
-	uint8* RESTRICT pb = (uint8*)dst;
-	uint16* RESTRICT pw = (uint16*)dst;
-	uint32* RESTRICT pd = (uint32*)dst;
-
-	uint32 bp = BITBLTBUF.SBP;
-	uint32 bw = BITBLTBUF.SBW;
-
-	int sx = TRXPOS.SSAX;
-	int w = TRXREG.RRW;
-
-	GSOffset off = GetOffset(bp, bw, BITBLTBUF.SPSM);
-
-	// printf("spsm=%d x=%d ex=%d y=%d len=%d\n", BITBLTBUF.SPSM, x, ex, y, len);
-
-	switch (BITBLTBUF.SPSM)
-	{
-		case PSM_PSMCT32:
-		case PSM_PSMZ32:
-		{
-			// MGS1 intro, fade effect between two scenes (airplane outside-inside transition)
-
-			int x = tx;
-			int y = ty;
-			int ex = sx + w;
-
-			len /= 4;
-
-			GSOffset::PAPtrHelper pa = off.assertSizesMatch(swizzle32).paMulti(m_vm32, 0, y);
-
-			while (len > 0)
-			{
-				for (; len > 0 && x < ex && (x & 7); len--, x++, pd++)
-				{
-					*pd = *pa.value(x);
-				}
-
-				// aligned to a column
-
-				for (int ex8 = ex - 8; len >= 8 && x <= ex8; len -= 8, x += 8, pd += 8)
-				{
-					uint32* ps = pa.value(x);
-
-					GSVector4i::store<false>(&pd[0], GSVector4i::load(ps + 0, ps + 4));
-					GSVector4i::store<false>(&pd[4], GSVector4i::load(ps + 8, ps + 12));
-
-					for (int i = 0; i < 8; i++)
-						ASSERT(pd[i] == *pa.value(x + i));
-				}
-
-				for (; len > 0 && x < ex; len--, x++, pd++)
-				{
-					*pd = *pa.value(x);
-				}
-
-				if (x == ex)
-				{
-					y++;
-					x = sx;
-					pa = off.assertSizesMatch(swizzle32).paMulti(m_vm32, 0, y);
-				}
-			}
-
-			tx = x;
-			ty = y;
-		}
-		break;
-
-		case PSM_PSMCT24:
-		case PSM_PSMZ24:
-			readWriteHelper(m_vm32, tx, ty, len / 3, 1, sx, w, off.assertSizesMatch(swizzle32), [&](auto& pa, int x)
-			{
-				uint32 c = *pa.value(x);
-				pb[0] = (uint8)(c);
-				pb[1] = (uint8)(c >> 8);
-				pb[2] = (uint8)(c >> 16);
-				pb += 3;
-			});
-			break;
-
-		case PSM_PSMCT16:
-		case PSM_PSMCT16S:
-		case PSM_PSMZ16:
-		case PSM_PSMZ16S:
-			readWriteHelper(m_vm16, tx, ty, len / 2, 1, sx, w, off.assertSizesMatch(swizzle16), [&](auto& pa, int x)
-			{
-				*pw = *pa.value(x);
-				pw++;
-			});
-			break;
-
-		case PSM_PSMT8:
-			readWriteHelper(m_vm8, tx, ty, len, 1, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT8), [&](auto& pa, int x)
-			{
-				*pb = *pa.value(x);
-				pb++;
-			});
-			break;
-
-		case PSM_PSMT4:
-			readWriteHelper(tx, ty, len * 2, 2, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT4), [&](GSOffset::PAHelper& pa, int x)
-			{
-				uint8 low = ReadPixel4(pa.value(x));
-				uint8 high = ReadPixel4(pa.value(x + 1));
-				*pb = low | (high << 4);
-			});
-			break;
-
-		case PSM_PSMT8H:
-			readWriteHelper(m_vm32, tx, ty, len, 1, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT8H), [&](auto& pa, int x)
-			{
-				*pb = (uint8)(*pa.value(x) >> 24);
-				pb++;
-			});
-			break;
-
-		case PSM_PSMT4HL:
-			readWriteHelper(m_vm32, tx, ty, len * 2, 2, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT4HL), [&](auto& pa, int x)
-			{
-				uint32 c0 = *pa.value(x) >> 24 & 0x0f;
-				uint32 c1 = *pa.value(x + 1) >> 20 & 0xf0;
-				*pb = (uint8)(c0 | c1);
-				pb++;
-			});
-			break;
-
-		case PSM_PSMT4HH:
-			readWriteHelper(m_vm32, tx, ty, len * 2, 2, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT4HH), [&](auto& pa, int x)
-			{
-				uint32 c0 = *pa.value(x) >> 28 & 0x0f;
-				uint32 c1 = *pa.value(x + 1) >> 24 & 0xf0;
-				*pb = (uint8)(c0 | c1);
-				pb++;
-			});
-			break;
-	}
-}
-
-///////////////////
-
-void GSLocalMemory::ReadTexture32(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
-	{
-		GSBlock::ReadBlock32(src, read_dst, dstpitch);
-	});
-}
-
-void GSLocalMemory::ReadTexture24(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	if (TEXA.AEM)
-	{
-		foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
-		{
-			GSBlock::ReadAndExpandBlock24<true>(src, read_dst, dstpitch, TEXA);
-		});
-	}
-	else
-	{
-		foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
-		{
-			GSBlock::ReadAndExpandBlock24<false>(src, read_dst, dstpitch, TEXA);
-		});
-	}
-}
-
-void GSLocalMemory::ReadTextureGPU24(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	foreachBlock(off.assertSizesMatch(swizzle16), this, r, dst, dstpitch, 16, [&](uint8* read_dst, const uint8* src)
-	{
-		GSBlock::ReadBlock16(src, read_dst, dstpitch);
-	});
-
-	// Convert packed RGB scanline to 32 bits RGBA
-	ASSERT(dstpitch >= r.width() * 4);
-	for (int y = r.top; y < r.bottom; y++)
-	{
-		uint8* line = dst + y * dstpitch;
-
-		for (int x = r.right; x >= r.left; x--)
-		{
-			*(uint32*)&line[x * 4] = *(uint32*)&line[x * 3] & 0xFFFFFF;
-		}
-	}
-}
-
-void GSLocalMemory::ReadTexture16(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	if (TEXA.AEM)
-	{
-		foreachBlock(off.assertSizesMatch(swizzle16), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
-		{
-			GSBlock::ReadAndExpandBlock16<true>(src, read_dst, dstpitch, TEXA);
-		});
-	}
-	else
-	{
-		foreachBlock(off.assertSizesMatch(swizzle16), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
-		{
-			GSBlock::ReadAndExpandBlock16<false>(src, read_dst, dstpitch, TEXA);
-		});
-	}
-}
-
-void GSLocalMemory::ReadTexture8(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	const uint32* pal = m_clut;
-
-	foreachBlock(off.assertSizesMatch(swizzle8), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
-	{
-		GSBlock::ReadAndExpandBlock8_32(src, read_dst, dstpitch, pal);
-	});
-}
-
-void GSLocalMemory::ReadTexture4(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	const uint64* pal = m_clut;
-
-	foreachBlock(off.assertSizesMatch(swizzle4), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
-	{
-		GSBlock::ReadAndExpandBlock4_32(src, read_dst, dstpitch, pal);
-	});
-}
-
-void GSLocalMemory::ReadTexture8H(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	const uint32* pal = m_clut;
-
-	foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
-	{
-		GSBlock::ReadAndExpandBlock8H_32(src, read_dst, dstpitch, pal);
-	});
-}
-
-void GSLocalMemory::ReadTexture4HL(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	const uint32* pal = m_clut;
-
-	foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
-	{
-		GSBlock::ReadAndExpandBlock4HL_32(src, read_dst, dstpitch, pal);
-	});
-}
-
-void GSLocalMemory::ReadTexture4HH(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	const uint32* pal = m_clut;
-
-	foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
-	{
-		GSBlock::ReadAndExpandBlock4HH_32(src, read_dst, dstpitch, pal);
-	});
-}
-
-///////////////////
-
-void GSLocalMemory::ReadTextureBlock32(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadBlock32(BlockPtr(bp), dst, dstpitch);
-}
-
-void GSLocalMemory::ReadTextureBlock24(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	if (TEXA.AEM)
-	{
-		GSBlock::ReadAndExpandBlock24<true>(BlockPtr(bp), dst, dstpitch, TEXA);
-	}
-	else
-	{
-		GSBlock::ReadAndExpandBlock24<false>(BlockPtr(bp), dst, dstpitch, TEXA);
-	}
-}
-
-void GSLocalMemory::ReadTextureBlock16(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	if (TEXA.AEM)
-	{
-		GSBlock::ReadAndExpandBlock16<true>(BlockPtr(bp), dst, dstpitch, TEXA);
-	}
-	else
-	{
-		GSBlock::ReadAndExpandBlock16<false>(BlockPtr(bp), dst, dstpitch, TEXA);
-	}
-}
-
-void GSLocalMemory::ReadTextureBlock8(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadAndExpandBlock8_32(BlockPtr(bp), dst, dstpitch, m_clut);
-}
-
-void GSLocalMemory::ReadTextureBlock4(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadAndExpandBlock4_32(BlockPtr(bp), dst, dstpitch, m_clut);
-}
-
-void GSLocalMemory::ReadTextureBlock8H(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadAndExpandBlock8H_32(BlockPtr(bp), dst, dstpitch, m_clut);
-}
-
-void GSLocalMemory::ReadTextureBlock4HL(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadAndExpandBlock4HL_32(BlockPtr(bp), dst, dstpitch, m_clut);
-}
-
-void GSLocalMemory::ReadTextureBlock4HH(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadAndExpandBlock4HH_32(BlockPtr(bp), dst, dstpitch, m_clut);
-}
-
 ///////////////////
 
 void GSLocalMemory::ReadTexture(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
@@ -1621,83 +342,6 @@ void GSLocalMemory::ReadTexture(const GSOffset& off, const GSVector4i& r, uint8*
 	}
 }
 
-// 32/8
-
-void GSLocalMemory::ReadTexture8P(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	foreachBlock(off.assertSizesMatch(swizzle8), this, r, dst, dstpitch, 8, [&](uint8* read_dst, const uint8* src)
-	{
-		GSBlock::ReadBlock8(src, read_dst, dstpitch);
-	});
-}
-
-void GSLocalMemory::ReadTexture4P(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	foreachBlock(off.assertSizesMatch(swizzle4), this, r, dst, dstpitch, 8, [&](uint8* read_dst, const uint8* src)
-	{
-		GSBlock::ReadBlock4P(src, read_dst, dstpitch);
-	});
-}
-
-void GSLocalMemory::ReadTexture8HP(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 8, [&](uint8* read_dst, const uint8* src)
-	{
-		GSBlock::ReadBlock8HP(src, read_dst, dstpitch);
-	});
-}
-
-void GSLocalMemory::ReadTexture4HLP(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 8, [&](uint8* read_dst, const uint8* src)
-	{
-		GSBlock::ReadBlock4HLP(src, read_dst, dstpitch);
-	});
-}
-
-void GSLocalMemory::ReadTexture4HHP(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 8, [&](uint8* read_dst, const uint8* src)
-	{
-		GSBlock::ReadBlock4HHP(src, read_dst, dstpitch);
-	});
-}
-
-//
-
-void GSLocalMemory::ReadTextureBlock8P(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	GSBlock::ReadBlock8(BlockPtr(bp), dst, dstpitch);
-}
-
-void GSLocalMemory::ReadTextureBlock4P(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadBlock4P(BlockPtr(bp), dst, dstpitch);
-}
-
-void GSLocalMemory::ReadTextureBlock8HP(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadBlock8HP(BlockPtr(bp), dst, dstpitch);
-}
-
-void GSLocalMemory::ReadTextureBlock4HLP(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadBlock4HLP(BlockPtr(bp), dst, dstpitch);
-}
-
-void GSLocalMemory::ReadTextureBlock4HHP(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadBlock4HHP(BlockPtr(bp), dst, dstpitch);
-}
-
 //
 
 #include "Renderers/SW/GSTextureSW.h"
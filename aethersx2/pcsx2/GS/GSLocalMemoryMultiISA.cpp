@@ -0,0 +1,965 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "GSLocalMemory.h"
+
+// Swizzled image transfer and texture unpacking kernels.
+//
+// With GS_MULTI_ISA this file is compiled once for every GSVectorISA level (see pcsx2/CMakeLists.txt). Each object only
+// instantiates the kernels for its own GS_CURRENT_ISA, its helpers are static and GSBlock lives in GS_ISA_NAMESPACE, so
+// they don't share any symbol, and the GSLocalMemory constructor fills the psm table from the best one the host supports.
+
+template <typename Fn>
+static void foreachBlock(const GSOffset& off, GSLocalMemory* mem, const GSVector4i& r, uint8* dst, int dstpitch, int bpp, Fn&& fn)
+{
+	ASSERT(off.isBlockAligned(r));
+	GSOffset::BNHelper bn = off.bnMulti(r.left, r.top);
+	int right = r.right >> off.blockShiftX();
+	int bottom = r.bottom >> off.blockShiftY();
+
+	int offset = dstpitch << off.blockShiftY();
+	int xAdd = (1 << off.blockShiftX()) * (bpp / 8);
+
+	for (; bn.blkY() < bottom; bn.nextBlockY(), dst += offset)
+	{
+		for (int x = 0; bn.blkX() < right; bn.nextBlockX(), x += xAdd)
+		{
+			const uint8* src = mem->BlockPtr(bn.value());
+			uint8* read_dst = dst + x;
+			fn(read_dst, src);
+		}
+	}
+}
+
+////////////////////
+
+template <GSVectorISA isa, int psm, int bsx, int bsy, int alignment>
+void GSLocalMemory::WriteImageColumn(int l, int r, int y, int h, const uint8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
+{
+	uint32 bp = BITBLTBUF.DBP;
+	uint32 bw = BITBLTBUF.DBW;
+
+	const int csy = bsy / 4;
+
+	for (int offset = srcpitch * csy; h >= csy; h -= csy, y += csy, src += offset)
+	{
+		for (int x = l; x < r; x += bsx)
+		{
+			switch (psm)
+			{
+				case PSM_PSMCT32: GSBlock::WriteColumn32<alignment, 0xffffffff>(y, BlockPtr32(x, y, bp, bw), &src[x * 4], srcpitch); break;
+				case PSM_PSMCT16: GSBlock::WriteColumn16<alignment>(y, BlockPtr16(x, y, bp, bw), &src[x * 2], srcpitch); break;
+				case PSM_PSMCT16S: GSBlock::WriteColumn16<alignment>(y, BlockPtr16S(x, y, bp, bw), &src[x * 2], srcpitch); break;
+				case PSM_PSMT8: GSBlock::WriteColumn8<alignment>(y, BlockPtr8(x, y, bp, bw), &src[x], srcpitch); break;
+				case PSM_PSMT4: GSBlock::WriteColumn4<alignment>(y, BlockPtr4(x, y, bp, bw), &src[x >> 1], srcpitch); break;
+				case PSM_PSMZ32: GSBlock::WriteColumn32<alignment, 0xffffffff>(y, BlockPtr32Z(x, y, bp, bw), &src[x * 4], srcpitch); break;
+				case PSM_PSMZ16: GSBlock::WriteColumn16<alignment>(y, BlockPtr16Z(x, y, bp, bw), &src[x * 2], srcpitch); break;
+				case PSM_PSMZ16S: GSBlock::WriteColumn16<alignment>(y, BlockPtr16SZ(x, y, bp, bw), &src[x * 2], srcpitch); break;
+				// TODO
+				default: __assume(0);
+			}
+		}
+	}
+}
+
+template <GSVectorISA isa, int psm, int bsx, int bsy, int alignment>
+void GSLocalMemory::WriteImageBlock(int l, int r, int y, int h, const uint8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
+{
+	uint32 bp = BITBLTBUF.DBP;
+	uint32 bw = BITBLTBUF.DBW;
+
+	for (int offset = srcpitch * bsy; h >= bsy; h -= bsy, y += bsy, src += offset)
+	{
+		for (int x = l; x < r; x += bsx)
+		{
+			switch (psm)
+			{
+				case PSM_PSMCT32: GSBlock::WriteBlock32<alignment, 0xffffffff>(BlockPtr32(x, y, bp, bw), &src[x * 4], srcpitch); break;
+				case PSM_PSMCT16: GSBlock::WriteBlock16<alignment>(BlockPtr16(x, y, bp, bw), &src[x * 2], srcpitch); break;
+				case PSM_PSMCT16S: GSBlock::WriteBlock16<alignment>(BlockPtr16S(x, y, bp, bw), &src[x * 2], srcpitch); break;
+				case PSM_PSMT8: GSBlock::WriteBlock8<alignment>(BlockPtr8(x, y, bp, bw), &src[x], srcpitch); break;
+				case PSM_PSMT4: GSBlock::WriteBlock4<alignment>(BlockPtr4(x, y, bp, bw), &src[x >> 1], srcpitch); break;
+				case PSM_PSMZ32: GSBlock::WriteBlock32<alignment, 0xffffffff>(BlockPtr32Z(x, y, bp, bw), &src[x * 4], srcpitch); break;
+				case PSM_PSMZ16: GSBlock::WriteBlock16<alignment>(BlockPtr16Z(x, y, bp, bw), &src[x * 2], srcpitch); break;
+				case PSM_PSMZ16S: GSBlock::WriteBlock16<alignment>(BlockPtr16SZ(x, y, bp, bw), &src[x * 2], srcpitch); break;
+				// TODO
+				default: __assume(0);
+			}
+		}
+	}
+}
+
+template <GSVectorISA isa, int psm, int bsx, int bsy>
+void GSLocalMemory::WriteImageLeftRight(int l, int r, int y, int h, const uint8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
+{
+	uint32 bp = BITBLTBUF.DBP;
+	uint32 bw = BITBLTBUF.DBW;
+
+	for (; h > 0; y++, h--, src += srcpitch)
+	{
+		for (int x = l; x < r; x++)
+		{
+			switch (psm)
+			{
+				case PSM_PSMCT32: WritePixel32(x, y, *(uint32*)&src[x * 4], bp, bw); break;
+				case PSM_PSMCT16: WritePixel16(x, y, *(uint16*)&src[x * 2], bp, bw); break;
+				case PSM_PSMCT16S: WritePixel16S(x, y, *(uint16*)&src[x * 2], bp, bw); break;
+				case PSM_PSMT8: WritePixel8(x, y, src[x], bp, bw); break;
+				case PSM_PSMT4: WritePixel4(x, y, src[x >> 1] >> ((x & 1) << 2), bp, bw); break;
+				case PSM_PSMZ32: WritePixel32Z(x, y, *(uint32*)&src[x * 4], bp, bw); break;
+				case PSM_PSMZ16: WritePixel16Z(x, y, *(uint16*)&src[x * 2], bp, bw); break;
+				case PSM_PSMZ16S: WritePixel16SZ(x, y, *(uint16*)&src[x * 2], bp, bw); break;
+				// TODO
+				default: __assume(0);
+			}
+		}
+	}
+}
+
+template <GSVectorISA isa, int psm, int bsx, int bsy, int trbpp>
+void GSLocalMemory::WriteImageTopBottom(int l, int r, int y, int h, const uint8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
+{
+	alignas(32) uint8 buff[64]; // merge buffer for one column
+
+	uint32 bp = BITBLTBUF.DBP;
+	uint32 bw = BITBLTBUF.DBW;
+
+	const int csy = bsy / 4;
+
+	// merge incomplete column
+
+	int y2 = y & (csy - 1);
+
+	if (y2 > 0)
+	{
+		int h2 = std::min(h, csy - y2);
+
+		for (int x = l; x < r; x += bsx)
+		{
+			uint8* dst = NULL;
+
+			switch (psm)
+			{
+				case PSM_PSMCT32: dst = BlockPtr32(x, y, bp, bw); break;
+				case PSM_PSMCT16: dst = BlockPtr16(x, y, bp, bw); break;
+				case PSM_PSMCT16S: dst = BlockPtr16S(x, y, bp, bw); break;
+				case PSM_PSMT8: dst = BlockPtr8(x, y, bp, bw); break;
+				case PSM_PSMT4: dst = BlockPtr4(x, y, bp, bw); break;
+				case PSM_PSMZ32: dst = BlockPtr32Z(x, y, bp, bw); break;
+				case PSM_PSMZ16: dst = BlockPtr16Z(x, y, bp, bw); break;
+				case PSM_PSMZ16S: dst = BlockPtr16SZ(x, y, bp, bw); break;
+				// TODO
+				default: __assume(0);
+			}
+
+			switch (psm)
+			{
+				case PSM_PSMCT32:
+				case PSM_PSMZ32:
+					GSBlock::ReadColumn32(y, dst, buff, 32);
+					memcpy(&buff[32], &src[x * 4], 32);
+					GSBlock::WriteColumn32<32, 0xffffffff>(y, dst, buff, 32);
+					break;
+				case PSM_PSMCT16:
+				case PSM_PSMCT16S:
+				case PSM_PSMZ16:
+				case PSM_PSMZ16S:
+					GSBlock::ReadColumn16(y, dst, buff, 32);
+					memcpy(&buff[32], &src[x * 2], 32);
+					GSBlock::WriteColumn16<32>(y, dst, buff, 32);
+					break;
+				case PSM_PSMT8:
+					GSBlock::ReadColumn8(y, dst, buff, 16);
+					for (int i = 0, j = y2; i < h2; i++, j++)
+						memcpy(&buff[j * 16], &src[i * srcpitch + x], 16);
+					GSBlock::WriteColumn8<32>(y, dst, buff, 16);
+					break;
+				case PSM_PSMT4:
+					GSBlock::ReadColumn4(y, dst, buff, 16);
+					for (int i = 0, j = y2; i < h2; i++, j++)
+						memcpy(&buff[j * 16], &src[i * srcpitch + (x >> 1)], 16);
+					GSBlock::WriteColumn4<32>(y, dst, buff, 16);
+					break;
+				// TODO
+				default:
+					__assume(0);
+			}
+		}
+
+		src += srcpitch * h2;
+		y += h2;
+		h -= h2;
+	}
+
+	// write whole columns
+
+	{
+		int h2 = h & ~(csy - 1);
+
+		if (h2 > 0)
+		{
+			size_t addr = (size_t)&src[l * trbpp >> 3];
+
+			if ((addr & 31) == 0 && (srcpitch & 31) == 0)
+			{
+				WriteImageColumn<isa, psm, bsx, bsy, 32>(l, r, y, h2, src, srcpitch, BITBLTBUF);
+			}
+			else if ((addr & 15) == 0 && (srcpitch & 15) == 0)
+			{
+				WriteImageColumn<isa, psm, bsx, bsy, 16>(l, r, y, h2, src, srcpitch, BITBLTBUF);
+			}
+			else
+			{
+				WriteImageColumn<isa, psm, bsx, bsy, 0>(l, r, y, h2, src, srcpitch, BITBLTBUF);
+			}
+
+			src += srcpitch * h2;
+			y += h2;
+			h -= h2;
+		}
+	}
+
+	// merge incomplete column
+
+	if (h >= 1)
+	{
+		for (int x = l; x < r; x += bsx)
+		{
+			uint8* dst = NULL;
+
+			switch (psm)
+			{
+			case PSM_PSMCT32: dst = BlockPtr32(x, y, bp, bw); break;
+			case PSM_PSMCT16: dst = BlockPtr16(x, y, bp, bw); break;
+			case PSM_PSMCT16S: dst = BlockPtr16S(x, y, bp, bw); break;
+			case PSM_PSMT8: dst = BlockPtr8(x, y, bp, bw); break;
+			case PSM_PSMT4: dst = BlockPtr4(x, y, bp, bw); break;
+			case PSM_PSMZ32: dst = BlockPtr32Z(x, y, bp, bw); break;
+			case PSM_PSMZ16: dst = BlockPtr16Z(x, y, bp, bw); break;
+			case PSM_PSMZ16S: dst = BlockPtr16SZ(x, y, bp, bw); break;
+			// TODO
+			default: __assume(0);
+			}
+
+			switch (psm)
+			{
+				case PSM_PSMCT32:
+				case PSM_PSMZ32:
+					GSBlock::ReadColumn32(y, dst, buff, 32);
+					memcpy(&buff[0], &src[x * 4], 32);
+					GSBlock::WriteColumn32<32, 0xffffffff>(y, dst, buff, 32);
+					break;
+				case PSM_PSMCT16:
+				case PSM_PSMCT16S:
+				case PSM_PSMZ16:
+				case PSM_PSMZ16S:
+					GSBlock::ReadColumn16(y, dst, buff, 32);
+					memcpy(&buff[0], &src[x * 2], 32);
+					GSBlock::WriteColumn16<32>(y, dst, buff, 32);
+					break;
+				case PSM_PSMT8:
+					GSBlock::ReadColumn8(y, dst, buff, 16);
+					for (int i = 0; i < h; i++)
+						memcpy(&buff[i * 16], &src[i * srcpitch + x], 16);
+					GSBlock::WriteColumn8<32>(y, dst, buff, 16);
+					break;
+				case PSM_PSMT4:
+					GSBlock::ReadColumn4(y, dst, buff, 16);
+					for (int i = 0; i < h; i++)
+						memcpy(&buff[i * 16], &src[i * srcpitch + (x >> 1)], 16);
+					GSBlock::WriteColumn4<32>(y, dst, buff, 16);
+					break;
+				// TODO
+				default:
+					__assume(0);
+			}
+		}
+	}
+}
+
+template <GSVectorISA isa, int psm, int bsx, int bsy, int trbpp>
+void GSLocalMemory::WriteImage(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if (TRXREG.RRW == 0)
+		return;
+
+	int l = (int)TRXPOS.DSAX;
+	int r = l + (int)TRXREG.RRW;
+
+	// finish the incomplete row first
+
+	if (tx != l)
+	{
+		int n = std::min(len, (r - tx) * trbpp >> 3);
+		WriteImageX(tx, ty, src, n, BITBLTBUF, TRXPOS, TRXREG);
+		src += n;
+		len -= n;
+	}
+
+	int la = (l + (bsx - 1)) & ~(bsx - 1);
+	int ra = r & ~(bsx - 1);
+	int srcpitch = (r - l) * trbpp >> 3;
+	int h = len / srcpitch;
+
+	if (ra - la >= bsx && h > 0) // "transfer width" >= "block width" && there is at least one full row
+	{
+		const uint8* s = &src[-l * trbpp >> 3];
+
+		src += srcpitch * h;
+		len -= srcpitch * h;
+
+		// left part
+
+		if (l < la)
+		{
+			WriteImageLeftRight<isa, psm, bsx, bsy>(l, la, ty, h, s, srcpitch, BITBLTBUF);
+		}
+
+		// right part
+
+		if (ra < r)
+		{
+			WriteImageLeftRight<isa, psm, bsx, bsy>(ra, r, ty, h, s, srcpitch, BITBLTBUF);
+		}
+
+		// horizontally aligned part
+
+		if (la < ra)
+		{
+			// top part
+
+			{
+				int h2 = std::min(h, bsy - (ty & (bsy - 1)));
+
+				if (h2 < bsy)
+				{
+					WriteImageTopBottom<isa, psm, bsx, bsy, trbpp>(la, ra, ty, h2, s, srcpitch, BITBLTBUF);
+
+					s += srcpitch * h2;
+					ty += h2;
+					h -= h2;
+				}
+			}
+
+			// horizontally and vertically aligned part
+
+			{
+				int h2 = h & ~(bsy - 1);
+
+				if (h2 > 0)
+				{
+					size_t addr = (size_t)&s[la * trbpp >> 3];
+
+					if ((addr & 31) == 0 && (srcpitch & 31) == 0)
+					{
+						WriteImageBlock<isa, psm, bsx, bsy, 32>(la, ra, ty, h2, s, srcpitch, BITBLTBUF);
+					}
+					else if ((addr & 15) == 0 && (srcpitch & 15) == 0)
+					{
+						WriteImageBlock<isa, psm, bsx, bsy, 16>(la, ra, ty, h2, s, srcpitch, BITBLTBUF);
+					}
+					else
+					{
+						WriteImageBlock<isa, psm, bsx, bsy, 0>(la, ra, ty, h2, s, srcpitch, BITBLTBUF);
+					}
+
+					s += srcpitch * h2;
+					ty += h2;
+					h -= h2;
+				}
+			}
+
+			// bottom part
+
+			if (h > 0)
+			{
+				WriteImageTopBottom<isa, psm, bsx, bsy, trbpp>(la, ra, ty, h, s, srcpitch, BITBLTBUF);
+
+				// s += srcpitch * h;
+				ty += h;
+				// h -= h;
+			}
+		}
+	}
+
+	// the rest
+
+	if (len > 0)
+	{
+		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+}
+
+
+static bool IsTopLeftAligned(int dsax, int tx, int ty, int bw, int bh)
+{
+	return ((dsax & (bw - 1)) == 0 && (tx & (bw - 1)) == 0 && dsax == tx && (ty & (bh - 1)) == 0);
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::WriteImage24(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if (TRXREG.RRW == 0)
+		return;
+
+	uint32 bp = BITBLTBUF.DBP;
+	uint32 bw = BITBLTBUF.DBW;
+
+	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW * 3;
+	int th = len / srcpitch;
+
+	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
+
+	if (!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
+	{
+		// TODO
+
+		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+	else
+	{
+		th += ty;
+
+		for (int y = ty; y < th; y += 8, src += srcpitch * 8)
+		{
+			for (int x = tx; x < tw; x += 8)
+			{
+				GSBlock::UnpackAndWriteBlock24(src + (x - tx) * 3, srcpitch, BlockPtr32(x, y, bp, bw));
+			}
+		}
+
+		ty = th;
+	}
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::WriteImage8H(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if (TRXREG.RRW == 0)
+		return;
+
+	uint32 bp = BITBLTBUF.DBP;
+	uint32 bw = BITBLTBUF.DBW;
+
+	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW;
+	int th = len / srcpitch;
+
+	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
+
+	if (!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
+	{
+		// TODO
+
+		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+	else
+	{
+		th += ty;
+
+		for (int y = ty; y < th; y += 8, src += srcpitch * 8)
+		{
+			for (int x = tx; x < tw; x += 8)
+			{
+				GSBlock::UnpackAndWriteBlock8H(src + (x - tx), srcpitch, BlockPtr32(x, y, bp, bw));
+			}
+		}
+
+		ty = th;
+	}
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::WriteImage4HL(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if (TRXREG.RRW == 0)
+		return;
+
+	uint32 bp = BITBLTBUF.DBP;
+	uint32 bw = BITBLTBUF.DBW;
+
+	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW / 2;
+	int th = len / srcpitch;
+
+	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
+
+	if (!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
+	{
+		// TODO
+
+		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+	else
+	{
+		th += ty;
+
+		for (int y = ty; y < th; y += 8, src += srcpitch * 8)
+		{
+			for (int x = tx; x < tw; x += 8)
+			{
+				GSBlock::UnpackAndWriteBlock4HL(src + (x - tx) / 2, srcpitch, BlockPtr32(x, y, bp, bw));
+			}
+		}
+
+		ty = th;
+	}
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::WriteImage4HH(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if (TRXREG.RRW == 0)
+		return;
+
+	uint32 bp = BITBLTBUF.DBP;
+	uint32 bw = BITBLTBUF.DBW;
+
+	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW / 2;
+	int th = len / srcpitch;
+
+	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
+
+	if (!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
+	{
+		// TODO
+
+		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+	else
+	{
+		th += ty;
+
+		for (int y = ty; y < th; y += 8, src += srcpitch * 8)
+		{
+			for (int x = tx; x < tw; x += 8)
+			{
+				GSBlock::UnpackAndWriteBlock4HH(src + (x - tx) / 2, srcpitch, BlockPtr32(x, y, bp, bw));
+			}
+		}
+
+		ty = th;
+	}
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::WriteImage24Z(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if (TRXREG.RRW == 0)
+		return;
+
+	uint32 bp = BITBLTBUF.DBP;
+	uint32 bw = BITBLTBUF.DBW;
+
+	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW * 3;
+	int th = len / srcpitch;
+
+	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
+
+	if (!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
+	{
+		// TODO
+
+		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+	else
+	{
+		th += ty;
+
+		for (int y = ty; y < th; y += 8, src += srcpitch * 8)
+		{
+			for (int x = tx; x < tw; x += 8)
+			{
+				GSBlock::UnpackAndWriteBlock24(src + (x - tx) * 3, srcpitch, BlockPtr32Z(x, y, bp, bw));
+			}
+		}
+
+		ty = th;
+	}
+}
+
+///////////////////
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTexture32(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
+	{
+		GSBlock::ReadBlock32(src, read_dst, dstpitch);
+	});
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTexture24(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	if (TEXA.AEM)
+	{
+		foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
+		{
+			GSBlock::ReadAndExpandBlock24<true>(src, read_dst, dstpitch, TEXA);
+		});
+	}
+	else
+	{
+		foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
+		{
+			GSBlock::ReadAndExpandBlock24<false>(src, read_dst, dstpitch, TEXA);
+		});
+	}
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTextureGPU24(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	foreachBlock(off.assertSizesMatch(swizzle16), this, r, dst, dstpitch, 16, [&](uint8* read_dst, const uint8* src)
+	{
+		GSBlock::ReadBlock16(src, read_dst, dstpitch);
+	});
+
+	// Convert packed RGB scanline to 32 bits RGBA
+	ASSERT(dstpitch >= r.width() * 4);
+	for (int y = r.top; y < r.bottom; y++)
+	{
+		uint8* line = dst + y * dstpitch;
+
+		for (int x = r.right; x >= r.left; x--)
+		{
+			*(uint32*)&line[x * 4] = *(uint32*)&line[x * 3] & 0xFFFFFF;
+		}
+	}
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTexture16(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	if (TEXA.AEM)
+	{
+		foreachBlock(off.assertSizesMatch(swizzle16), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
+		{
+			GSBlock::ReadAndExpandBlock16<true>(src, read_dst, dstpitch, TEXA);
+		});
+	}
+	else
+	{
+		foreachBlock(off.assertSizesMatch(swizzle16), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
+		{
+			GSBlock::ReadAndExpandBlock16<false>(src, read_dst, dstpitch, TEXA);
+		});
+	}
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTexture8(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	const uint32* pal = m_clut;
+
+	foreachBlock(off.assertSizesMatch(swizzle8), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
+	{
+		GSBlock::ReadAndExpandBlock8_32(src, read_dst, dstpitch, pal);
+	});
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTexture4(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	const uint64* pal = m_clut;
+
+	foreachBlock(off.assertSizesMatch(swizzle4), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
+	{
+		GSBlock::ReadAndExpandBlock4_32(src, read_dst, dstpitch, pal);
+	});
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTexture8H(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	const uint32* pal = m_clut;
+
+	foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
+	{
+		GSBlock::ReadAndExpandBlock8H_32(src, read_dst, dstpitch, pal);
+	});
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTexture4HL(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	const uint32* pal = m_clut;
+
+	foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
+	{
+		GSBlock::ReadAndExpandBlock4HL_32(src, read_dst, dstpitch, pal);
+	});
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTexture4HH(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	const uint32* pal = m_clut;
+
+	foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 32, [&](uint8* read_dst, const uint8* src)
+	{
+		GSBlock::ReadAndExpandBlock4HH_32(src, read_dst, dstpitch, pal);
+	});
+}
+
+///////////////////
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTextureBlock32(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadBlock32(BlockPtr(bp), dst, dstpitch);
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTextureBlock24(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	if (TEXA.AEM)
+	{
+		GSBlock::ReadAndExpandBlock24<true>(BlockPtr(bp), dst, dstpitch, TEXA);
+	}
+	else
+	{
+		GSBlock::ReadAndExpandBlock24<false>(BlockPtr(bp), dst, dstpitch, TEXA);
+	}
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTextureBlock16(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	if (TEXA.AEM)
+	{
+		GSBlock::ReadAndExpandBlock16<true>(BlockPtr(bp), dst, dstpitch, TEXA);
+	}
+	else
+	{
+		GSBlock::ReadAndExpandBlock16<false>(BlockPtr(bp), dst, dstpitch, TEXA);
+	}
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTextureBlock8(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadAndExpandBlock8_32(BlockPtr(bp), dst, dstpitch, m_clut);
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTextureBlock4(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadAndExpandBlock4_32(BlockPtr(bp), dst, dstpitch, m_clut);
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTextureBlock8H(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadAndExpandBlock8H_32(BlockPtr(bp), dst, dstpitch, m_clut);
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTextureBlock4HL(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadAndExpandBlock4HL_32(BlockPtr(bp), dst, dstpitch, m_clut);
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTextureBlock4HH(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadAndExpandBlock4HH_32(BlockPtr(bp), dst, dstpitch, m_clut);
+}
+
+// 32/8
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTexture8P(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	foreachBlock(off.assertSizesMatch(swizzle8), this, r, dst, dstpitch, 8, [&](uint8* read_dst, const uint8* src)
+	{
+		GSBlock::ReadBlock8(src, read_dst, dstpitch);
+	});
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTexture4P(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	foreachBlock(off.assertSizesMatch(swizzle4), this, r, dst, dstpitch, 8, [&](uint8* read_dst, const uint8* src)
+	{
+		GSBlock::ReadBlock4P(src, read_dst, dstpitch);
+	});
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTexture8HP(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 8, [&](uint8* read_dst, const uint8* src)
+	{
+		GSBlock::ReadBlock8HP(src, read_dst, dstpitch);
+	});
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTexture4HLP(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 8, [&](uint8* read_dst, const uint8* src)
+	{
+		GSBlock::ReadBlock4HLP(src, read_dst, dstpitch);
+	});
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTexture4HHP(const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	foreachBlock(off.assertSizesMatch(swizzle32), this, r, dst, dstpitch, 8, [&](uint8* read_dst, const uint8* src)
+	{
+		GSBlock::ReadBlock4HHP(src, read_dst, dstpitch);
+	});
+}
+
+//
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTextureBlock8P(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	GSBlock::ReadBlock8(BlockPtr(bp), dst, dstpitch);
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTextureBlock4P(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadBlock4P(BlockPtr(bp), dst, dstpitch);
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTextureBlock8HP(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadBlock8HP(BlockPtr(bp), dst, dstpitch);
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTextureBlock4HLP(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadBlock4HLP(BlockPtr(bp), dst, dstpitch);
+}
+
+template <GSVectorISA isa>
+void GSLocalMemory::ReadTextureBlock4HHP(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadBlock4HHP(BlockPtr(bp), dst, dstpitch);
+}
+
+//
+
+template <GSVectorISA isa>
+void GSLocalMemory::SetupTransferFunctions()
+{
+	for (size_t i = 0; i < countof(m_psm); i++)
+	{
+		m_psm[i].wi = &GSLocalMemory::WriteImage<isa, PSM_PSMCT32, 8, 8, 32>;
+		m_psm[i].rtx = &GSLocalMemory::ReadTexture32<isa>;
+		m_psm[i].rtxP = &GSLocalMemory::ReadTexture32<isa>;
+		m_psm[i].rtxb = &GSLocalMemory::ReadTextureBlock32<isa>;
+		m_psm[i].rtxbP = &GSLocalMemory::ReadTextureBlock32<isa>;
+	}
+
+	m_psm[PSM_PSMCT24].wi = &GSLocalMemory::WriteImage24<isa>; // TODO
+	m_psm[PSM_PSMCT16].wi = &GSLocalMemory::WriteImage<isa, PSM_PSMCT16, 16, 8, 16>;
+	m_psm[PSM_PSMCT16S].wi = &GSLocalMemory::WriteImage<isa, PSM_PSMCT16S, 16, 8, 16>;
+	m_psm[PSM_PSMT8].wi = &GSLocalMemory::WriteImage<isa, PSM_PSMT8, 16, 16, 8>;
+	m_psm[PSM_PSMT4].wi = &GSLocalMemory::WriteImage<isa, PSM_PSMT4, 32, 16, 4>;
+	m_psm[PSM_PSMT8H].wi = &GSLocalMemory::WriteImage8H<isa>; // TODO
+	m_psm[PSM_PSMT4HL].wi = &GSLocalMemory::WriteImage4HL<isa>; // TODO
+	m_psm[PSM_PSMT4HH].wi = &GSLocalMemory::WriteImage4HH<isa>; // TODO
+	m_psm[PSM_PSMZ32].wi = &GSLocalMemory::WriteImage<isa, PSM_PSMZ32, 8, 8, 32>;
+	m_psm[PSM_PSMZ24].wi = &GSLocalMemory::WriteImage24Z<isa>; // TODO
+	m_psm[PSM_PSMZ16].wi = &GSLocalMemory::WriteImage<isa, PSM_PSMZ16, 16, 8, 16>;
+	m_psm[PSM_PSMZ16S].wi = &GSLocalMemory::WriteImage<isa, PSM_PSMZ16S, 16, 8, 16>;
+
+	m_psm[PSM_PSMCT24].rtx = &GSLocalMemory::ReadTexture24<isa>;
+	m_psm[PSM_PSGPU24].rtx = &GSLocalMemory::ReadTextureGPU24<isa>;
+	m_psm[PSM_PSMCT16].rtx = &GSLocalMemory::ReadTexture16<isa>;
+	m_psm[PSM_PSMCT16S].rtx = &GSLocalMemory::ReadTexture16<isa>;
+	m_psm[PSM_PSMT8].rtx = &GSLocalMemory::ReadTexture8<isa>;
+	m_psm[PSM_PSMT4].rtx = &GSLocalMemory::ReadTexture4<isa>;
+	m_psm[PSM_PSMT8H].rtx = &GSLocalMemory::ReadTexture8H<isa>;
+	m_psm[PSM_PSMT4HL].rtx = &GSLocalMemory::ReadTexture4HL<isa>;
+	m_psm[PSM_PSMT4HH].rtx = &GSLocalMemory::ReadTexture4HH<isa>;
+	m_psm[PSM_PSMZ32].rtx = &GSLocalMemory::ReadTexture32<isa>;
+	m_psm[PSM_PSMZ24].rtx = &GSLocalMemory::ReadTexture24<isa>;
+	m_psm[PSM_PSMZ16].rtx = &GSLocalMemory::ReadTexture16<isa>;
+	m_psm[PSM_PSMZ16S].rtx = &GSLocalMemory::ReadTexture16<isa>;
+
+	m_psm[PSM_PSMCT24].rtxP = &GSLocalMemory::ReadTexture24<isa>;
+	m_psm[PSM_PSMCT16].rtxP = &GSLocalMemory::ReadTexture16<isa>;
+	m_psm[PSM_PSMCT16S].rtxP = &GSLocalMemory::ReadTexture16<isa>;
+	m_psm[PSM_PSMT8].rtxP = &GSLocalMemory::ReadTexture8P<isa>;
+	m_psm[PSM_PSMT4].rtxP = &GSLocalMemory::ReadTexture4P<isa>;
+	m_psm[PSM_PSMT8H].rtxP = &GSLocalMemory::ReadTexture8HP<isa>;
+	m_psm[PSM_PSMT4HL].rtxP = &GSLocalMemory::ReadTexture4HLP<isa>;
+	m_psm[PSM_PSMT4HH].rtxP = &GSLocalMemory::ReadTexture4HHP<isa>;
+	m_psm[PSM_PSMZ32].rtxP = &GSLocalMemory::ReadTexture32<isa>;
+	m_psm[PSM_PSMZ24].rtxP = &GSLocalMemory::ReadTexture24<isa>;
+	m_psm[PSM_PSMZ16].rtxP = &GSLocalMemory::ReadTexture16<isa>;
+	m_psm[PSM_PSMZ16S].rtxP = &GSLocalMemory::ReadTexture16<isa>;
+
+	m_psm[PSM_PSMCT24].rtxb = &GSLocalMemory::ReadTextureBlock24<isa>;
+	m_psm[PSM_PSMCT16].rtxb = &GSLocalMemory::ReadTextureBlock16<isa>;
+	m_psm[PSM_PSMCT16S].rtxb = &GSLocalMemory::ReadTextureBlock16<isa>;
+	m_psm[PSM_PSMT8].rtxb = &GSLocalMemory::ReadTextureBlock8<isa>;
+	m_psm[PSM_PSMT4].rtxb = &GSLocalMemory::ReadTextureBlock4<isa>;
+	m_psm[PSM_PSMT8H].rtxb = &GSLocalMemory::ReadTextureBlock8H<isa>;
+	m_psm[PSM_PSMT4HL].rtxb = &GSLocalMemory::ReadTextureBlock4HL<isa>;
+	m_psm[PSM_PSMT4HH].rtxb = &GSLocalMemory::ReadTextureBlock4HH<isa>;
+	m_psm[PSM_PSMZ32].rtxb = &GSLocalMemory::ReadTextureBlock32<isa>;
+	m_psm[PSM_PSMZ24].rtxb = &GSLocalMemory::ReadTextureBlock24<isa>;
+	m_psm[PSM_PSMZ16].rtxb = &GSLocalMemory::ReadTextureBlock16<isa>;
+	m_psm[PSM_PSMZ16S].rtxb = &GSLocalMemory::ReadTextureBlock16<isa>;
+
+	m_psm[PSM_PSMCT24].rtxbP = &GSLocalMemory::ReadTextureBlock24<isa>;
+	m_psm[PSM_PSMCT16].rtxbP = &GSLocalMemory::ReadTextureBlock16<isa>;
+	m_psm[PSM_PSMCT16S].rtxbP = &GSLocalMemory::ReadTextureBlock16<isa>;
+	m_psm[PSM_PSMT8].rtxbP = &GSLocalMemory::ReadTextureBlock8P<isa>;
+	m_psm[PSM_PSMT4].rtxbP = &GSLocalMemory::ReadTextureBlock4P<isa>;
+	m_psm[PSM_PSMT8H].rtxbP = &GSLocalMemory::ReadTextureBlock8HP<isa>;
+	m_psm[PSM_PSMT4HL].rtxbP = &GSLocalMemory::ReadTextureBlock4HLP<isa>;
+	m_psm[PSM_PSMT4HH].rtxbP = &GSLocalMemory::ReadTextureBlock4HHP<isa>;
+	m_psm[PSM_PSMZ32].rtxbP = &GSLocalMemory::ReadTextureBlock32<isa>;
+	m_psm[PSM_PSMZ24].rtxbP = &GSLocalMemory::ReadTextureBlock24<isa>;
+	m_psm[PSM_PSMZ16].rtxbP = &GSLocalMemory::ReadTextureBlock16<isa>;
+	m_psm[PSM_PSMZ16S].rtxbP = &GSLocalMemory::ReadTextureBlock16<isa>;
+}
+
+template void GSLocalMemory::SetupTransferFunctions<GS_CURRENT_ISA>();
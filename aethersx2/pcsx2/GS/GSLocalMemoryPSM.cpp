@@ -0,0 +1,494 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "GSLocalMemory.h"
+
+constexpr GSSwizzleInfo GSLocalMemory::swizzle32;
+constexpr GSSwizzleInfo GSLocalMemory::swizzle32Z;
+constexpr GSSwizzleInfo GSLocalMemory::swizzle16;
+constexpr GSSwizzleInfo GSLocalMemory::swizzle16S;
+constexpr GSSwizzleInfo GSLocalMemory::swizzle16Z;
+constexpr GSSwizzleInfo GSLocalMemory::swizzle16SZ;
+constexpr GSSwizzleInfo GSLocalMemory::swizzle8;
+constexpr GSSwizzleInfo GSLocalMemory::swizzle4;
+
+//
+
+GSLocalMemory::psm_t GSLocalMemory::m_psm[64];
+
+//
+
+void GSLocalMemory::SetupPSMTable()
+{
+	for (size_t i = 0; i < countof(m_psm); i++)
+	{
+		m_psm[i].info = GSLocalMemory::swizzle32;
+		m_psm[i].rp = &GSLocalMemory::ReadPixel32;
+		m_psm[i].rpa = &GSLocalMemory::ReadPixel32;
+		m_psm[i].wp = &GSLocalMemory::WritePixel32;
+		m_psm[i].wpa = &GSLocalMemory::WritePixel32;
+		m_psm[i].rt = &GSLocalMemory::ReadTexel32;
+		m_psm[i].rta = &GSLocalMemory::ReadTexel32;
+		m_psm[i].wfa = &GSLocalMemory::WritePixel32;
+		m_psm[i].ri = &GSLocalMemory::ReadImageX; // TODO
+		m_psm[i].bpp = m_psm[i].trbpp = 32;
+		m_psm[i].pal = 0;
+		m_psm[i].bs = GSVector2i(8, 8);
+		m_psm[i].pgs = GSVector2i(64, 32);
+		m_psm[i].msk = 0xff;
+		m_psm[i].depth = 0;
+	}
+
+	m_psm[PSM_PSGPU24].info = GSLocalMemory::swizzle16;
+	m_psm[PSM_PSMCT16].info = GSLocalMemory::swizzle16;
+	m_psm[PSM_PSMCT16S].info = GSLocalMemory::swizzle16S;
+	m_psm[PSM_PSMT8].info = GSLocalMemory::swizzle8;
+	m_psm[PSM_PSMT4].info = GSLocalMemory::swizzle4;
+	m_psm[PSM_PSMZ32].info = GSLocalMemory::swizzle32Z;
+	m_psm[PSM_PSMZ24].info = GSLocalMemory::swizzle32Z;
+	m_psm[PSM_PSMZ16].info = GSLocalMemory::swizzle16Z;
+	m_psm[PSM_PSMZ16S].info = GSLocalMemory::swizzle16SZ;
+
+	m_psm[PSM_PSMCT24].rp = &GSLocalMemory::ReadPixel24;
+	m_psm[PSM_PSMCT16].rp = &GSLocalMemory::ReadPixel16;
+	m_psm[PSM_PSMCT16S].rp = &GSLocalMemory::ReadPixel16S;
+	m_psm[PSM_PSMT8].rp = &GSLocalMemory::ReadPixel8;
+	m_psm[PSM_PSMT4].rp = &GSLocalMemory::ReadPixel4;
+	m_psm[PSM_PSMT8H].rp = &GSLocalMemory::ReadPixel8H;
+	m_psm[PSM_PSMT4HL].rp = &GSLocalMemory::ReadPixel4HL;
+	m_psm[PSM_PSMT4HH].rp = &GSLocalMemory::ReadPixel4HH;
+	m_psm[PSM_PSMZ32].rp = &GSLocalMemory::ReadPixel32Z;
+	m_psm[PSM_PSMZ24].rp = &GSLocalMemory::ReadPixel24Z;
+	m_psm[PSM_PSMZ16].rp = &GSLocalMemory::ReadPixel16Z;
+	m_psm[PSM_PSMZ16S].rp = &GSLocalMemory::ReadPixel16SZ;
+
+	m_psm[PSM_PSMCT24].rpa = &GSLocalMemory::ReadPixel24;
+	m_psm[PSM_PSMCT16].rpa = &GSLocalMemory::ReadPixel16;
+	m_psm[PSM_PSMCT16S].rpa = &GSLocalMemory::ReadPixel16;
+	m_psm[PSM_PSMT8].rpa = &GSLocalMemory::ReadPixel8;
+	m_psm[PSM_PSMT4].rpa = &GSLocalMemory::ReadPixel4;
+	m_psm[PSM_PSMT8H].rpa = &GSLocalMemory::ReadPixel8H;
+	m_psm[PSM_PSMT4HL].rpa = &GSLocalMemory::ReadPixel4HL;
+	m_psm[PSM_PSMT4HH].rpa = &GSLocalMemory::ReadPixel4HH;
+	m_psm[PSM_PSMZ32].rpa = &GSLocalMemory::ReadPixel32;
+	m_psm[PSM_PSMZ24].rpa = &GSLocalMemory::ReadPixel24;
+	m_psm[PSM_PSMZ16].rpa = &GSLocalMemory::ReadPixel16;
+	m_psm[PSM_PSMZ16S].rpa = &GSLocalMemory::ReadPixel16;
+
+	m_psm[PSM_PSMCT32].wp = &GSLocalMemory::WritePixel32;
+	m_psm[PSM_PSMCT24].wp = &GSLocalMemory::WritePixel24;
+	m_psm[PSM_PSMCT16].wp = &GSLocalMemory::WritePixel16;
+	m_psm[PSM_PSMCT16S].wp = &GSLocalMemory::WritePixel16S;
+	m_psm[PSM_PSMT8].wp = &GSLocalMemory::WritePixel8;
+	m_psm[PSM_PSMT4].wp = &GSLocalMemory::WritePixel4;
+	m_psm[PSM_PSMT8H].wp = &GSLocalMemory::WritePixel8H;
+	m_psm[PSM_PSMT4HL].wp = &GSLocalMemory::WritePixel4HL;
+	m_psm[PSM_PSMT4HH].wp = &GSLocalMemory::WritePixel4HH;
+	m_psm[PSM_PSMZ32].wp = &GSLocalMemory::WritePixel32Z;
+	m_psm[PSM_PSMZ24].wp = &GSLocalMemory::WritePixel24Z;
+	m_psm[PSM_PSMZ16].wp = &GSLocalMemory::WritePixel16Z;
+	m_psm[PSM_PSMZ16S].wp = &GSLocalMemory::WritePixel16SZ;
+
+	m_psm[PSM_PSMCT32].wpa = &GSLocalMemory::WritePixel32;
+	m_psm[PSM_PSMCT24].wpa = &GSLocalMemory::WritePixel24;
+	m_psm[PSM_PSMCT16].wpa = &GSLocalMemory::WritePixel16;
+	m_psm[PSM_PSMCT16S].wpa = &GSLocalMemory::WritePixel16;
+	m_psm[PSM_PSMT8].wpa = &GSLocalMemory::WritePixel8;
+	m_psm[PSM_PSMT4].wpa = &GSLocalMemory::WritePixel4;
+	m_psm[PSM_PSMT8H].wpa = &GSLocalMemory::WritePixel8H;
+	m_psm[PSM_PSMT4HL].wpa = &GSLocalMemory::WritePixel4HL;
+	m_psm[PSM_PSMT4HH].wpa = &GSLocalMemory::WritePixel4HH;
+	m_psm[PSM_PSMZ32].wpa = &GSLocalMemory::WritePixel32;
+	m_psm[PSM_PSMZ24].wpa = &GSLocalMemory::WritePixel24;
+	m_psm[PSM_PSMZ16].wpa = &GSLocalMemory::WritePixel16;
+	m_psm[PSM_PSMZ16S].wpa = &GSLocalMemory::WritePixel16;
+
+	m_psm[PSM_PSMCT24].rt = &GSLocalMemory::ReadTexel24;
+	m_psm[PSM_PSMCT16].rt = &GSLocalMemory::ReadTexel16;
+	m_psm[PSM_PSMCT16S].rt = &GSLocalMemory::ReadTexel16S;
+	m_psm[PSM_PSMT8].rt = &GSLocalMemory::ReadTexel8;
+	m_psm[PSM_PSMT4].rt = &GSLocalMemory::ReadTexel4;
+	m_psm[PSM_PSMT8H].rt = &GSLocalMemory::ReadTexel8H;
+	m_psm[PSM_PSMT4HL].rt = &GSLocalMemory::ReadTexel4HL;
+	m_psm[PSM_PSMT4HH].rt = &GSLocalMemory::ReadTexel4HH;
+	m_psm[PSM_PSMZ32].rt = &GSLocalMemory::ReadTexel32Z;
+	m_psm[PSM_PSMZ24].rt = &GSLocalMemory::ReadTexel24Z;
+	m_psm[PSM_PSMZ16].rt = &GSLocalMemory::ReadTexel16Z;
+	m_psm[PSM_PSMZ16S].rt = &GSLocalMemory::ReadTexel16SZ;
+
+	m_psm[PSM_PSMCT24].rta = &GSLocalMemory::ReadTexel24;
+	m_psm[PSM_PSMCT16].rta = &GSLocalMemory::ReadTexel16;
+	m_psm[PSM_PSMCT16S].rta = &GSLocalMemory::ReadTexel16;
+	m_psm[PSM_PSMT8].rta = &GSLocalMemory::ReadTexel8;
+	m_psm[PSM_PSMT4].rta = &GSLocalMemory::ReadTexel4;
+	m_psm[PSM_PSMT8H].rta = &GSLocalMemory::ReadTexel8H;
+	m_psm[PSM_PSMT4HL].rta = &GSLocalMemory::ReadTexel4HL;
+	m_psm[PSM_PSMT4HH].rta = &GSLocalMemory::ReadTexel4HH;
+	m_psm[PSM_PSMZ24].rta = &GSLocalMemory::ReadTexel24;
+	m_psm[PSM_PSMZ16].rta = &GSLocalMemory::ReadTexel16;
+	m_psm[PSM_PSMZ16S].rta = &GSLocalMemory::ReadTexel16;
+
+	m_psm[PSM_PSMCT24].wfa = &GSLocalMemory::WritePixel24;
+	m_psm[PSM_PSMCT16].wfa = &GSLocalMemory::WriteFrame16;
+	m_psm[PSM_PSMCT16S].wfa = &GSLocalMemory::WriteFrame16;
+	m_psm[PSM_PSMZ24].wfa = &GSLocalMemory::WritePixel24;
+	m_psm[PSM_PSMZ16].wfa = &GSLocalMemory::WriteFrame16;
+	m_psm[PSM_PSMZ16S].wfa = &GSLocalMemory::WriteFrame16;
+
+	m_psm[PSM_PSGPU24].bpp = 16;
+	m_psm[PSM_PSMCT16].bpp = m_psm[PSM_PSMCT16S].bpp = 16;
+	m_psm[PSM_PSMT8].bpp = 8;
+	m_psm[PSM_PSMT4].bpp = 4;
+	m_psm[PSM_PSMZ16].bpp = m_psm[PSM_PSMZ16S].bpp = 16;
+
+	m_psm[PSM_PSMCT24].trbpp = 24;
+	m_psm[PSM_PSGPU24].trbpp = 16;
+	m_psm[PSM_PSMCT16].trbpp = m_psm[PSM_PSMCT16S].trbpp = 16;
+	m_psm[PSM_PSMT8].trbpp = m_psm[PSM_PSMT8H].trbpp = 8;
+	m_psm[PSM_PSMT4].trbpp = m_psm[PSM_PSMT4HL].trbpp = m_psm[PSM_PSMT4HH].trbpp = 4;
+	m_psm[PSM_PSMZ24].trbpp = 24;
+	m_psm[PSM_PSMZ16].trbpp = m_psm[PSM_PSMZ16S].trbpp = 16;
+
+	m_psm[PSM_PSMT8].pal = m_psm[PSM_PSMT8H].pal = 256;
+	m_psm[PSM_PSMT4].pal = m_psm[PSM_PSMT4HL].pal = m_psm[PSM_PSMT4HH].pal = 16;
+
+	for (size_t i = 0; i < countof(m_psm); i++)
+		m_psm[i].fmt = 3;
+	m_psm[PSM_PSMCT32].fmt = m_psm[PSM_PSMZ32].fmt = 0;
+	m_psm[PSM_PSMCT24].fmt = m_psm[PSM_PSMZ24].fmt = 1;
+	m_psm[PSM_PSMCT16].fmt = m_psm[PSM_PSMZ16].fmt = 2;
+	m_psm[PSM_PSMCT16S].fmt = m_psm[PSM_PSMZ16S].fmt = 2;
+
+
+	m_psm[PSM_PSGPU24].bs = GSVector2i(16, 8);
+	m_psm[PSM_PSMCT16].bs = m_psm[PSM_PSMCT16S].bs = GSVector2i(16, 8);
+	m_psm[PSM_PSMT8].bs = GSVector2i(16, 16);
+	m_psm[PSM_PSMT4].bs = GSVector2i(32, 16);
+	m_psm[PSM_PSMZ16].bs = m_psm[PSM_PSMZ16S].bs = GSVector2i(16, 8);
+
+	m_psm[PSM_PSGPU24].pgs = GSVector2i(64, 64);
+	m_psm[PSM_PSMCT16].pgs = m_psm[PSM_PSMCT16S].pgs = GSVector2i(64, 64);
+	m_psm[PSM_PSMT8].pgs = GSVector2i(128, 64);
+	m_psm[PSM_PSMT4].pgs = GSVector2i(128, 128);
+	m_psm[PSM_PSMZ16].pgs = m_psm[PSM_PSMZ16S].pgs = GSVector2i(64, 64);
+
+	m_psm[PSM_PSMCT24].msk = 0x3f;
+	m_psm[PSM_PSMZ24].msk = 0x3f;
+	m_psm[PSM_PSMT8H].msk = 0xc0;
+	m_psm[PSM_PSMT4HL].msk = 0x40;
+	m_psm[PSM_PSMT4HH].msk = 0x80;
+
+	m_psm[PSM_PSMZ32].depth  = 1;
+	m_psm[PSM_PSMZ24].depth  = 1;
+	m_psm[PSM_PSMZ16].depth  = 1;
+	m_psm[PSM_PSMZ16S].depth = 1;
+}
+
+//
+
+/// Helper for WriteImageX and ReadImageX
+/// `len` is in pixels, unlike WriteImageX/ReadImageX where it's bytes
+/// `xinc` is the amount to increment `x` by per iteration
+/// Calls `paGetter` on a starting (x, y) to get some sort of pixel address helper for each line,
+///  then `fn` on the helper and an x offset once for every `xinc` pixels along that line
+template <typename PAGetter, typename Fn>
+static void readWriteHelperImpl(int& tx, int& ty, int len, int xinc, int sx, int w, PAGetter&& paGetter, Fn&& fn)
+{
+	int y = ty;
+	int ex = sx + w;
+	int remX = ex - tx;
+
+	ASSERT(remX >= 0);
+
+	auto pa = paGetter(tx, y);
+
+	while (len > 0)
+	{
+		int stop = std::min(remX, len);
+		len -= stop;
+		remX -= stop;
+
+		for (int x = 0; x < stop; x += xinc)
+			fn(pa, x);
+
+		if (remX == 0)
+		{
+			y++;
+			remX = w;
+			pa = paGetter(sx, y);
+		}
+	}
+
+	tx = ex - remX;
+	ty = y;
+}
+
+/// Helper for WriteImageX and ReadImageX
+/// `len` is in pixels, unlike WriteImageX/ReadImageX where it's bytes
+/// `xinc` is the amount to increment `x` by per iteration
+/// Calls `fn` with a `PAHelper` representing the current line and an int representing the x offset in that line
+template <typename Fn>
+static void readWriteHelper(int& tx, int& ty, int len, int xinc, int sx, int w, const GSOffset& off, Fn&& fn)
+{
+	readWriteHelperImpl(tx, ty, len, xinc, sx, w, [&](int x, int y){ return off.paMulti(x, y); }, std::forward<Fn>(fn));
+}
+
+/// Helper for WriteImageX and ReadImageX
+/// `len` is in pixels, unlike WriteImageX/ReadImageX where it's bytes
+/// `xinc` is the amount to increment `x` by per iteration
+/// Calls `fn` with a `PAPtrHelper` representing the current line and an int representing the x offset in that line
+template <typename VM, typename Fn>
+static void readWriteHelper(VM* vm, int& tx, int& ty, int len, int xinc, int sx, int w, const GSOffset& off, Fn&& fn)
+{
+	readWriteHelperImpl(tx, ty, len, xinc, sx, w, [&](int x, int y){ return off.paMulti(vm, x, y); }, std::forward<Fn>(fn));
+}
+
+void GSLocalMemory::WriteImageX(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if (len <= 0)
+		return;
+
+	const uint8* pb = (uint8*)src;
+	const uint16* pw = (uint16*)src;
+	const uint32* pd = (uint32*)src;
+
+	uint32 bp = BITBLTBUF.DBP;
+	uint32 bw = BITBLTBUF.DBW;
+
+	int sx = TRXPOS.DSAX;
+	int w = TRXREG.RRW;
+
+	GSOffset off = GetOffset(bp, bw, BITBLTBUF.DPSM);
+
+	switch (BITBLTBUF.DPSM)
+	{
+		case PSM_PSMCT32:
+		case PSM_PSMZ32:
+			readWriteHelper(m_vm32, tx, ty, len / 4, 1, sx, w, off.assertSizesMatch(swizzle32), [&](auto& pa, int x)
+			{
+				*pa.value(x) = *pd;
+				pd++;
+			});
+			break;
+
+		case PSM_PSMCT24:
+		case PSM_PSMZ24:
+			readWriteHelper(m_vm32, tx, ty, len / 3, 1, sx, w, off.assertSizesMatch(swizzle32), [&](auto& pa, int x)
+			{
+				WritePixel24(pa.value(x), *(uint32*)pb);
+				pb += 3;
+			});
+			break;
+
+		case PSM_PSMCT16:
+		case PSM_PSMCT16S:
+		case PSM_PSMZ16:
+		case PSM_PSMZ16S:
+			readWriteHelper(m_vm16, tx, ty, len / 2, 1, sx, w, off.assertSizesMatch(swizzle16), [&](auto& pa, int x)
+			{
+				*pa.value(x) = *pw;
+				pw++;
+			});
+			break;
+
+		case PSM_PSMT8:
+			readWriteHelper(m_vm8, tx, ty, len, 1, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT8), [&](auto& pa, int x)
+			{
+				*pa.value(x) = *pb;
+				pb++;
+			});
+			break;
+
+		case PSM_PSMT4:
+			readWriteHelper(tx, ty, len * 2, 2, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT4), [&](GSOffset::PAHelper& pa, int x)
+			{
+				WritePixel4(pa.value(x), *pb & 0xf);
+				WritePixel4(pa.value(x + 1), *pb >> 4);
+				pb++;
+			});
+			break;
+
+		case PSM_PSMT8H:
+			readWriteHelper(m_vm32, tx, ty, len, 1, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT8H), [&](auto& pa, int x)
+			{
+				WritePixel8H(pa.value(x), *pb);
+				pb++;
+			});
+			break;
+
+		case PSM_PSMT4HL:
+			readWriteHelper(m_vm32, tx, ty, len * 2, 2, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT4HL), [&](auto& pa, int x)
+			{
+				WritePixel4HL(pa.value(x), *pb & 0xf);
+				WritePixel4HL(pa.value(x + 1), *pb >> 4);
+				pb++;
+			});
+			break;
+
+		case PSM_PSMT4HH:
+			readWriteHelper(m_vm32, tx, ty, len * 2, 2, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT4HH), [&](auto& pa, int x)
+			{
+				WritePixel4HH(pa.value(x), *pb & 0xf);
+				WritePixel4HH(pa.value(x + 1), *pb >> 4);
+				pb++;
+			});
+			break;
+	}
+}
+
+//
+
+void GSLocalMemory::ReadImageX(int& tx, int& ty, uint8* dst, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG) const
+{
+	if (len <= 0)
+		return;
+
+	uint8* RESTRICT pb = (uint8*)dst;
+	uint16* RESTRICT pw = (uint16*)dst;
+	uint32* RESTRICT pd = (uint32*)dst;
+
+	uint32 bp = BITBLTBUF.SBP;
+	uint32 bw = BITBLTBUF.SBW;
+
+	int sx = TRXPOS.SSAX;
+	int w = TRXREG.RRW;
+
+	GSOffset off = GetOffset(bp, bw, BITBLTBUF.SPSM);
+
+	// printf("spsm=%d x=%d ex=%d y=%d len=%d\n", BITBLTBUF.SPSM, x, ex, y, len);
+
+	switch (BITBLTBUF.SPSM)
+	{
+		case PSM_PSMCT32:
+		case PSM_PSMZ32:
+		{
+			// MGS1 intro, fade effect between two scenes (airplane outside-inside transition)
+
+			int x = tx;
+			int y = ty;
+			int ex = sx + w;
+
+			len /= 4;
+
+			GSOffset::PAPtrHelper pa = off.assertSizesMatch(swizzle32).paMulti(m_vm32, 0, y);
+
+			while (len > 0)
+			{
+				for (; len > 0 && x < ex && (x & 7); len--, x++, pd++)
+				{
+					*pd = *pa.value(x);
+				}
+
+				// aligned to a column
+
+				for (int ex8 = ex - 8; len >= 8 && x <= ex8; len -= 8, x += 8, pd += 8)
+				{
+					uint32* ps = pa.value(x);
+
+					GSVector4i::store<false>(&pd[0], GSVector4i::load(ps + 0, ps + 4));
+					GSVector4i::store<false>(&pd[4], GSVector4i::load(ps + 8, ps + 12));
+
+					for (int i = 0; i < 8; i++)
+						ASSERT(pd[i] == *pa.value(x + i));
+				}
+
+				for (; len > 0 && x < ex; len--, x++, pd++)
+				{
+					*pd = *pa.value(x);
+				}
+
+				if (x == ex)
+				{
+					y++;
+					x = sx;
+					pa = off.assertSizesMatch(swizzle32).paMulti(m_vm32, 0, y);
+				}
+			}
+
+			tx = x;
+			ty = y;
+		}
+		break;
+
+		case PSM_PSMCT24:
+		case PSM_PSMZ24:
+			readWriteHelper(m_vm32, tx, ty, len / 3, 1, sx, w, off.assertSizesMatch(swizzle32), [&](auto& pa, int x)
+			{
+				uint32 c = *pa.value(x);
+				pb[0] = (uint8)(c);
+				pb[1] = (uint8)(c >> 8);
+				pb[2] = (uint8)(c >> 16);
+				pb += 3;
+			});
+			break;
+
+		case PSM_PSMCT16:
+		case PSM_PSMCT16S:
+		case PSM_PSMZ16:
+		case PSM_PSMZ16S:
+			readWriteHelper(m_vm16, tx, ty, len / 2, 1, sx, w, off.assertSizesMatch(swizzle16), [&](auto& pa, int x)
+			{
+				*pw = *pa.value(x);
+				pw++;
+			});
+			break;
+
+		case PSM_PSMT8:
+			readWriteHelper(m_vm8, tx, ty, len, 1, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT8), [&](auto& pa, int x)
+			{
+				*pb = *pa.value(x);
+				pb++;
+			});
+			break;
+
+		case PSM_PSMT4:
+			readWriteHelper(tx, ty, len * 2, 2, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT4), [&](GSOffset::PAHelper& pa, int x)
+			{
+				uint8 low = ReadPixel4(pa.value(x));
+				uint8 high = ReadPixel4(pa.value(x + 1));
+				*pb = low | (high << 4);
+			});
+			break;
+
+		case PSM_PSMT8H:
+			readWriteHelper(m_vm32, tx, ty, len, 1, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT8H), [&](auto& pa, int x)
+			{
+				*pb = (uint8)(*pa.value(x) >> 24);
+				pb++;
+			});
+			break;
+
+		case PSM_PSMT4HL:
+			readWriteHelper(m_vm32, tx, ty, len * 2, 2, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT4HL), [&](auto& pa, int x)
+			{
+				uint32 c0 = *pa.value(x) >> 24 & 0x0f;
+				uint32 c1 = *pa.value(x + 1) >> 20 & 0xf0;
+				*pb = (uint8)(c0 | c1);
+				pb++;
+			});
+			break;
+
+		case PSM_PSMT4HH:
+			readWriteHelper(m_vm32, tx, ty, len * 2, 2, sx, w, GSOffset::fromKnownPSM(bp, bw, PSM_PSMT4HH), [&](auto& pa, int x)
+			{
+				uint32 c0 = *pa.value(x) >> 28 & 0x0f;
+				uint32 c1 = *pa.value(x + 1) >> 24 & 0xf0;
+				*pb = (uint8)(c0 | c1);
+				pb++;
+			});
+			break;
+	}
+}
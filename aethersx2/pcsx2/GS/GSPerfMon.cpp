@@ -27,6 +27,7 @@ GSPerfMon::GSPerfMon()
 {
 	memset(m_counters, 0, sizeof(m_counters));
 	memset(m_stats, 0, sizeof(m_stats));
+	memset(m_totals, 0, sizeof(m_totals));
 	memset(m_timer_stats, 0, sizeof(m_timer_stats));
 	memset(m_total, 0, sizeof(m_total));
 	memset(m_begin, 0, sizeof(m_begin));
@@ -38,6 +39,11 @@ void GSPerfMon::EndFrame()
 	m_count++;
 }
 
+void GSPerfMon::ResetTotals()
+{
+	memset(m_totals, 0, sizeof(m_totals));
+}
+
 void GSPerfMon::Update()
 {
 #ifndef DISABLE_PERF_MON
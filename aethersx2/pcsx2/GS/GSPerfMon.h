@@ -40,16 +40,23 @@ public:
 		Fillrate,
 		Quad,
 		SyncPoint,
+		QueuePush,
+		QueuePark,
+		QueueSpin,
 		CounterLast,
 
 		// Reused counters for HW.
 		TextureCopies = Fillrate,
 		TextureUploads = SyncPoint,
+		TextureHashHits = QueuePush,
+		TextureHashMisses = QueuePark,
+		TextureHashSaved = QueueSpin,
 	};
 
 protected:
 	double m_counters[CounterLast];
 	double m_stats[CounterLast];
+	double m_totals[CounterLast];
 	float m_timer_stats[TimerLast];
 	uint64 m_begin[TimerLast], m_total[TimerLast], m_start[TimerLast];
 	uint64 m_frame;
@@ -65,8 +72,14 @@ public:
 	uint64 GetFrame() { return m_frame; }
 	void EndFrame();
 
-	void Put(counter_t c, double val = 0) { m_counters[c] += val; }
+	void Put(counter_t c, double val = 0)
+	{
+		m_counters[c] += val;
+		m_totals[c] += val;
+	}
 	double Get(counter_t c) { return m_stats[c]; }
+	double GetTotal(counter_t c) { return m_totals[c]; }
+	void ResetTotals();
 	float GetTimer(timer_t t) { return m_timer_stats[t]; }
 	void Update();
 
@@ -17,6 +17,7 @@
 #include "GSState.h"
 #include "GS.h"
 #include "GSUtil.h"
+#include "common/Timer.h"
 
 #include <algorithm> // clamp
 
@@ -31,6 +32,7 @@ GSState::GSState()
 	, m_vt(this)
 	, m_regs(NULL)
 	, m_crc(0)
+	, m_draw_timings(nullptr)
 	, m_options(0)
 	, m_frameskip(0)
 {
@@ -1438,6 +1440,8 @@ void GSState::FlushPrim()
 
 		m_context->SaveReg();
 
+		const Common::Timer::Value draw_start = m_draw_timings ? Common::Timer::GetCurrentValue() : 0;
+
 		try
 		{
 			Draw();
@@ -1455,6 +1459,12 @@ void GSState::FlushPrim()
 
 		m_context->RestoreReg();
 
+		if (m_draw_timings)
+		{
+			const double ns = Common::Timer::ConvertValueToNanoseconds(Common::Timer::GetCurrentValue() - draw_start);
+			m_draw_timings->push_back({static_cast<uint32>(s_n), PRIM->PRIM, static_cast<uint32>(m_index.tail), static_cast<uint64>(ns)});
+		}
+
 		g_perfmon.Put(GSPerfMon::Draw, 1);
 		g_perfmon.Put(GSPerfMon::Prim, m_index.tail / GSUtil::GetVertexCount(PRIM->PRIM));
 
@@ -42,6 +42,16 @@ struct GSFrameInfo
 
 typedef bool (*GetSkipCount)(const GSFrameInfo& fi, int& skip);
 
+// Time spent in Draw() on the GS thread for one flushed primitive batch. With the SW renderer and
+// extra threads, this only covers setup and queueing, rasterization shows up in the selector ticks.
+struct GSDrawTiming
+{
+	uint32 draw;
+	uint32 prim;
+	uint32 vertices;
+	uint64 ns;
+};
+
 class GSState : public GSAlignedClass<32>
 {
 	// RESTRICT prevents multiple loads of the same part of the register when accessing its bitfields (the compiler is happy to know that memory writes in-between will not go there)
@@ -204,6 +214,7 @@ public:
 	uint32 m_crc;
 	CRC::Game m_game;
 	std::unique_ptr<GSDumpBase> m_dump;
+	std::vector<GSDrawTiming>* m_draw_timings;
 	int m_options;
 	int m_frameskip;
 	bool m_NTSC_Saturation;
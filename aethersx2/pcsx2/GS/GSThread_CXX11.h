@@ -19,6 +19,12 @@
 #include "common/boost_spsc_queue.hpp"
 #include "common/General.h"
 
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 template <class T, int CAPACITY>
 class GSJobQueue final
 {
@@ -132,3 +138,291 @@ public:
 		m_func(item);
 	}
 };
+
+// Futex-style wait/wake on a 32-bit sequence number. A waiter only sleeps while the
+// sequence still has the value it observed, so a wake racing with the wait is never lost.
+class GSWaitWord final
+{
+private:
+	std::atomic<uint32> m_value;
+
+#ifndef __linux__
+	std::mutex m_lock;
+	std::condition_variable m_cv;
+#endif
+
+public:
+	GSWaitWord()
+		: m_value(0)
+	{
+		static_assert(sizeof(m_value) == sizeof(uint32), "futex word must be 32 bits");
+	}
+
+	uint32 Load() const
+	{
+		return m_value.load(std::memory_order_acquire);
+	}
+
+	void Wait(uint32 expected)
+	{
+#ifdef __linux__
+		syscall(SYS_futex, reinterpret_cast<uint32*>(&m_value), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+		std::unique_lock<std::mutex> l(m_lock);
+		while (m_value.load(std::memory_order_acquire) == expected)
+			m_cv.wait(l);
+#endif
+	}
+
+	void WakeAll()
+	{
+#ifdef __linux__
+		m_value.fetch_add(1, std::memory_order_release);
+		syscall(SYS_futex, reinterpret_cast<uint32*>(&m_value), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+		{
+			std::lock_guard<std::mutex> l(m_lock);
+			m_value.fetch_add(1, std::memory_order_release);
+		}
+		m_cv.notify_all();
+#endif
+	}
+};
+
+// Single producer, multiple consumer queue where every consumer sees every item.
+// Pushing never takes a lock; consumers spin for an adaptive amount of time once they
+// run dry and then park on a futex, and the producer only makes a syscall when someone
+// is actually parked. An item is released by whichever consumer is the last to see it.
+template <class T, int CAPACITY>
+class GSBroadcastQueue final
+{
+	static_assert((CAPACITY & (CAPACITY - 1)) == 0, "capacity must be a power of two");
+
+public:
+	struct Stats
+	{
+		uint64 pushes;
+		uint64 parks;
+		uint64 spin_ns;
+	};
+
+private:
+	static constexpr uint32 MIN_SPIN_NS = 2 * 1000;
+
+	struct Slot
+	{
+		T item;
+		// Consumers yet to run the item, plus one until the last of them released it.
+		// 0 when the slot is free.
+		std::atomic<int> remaining;
+	};
+
+	struct alignas(64) Consumer
+	{
+		std::thread thread;
+		std::atomic<size_t> read;
+		uint32 spin_ns;
+	};
+
+	std::function<void(int, T&)> m_func;
+	std::unique_ptr<Slot[]> m_slots;
+	std::unique_ptr<Consumer[]> m_consumers;
+	int m_count;
+
+	alignas(64) std::atomic<size_t> m_write;
+	std::atomic<bool> m_exit;
+
+	alignas(64) std::atomic<int> m_parked;
+	std::atomic<int> m_waiters;
+	GSWaitWord m_pushed;
+	GSWaitWord m_drained;
+
+	alignas(64) std::atomic<uint64> m_pushes;
+	std::atomic<uint64> m_parks;
+	std::atomic<uint64> m_spin_ns;
+
+	void ThreadProc(int id)
+	{
+		Consumer& c = m_consumers[id];
+
+		size_t read = c.read.load(std::memory_order_relaxed);
+
+		while (true)
+		{
+			uint32 waited = 0;
+
+			while (read == m_write.load(std::memory_order_acquire) && waited < c.spin_ns)
+				waited += ShortSpin();
+
+			if (waited > 0)
+				m_spin_ns.fetch_add(waited, std::memory_order_relaxed);
+
+			size_t write = m_write.load(std::memory_order_acquire);
+
+			if (read == write)
+			{
+				// Spun for nothing, so spin less next time.
+				c.spin_ns = std::max<uint32>(c.spin_ns / 2, MIN_SPIN_NS);
+
+				const uint32 seq = m_pushed.Load();
+
+				m_parked.fetch_add(1);
+
+				if (read == m_write.load())
+				{
+					if (m_exit.load(std::memory_order_acquire))
+					{
+						m_parked.fetch_sub(1);
+						return;
+					}
+
+					m_parks.fetch_add(1, std::memory_order_relaxed);
+					m_pushed.Wait(seq);
+				}
+
+				m_parked.fetch_sub(1);
+
+				continue;
+			}
+
+			if (waited > 0)
+			{
+				// Work showed up while spinning, spinning a bit longer would have avoided a park.
+				c.spin_ns = std::min<uint32>(c.spin_ns * 2, SPIN_TIME_NS * 4);
+			}
+
+			do
+			{
+				Slot& slot = m_slots[read & (CAPACITY - 1)];
+
+				m_func(id, slot.item);
+
+				// The last consumer takes the count down to 1, releases the item and only then
+				// hands the slot back to the producer, which may overwrite it as soon as it sees 0.
+				if (slot.remaining.fetch_sub(1, std::memory_order_acq_rel) == 2)
+				{
+					slot.item = T();
+					slot.remaining.store(0, std::memory_order_release);
+				}
+
+				c.read.store(++read, std::memory_order_release);
+			} while (read != write);
+
+			c.read.store(read);
+
+			if (m_waiters.load() > 0)
+				m_drained.WakeAll();
+		}
+	}
+
+public:
+	GSBroadcastQueue(int consumers, std::function<void(int, T&)> func)
+		: m_func(func)
+		, m_slots(new Slot[CAPACITY])
+		, m_consumers(new Consumer[consumers])
+		, m_count(consumers)
+		, m_write(0)
+		, m_exit(false)
+		, m_parked(0)
+		, m_waiters(0)
+		, m_pushes(0)
+		, m_parks(0)
+		, m_spin_ns(0)
+	{
+		for (int i = 0; i < CAPACITY; i++)
+			m_slots[i].remaining.store(0, std::memory_order_relaxed);
+
+		for (int i = 0; i < m_count; i++)
+		{
+			m_consumers[i].read.store(0, std::memory_order_relaxed);
+			m_consumers[i].spin_ns = SPIN_TIME_NS;
+		}
+
+		for (int i = 0; i < m_count; i++)
+			m_consumers[i].thread = std::thread(&GSBroadcastQueue::ThreadProc, this, i);
+	}
+
+	~GSBroadcastQueue()
+	{
+		m_exit.store(true);
+		m_pushed.WakeAll();
+
+		for (int i = 0; i < m_count; i++)
+			m_consumers[i].thread.join();
+	}
+
+	bool IsEmpty() const
+	{
+		const size_t write = m_write.load(std::memory_order_acquire);
+
+		for (int i = 0; i < m_count; i++)
+		{
+			if (m_consumers[i].read.load() != write)
+				return false;
+		}
+
+		return true;
+	}
+
+	void Push(const T& item)
+	{
+		Push(&item, 1);
+	}
+
+	// Publishes all items at once, waking the parked consumers a single time.
+	void Push(const T* items, size_t count)
+	{
+		size_t write = m_write.load(std::memory_order_relaxed);
+
+		for (size_t i = 0; i < count; i++, write++)
+		{
+			Slot& slot = m_slots[write & (CAPACITY - 1)];
+
+			while (slot.remaining.load(std::memory_order_acquire) != 0)
+				std::this_thread::yield();
+
+			slot.item = items[i];
+			slot.remaining.store(m_count + 1, std::memory_order_relaxed);
+		}
+
+		m_write.store(write);
+		m_pushes.fetch_add(count, std::memory_order_relaxed);
+
+		if (m_parked.load() > 0)
+			m_pushed.WakeAll();
+	}
+
+	void Wait()
+	{
+		uint32 waited = 0;
+
+		while (!IsEmpty())
+		{
+			if (waited >= SPIN_TIME_NS)
+				break;
+
+			waited += ShortSpin();
+		}
+
+		while (!IsEmpty())
+		{
+			const uint32 seq = m_drained.Load();
+
+			m_waiters.fetch_add(1);
+
+			if (!IsEmpty())
+				m_drained.Wait(seq);
+
+			m_waiters.fetch_sub(1);
+		}
+	}
+
+	Stats ResetStats()
+	{
+		Stats stats;
+		stats.pushes = m_pushes.exchange(0, std::memory_order_relaxed);
+		stats.parks = m_parks.exchange(0, std::memory_order_relaxed);
+		stats.spin_ns = m_spin_ns.exchange(0, std::memory_order_relaxed);
+		return stats;
+	}
+};
@@ -184,6 +184,20 @@ bool GSUtil::CheckSSE()
 	return status;
 }
 
+GSVectorISA GSUtil::GetBestVectorISA()
+{
+#if defined(_M_X86_32) || defined(_M_X86_64)
+	if (g_cpu.has(Xbyak::util::Cpu::tAVX2))
+		return GSVectorISA::AVX2;
+
+	if (g_cpu.has(Xbyak::util::Cpu::tAVX))
+		return GSVectorISA::AVX;
+#endif
+
+	// Never below what the rest of the binary already requires.
+	return GS_CURRENT_ISA;
+}
+
 CRCHackLevel GSUtil::GetRecommendedCRCHackLevel(GSRendererType type)
 {
 	return type == GSRendererType::OGL ? CRCHackLevel::Partial : CRCHackLevel::Full;
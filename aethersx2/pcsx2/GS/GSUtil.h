@@ -37,6 +37,7 @@ public:
 	static bool HasCompatibleBits(uint32 spsm, uint32 dpsm);
 
 	static bool CheckSSE();
+	static GSVectorISA GetBestVectorISA();
 	static CRCHackLevel GetRecommendedCRCHackLevel(GSRendererType type);
 };
 
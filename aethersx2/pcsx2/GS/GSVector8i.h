@@ -596,6 +596,12 @@ public:
 		//return GSVector8i(_mm256_slli_si128(m, i));
 	}
 
+	template <int i>
+	__forceinline GSVector8i sra16() const
+	{
+		return GSVector8i(_mm256_srai_epi16(m, i));
+	}
+
 	__forceinline GSVector8i sra16(int i) const
 	{
 		return GSVector8i(_mm256_srai_epi16(m, i));
@@ -127,3 +127,33 @@ extern void vmfree(void* ptr, size_t size);
 
 #endif
 #endif
+
+// Vector ISA levels the GS kernels can be built for. GS_CURRENT_ISA is the one of the current translation unit,
+// only GSLocalMemoryMultiISA.cpp is built for more than one level (GS_MULTI_ISA).
+enum class GSVectorISA
+{
+	SSE4,
+	AVX,
+	AVX2,
+};
+
+#if _M_SSE >= 0x501
+	#define GS_CURRENT_ISA GSVectorISA::AVX2
+#elif _M_SSE >= 0x500
+	#define GS_CURRENT_ISA GSVectorISA::AVX
+#else
+	#define GS_CURRENT_ISA GSVectorISA::SSE4
+#endif
+
+// Code that is built once per ISA goes between MULTI_ISA_UNSHARED_START/END, in a namespace named after GS_CURRENT_ISA,
+// so the objects of a GS_MULTI_ISA build never define the same symbol with different code.
+#if _M_SSE >= 0x501
+	#define GS_ISA_NAMESPACE GSISA_AVX2
+#elif _M_SSE >= 0x500
+	#define GS_ISA_NAMESPACE GSISA_AVX
+#else
+	#define GS_ISA_NAMESPACE GSISA_SSE4
+#endif
+
+#define MULTI_ISA_UNSHARED_START namespace GS_ISA_NAMESPACE {
+#define MULTI_ISA_UNSHARED_END }
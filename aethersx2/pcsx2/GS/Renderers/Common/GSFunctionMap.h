@@ -112,6 +112,12 @@ public:
 		}
 	}
 
+	void GetTicks(std::unordered_map<KEY, uint64>& ticks) const
+	{
+		for (const auto& i : m_map_active)
+			ticks[i.first] += i.second->ticks;
+	}
+
 	virtual void PrintStats()
 	{
 		uint64 totalTicks = 0;
@@ -204,6 +210,7 @@ class GSCodeGeneratorFunctionMap : public GSFunctionMap<KEY, VALUE>
 	std::unordered_map<uint64, VALUE> m_cgmap;
 	GSCodeBuffer m_cb;
 	size_t m_total_code_size;
+	std::mutex m_lock; // functions can be generated ahead of time from another thread
 
 	enum { MAX_SIZE = 8192 };
 
@@ -224,6 +231,8 @@ public:
 
 	VALUE GetDefaultFunction(KEY key)
 	{
+		std::lock_guard<std::mutex> lock(m_lock);
+
 		VALUE ret = NULL;
 
 		auto i = m_cgmap.find(key);
@@ -298,5 +307,10 @@ public:
 
 		return ret;
 	}
+
+	void Pregenerate(KEY key)
+	{
+		GetDefaultFunction(key);
+	}
 };
 
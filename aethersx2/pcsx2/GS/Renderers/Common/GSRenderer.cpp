@@ -18,11 +18,15 @@
 #include "Host.h"
 #include "HostDisplay.h"
 #include "pcsx2/Config.h"
+#include "pcsx2/Rewind.h"
 #include "common/StringUtil.h"
 #if defined(__unix__) && !defined(__ANDROID__)
 #include <X11/keysym.h>
 #endif
 
+// x86/ix86-32/iR5900-32.cpp
+extern void recRequestBlockProfileDump();
+
 const unsigned int s_interlace_nb = 8;
 const unsigned int s_post_shader_nb = 5;
 const unsigned int s_mipmap_nb = 3;
@@ -492,6 +496,7 @@ void GSRenderer::KeyEvent(const HostKeyEvent& e)
 #define VK_PRIOR XK_Prior
 #define VK_NEXT XK_Next
 #define VK_HOME XK_Home
+#define VK_BACK XK_BackSpace
 #endif
 
 		switch (e.key)
@@ -501,6 +506,9 @@ void GSRenderer::KeyEvent(const HostKeyEvent& e)
 				theApp.SetConfig("interlace", m_interlace);
 				printf("GS: Set deinterlace mode to %d (%s).\n", m_interlace, theApp.m_gs_interlace.at(m_interlace).name.c_str());
 				return;
+			case VK_F6:
+				recRequestBlockProfileDump();
+				return;
 			case VK_DELETE:
 				m_aa1 = !m_aa1;
 				theApp.SetConfig("aa1", m_aa1);
@@ -511,6 +519,13 @@ void GSRenderer::KeyEvent(const HostKeyEvent& e)
 				theApp.SetConfig("mipmap_hw", m_mipmap);
 				printf("GS: Mipmapping is now %s.\n", theApp.m_gs_hack.at(m_mipmap).name.c_str());
 				return;
+			case VK_BACK:
+				// The CPU thread picks the request up at its next state check.
+				if (m_shift_key)
+					Rewind::LogStats();
+				else
+					Rewind::RequestLoadPrevious();
+				return;
 			case VK_NEXT: // As requested by Prafull, to be removed later
 				char dither_msg[3][16] = {"disabled", "auto", "auto unscaled"};
 				m_dithering = (m_dithering + 1) % 3;
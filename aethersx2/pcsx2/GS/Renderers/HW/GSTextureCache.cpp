@@ -25,10 +25,13 @@
 bool GSTextureCache::m_disable_partial_invalidation = false;
 bool GSTextureCache::m_wrap_gs_mem = false;
 bool GSTextureCache::m_preload_texture = false;
+bool GSTextureCache::m_texture_hash_cache = false;
 
 GSTextureCache::GSTextureCache(GSRenderer* r)
 	: m_renderer(r)
 	, m_palette_map(r)
+	, m_hash_cache(r)
+	, m_decoder(theApp.GetConfigI("texture_decode_threads"))
 {
 	if (theApp.GetConfigB("UserHacks"))
 	{
@@ -53,6 +56,8 @@ GSTextureCache::GSTextureCache(GSRenderer* r)
 
 	m_paltex = theApp.GetConfigB("paltex");
 	m_preload_texture = theApp.GetConfigB("preload_texture");
+	m_texture_hash_cache = theApp.GetConfigB("texture_hash_cache");
+	m_src.m_hash_cache = m_texture_hash_cache ? &m_hash_cache : nullptr;
 	m_crc_hack_level = theApp.GetConfigT<CRCHackLevel>("crc_hack_level");
 	if (m_crc_hack_level == CRCHackLevel::Automatic)
 		m_crc_hack_level = GSUtil::GetRecommendedCRCHackLevel(GSConfig.Renderer);
@@ -90,6 +95,7 @@ void GSTextureCache::RemovePartial()
 void GSTextureCache::RemoveAll()
 {
 	m_src.RemoveAll();
+	m_hash_cache.Clear();
 
 	for (int type = 0; type < 2; type++)
 	{
@@ -914,8 +920,28 @@ void GSTextureCache::InvalidateVideoMem(const GSOffset& off, const GSVector4i& r
 							valid[page] = 0;
 						}
 
+						// Same for the blocks the content hash was taken from.
+						if (!s->m_hashed.empty())
+						{
+							uint32* RESTRICT hashed = s->m_hashed.data();
+
+							if (s->m_repeating)
+							{
+								for (const GSVector2i& k : s->m_p2t[page])
+									hashed[k.x] &= k.y;
+							}
+							else
+							{
+								hashed[page] = 0;
+							}
+						}
+
 						s->m_complete = false;
 
+						// The texture still holds the hashed data (if any), but a partially uploaded one never will.
+						if (s->m_content_hash_state == ContentHashState::Pending)
+							s->m_content_hash_state = ContentHashState::None;
+
 						found |= b;
 					}
 				}
@@ -1250,6 +1276,8 @@ void GSTextureCache::IncAge()
 
 	m_src.m_used = false;
 
+	m_hash_cache.IncAge();
+
 	// Clearing of Rendertargets causes flickering in many scene transitions.
 	// Sigh, this seems to be used to invalidate surfaces. So set a huge maxage to avoid flicker,
 	// but still invalidate surfaces. (Disgaea 2 fmv when booting the game through the BIOS)
@@ -1295,6 +1323,7 @@ GSTextureCache::Source* GSTextureCache::CreateSource(const GIFRegTEX0& TEX0, con
 {
 	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[TEX0.PSM];
 	Source* src = new Source(m_renderer, TEX0, TEXA, m_temp);
+	src->m_decoder = &m_decoder;
 
 	int tw = 1 << TEX0.TW;
 	int th = 1 << TEX0.TH;
@@ -1617,20 +1646,36 @@ GSTextureCache::Source* GSTextureCache::CreateSource(const GIFRegTEX0& TEX0, con
 	}
 	else
 	{
-		if (m_paltex && psm.pal > 0)
-		{
-			src->m_texture = m_renderer->m_dev->CreateTexture(tw, th, Get8bitFormat());
-			AttachPaletteToSource(src, psm.pal, true);
-		}
-		else
+		const bool paltex = m_paltex && psm.pal > 0;
+
+		// The palette is attached first, the hash covers the CLUT when it is expanded on the CPU.
+		if (psm.pal > 0)
+			AttachPaletteToSource(src, psm.pal, paltex);
+
+		if (m_texture_hash_cache)
 		{
-			src->m_texture = m_renderer->m_dev->CreateTexture(tw, th);
+			src->m_content_hash = src->HashContent();
+			src->m_texture = m_hash_cache.Lookup(src->GetHashCacheKey());
+
+			if (src->m_texture)
+			{
+				GL_CACHE("TC: src hash hit: %d (0x%x, %s)", src->m_texture->GetID(), TEX0.TBP0, psm_str(TEX0.PSM));
+				g_perfmon.Put(GSPerfMon::TextureHashHits, 1);
+				g_perfmon.Put(GSPerfMon::TextureHashSaved, src->GetUploadSize());
 
-			if (psm.pal > 0)
+				src->m_content_hash_state = ContentHashState::Valid;
+				src->m_complete = true;
+			}
+			else
 			{
-				AttachPaletteToSource(src, psm.pal, false);
+				g_perfmon.Put(GSPerfMon::TextureHashMisses, 1);
+
+				src->m_content_hash_state = ContentHashState::Pending;
 			}
 		}
+
+		if (!src->m_texture)
+			src->m_texture = paltex ? m_renderer->m_dev->CreateTexture(tw, th, Get8bitFormat()) : m_renderer->m_dev->CreateTexture(tw, th);
 	}
 
 	ASSERT(src->m_texture);
@@ -1694,7 +1739,17 @@ void GSTextureCache::PrintMemoryUsage()
 			dss += t->m_texture->GetMemUsage();
 	}
 
-	GL_PERF("MEM: RO Tex %dMB. RW Tex %dMB. Target %dMB. Depth %dMB", tex >> 20u, tex_rt >> 20u, rt >> 20u, dss >> 20u);
+	GL_PERF("MEM: RO Tex %dMB. RW Tex %dMB. Target %dMB. Depth %dMB. Hash cache %dMB", tex >> 20u, tex_rt >> 20u, rt >> 20u, dss >> 20u,
+		m_hash_cache.GetMemoryUsage() >> 20u);
+
+	if (m_texture_hash_cache)
+	{
+		const double hits = g_perfmon.GetTotal(GSPerfMon::TextureHashHits);
+		const double lookups = hits + g_perfmon.GetTotal(GSPerfMon::TextureHashMisses);
+
+		GL_PERF("TC hash: %.0f hits for %.0f lookups (%.1f%%), %.1fMB uploads saved", hits, lookups,
+			lookups > 0.0 ? hits * 100.0 / lookups : 0.0, g_perfmon.GetTotal(GSPerfMon::TextureHashSaved) / (1024.0 * 1024.0));
+	}
 #endif
 }
 
@@ -1752,6 +1807,10 @@ GSTextureCache::Source::Source(GSRenderer* r, const GIFRegTEX0& TEX0, const GIFR
 	, m_p2t(NULL)
 	, m_from_target(NULL)
 	, m_from_target_TEX0(TEX0)
+	, m_content_hash(0)
+	, m_content_hash_state(ContentHashState::None)
+	, m_block_hash_sum(0)
+	, m_decoder(nullptr)
 {
 	m_TEX0 = TEX0;
 	m_TEXA = TEXA;
@@ -1799,7 +1858,30 @@ void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
 	{
 		return;
 	}
-	
+
+	if (layer == 0 && m_content_hash_state == ContentHashState::Valid)
+	{
+		// Invalidated, but the texture may already hold what was written back (data streamed
+		// again every frame). Otherwise it is about to be partially overwritten.
+		const uint64 hash = HashContent();
+		if (hash == m_content_hash)
+		{
+			g_perfmon.Put(GSPerfMon::TextureHashHits, 1);
+			g_perfmon.Put(GSPerfMon::TextureHashSaved, GetUploadSize());
+
+			if (!m_repeating)
+				m_pages.loopPages([this](uint32 page) { m_valid[page] = 0xffffffff; });
+
+			m_complete = true;
+			return;
+		}
+
+		g_perfmon.Put(GSPerfMon::TextureHashMisses, 1);
+
+		m_content_hash = hash;
+		m_content_hash_state = ContentHashState::Pending;
+	}
+
 	const GSVector2i& bs = GSLocalMemory::m_psm[m_TEX0.PSM].bs;
 
 	int tw = std::max<int>(1 << m_TEX0.TW, bs.x);
@@ -1892,6 +1974,15 @@ void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
 
 		Flush(m_write.count, layer);
 	}
+
+	if (layer == 0 && m_complete && m_texture_hash_cache && m_content_hash_state != ContentHashState::Valid)
+	{
+		// A pending hash was taken before the upload and nothing changed since.
+		if (m_content_hash_state == ContentHashState::None)
+			m_content_hash = HashContent();
+
+		m_content_hash_state = ContentHashState::Valid;
+	}
 }
 
 void GSTextureCache::Source::UpdateLayer(const GIFRegTEX0& TEX0, const GSVector4i& rect, int layer)
@@ -2004,10 +2095,6 @@ void GSTextureCache::Source::Flush(uint32 count, int layer)
 
 	int pitch = std::max(tw, psm.bs.x) * sizeof(uint32);
 
-	GSLocalMemory& mem = m_renderer->m_mem;
-
-	const GSOffset& off = m_renderer->m_context->offset.tex;
-
 	GSLocalMemory::readTexture rtx = psm.rtx;
 
 	if (m_palette)
@@ -2024,7 +2111,7 @@ void GSTextureCache::Source::Flush(uint32 count, int layer)
 
 		if (m_preload_texture)
 		{
-			(mem.*rtx)(off, r, buff, pitch, m_TEXA);
+			ReadTexture(rtx, r, buff, pitch);
 
 			const u32 hash = HashTexture(buff, std::max(tw >> layer, 1), std::max(th >> layer, 1), pitch, m_palette != nullptr);
 			if (m_layer_hash[layer] != hash)
@@ -2038,7 +2125,7 @@ void GSTextureCache::Source::Flush(uint32 count, int layer)
 
 		if ((r > tr).mask() & 0xff00)
 		{
-			(mem.*rtx)(off, r, buff, pitch, m_TEXA);
+			ReadTexture(rtx, r, buff, pitch);
 			m_texture->Update(r.rintersect(tr), buff, pitch, layer);
 		}
 		else
@@ -2047,13 +2134,13 @@ void GSTextureCache::Source::Flush(uint32 count, int layer)
 
 			if (m_texture->Map(m, &r, layer))
 			{
-				(mem.*rtx)(off, r, m.bits, m.pitch, m_TEXA);
+				ReadTexture(rtx, r, m.bits, m.pitch);
 
 				m_texture->Unmap();
 			}
 			else
 			{
-				(mem.*rtx)(off, r, buff, pitch, m_TEXA);
+				ReadTexture(rtx, r, buff, pitch);
 
 				m_texture->Update(r, buff, pitch, layer);
 			}
@@ -2069,11 +2156,152 @@ void GSTextureCache::Source::Flush(uint32 count, int layer)
 	m_write.count -= count;
 }
 
+void GSTextureCache::Source::ReadTexture(GSLocalMemory::readTexture rtx, const GSVector4i& r, uint8* dst, int dstpitch)
+{
+	GSLocalMemory& mem = m_renderer->m_mem;
+	const GSOffset& off = m_renderer->m_context->offset.tex;
+
+	if (m_decoder)
+		m_decoder->ReadTexture(mem, rtx, off, r, dst, dstpitch, m_TEXA);
+	else
+		(mem.*rtx)(off, r, dst, dstpitch, m_TEXA);
+}
+
 bool GSTextureCache::Source::ClutMatch(PaletteKey palette_key)
 {
 	return PaletteKeyEqual()(palette_key, m_palette_obj->GetPaletteKey());
 }
 
+// XXH64 (seed 0) for sizes which are a multiple of 32 bytes, GS blocks are 256 and CLUTs 64 or 1024.
+static constexpr u64 HASH_PRIME1 = 0x9E3779B185EBCA87ULL;
+static constexpr u64 HASH_PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr u64 HASH_PRIME3 = 0x165667B19E3779F9ULL;
+static constexpr u64 HASH_PRIME4 = 0x85EBCA77C2B2AE63ULL;
+static constexpr u64 HASH_PRIME5 = 0x27D4EB2F165667C5ULL;
+
+static __forceinline u64 HashRotl(u64 value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+static __forceinline u64 HashRound(u64 acc, u64 input)
+{
+	return HashRotl(acc + input * HASH_PRIME2, 31) * HASH_PRIME1;
+}
+
+static __forceinline u64 HashMergeRound(u64 acc, u64 value)
+{
+	return (acc ^ HashRound(0, value)) * HASH_PRIME1 + HASH_PRIME4;
+}
+
+static __forceinline u64 HashAvalanche(u64 hash)
+{
+	hash = (hash ^ (hash >> 33)) * HASH_PRIME2;
+	hash = (hash ^ (hash >> 29)) * HASH_PRIME3;
+	return hash ^ (hash >> 32);
+}
+
+static u64 Hash64(const void* data, size_t size)
+{
+	ASSERT(size > 0 && (size % 32) == 0);
+
+	const u8* p = static_cast<const u8*>(data);
+	u64 v1 = HASH_PRIME1 + HASH_PRIME2;
+	u64 v2 = HASH_PRIME2;
+	u64 v3 = 0;
+	u64 v4 = 0 - HASH_PRIME1;
+
+	for (size_t i = 0; i < size; i += 32)
+	{
+		u64 in[4];
+		memcpy(in, p + i, sizeof(in));
+		v1 = HashRound(v1, in[0]);
+		v2 = HashRound(v2, in[1]);
+		v3 = HashRound(v3, in[2]);
+		v4 = HashRound(v4, in[3]);
+	}
+
+	u64 hash = HashRotl(v1, 1) + HashRotl(v2, 7) + HashRotl(v3, 12) + HashRotl(v4, 18);
+	hash = HashMergeRound(hash, v1);
+	hash = HashMergeRound(hash, v2);
+	hash = HashMergeRound(hash, v3);
+	hash = HashMergeRound(hash, v4);
+
+	return HashAvalanche(hash + size);
+}
+
+uint64 GSTextureCache::Source::HashContent()
+{
+	const GSVector2i& bs = GSLocalMemory::m_psm[m_TEX0.PSM].bs;
+
+	const int tw = std::max<int>(1 << m_TEX0.TW, bs.x);
+	const int th = std::max<int>(1 << m_TEX0.TH, bs.y);
+
+	if (m_block_hashes.empty())
+	{
+		m_block_hashes.assign((tw / bs.x) * (th / bs.y), 0);
+		m_hashed.assign(MAX_PAGES, 0);
+		m_block_hash_sum = 0;
+	}
+
+	// Visits the blocks like Update() does, with the m_valid bit of each of them.
+	const GSOffset& off = m_renderer->m_context->offset.tex;
+	auto loop_blocks = [this, &off, &bs, tw, th](auto&& fn) {
+		GSOffset::BNHelper bn = off.bnMulti(0, 0);
+		uint32 index = 0;
+
+		for (int y = 0; y < th; y += bs.y, bn.nextBlockY())
+		{
+			for (int x = 0; x < tw; x += bs.x, bn.nextBlockX(), index++)
+			{
+				const uint32 block = bn.valueNoWrap();
+				if (block < MAX_BLOCKS || m_wrap_gs_mem)
+				{
+					const uint32 addr = m_repeating ? (((bn.blkY() << 7) + bn.blkX()) % MAX_BLOCKS) : (block % MAX_BLOCKS);
+					fn(index, block % MAX_BLOCKS, addr >> 5u, 1u << (addr & 31u));
+				}
+			}
+		}
+	};
+
+	// Only the blocks written since the last call are read. Each hash is mixed with its position,
+	// so the sum can be updated one block at a time without blocks cancelling each other.
+	loop_blocks([this](uint32 index, uint32 block, uint32 row, uint32 col) {
+		if (m_hashed[row] & col)
+			return;
+
+		const uint64 hash = HashAvalanche(Hash64(m_renderer->m_mem.BlockPtr(block), 256) + index * HASH_PRIME5);
+		m_block_hash_sum ^= m_block_hashes[index] ^ hash;
+		m_block_hashes[index] = hash;
+	});
+
+	// Set afterwards, with a wrapping texture two blocks of the texture can share one bit.
+	loop_blocks([this](uint32 index, uint32 block, uint32 row, uint32 col) { m_hashed[row] |= col; });
+
+	uint64 hash = m_block_hash_sum;
+
+	if (m_palette_obj && !m_palette)
+	{
+		const PaletteKey key = m_palette_obj->GetPaletteKey();
+		hash ^= HashRotl(Hash64(key.clut, key.pal * sizeof(uint32)), 1);
+	}
+
+	return hash;
+}
+
+GSTextureCache::HashCacheKey GSTextureCache::Source::GetHashCacheKey() const
+{
+	// Same fields LookupSource compares.
+	const uint64 TEX0 = m_TEX0.u32[0] | (static_cast<uint64>(m_TEX0.u32[1] & 3) << 32);
+
+	return {m_content_hash, TEX0, m_TEXA.u64, m_palette != nullptr};
+}
+
+uint32 GSTextureCache::Source::GetUploadSize() const
+{
+	return (1u << m_TEX0.TW) * (1u << m_TEX0.TH) * (m_palette ? 1 : 4);
+}
+
 // GSTextureCache::Target
 
 GSTextureCache::Target::Target(GSRenderer* r, const GIFRegTEX0& TEX0, uint8* temp, bool depth_supported)
@@ -2255,6 +2483,9 @@ void GSTextureCache::SourceMap::RemoveAt(Source* s)
 		});
 	}
 
+	if (m_hash_cache)
+		m_hash_cache->Insert(s);
+
 	delete s;
 }
 
@@ -2457,3 +2688,147 @@ void GSTextureCache::PaletteMap::Clear()
 		map.reserve(MAX_SIZE); // Ensure map capacity is not modified by the clearing
 	}
 }
+
+// GSTextureCache::HashCacheKeyHash
+
+std::size_t GSTextureCache::HashCacheKeyHash::operator()(const HashCacheKey& key) const
+{
+	// The content hash is already well spread, fold the rest of the key in.
+	return static_cast<std::size_t>(key.hash ^ (key.TEX0 * 0x9E3779B97F4A7C15ull) ^ (key.TEXA << 1) ^ key.indexed);
+}
+
+// GSTextureCache::HashCache
+
+GSTextureCache::HashCache::HashCache(const GSRenderer* renderer)
+	: m_renderer(renderer)
+	, m_memory(0)
+{
+}
+
+void GSTextureCache::HashCache::Evict(std::unordered_map<HashCacheKey, Entry, HashCacheKeyHash>::iterator it)
+{
+	m_memory -= it->second.texture->GetMemUsage();
+	m_renderer->m_dev->Recycle(it->second.texture);
+	m_map.erase(it);
+}
+
+void GSTextureCache::HashCache::Insert(Source* s)
+{
+	if (s->m_target || s->m_shared_texture || !s->m_texture || s->m_content_hash_state != ContentHashState::Valid)
+		return;
+
+	const uint32 size = s->m_texture->GetMemUsage();
+	if (size > MAX_MEMORY)
+		return;
+
+	const HashCacheKey key = s->GetHashCacheKey();
+	if (m_map.find(key) != m_map.end())
+		return;
+
+	// Drop the least recently used textures to make room.
+	while (m_memory + size > MAX_MEMORY)
+	{
+		auto oldest = m_map.begin();
+		for (auto it = m_map.begin(); it != m_map.end(); ++it)
+		{
+			if (it->second.age > oldest->second.age)
+				oldest = it;
+		}
+
+		Evict(oldest);
+	}
+
+	m_map.emplace(key, Entry{s->m_texture, 0});
+	m_memory += size;
+
+	// The texture now belongs to the cache.
+	s->m_texture = nullptr;
+}
+
+GSTexture* GSTextureCache::HashCache::Lookup(const HashCacheKey& key)
+{
+	const auto it = m_map.find(key);
+	if (it == m_map.end())
+		return nullptr;
+
+	GSTexture* texture = it->second.texture;
+	m_memory -= texture->GetMemUsage();
+	m_map.erase(it);
+	return texture;
+}
+
+void GSTextureCache::HashCache::IncAge()
+{
+	for (auto it = m_map.begin(); it != m_map.end();)
+	{
+		auto current = it++;
+		if (++current->second.age > MAX_AGE)
+			Evict(current);
+	}
+}
+
+void GSTextureCache::HashCache::Clear()
+{
+	for (auto& it : m_map)
+		m_renderer->m_dev->Recycle(it.second.texture);
+
+	m_map.clear();
+	m_memory = 0;
+}
+
+// GSTextureCache::TextureDecoder
+
+GSTextureCache::TextureDecoder::TextureDecoder(int threads)
+	: m_threads(std::max(threads, 0))
+{
+	if (m_threads > 0)
+		m_workers = std::make_unique<Workers>(m_threads, [](int, Job& job) { DecodeBands(job); });
+}
+
+void GSTextureCache::TextureDecoder::DecodeBands(const Job& job)
+{
+	for (int i = job.next->fetch_add(1); i < job.bands; i = job.next->fetch_add(1))
+	{
+		GSVector4i band = job.r;
+		band.top += i * job.band_height;
+		band.bottom = std::min(band.top + job.band_height, job.r.bottom);
+
+		(job.mem->*job.rtx)(*job.off, band, job.dst + (band.top - job.r.top) * job.dstpitch, job.dstpitch, *job.TEXA);
+	}
+}
+
+void GSTextureCache::TextureDecoder::ReadTexture(GSLocalMemory& mem, GSLocalMemory::readTexture rtx, const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	const int block_mask = (1 << off.blockShiftY()) - 1;
+	const int rows = r.height() >> off.blockShiftY();
+
+	// Bands must start on a block row, mipmap layers smaller than a block are not aligned.
+	if (!m_workers || r.width() * r.height() < MIN_TEXELS || ((r.top | r.bottom) & block_mask) != 0 || rows < 2)
+	{
+		(mem.*rtx)(off, r, dst, dstpitch, TEXA);
+		return;
+	}
+
+	const int band_rows = std::max(rows / ((m_threads + 1) * BANDS_PER_THREAD), 1);
+
+	std::atomic<int> next{0};
+
+	Job job;
+	job.mem = &mem;
+	job.rtx = rtx;
+	job.off = &off;
+	job.TEXA = &TEXA;
+	job.r = r;
+	job.dst = dst;
+	job.dstpitch = dstpitch;
+	job.band_height = band_rows << off.blockShiftY();
+	job.bands = (rows + band_rows - 1) / band_rows;
+	job.next = &next;
+
+	m_workers->Push(job);
+
+	DecodeBands(job);
+
+	// The job and the counter live on this stack, every worker has to be done with them.
+	m_workers->Wait();
+}
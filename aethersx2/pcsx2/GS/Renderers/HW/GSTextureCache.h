@@ -18,6 +18,7 @@
 #include "GS/Renderers/Common/GSRenderer.h"
 #include "GS/Renderers/Common/GSFastList.h"
 #include "GS/Renderers/Common/GSDirtyRect.h"
+#include "GS/GSThread_CXX11.h"
 
 class GSTextureCache
 {
@@ -97,6 +98,67 @@ public:
 		bool operator()(const PaletteKey& lhs, const PaletteKey& rhs) const;
 	};
 
+	enum class ContentHashState : uint8
+	{
+		None,
+		Pending,
+		Valid,
+	};
+
+	struct HashCacheKey
+	{
+		uint64 hash;
+		uint64 TEX0; // TBP0 TBW PSM TW TH
+		uint64 TEXA;
+		bool indexed; // 8 bit texture expanded by the GPU palette
+
+		bool operator==(const HashCacheKey& rhs) const
+		{
+			return hash == rhs.hash && TEX0 == rhs.TEX0 && TEXA == rhs.TEXA && indexed == rhs.indexed;
+		}
+	};
+
+	struct HashCacheKeyHash
+	{
+		std::size_t operator()(const HashCacheKey& key) const;
+	};
+
+	// Unswizzles large source updates in bands of block rows, on texture_decode_threads worker
+	// threads and the calling thread together. Smaller areas are decoded on the calling thread.
+	class TextureDecoder
+	{
+	private:
+		static const int MIN_TEXELS = 128 * 128;
+		static const int BANDS_PER_THREAD = 4;
+
+		struct Job
+		{
+			GSLocalMemory* mem;
+			GSLocalMemory::readTexture rtx;
+			const GSOffset* off;
+			const GIFRegTEXA* TEXA;
+			GSVector4i r;
+			uint8* dst;
+			int dstpitch;
+			int band_height;
+			int bands;
+			std::atomic<int>* next;
+		};
+
+		using Workers = GSBroadcastQueue<Job, 16>;
+
+		std::unique_ptr<Workers> m_workers;
+		int m_threads;
+
+		static void DecodeBands(const Job& job);
+
+	public:
+		TextureDecoder(int threads);
+
+		// Same as (mem.*rtx)(off, r, dst, dstpitch, TEXA), returns once the whole area is decoded.
+		void ReadTexture(GSLocalMemory& mem, GSLocalMemory::readTexture rtx, const GSOffset& off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	};
+
 	class Source : public Surface
 	{
 		struct
@@ -108,6 +170,7 @@ public:
 		void Write(const GSVector4i& r, int layer);
 		void Flush(uint32 count, int layer);
 		void PreloadUpdate(int layer);
+		void ReadTexture(GSLocalMemory::readTexture rtx, const GSVector4i& r, uint8* dst, int dstpitch);
 
 	public:
 		std::shared_ptr<Palette> m_palette_obj;
@@ -128,6 +191,17 @@ public:
 		// Keep a GSTextureCache::SourceMap::m_map iterator to allow fast erase
 		std::array<uint16, MAX_PAGES> m_erase_it;
 		GSOffset::PageLooper m_pages;
+		// Hash of the local memory blocks (and of the CLUT when it is expanded on the CPU) the
+		// texture is built from. Pending until the whole texture is uploaded, then Valid as long
+		// as m_texture holds exactly that data. Only tracked when the hash cache is enabled.
+		uint64 m_content_hash;
+		ContentHashState m_content_hash_state;
+		// Per block hashes behind m_content_hash, in texture block order. m_hashed has the layout
+		// of m_valid and is cleared with it, only blocks without their bit are read again.
+		std::vector<uint64> m_block_hashes;
+		std::vector<uint32> m_hashed;
+		uint64 m_block_hash_sum;
+		TextureDecoder* m_decoder; // nullptr decodes on the GS thread
 
 	public:
 		Source(GSRenderer* r, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, uint8* temp, bool dummy_container = false);
@@ -137,6 +211,10 @@ public:
 		void UpdateLayer(const GIFRegTEX0& TEX0, const GSVector4i& rect, int layer = 0);
 
 		bool ClutMatch(PaletteKey palette_key);
+
+		uint64 HashContent();
+		HashCacheKey GetHashCacheKey() const;
+		uint32 GetUploadSize() const;
 	};
 
 	class Target : public Surface
@@ -177,6 +255,41 @@ public:
 		void Clear(); // Clears m_maps, thus deletes Palette objects
 	};
 
+	// Textures of the sources which left the cache, keyed by their content. A source created
+	// for data which was already decoded and uploaded once takes its texture back from here.
+	class HashCache
+	{
+	private:
+		static const uint32 MAX_AGE = 300; // Frames an unused texture is kept.
+		static const uint32 MAX_MEMORY = 64 * 1024 * 1024;
+
+		struct Entry
+		{
+			GSTexture* texture;
+			uint32 age;
+		};
+
+		const GSRenderer* m_renderer;
+		std::unordered_map<HashCacheKey, Entry, HashCacheKeyHash> m_map;
+		uint32 m_memory;
+
+		void Evict(std::unordered_map<HashCacheKey, Entry, HashCacheKeyHash>::iterator it);
+
+	public:
+		HashCache(const GSRenderer* renderer);
+
+		// Takes the texture of a source which is about to be deleted if its content is known.
+		void Insert(Source* s);
+
+		// Removes and returns the texture built from the same data, or nullptr.
+		GSTexture* Lookup(const HashCacheKey& key);
+
+		void IncAge();
+		void Clear();
+
+		uint32 GetMemoryUsage() const { return m_memory; }
+	};
+
 	class SourceMap
 	{
 	public:
@@ -184,9 +297,11 @@ public:
 		std::array<FastList<Source*>, MAX_PAGES> m_map;
 		uint32 m_pages[16]; // bitmap of all pages
 		bool m_used;
+		HashCache* m_hash_cache; // Receives the removed sources when enabled.
 
 		SourceMap()
 			: m_used(false)
+			, m_hash_cache(nullptr)
 		{
 			memset(m_pages, 0, sizeof(m_pages));
 		}
@@ -213,6 +328,8 @@ public:
 protected:
 	GSRenderer* m_renderer;
 	PaletteMap m_palette_map;
+	HashCache m_hash_cache;
+	TextureDecoder m_decoder;
 	SourceMap m_src;
 	FastList<Target*> m_dst[2];
 	bool m_paltex;
@@ -225,6 +342,7 @@ protected:
 	bool m_texture_inside_rt;
 	static bool m_wrap_gs_mem;
 	static bool m_preload_texture;
+	static bool m_texture_hash_cache;
 	uint8 m_texture_inside_rt_cache_size = 255;
 	std::vector<TexInsideRtCacheEntry> m_texture_inside_rt_cache;
 
@@ -37,6 +37,9 @@ protected:
 	GSCodeGeneratorFunctionMap<GSSetupPrimCodeGenerator, uint64, SetupPrimPtr> m_sp_map;
 	GSCodeGeneratorFunctionMap<GSDrawScanlineCodeGenerator, uint64, DrawScanlinePtr> m_ds_map;
 
+	static GSScanlineSelector GetEdgeSelector(const GSScanlineSelector& global);
+	static GSScanlineSelector GetSetupPrimSelector(const GSScanlineSelector& global);
+
 	template <class T, bool masked>
 	void DrawRectT(const GSOffset& off, const GSVector4i& r, uint32 c, uint32 m);
 
@@ -84,4 +87,7 @@ public:
 	{
 		m_ds_map.PrintStats();
 	}
+
+	void Pregenerate(uint64 key);
+	void GetSelectorTicks(std::unordered_map<uint64, uint64>& ticks) const;
 };
@@ -131,6 +131,11 @@ int GSRasterizer::GetPixels(bool reset)
 }
 
 void GSRasterizer::Draw(GSRasterizerData* data)
+{
+	Draw(data, data->scissor);
+}
+
+void GSRasterizer::Draw(GSRasterizerData* data, const GSVector4i& scissor)
 {
 	GSPerfMonAutoTimer pmat(m_perfmon, GSPerfMon::WorkerDraw0 + m_id);
 
@@ -153,11 +158,11 @@ void GSRasterizer::Draw(GSRasterizerData* data)
 
 	uint32 tmp_index[] = {0, 1, 2};
 
-	bool scissor_test = !data->bbox.eq(data->bbox.rintersect(data->scissor));
+	bool scissor_test = !data->bbox.eq(data->bbox.rintersect(scissor));
 
-	m_scissor = data->scissor;
-	m_fscissor_x = GSVector4(data->scissor).xzxz();
-	m_fscissor_y = GSVector4(data->scissor).ywyw();
+	m_scissor = scissor;
+	m_fscissor_x = GSVector4(scissor).xzxz();
+	m_fscissor_y = GSVector4(scissor).ywyw();
 
 	switch (data->primclass)
 	{
@@ -1182,25 +1187,34 @@ void GSRasterizer::DrawEdge(int pixels, int left, int top, const GSVertexSW& sca
 GSRasterizerList::GSRasterizerList(int threads, GSPerfMon* perfmon)
 	: m_perfmon(perfmon)
 {
-	m_thread_height = compute_best_thread_height(threads);
+}
 
-	int rows = (2048 >> m_thread_height) + 16;
-	m_scanline = (uint8*)_aligned_malloc(rows, 64);
+GSRasterizerList::~GSRasterizerList()
+{
+	// Stop the workers before the rasterizers they draw with go away.
+	m_workers.reset();
+}
 
-	int row = 0;
+void GSRasterizerList::Process(int id, GSRasterizerData* data)
+{
+	GSRasterizer& r = *m_r[id];
 
-	while (row < rows)
+	// Every worker sees every draw, skip the ones which don't touch any of our scanlines.
+	GSVector4i rect = data->bbox.rintersect(data->scissor);
+
+	if (r.IsOneOfMyScanlines(rect.top, rect.bottom))
 	{
-		for (int i = 0; i < threads; i++, row++)
-		{
-			m_scanline[row] = (uint8)i;
-		}
+		r.Draw(data);
 	}
 }
 
-GSRasterizerList::~GSRasterizerList()
+void GSRasterizerList::UpdatePerfMon()
 {
-	_aligned_free(m_scanline);
+	GSWorkers::Stats stats = m_workers->ResetStats();
+
+	m_perfmon->Put(GSPerfMon::QueuePush, static_cast<double>(stats.pushes));
+	m_perfmon->Put(GSPerfMon::QueuePark, static_cast<double>(stats.parks));
+	m_perfmon->Put(GSPerfMon::QueueSpin, static_cast<double>(stats.spin_ns) / 1000);
 }
 
 void GSRasterizerList::Queue(const GSRingHeap::SharedPtr<GSRasterizerData>& data)
@@ -1209,12 +1223,9 @@ void GSRasterizerList::Queue(const GSRingHeap::SharedPtr<GSRasterizerData>& data
 
 	ASSERT(r.top >= 0 && r.top < 2048 && r.bottom >= 0 && r.bottom < 2048);
 
-	int top = r.top >> m_thread_height;
-	int bottom = std::min<int>((r.bottom + (1 << m_thread_height) - 1) >> m_thread_height, top + m_workers.size());
-
-	while (top < bottom)
+	if (r.top < r.bottom)
 	{
-		m_workers[m_scanline[top++]]->Push(data);
+		m_workers->Push(data);
 	}
 }
 
@@ -1222,36 +1233,315 @@ void GSRasterizerList::Sync()
 {
 	if (!IsSynced())
 	{
-		for (size_t i = 0; i < m_workers.size(); i++)
-		{
-			m_workers[i]->Wait();
-		}
+		m_workers->Wait();
 
 		m_perfmon->Put(GSPerfMon::SyncPoint, 1);
 	}
+
+	UpdatePerfMon();
 }
 
 bool GSRasterizerList::IsSynced() const
 {
-	for (size_t i = 0; i < m_workers.size(); i++)
+	return m_workers->IsEmpty();
+}
+
+int GSRasterizerList::GetPixels(bool reset)
+{
+	int pixels = 0;
+
+	for (size_t i = 0; i < m_r.size(); i++)
+	{
+		pixels += m_r[i]->GetPixels(reset);
+	}
+
+	return pixels;
+}
+
+void GSRasterizerList::Pregenerate(uint64 key)
+{
+	for (size_t i = 0; i < m_r.size(); i++)
+	{
+		m_r[i]->Pregenerate(key);
+	}
+}
+
+void GSRasterizerList::GetSelectorTicks(std::unordered_map<uint64, uint64>& ticks) const
+{
+	for (size_t i = 0; i < m_r.size(); i++)
+	{
+		m_r[i]->GetSelectorTicks(ticks);
+	}
+}
+
+//
+
+GSRasterizerTileList::GSRasterizerTileList(int threads, GSPerfMon* perfmon)
+	: m_perfmon(perfmon)
+	, m_ready(0)
+	, m_pending(0)
+	, m_steals(0)
+	, m_exit(false)
+{
+	m_thread_height = compute_best_thread_height(threads);
+	m_band_count = 2048 >> m_thread_height;
+
+	m_bands = std::make_unique<Band[]>(m_band_count);
+	m_pools = std::make_unique<Pool[]>(threads);
+}
+
+GSRasterizerTileList::~GSRasterizerTileList()
+{
+	Sync();
+
+	{
+		std::lock_guard<std::mutex> l(m_lock);
+		m_exit = true;
+	}
+	m_notempty.notify_all();
+
+	for (std::thread& t : m_threads)
+		t.join();
+}
+
+void GSRasterizerTileList::Start()
+{
+	for (size_t i = 0; i < m_r.size(); i++)
+	{
+		m_threads.emplace_back(&GSRasterizerTileList::ThreadProc, this, static_cast<int>(i));
+	}
+}
+
+void GSRasterizerTileList::ThreadProc(int id)
+{
+	GSRasterizer& r = *m_r[id];
+
+	while (true)
 	{
-		if (!m_workers[i]->IsEmpty())
+		int band;
+		uint32 waited = 0;
+
+		while (!Pop(id, band))
 		{
-			return false;
+			if (waited < SPIN_TIME_NS)
+			{
+				waited += ShortSpin();
+				continue;
+			}
+
+			std::unique_lock<std::mutex> l(m_lock);
+
+			while (m_ready.load(std::memory_order_acquire) == 0)
+			{
+				if (m_exit)
+					return;
+
+				m_notempty.wait(l);
+			}
+
+			waited = 0;
 		}
+
+		Process(r, band);
+	}
+}
+
+void GSRasterizerTileList::Schedule(int band)
+{
+	// Bands are homed on workers the same way the interleaved scheme assigns them,
+	// so without contention every worker keeps touching the same part of the screen.
+	Pool& pool = m_pools[band % m_r.size()];
+
+	{
+		std::lock_guard<std::mutex> l(pool.lock);
+		pool.bands.push_back(band);
 	}
 
-	return true;
+	m_ready.fetch_add(1, std::memory_order_release);
+
+	{
+		std::lock_guard<std::mutex> l(m_lock);
+	}
+	m_notempty.notify_one();
 }
 
-int GSRasterizerList::GetPixels(bool reset)
+bool GSRasterizerTileList::Pop(int id, int& band)
+{
+	if (m_ready.load(std::memory_order_acquire) == 0)
+		return false;
+
+	const int count = static_cast<int>(m_r.size());
+
+	for (int i = 0; i < count; i++)
+	{
+		Pool& pool = m_pools[(id + i) % count];
+
+		std::lock_guard<std::mutex> l(pool.lock);
+
+		if (pool.bands.empty())
+			continue;
+
+		// Own work is taken from the front (oldest first), stolen work from the back.
+		if (i == 0)
+		{
+			band = pool.bands.front();
+			pool.bands.pop_front();
+		}
+		else
+		{
+			band = pool.bands.back();
+			pool.bands.pop_back();
+			m_steals.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		m_ready.fetch_sub(1, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	return false;
+}
+
+void GSRasterizerTileList::Process(GSRasterizer& r, int band)
+{
+	Band& b = m_bands[band];
+
+	const int top = band << m_thread_height;
+	const int bottom = top + (1 << m_thread_height);
+
+	while (true)
+	{
+		GSRingHeap::SharedPtr<GSRasterizerData> data;
+
+		{
+			std::lock_guard<std::mutex> l(b.lock);
+
+			if (b.queue.empty())
+			{
+				// Nobody else can pick the band up until it is scheduled again.
+				b.scheduled = false;
+				break;
+			}
+
+			data = std::move(b.queue.front());
+			b.queue.pop_front();
+		}
+
+		GSVector4i scissor = data->scissor;
+
+		scissor.top = std::max<int>(scissor.top, top);
+		scissor.bottom = std::min<int>(scissor.bottom, bottom);
+
+		r.Draw(data.get(), scissor);
+
+		if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			{
+				std::lock_guard<std::mutex> l(m_wait_lock);
+			}
+			m_empty.notify_all();
+		}
+	}
+}
+
+void GSRasterizerTileList::Queue(const GSRingHeap::SharedPtr<GSRasterizerData>& data)
+{
+	GSVector4i r = data->bbox.rintersect(data->scissor);
+
+	ASSERT(r.top >= 0 && r.top < 2048 && r.bottom >= 0 && r.bottom < 2048);
+
+	int top = r.top >> m_thread_height;
+	int bottom = std::min<int>((r.bottom + (1 << m_thread_height) - 1) >> m_thread_height, m_band_count);
+
+	if (top >= bottom)
+		return;
+
+	m_pending.fetch_add(bottom - top, std::memory_order_relaxed);
+
+	while (top < bottom)
+	{
+		Band& b = m_bands[top];
+		bool schedule;
+
+		{
+			std::lock_guard<std::mutex> l(b.lock);
+
+			b.queue.push_back(data);
+
+			schedule = !b.scheduled;
+			b.scheduled = true;
+		}
+
+		if (schedule)
+		{
+			Schedule(top);
+		}
+
+		top++;
+	}
+}
+
+void GSRasterizerTileList::Sync()
+{
+	if (!IsSynced())
+	{
+		uint32 waited = 0;
+
+		while (waited < SPIN_TIME_NS)
+		{
+			if (IsSynced())
+				break;
+
+			waited += ShortSpin();
+		}
+
+		if (!IsSynced())
+		{
+			std::unique_lock<std::mutex> l(m_wait_lock);
+
+			while (!IsSynced())
+				m_empty.wait(l);
+		}
+
+		m_perfmon->Put(GSPerfMon::SyncPoint, 1);
+	}
+}
+
+bool GSRasterizerTileList::IsSynced() const
+{
+	return m_pending.load(std::memory_order_acquire) == 0;
+}
+
+int GSRasterizerTileList::GetPixels(bool reset)
 {
 	int pixels = 0;
 
-	for (size_t i = 0; i < m_workers.size(); i++)
+	for (size_t i = 0; i < m_r.size(); i++)
 	{
 		pixels += m_r[i]->GetPixels(reset);
 	}
 
 	return pixels;
 }
+
+void GSRasterizerTileList::Pregenerate(uint64 key)
+{
+	for (size_t i = 0; i < m_r.size(); i++)
+	{
+		m_r[i]->Pregenerate(key);
+	}
+}
+
+void GSRasterizerTileList::GetSelectorTicks(std::unordered_map<uint64, uint64>& ticks) const
+{
+	for (size_t i = 0; i < m_r.size(); i++)
+	{
+		m_r[i]->GetSelectorTicks(ticks);
+	}
+}
+
+void GSRasterizerTileList::PrintStats()
+{
+	printf("%d workers, %d bands of %d lines, %u steals\n",
+		static_cast<int>(m_r.size()), m_band_count, 1 << m_thread_height, m_steals.load());
+}
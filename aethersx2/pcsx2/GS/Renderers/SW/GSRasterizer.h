@@ -22,6 +22,8 @@
 #include "GS/GSPerfMon.h"
 #include "GS/GSThread_CXX11.h"
 #include "GS/GSRingHeap.h"
+#include <atomic>
+#include <deque>
 
 class alignas(32) GSRasterizerData : public GSAlignedClass<32>
 {
@@ -108,6 +110,9 @@ public:
 
 	virtual void PrintStats() = 0;
 
+	virtual void Pregenerate(uint64 key) = 0;
+	virtual void GetSelectorTicks(std::unordered_map<uint64, uint64>& ticks) const = 0;
+
 	__forceinline bool HasEdge() const { return m_de != NULL; }
 	__forceinline bool IsSolidRect() const { return m_dr != NULL; }
 };
@@ -122,6 +127,11 @@ public:
 	virtual bool IsSynced() const = 0;
 	virtual int GetPixels(bool reset = true) = 0;
 	virtual void PrintStats() = 0;
+
+	// Generates the drawing functions for a selector ahead of time, can be called from any thread.
+	virtual void Pregenerate(uint64 key) = 0;
+	// Only valid while synced.
+	virtual void GetSelectorTicks(std::unordered_map<uint64, uint64>& ticks) const = 0;
 };
 
 class alignas(32) GSRasterizer : public IRasterizer
@@ -171,6 +181,7 @@ public:
 	__forceinline int FindMyNextScanline(int top) const;
 
 	void Draw(GSRasterizerData* data);
+	void Draw(GSRasterizerData* data, const GSVector4i& scissor);
 
 	// IRasterizer
 
@@ -179,47 +190,92 @@ public:
 	bool IsSynced() const { return true; }
 	int GetPixels(bool reset);
 	void PrintStats() { m_ds->PrintStats(); }
+	void Pregenerate(uint64 key) { m_ds->Pregenerate(key); }
+	void GetSelectorTicks(std::unordered_map<uint64, uint64>& ticks) const { m_ds->GetSelectorTicks(ticks); }
 };
 
 class GSRasterizerList : public IRasterizer
 {
 protected:
-	using GSWorker = GSJobQueue<GSRingHeap::SharedPtr<GSRasterizerData>, 65536>;
+	using GSWorkers = GSBroadcastQueue<GSRingHeap::SharedPtr<GSRasterizerData>, 65536>;
 
 	GSPerfMon* m_perfmon;
 	// Worker threads depend on the rasterizers, so don't change the order.
 	std::vector<std::unique_ptr<GSRasterizer>> m_r;
-	std::vector<std::unique_ptr<GSWorker>> m_workers;
-	uint8* m_scanline;
-	int m_thread_height;
+	std::unique_ptr<GSWorkers> m_workers;
 
 	GSRasterizerList(int threads, GSPerfMon* perfmon);
 
+	void Process(int id, GSRasterizerData* data);
+	void UpdatePerfMon();
+
 public:
 	virtual ~GSRasterizerList();
 
 	template <class DS>
-	static IRasterizer* Create(int threads, GSPerfMon* perfmon)
+	static IRasterizer* Create(int threads, GSPerfMon* perfmon);
+
+	// IRasterizer
+
+	void Queue(const GSRingHeap::SharedPtr<GSRasterizerData>& data);
+	void Sync();
+	bool IsSynced() const;
+	int GetPixels(bool reset);
+	void PrintStats() {}
+	void Pregenerate(uint64 key);
+	void GetSelectorTicks(std::unordered_map<uint64, uint64>& ticks) const;
+};
+
+// Bins the screen into bands of (1 << extrathreads_height) scanlines. Each band keeps its own
+// FIFO of draws, so draws touching the same band are always rasterized in submission order,
+// while the bands themselves are pulled by whichever worker is free. Workers prefer the bands
+// homed on them and steal from the other workers' pools once their own pool runs dry.
+class GSRasterizerTileList : public IRasterizer
+{
+protected:
+	struct alignas(64) Band
 	{
-		threads = std::max<int>(threads, 0);
+		std::mutex lock;
+		std::deque<GSRingHeap::SharedPtr<GSRasterizerData>> queue;
+		bool scheduled = false;
+	};
 
-		if (threads == 0)
-		{
-			return new GSRasterizer(new DS(), 0, 1, perfmon);
-		}
+	struct alignas(64) Pool
+	{
+		std::mutex lock;
+		std::deque<int> bands;
+	};
 
-		GSRasterizerList* rl = new GSRasterizerList(threads, perfmon);
+	GSPerfMon* m_perfmon;
+	std::vector<std::unique_ptr<GSRasterizer>> m_r;
+	std::vector<std::thread> m_threads;
+	std::unique_ptr<Band[]> m_bands;
+	std::unique_ptr<Pool[]> m_pools;
+	int m_band_count;
+	int m_thread_height;
 
-		for (int i = 0; i < threads; i++)
-		{
-			rl->m_r.push_back(std::unique_ptr<GSRasterizer>(new GSRasterizer(new DS(), i, threads, perfmon)));
-			auto& r = *rl->m_r[i];
-			rl->m_workers.push_back(std::unique_ptr<GSWorker>(new GSWorker(
-				[&r](GSRingHeap::SharedPtr<GSRasterizerData>& item) { r.Draw(item.get()); })));
-		}
+	std::atomic<int> m_ready; // bands sitting in the pools
+	std::atomic<int> m_pending; // (draw, band) pairs not rasterized yet
+	std::atomic<uint32> m_steals;
+	bool m_exit;
 
-		return rl;
-	}
+	std::mutex m_lock;
+	std::mutex m_wait_lock;
+	std::condition_variable m_notempty;
+	std::condition_variable m_empty;
+
+	GSRasterizerTileList(int threads, GSPerfMon* perfmon);
+
+	void Start();
+	void ThreadProc(int id);
+	void Schedule(int band);
+	bool Pop(int id, int& band);
+	void Process(GSRasterizer& r, int band);
+
+public:
+	virtual ~GSRasterizerTileList();
+
+	friend class GSRasterizerList;
 
 	// IRasterizer
 
@@ -227,5 +283,46 @@ public:
 	void Sync();
 	bool IsSynced() const;
 	int GetPixels(bool reset);
-	void PrintStats() {}
+	void PrintStats();
+	void Pregenerate(uint64 key);
+	void GetSelectorTicks(std::unordered_map<uint64, uint64>& ticks) const;
 };
+
+template <class DS>
+IRasterizer* GSRasterizerList::Create(int threads, GSPerfMon* perfmon)
+{
+	threads = std::max<int>(threads, 0);
+
+	if (threads == 0)
+	{
+		return new GSRasterizer(new DS(), 0, 1, perfmon);
+	}
+
+	if (theApp.GetConfigB("extrathreads_tiles"))
+	{
+		GSRasterizerTileList* rl = new GSRasterizerTileList(threads, perfmon);
+
+		// Every worker owns whole bands at a time, so each rasterizer covers all scanlines
+		// and relies on the band being applied as scissor.
+		for (int i = 0; i < threads; i++)
+		{
+			rl->m_r.push_back(std::unique_ptr<GSRasterizer>(new GSRasterizer(new DS(), i, 1, perfmon)));
+		}
+
+		rl->Start();
+
+		return rl;
+	}
+
+	GSRasterizerList* rl = new GSRasterizerList(threads, perfmon);
+
+	for (int i = 0; i < threads; i++)
+	{
+		rl->m_r.push_back(std::unique_ptr<GSRasterizer>(new GSRasterizer(new DS(), i, threads, perfmon)));
+	}
+
+	rl->m_workers = std::make_unique<GSWorkers>(threads,
+		[rl](int id, GSRingHeap::SharedPtr<GSRasterizerData>& item) { rl->Process(id, item.get()); });
+
+	return rl;
+}
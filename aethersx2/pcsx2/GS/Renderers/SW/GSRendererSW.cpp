@@ -75,6 +75,9 @@ GSRendererSW::GSRendererSW(std::unique_ptr<GSDevice> dev, int threads)
 
 GSRendererSW::~GSRendererSW()
 {
+	m_rl->Sync();
+	m_selector_cache.Close();
+
 	delete m_tc;
 
 	for (size_t i = 0; i < countof(m_texture); i++)
@@ -92,6 +95,24 @@ const char* GSRendererSW::GetName() const
 	return "SW";
 }
 
+void GSRendererSW::SetGameCRC(uint32 crc, int options)
+{
+	GSRenderer::SetGameCRC(crc, options);
+
+	if (crc != m_selector_cache.GetCRC() && !GLLoader::in_replayer)
+	{
+		m_rl->Sync();
+		m_selector_cache.Close();
+		m_selector_cache.Open(crc, m_rl);
+	}
+}
+
+void GSRendererSW::GetSelectorTicks(std::unordered_map<uint64, uint64>& ticks)
+{
+	m_rl->Sync();
+	m_rl->GetSelectorTicks(ticks);
+}
+
 void GSRendererSW::Reset()
 {
 	Sync(-1);
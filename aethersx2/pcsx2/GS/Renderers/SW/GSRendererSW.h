@@ -17,6 +17,7 @@
 
 #include "GSTextureCacheSW.h"
 #include "GSDrawScanline.h"
+#include "GSSelectorCache.h"
 #include "GS/GSRingHeap.h"
 
 class GSRendererSW : public GSRenderer
@@ -69,6 +70,7 @@ class GSRendererSW : public GSRenderer
 
 protected:
 	IRasterizer* m_rl;
+	GSSelectorCache m_selector_cache;
 	GSRingHeap m_vertex_heap;
 	GSTextureCacheSW* m_tc;
 	GSTexture* m_texture[2];
@@ -104,4 +106,9 @@ public:
 	virtual ~GSRendererSW();
 
 	const char* GetName() const override;
+
+	void SetGameCRC(uint32 crc, int options) override;
+
+	// Waits for the rasterizers, then adds the ticks spent in each scanline selector.
+	void GetSelectorTicks(std::unordered_map<uint64, uint64>& ticks);
 };
@@ -0,0 +1,193 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "GSSelectorCache.h"
+#include "GSScanlineEnvironment.h"
+#include "common/FileSystem.h"
+#include "common/StringUtil.h"
+#include "common/Timer.h"
+
+static constexpr uint32 SELECTOR_CACHE_MAGIC = 0x43535347; // GSSC
+static constexpr uint32 SELECTOR_CACHE_VERSION = 1;
+static constexpr size_t SELECTOR_CACHE_MAX_ENTRIES = 4096;
+
+struct SelectorCacheHeader
+{
+	uint32 magic;
+	uint32 version;
+	uint32 selector_size;
+	uint32 count;
+};
+
+GSSelectorCache::GSSelectorCache()
+	: m_rl(nullptr)
+	, m_crc(0)
+	, m_stop(false)
+{
+}
+
+GSSelectorCache::~GSSelectorCache()
+{
+	if (m_thread.joinable())
+	{
+		m_stop.store(true);
+		m_thread.join();
+	}
+}
+
+std::string GSSelectorCache::GetPath(uint32 crc)
+{
+	const std::string dir(FileSystem::JoinPath(StringUtil::wxStringToUTF8String(EmuFolders::Cache.ToString()), "sw_selectors"));
+
+	if (!FileSystem::CreateDirectoryPath(dir.c_str(), true))
+		return {};
+
+	return FileSystem::JoinPath(dir, StringUtil::StdStringFromFormat("%08X.bin", crc));
+}
+
+void GSSelectorCache::Open(uint32 crc, IRasterizer* rl)
+{
+	pxAssert(!m_thread.joinable());
+
+	m_rl = rl;
+	m_crc = crc;
+	m_ticks.clear();
+
+	if (m_crc == 0 || !Load())
+		return;
+
+	// Hottest selectors first, the game most likely hits those early on as well.
+	std::vector<std::pair<uint64, uint64>> sorted(m_ticks.begin(), m_ticks.end());
+	std::sort(sorted.begin(), sorted.end(), [](const auto& l, const auto& r) { return l.second > r.second; });
+
+	std::vector<uint64> keys;
+	keys.reserve(sorted.size());
+
+	for (const auto& it : sorted)
+		keys.push_back(it.first);
+
+	m_stop.store(false);
+	m_thread = std::thread(&GSSelectorCache::ThreadProc, this, std::move(keys));
+}
+
+void GSSelectorCache::Close()
+{
+	if (m_thread.joinable())
+	{
+		m_stop.store(true);
+		m_thread.join();
+	}
+
+	if (m_crc != 0 && m_rl)
+		Save();
+
+	m_rl = nullptr;
+	m_crc = 0;
+	m_ticks.clear();
+}
+
+void GSSelectorCache::ThreadProc(std::vector<uint64> keys)
+{
+	Common::Timer timer;
+
+	size_t count = 0;
+
+	for (uint64 key : keys)
+	{
+		if (m_stop.load(std::memory_order_relaxed))
+			break;
+
+		m_rl->Pregenerate(key);
+		count++;
+	}
+
+	DevCon.WriteLn("GS: Pregenerated %zu of %zu scanline selectors for %08X in %.2f ms",
+		count, keys.size(), m_crc, timer.GetTimeMilliseconds());
+}
+
+bool GSSelectorCache::Load()
+{
+	const std::string path(GetPath(m_crc));
+	if (path.empty())
+		return false;
+
+	std::optional<std::vector<u8>> data(FileSystem::ReadBinaryFile(path.c_str()));
+	if (!data.has_value() || data->size() < sizeof(SelectorCacheHeader))
+		return false;
+
+	SelectorCacheHeader header;
+	std::memcpy(&header, data->data(), sizeof(header));
+
+	if (header.magic != SELECTOR_CACHE_MAGIC || header.version != SELECTOR_CACHE_VERSION ||
+		header.selector_size != sizeof(GSScanlineSelector) ||
+		data->size() != sizeof(header) + header.count * sizeof(Entry))
+	{
+		Console.Warning("GS: Ignoring invalid selector cache '%s'", path.c_str());
+		return false;
+	}
+
+	const u8* ptr = data->data() + sizeof(header);
+
+	for (uint32 i = 0; i < header.count; i++, ptr += sizeof(Entry))
+	{
+		Entry entry;
+		std::memcpy(&entry, ptr, sizeof(entry));
+		m_ticks[entry.key] = entry.ticks;
+	}
+
+	return !m_ticks.empty();
+}
+
+void GSSelectorCache::Save()
+{
+	std::unordered_map<uint64, uint64> session;
+	m_rl->GetSelectorTicks(session);
+
+	if (session.empty())
+		return;
+
+	// Older sessions count for less, so selectors a game stopped using eventually drop out.
+	for (auto& it : m_ticks)
+		it.second /= 2;
+
+	for (const auto& it : session)
+		m_ticks[it.first] += std::max<uint64>(it.second, 1);
+
+	std::vector<Entry> entries;
+	entries.reserve(m_ticks.size());
+
+	for (const auto& it : m_ticks)
+		entries.push_back({it.first, it.second});
+
+	std::sort(entries.begin(), entries.end(), [](const Entry& l, const Entry& r) { return l.ticks > r.ticks; });
+
+	if (entries.size() > SELECTOR_CACHE_MAX_ENTRIES)
+		entries.resize(SELECTOR_CACHE_MAX_ENTRIES);
+
+	SelectorCacheHeader header;
+	header.magic = SELECTOR_CACHE_MAGIC;
+	header.version = SELECTOR_CACHE_VERSION;
+	header.selector_size = sizeof(GSScanlineSelector);
+	header.count = static_cast<uint32>(entries.size());
+
+	std::vector<u8> data(sizeof(header) + entries.size() * sizeof(Entry));
+	std::memcpy(data.data(), &header, sizeof(header));
+	std::memcpy(data.data() + sizeof(header), entries.data(), entries.size() * sizeof(Entry));
+
+	const std::string path(GetPath(m_crc));
+	if (path.empty() || !FileSystem::WriteBinaryFile(path.c_str(), data.data(), data.size()))
+		Console.Warning("GS: Failed to write selector cache for %08X", m_crc);
+}
@@ -0,0 +1,54 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "GSRasterizer.h"
+
+// Remembers which scanline selectors a game used and how much time was spent in each,
+// so the next boot can generate them in the background before the first draw needs them.
+class GSSelectorCache
+{
+	struct Entry
+	{
+		uint64 key;
+		uint64 ticks;
+	};
+
+	IRasterizer* m_rl;
+	uint32 m_crc;
+	std::unordered_map<uint64, uint64> m_ticks;
+	std::thread m_thread;
+	std::atomic<bool> m_stop;
+
+	static std::string GetPath(uint32 crc);
+
+	bool Load();
+	void Save();
+	void ThreadProc(std::vector<uint64> keys);
+
+public:
+	GSSelectorCache();
+	~GSSelectorCache();
+
+	uint32 GetCRC() const { return m_crc; }
+
+	// Loads the selectors recorded for the game and starts generating them.
+	void Open(uint32 crc, IRasterizer* rl);
+
+	// Stops generating, then merges the selectors used since Open() and writes them back.
+	// The rasterizer must be synced.
+	void Close();
+};
@@ -124,6 +124,10 @@ const char* dialog_message(int ID, bool* updateText)
 				"If you have 4 threads on your CPU pick 2 or 3.\n"
 				"You can calculate how to get the best performance (amount of CPU threads - 2)\n"
 				"Note: 7+ threads will not give much more performance and could perhaps even lower it.");
+		case IDC_SWTHREADS_TILES:
+			return cvtString("Splits draws into screen bands which are picked up by whichever rendering thread is idle,\n"
+				"instead of giving each thread a fixed set of interleaved scanlines.\n"
+				"Scales better with many rendering threads, especially for draws covering only part of the screen.");
 		case IDC_MIPMAP_SW:
 			return cvtString("Enables mipmapping, which some games require to render correctly.");
 		case IDC_SHADEBOOST:
@@ -84,6 +84,7 @@ enum
 	IDC_MIPMAP_SW,
 	IDC_SWTHREADS,
 	IDC_SWTHREADS_EDIT,
+	IDC_SWTHREADS_TILES,
 	// OpenGL Advanced Settings
 	IDC_GEOMETRY_SHADER_OVERRIDE,
 	IDC_IMAGE_LOAD_STORE,
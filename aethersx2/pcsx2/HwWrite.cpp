@@ -19,6 +19,7 @@
 #include "Hardware.h"
 #include "Gif_Unit.h"
 #include "IopCommon.h"
+#include "MTIOP.h"
 #include "ps2/HwInternal.h"
 #include "ps2/eeHwTraceLog.inl"
 
@@ -179,6 +180,8 @@ void __fastcall _hwWrite32( u32 mem, u32 value )
 				mcase(SBUS_F240) :
 					if (value & (1 << 19))
 					{
+						iopThread.WaitIOP();
+
 						u32 cycle = psxRegs.cycle;
 						//pgifInit();
 						psxReset();
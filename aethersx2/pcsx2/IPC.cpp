@@ -26,16 +26,24 @@
 #define bzero(b, len) (memset((b), '\0', (len)), (void)0)
 #include <WinSock2.h>
 #include <windows.h>
+#define shutdown_portable(a) (shutdown(a, SD_BOTH))
 #else
 #define read_portable(a, b, c) (read(a, b, c))
 #define write_portable(a, b, c) (write(a, b, c))
 #define close_portable(a) (close(a))
+#define shutdown_portable(a) (shutdown(a, SHUT_RDWR))
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
 #include <sys/un.h>
+#include <unistd.h>
 #endif
 
 #include "Common.h"
+#include "Counters.h"
 #include "Memory.h"
+#include "common/Align.h"
+#include "common/StringUtil.h"
 #include "gui/AppSaveStates.h"
 #include "gui/AppCoreThread.h"
 #include "System/SysThreads.h"
@@ -44,6 +52,7 @@
 
 SocketIPC::SocketIPC(SysCoreThread* vm, unsigned int slot)
 	: pxThread("IPC_Socket")
+	, m_slot(slot)
 {
 #ifdef _WIN32
 	WSADATA wsa;
@@ -142,11 +151,11 @@ char* SocketIPC::MakeFailIPC(char* ret_buffer, uint32_t size = 5)
 	return ret_buffer;
 }
 
-int SocketIPC::StartSocket()
+int SocketIPC::AcceptClient(std::unique_ptr<Client>& client)
 {
-	m_msgsock = accept(m_sock, 0, 0);
+	const auto sock = accept(m_sock, 0, 0);
 
-	if (m_msgsock == -1)
+	if (sock == -1)
 	{
 		// everything else is non recoverable in our scope
 		// we also mark as recoverable socket errors where it would block a
@@ -164,7 +173,17 @@ int SocketIPC::StartSocket()
 			m_end = true;
 			return -1;
 		}
+		return 0;
 	}
+
+	client = std::make_unique<Client>();
+	client->sock = sock;
+	client->id = m_next_client_id++;
+
+	// we allocate once buffers to not have to do mallocs for each IPC
+	// request, as malloc is expansive when we optimize for µs.
+	client->ret_buffer = std::make_unique<char[]>(MAX_IPC_RETURN_SIZE);
+	client->ipc_buffer = std::make_unique<char[]>(MAX_IPC_SIZE);
 	return 0;
 }
 
@@ -172,15 +191,39 @@ void SocketIPC::ExecuteTaskInThread()
 {
 	m_end = false;
 
-	// we allocate once buffers to not have to do mallocs for each IPC
-	// request, as malloc is expansive when we optimize for µs.
-	m_ret_buffer = new char[MAX_IPC_RETURN_SIZE];
-	m_ipc_buffer = new char[MAX_IPC_SIZE];
+	while (true)
+	{
+		std::unique_ptr<Client> client;
+		if (AcceptClient(client) < 0)
+			return;
+		if (!client)
+			continue;
 
-	if (StartSocket() < 0)
-		return;
+		ReapClients();
 
-	while (true)
+		std::lock_guard<std::mutex> lock(m_clients_mutex);
+		if (m_clients.size() >= MAX_IPC_CLIENTS)
+		{
+			Console.Warning("IPC: Too many clients connected, refusing a new one.");
+			close_portable(client->sock);
+			continue;
+		}
+
+		Client* ptr = client.get();
+		m_clients.push_back(std::move(client));
+		ptr->thread = std::thread(&SocketIPC::ClientThread, this, ptr);
+	}
+}
+
+void SocketIPC::ClientThread(Client* client)
+{
+	Threading::SetNameOfCurrentThread("IPC Client");
+
+	char* ipc_buffer = client->ipc_buffer.get();
+	char* ret_buffer = client->ret_buffer.get();
+	bool connected = true;
+
+	while (connected)
 	{
 		// either int or ssize_t depending on the platform, so we have to
 		// use a bunch of auto
@@ -191,14 +234,13 @@ void SocketIPC::ExecuteTaskInThread()
 		// socket datagram splittage, we continue to read
 		while (receive_length < end_length)
 		{
-			auto tmp_length = read_portable(m_msgsock, &m_ipc_buffer[receive_length], MAX_IPC_SIZE - receive_length);
+			auto tmp_length = read_portable(client->sock, &ipc_buffer[receive_length], MAX_IPC_SIZE - receive_length);
 
-			// we recreate the socket if an error happens
+			// the client is gone, or we are shutting down
 			if (tmp_length <= 0)
 			{
 				receive_length = 0;
-				if (StartSocket() < 0)
-					return;
+				connected = false;
 				break;
 			}
 
@@ -207,7 +249,7 @@ void SocketIPC::ExecuteTaskInThread()
 			// if we got at least the final size then update
 			if (end_length == 4 && receive_length >= 4)
 			{
-				end_length = FromArray<u32>(m_ipc_buffer, 0);
+				end_length = FromArray<u32>(ipc_buffer, 0);
 				// we'd like to avoid a client trying to do OOB
 				if (end_length > MAX_IPC_SIZE || end_length < 4)
 				{
@@ -225,40 +267,283 @@ void SocketIPC::ExecuteTaskInThread()
 		// disconnects
 		if (receive_length != 0)
 		{
-			res = ParseCommand(&m_ipc_buffer[4], m_ret_buffer, (u32)end_length - 4);
+			res = ParseCommand(*client, &ipc_buffer[4], ret_buffer, (u32)end_length - 4);
 
-			// if we cannot send back our answer restart the socket
-			if (write_portable(m_msgsock, res.buffer, res.size) < 0)
-			{
-				if (StartSocket() < 0)
-					return;
-			}
+			// if we cannot send back our answer drop the client
+			if (write_portable(client->sock, res.buffer, res.size) < 0)
+				connected = false;
+		}
+	}
+
+	// the snapshot goes away with the connection
+	SetSnapshot(*client, {});
+	client->done.store(true, std::memory_order_release);
+}
+
+void SocketIPC::ReapClients()
+{
+	std::lock_guard<std::mutex> lock(m_clients_mutex);
+	for (auto it = m_clients.begin(); it != m_clients.end();)
+	{
+		Client& client = **it;
+		if (!client.done.load(std::memory_order_acquire))
+		{
+			++it;
+			continue;
 		}
+
+		client.thread.join();
+		close_portable(client.sock);
+		it = m_clients.erase(it);
+	}
+}
+
+void SocketIPC::CloseClients()
+{
+	std::vector<std::unique_ptr<Client>> clients;
+	{
+		std::lock_guard<std::mutex> lock(m_clients_mutex);
+		clients.swap(m_clients);
+	}
+
+	for (const std::unique_ptr<Client>& client : clients)
+	{
+		// wakes the client thread up from read()
+		shutdown_portable(client->sock);
+		client->thread.join();
+		close_portable(client->sock);
 	}
-	return;
 }
 
 SocketIPC::~SocketIPC()
 {
 	m_end = true;
-#ifdef _WIN32
-	WSACleanup();
-#else
-	unlink(m_socket_name.c_str());
-#endif
 	close_portable(m_sock);
-	close_portable(m_msgsock);
-	delete[] m_ret_buffer;
-	delete[] m_ipc_buffer;
 	// destroy the thread
 	try
 	{
 		pxThread::Cancel();
 	}
 	DESTRUCTOR_CATCHALL
+
+	CloseClients();
+#ifdef _WIN32
+	WSACleanup();
+#else
+	unlink(m_socket_name.c_str());
+#endif
+}
+
+SocketIPC::SnapshotRing::~SnapshotRing()
+{
+	Destroy();
+}
+
+bool SocketIPC::SnapshotRing::Create(const std::string& name, std::vector<SnapshotRange> ranges)
+{
+	u32 data_size = 0;
+	for (const SnapshotRange& range : ranges)
+		data_size += range.size;
+
+	const u32 slot_offset = Common::AlignUpPow2(static_cast<u32>(sizeof(SnapshotHeader) + ranges.size() * sizeof(SnapshotRange)), 64);
+	const u32 slot_size = Common::AlignUpPow2(static_cast<u32>(sizeof(SnapshotSlot)) + data_size, 64);
+	const size_t size = slot_offset + static_cast<size_t>(slot_size) * SNAPSHOT_SLOT_COUNT;
+
+	void* ptr;
+#ifdef _WIN32
+	m_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(size), name.c_str());
+	if (!m_mapping || GetLastError() == ERROR_ALREADY_EXISTS)
+	{
+		Destroy();
+		return false;
+	}
+
+	ptr = MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	if (!ptr)
+	{
+		Destroy();
+		return false;
+	}
+#else
+	const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0)
+		return false;
+
+	m_name = name;
+	ptr = (ftruncate(fd, static_cast<off_t>(size)) == 0) ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+	close(fd);
+	if (ptr == MAP_FAILED)
+	{
+		Destroy();
+		return false;
+	}
+#endif
+
+	m_name = name;
+	m_size = size;
+	m_ranges = std::move(ranges);
+
+	// the object is zero filled, every slot starts with an even sequence
+	m_header = new (ptr) SnapshotHeader();
+	m_header->magic = SNAPSHOT_MAGIC;
+	m_header->version = SNAPSHOT_VERSION;
+	m_header->slot_count = SNAPSHOT_SLOT_COUNT;
+	m_header->slot_size = slot_size;
+	m_header->slot_offset = slot_offset;
+	m_header->range_count = static_cast<u32>(m_ranges.size());
+	m_header->data_size = data_size;
+	std::memcpy(m_header + 1, m_ranges.data(), m_ranges.size() * sizeof(SnapshotRange));
+	m_header->written.store(0, std::memory_order_release);
+	return true;
+}
+
+void SocketIPC::SnapshotRing::Destroy()
+{
+#ifdef _WIN32
+	if (m_header)
+		UnmapViewOfFile(m_header);
+	if (m_mapping)
+		CloseHandle(m_mapping);
+	m_mapping = NULL;
+#else
+	if (m_header)
+		munmap(m_header, m_size);
+	if (!m_name.empty())
+		shm_unlink(m_name.c_str());
+#endif
+	m_header = nullptr;
+	m_size = 0;
+	m_name.clear();
+}
+
+void SocketIPC::SnapshotRing::Write(u32 frame)
+{
+	const u64 written = m_header->written.load(std::memory_order_relaxed);
+	u8* base = reinterpret_cast<u8*>(m_header) + m_header->slot_offset;
+	SnapshotSlot* slot = reinterpret_cast<SnapshotSlot*>(base + (written % SNAPSHOT_SLOT_COUNT) * m_header->slot_size);
+
+	const u32 sequence = slot->sequence.load(std::memory_order_relaxed);
+	slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	slot->frame = frame;
+	u8* dst = reinterpret_cast<u8*>(slot + 1);
+	for (const SnapshotRange& range : m_ranges)
+	{
+		ReadRange(dst, range.address, range.size);
+		dst += range.size;
+	}
+
+	slot->sequence.store(sequence + 2, std::memory_order_release);
+	m_header->written.store(written + 1, std::memory_order_release);
+}
+
+bool SocketIPC::SetSnapshot(Client& client, std::vector<SnapshotRange> ranges)
+{
+	std::unique_ptr<SnapshotRing> ring;
+	if (!ranges.empty())
+	{
+		// a new object for every registration, a client still mapping the previous
+		// one can't mistake it for the new layout
+#ifdef _WIN32
+		const char* prefix = "Local\\";
+#else
+		const char* prefix = "/";
+#endif
+		const std::string name(StringUtil::StdStringFromFormat("%s%s.%u.%u.%u", prefix, IPC_EMULATOR_NAME, m_slot, client.id,
+			m_snapshot_serial.fetch_add(1, std::memory_order_relaxed)));
+
+		ring = std::make_unique<SnapshotRing>();
+		if (!ring->Create(name, std::move(ranges)))
+		{
+			Console.Error("IPC: Failed to create snapshot shared memory %s", name.c_str());
+			return false;
+		}
+	}
+
+	// the old ring is released after the lock, VSync() is done with it by then
+	std::lock_guard<std::mutex> lock(m_clients_mutex);
+	if (client.snapshot)
+		m_snapshot_count.fetch_sub(1, std::memory_order_release);
+	if (ring)
+		m_snapshot_count.fetch_add(1, std::memory_order_release);
+	client.snapshot.swap(ring);
+	return true;
+}
+
+void SocketIPC::VSync()
+{
+	if (m_snapshot_count.load(std::memory_order_acquire) == 0)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_clients_mutex);
+	for (const std::unique_ptr<Client>& client : m_clients)
+	{
+		if (client->snapshot)
+			client->snapshot->Write(g_FrameCount);
+	}
+}
+
+void SocketIPC::ReadRange(u8* dst, u32 address, u32 size)
+{
+	using namespace vtlb_private;
+
+	while (size > 0)
+	{
+		const u32 chunk = std::min<u32>(size, VTLB_PAGE_SIZE - (address & VTLB_PAGE_MASK));
+		const VTLBVirtual vmv = vtlbdata.vmap[address >> VTLB_PAGE_BITS];
+
+		if (!vmv.isHandler(address))
+			std::memcpy(dst, reinterpret_cast<const u8*>(vmv.assumePtr(address)), chunk);
+		else
+			std::memset(dst, 0, chunk);
+
+		dst += chunk;
+		address += chunk;
+		size -= chunk;
+	}
 }
 
-SocketIPC::IPCBuffer SocketIPC::ParseCommand(char* buf, char* ret_buffer, u32 buf_size)
+bool SocketIPC::IsRangeMapped(u32 address, u32 size)
+{
+	using namespace vtlb_private;
+
+	const u64 end = static_cast<u64>(address) + size;
+	for (u64 page = address & ~static_cast<u64>(VTLB_PAGE_MASK); page < end; page += VTLB_PAGE_SIZE)
+	{
+		const u32 vaddr = static_cast<u32>(std::max<u64>(page, address));
+		if (vtlbdata.vmap[vaddr >> VTLB_PAGE_BITS].isHandler(vaddr))
+			return false;
+	}
+
+	return true;
+}
+
+void SocketIPC::WriteRange(u32 address, const u8* src, u32 size)
+{
+	// through the handlers, writes can hit recompiled code or hardware registers
+	while (size > 0)
+	{
+		if (size >= 4 && (address & 3) == 0)
+		{
+			u32 value;
+			std::memcpy(&value, src, sizeof(value));
+			memWrite32(address, value);
+			address += 4;
+			src += 4;
+			size -= 4;
+		}
+		else
+		{
+			memWrite8(address, *src);
+			address++;
+			src++;
+			size--;
+		}
+	}
+}
+
+SocketIPC::IPCBuffer SocketIPC::ParseCommand(Client& client, char* buf, char* ret_buffer, u32 buf_size)
 {
 	u32 ret_cnt = 5;
 	u32 buf_cnt = 0;
@@ -491,6 +776,82 @@ SocketIPC::IPCBuffer SocketIPC::ParseCommand(char* buf, char* ret_buffer, u32 bu
 				ret_cnt += 4;
 				break;
 			}
+			// batched messages
+			//         IPC Message event (1 byte)
+			//         |  Memory address (4 byte)
+			//         |  |           Size (4 byte)
+			//         |  |           |           data (Size bytes, MsgWriteRange only)
+			//         |  |           |           |
+			// format: XX YY YY YY YY SS SS SS SS ZZ ...
+			case MsgReadRange:
+			{
+				if (!m_vm->HasActiveMachine())
+					goto error;
+				if (!SafetyChecks(buf_cnt, 8, ret_cnt, 0, buf_size))
+					goto error;
+				const u32 a = FromArray<u32>(&buf[buf_cnt], 0);
+				const u32 size = FromArray<u32>(&buf[buf_cnt], 4);
+				if (size >= MAX_IPC_RETURN_SIZE || !SafetyChecks(buf_cnt, 8, ret_cnt, size, buf_size))
+					goto error;
+				ReadRange(reinterpret_cast<u8*>(&ret_buffer[ret_cnt]), a, size);
+				ret_cnt += size;
+				buf_cnt += 8;
+				break;
+			}
+			case MsgWriteRange:
+			{
+				if (!m_vm->HasActiveMachine())
+					goto error;
+				if (!SafetyChecks(buf_cnt, 8, ret_cnt, 0, buf_size))
+					goto error;
+				const u32 a = FromArray<u32>(&buf[buf_cnt], 0);
+				const u32 size = FromArray<u32>(&buf[buf_cnt], 4);
+				if (size >= MAX_IPC_SIZE || !SafetyChecks(buf_cnt, 8 + size, ret_cnt, 0, buf_size))
+					goto error;
+				WriteRange(a, reinterpret_cast<const u8*>(&buf[buf_cnt + 8]), size);
+				buf_cnt += 8 + size;
+				break;
+			}
+			// format: XX CC CC CC CC [YY YY YY YY SS SS SS SS] * count
+			// reply: XX name of the shared memory object (256 bytes)
+			case MsgSnapshotRegister:
+			{
+				if (!m_vm->HasActiveMachine())
+					goto error;
+				if (!SafetyChecks(buf_cnt, 4, ret_cnt, 256, buf_size))
+					goto error;
+				const u32 count = FromArray<u32>(&buf[buf_cnt], 0);
+				if (count == 0 || count > MAX_SNAPSHOT_RANGES || !SafetyChecks(buf_cnt, 4 + count * 8, ret_cnt, 256, buf_size))
+					goto error;
+
+				std::vector<SnapshotRange> ranges(count);
+				u64 total = 0;
+				for (u32 i = 0; i < count; i++)
+				{
+					ranges[i].address = FromArray<u32>(&buf[buf_cnt], 4 + i * 8);
+					ranges[i].size = FromArray<u32>(&buf[buf_cnt], 8 + i * 8);
+					total += ranges[i].size;
+					if (ranges[i].size == 0 || static_cast<u64>(ranges[i].address) + ranges[i].size > 0x100000000ULL)
+						goto error;
+					// snapshots are taken on the EE thread, only plain memory can be read there
+					if (!IsRangeMapped(ranges[i].address, ranges[i].size))
+						goto error;
+				}
+				if (total > MAX_SNAPSHOT_SIZE || !SetSnapshot(client, std::move(ranges)))
+					goto error;
+
+				char name[256] = {};
+				snprintf(name, sizeof(name), "%s", client.snapshot->GetName().c_str());
+				memcpy(&ret_buffer[ret_cnt], name, 256);
+				ret_cnt += 256;
+				buf_cnt += 4 + count * 8;
+				break;
+			}
+			case MsgSnapshotUnregister:
+			{
+				SetSnapshot(client, {});
+				break;
+			}
 			default:
 			{
 			error:
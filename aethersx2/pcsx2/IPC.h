@@ -27,7 +27,12 @@
 
 #include "common/PersistentThread.h"
 #include "System/SysThreads.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 #ifdef _WIN32
 #include <WinSock2.h>
 #include <windows.h>
@@ -45,16 +50,15 @@ protected:
 	// windows claim to have support for AF_UNIX sockets but that is a blatant lie,
 	// their SDK won't even run their own examples, so we go on TCP sockets.
 	SOCKET m_sock = INVALID_SOCKET;
-	// the message socket used in thread's accept().
-	SOCKET m_msgsock = INVALID_SOCKET;
 #else
 	// absolute path of the socket. Stored in XDG_RUNTIME_DIR, if unset /tmp
 	std::string m_socket_name;
 	int m_sock = 0;
-	// the message socket used in thread's accept().
-	int m_msgsock = 0;
 #endif
 
+	// slot given at creation, part of the snapshot shared memory names
+	unsigned int m_slot;
+
 
 	/**
 	 * Maximum memory used by an IPC message request.
@@ -69,17 +73,18 @@ protected:
 #define MAX_IPC_RETURN_SIZE 450000
 
 	/**
-	 * IPC return buffer.
-	 * A preallocated buffer used to store all IPC replies.
-	 * to the size of 50.000 MsgWrite64 IPC calls.
+	 * Maximum number of clients connected at the same time.
+	 * Further connections are closed right away.
 	 */
-	char* m_ret_buffer;
+#define MAX_IPC_CLIENTS 16
 
 	/**
-	 * IPC messages buffer.
-	 * A preallocated buffer used to store all IPC messages.
+	 * Maximum number of ranges and total size of a snapshot.
+	 * The ring holds SNAPSHOT_SLOT_COUNT of them.
 	 */
-	char* m_ipc_buffer;
+#define MAX_SNAPSHOT_RANGES 4096
+#define MAX_SNAPSHOT_SIZE (16 * 1024 * 1024)
+#define SNAPSHOT_SLOT_COUNT 3
 
 	/**
 	 * IPC Command messages opcodes.  
@@ -105,9 +110,139 @@ protected:
 		MsgUUID = 0xD,          /**< Returns the game UUID. */
 		MsgGameVersion = 0xE,   /**< Returns the game verion. */
 		MsgStatus = 0xF,        /**< Returns the emulator status. */
+		MsgReadRange = 0x10,    /**< Reads a range of memory, MMIO reads as zero. */
+		MsgWriteRange = 0x11,   /**< Writes a range of memory. */
+		MsgSnapshotRegister = 0x12,   /**< Registers the ranges of per-vsync snapshots. */
+		MsgSnapshotUnregister = 0x13, /**< Stops per-vsync snapshots. */
 		MsgUnimplemented = 0xFF /**< Unimplemented IPC message. */
 	};
 
+public:
+	/**
+	 * Snapshot shared memory layout.
+	 * MsgSnapshotRegister creates a shared memory object for the client
+	 * (shm_open() on POSIX, a named file mapping on Windows) made of a
+	 * SnapshotHeader, the registered ranges as SnapshotRange, then
+	 * slot_count slots of slot_size bytes, 64 byte aligned, each made of a
+	 * SnapshotSlot followed by the content of every range, back to back.
+	 *
+	 * Ranges must lie in directly mapped memory (RAM, scratchpad, ROM),
+	 * registration fails otherwise. Pages unmapped later on read as zero.
+	 *
+	 * Every vsync the emulator thread copies the ranges into the next slot,
+	 * while the EE is stopped, so a slot is a consistent view of one frame.
+	 * The latest complete slot is (written - 1) % slot_count. Its sequence
+	 * is odd while the slot is being written: read it, copy the data, and
+	 * check that the sequence is still the same even value, otherwise the
+	 * slot was overwritten meanwhile and the copy must be retried.
+	 */
+	struct SnapshotHeader
+	{
+		u32 magic;      /**< SNAPSHOT_MAGIC */
+		u32 version;    /**< SNAPSHOT_VERSION */
+		u32 slot_count; /**< Slots in the ring. */
+		u32 slot_size;  /**< Size of a slot, SnapshotSlot included. */
+		u32 slot_offset; /**< Offset of the first slot. */
+		u32 range_count; /**< SnapshotRange entries after the header. */
+		u32 data_size;   /**< Sum of the range sizes. */
+		u32 pad;
+		std::atomic<u64> written; /**< Snapshots written so far. */
+	};
+
+	struct SnapshotRange
+	{
+		u32 address; /**< EE virtual address. */
+		u32 size;
+	};
+
+	struct SnapshotSlot
+	{
+		std::atomic<u32> sequence; /**< Odd while the slot is written. */
+		u32 frame;                 /**< Frame the snapshot was taken on. */
+		u64 pad;
+	};
+
+	static constexpr u32 SNAPSHOT_MAGIC = 0x504E5350; // 'PSNP'
+	static constexpr u32 SNAPSHOT_VERSION = 1;
+
+protected:
+	/**
+	 * Per-vsync snapshot ring of a client, in shared memory.
+	 */
+	class SnapshotRing
+	{
+	public:
+		SnapshotRing() = default;
+		~SnapshotRing();
+
+		/**
+		 * Creates the shared memory object for the given ranges.
+		 * return value: false if it couldn't be created.
+		 */
+		bool Create(const std::string& name, std::vector<SnapshotRange> ranges);
+
+		/**
+		 * Copies the ranges into the next slot, on the emulator thread.
+		 */
+		void Write(u32 frame);
+
+		const std::string& GetName() const { return m_name; }
+		const SnapshotHeader* GetHeader() const { return m_header; }
+
+	private:
+		void Destroy();
+
+		std::string m_name;
+		std::vector<SnapshotRange> m_ranges;
+		SnapshotHeader* m_header = nullptr;
+		size_t m_size = 0;
+#ifdef _WIN32
+		HANDLE m_mapping = NULL;
+#endif
+	};
+
+	/**
+	 * A connected client.
+	 * Each one is served by its own thread with its own buffers.
+	 */
+	struct Client
+	{
+#ifdef _WIN32
+		SOCKET sock = INVALID_SOCKET;
+#else
+		int sock = -1;
+#endif
+		u32 id = 0;
+		std::thread thread;
+		// set by the client thread once it is done with the socket
+		std::atomic<bool> done{false};
+
+		/**
+		 * IPC messages buffer.
+		 * A preallocated buffer used to store all IPC messages.
+		 */
+		std::unique_ptr<char[]> ipc_buffer;
+
+		/**
+		 * IPC return buffer.
+		 * A preallocated buffer used to store all IPC replies.
+		 * to the size of 50.000 MsgWrite64 IPC calls.
+		 */
+		std::unique_ptr<char[]> ret_buffer;
+
+		// snapshot ring, protected by m_clients_mutex as the vsync reads it
+		std::unique_ptr<SnapshotRing> snapshot;
+	};
+
+	// connected clients, and their snapshots
+	std::vector<std::unique_ptr<Client>> m_clients;
+	std::mutex m_clients_mutex;
+	u32 m_next_client_id = 0;
+	// registrations so far, keeps the shared memory names unique
+	std::atomic<u32> m_snapshot_serial{0};
+	// clients with a snapshot ring, lets VSync() skip the lock otherwise
+	std::atomic<u32> m_snapshot_count{0};
+
 	/**
 	 * Emulator status enum.
 	 * A list of possible emulator statuses.
@@ -144,9 +279,18 @@ protected:
 	// handle to the main vm thread
 	SysCoreThread* m_vm;
 
-	// Thread used to relay IPC commands.
+	// Thread used to accept IPC clients.
 	void ExecuteTaskInThread();
 
+	// Thread used to relay the IPC commands of a client.
+	void ClientThread(Client* client);
+
+	// Joins the threads of disconnected clients.
+	void ReapClients();
+
+	// Closes every client connection and joins their threads.
+	void CloseClients();
+
 	/**
 	 * Internal function, Parses an IPC command.
 	 * buf: buffer containing the IPC command.
@@ -155,7 +299,27 @@ protected:
 	 * return value: IPCBuffer containing a buffer with the result 
 	 *               of the command and its size. 
 	 */
-	IPCBuffer ParseCommand(char* buf, char* ret_buffer, u32 buf_size);
+	IPCBuffer ParseCommand(Client& client, char* buf, char* ret_buffer, u32 buf_size);
+
+	/**
+	 * Replaces the snapshot ring of a client, or removes it if ranges is empty.
+	 * return value: false if the new ring couldn't be created, the old one is kept.
+	 */
+	bool SetSnapshot(Client& client, std::vector<SnapshotRange> ranges);
+
+	/**
+	 * Copies a range of EE memory from the directly mapped pages (RAM,
+	 * scratchpad, ROM). Handler pages (MMIO, FIFOs, unmapped or TLB
+	 * missing addresses) read as zero: going through their handlers can
+	 * have side effects or raise CPU exceptions outside of the EE.
+	 */
+	static void ReadRange(u8* dst, u32 address, u32 size);
+
+	/**
+	 * return value: true if the range only covers directly mapped pages.
+	 */
+	static bool IsRangeMapped(u32 address, u32 size);
+	static void WriteRange(u32 address, const u8* src, u32 size);
 
 	/**
 	 * Formats an IPC buffer
@@ -167,10 +331,11 @@ protected:
 	static inline char* MakeFailIPC(char* ret_buffer, uint32_t size);
 
 	/**
-	 * Initializes an open socket for IPC communication.
-	 * return value: -1 if a fatal failure happened, 0 otherwise. 
+	 * Waits for a client to connect.
+	 * client: set to the accepted client, null if it failed but can be retried.
+	 * return value: -1 if a fatal failure happened, 0 otherwise.
 	 */
-	int StartSocket();
+	int AcceptClient(std::unique_ptr<Client>& client);
 
 	/**
 	 * Converts an uint to an char* in little endian 
@@ -221,4 +386,10 @@ public:
 	SocketIPC(SysCoreThread* vm, unsigned int slot = IPC_DEFAULT_SLOT);
 	virtual ~SocketIPC();
 
+	/**
+	 * Takes the snapshots registered by clients, called on the emulator
+	 * thread every vsync.
+	 */
+	void VSync();
+
 }; // class SocketIPC
@@ -18,6 +18,7 @@
 
 #include "IPU.h"
 #include "IPUdma.h"
+#include "IPUThread.h"
 
 #include <limits.h>
 #include "Config.h"
@@ -348,6 +349,19 @@ static __fi int bitstream_init()
 }
 
 
+static void mpeg2_idct_reference(s16* block);
+
+#if defined(_M_X86_32) || defined(_M_X86_64) || defined(_M_ARM64)
+
+#define mpeg2_idct mpeg2_idct_simd
+static void mpeg2_idct_simd(s16* block);
+
+#else
+
+#define mpeg2_idct mpeg2_idct_reference
+
+#endif
+
 static void mpeg2_idct_copy(s16* block, u8* dest, int stride);
 static void mpeg2_idct_add(int last, s16* block, s16* dest, int stride);
 
@@ -438,7 +452,9 @@ void tIPU_cmd::clear()
 	current = 0xffffffff;
 }
 
-__fi void IPUProcessInterrupt()
+// Runs the current command until it completes or stalls on a FIFO. Runs on the IPU thread
+// with Speedhacks.ipuThread, so it must not touch EE state other than through ipuThread.Signal().
+void IPUProcessCommand()
 {
 	if (ipuRegs.ctrl.BUSY) // && (g_BP.FP || g_BP.IFC || (ipu1ch.chcr.STR && ipu1ch.qwc > 0)))
 		IPUWorker();
@@ -451,11 +467,33 @@ __fi void IPUProcessInterrupt()
 	}
 }
 
+__fi void IPUProcessInterrupt()
+{
+	ipuThread.Wait();
+	IPUProcessCommand();
+}
+
+// Same as IPUProcessInterrupt(), for callers which don't look at the IPU state afterwards:
+// the command carries on on the IPU thread while the EE runs.
+void IPUProcessInterruptAsync()
+{
+	if (!THREAD_IPU)
+	{
+		IPUProcessInterrupt();
+		return;
+	}
+
+	ipuThread.Wait();
+	if (ipuRegs.ctrl.BUSY)
+		ipuThread.Start();
+}
+
 /////////////////////////////////////////////////////////
 // Register accesses (run on EE thread)
 
 void ipuReset()
 {
+	ipuThread.Wait();
 	memzero(ipuRegs);
 	memzero(g_BP);
 	memzero(decoder);
@@ -483,6 +521,7 @@ void SaveStateBase::ipuFreeze()
 {
 	// Get a report of the status of the ipu variables when saving and loading savestates.
 	//ReportIPU();
+	ipuThread.Wait();
 	FreezeTag("IPU");
 	Freeze(ipu_fifo);
 
@@ -689,12 +728,14 @@ __fi bool ipuWrite32(u32 mem, u32 value)
 	pxAssert((mem & ~0xfff) == 0x10002000);
 	mem &= 0xfff;
 
+	ipuThread.Wait();
+
 	switch (mem)
 	{
 		ipucase(IPU_CMD): // IPU_CMD
 			IPU_LOG("write32: IPU_CMD=0x%08X", value);
 			IPUCMD_WRITE(value);
-			IPUProcessInterrupt();
+			IPUProcessInterruptAsync();
 		return false;
 
 		ipucase(IPU_CTRL): // IPU_CTRL
@@ -725,12 +766,14 @@ __fi bool ipuWrite64(u32 mem, u64 value)
 	pxAssert((mem & ~0xfff) == 0x10002000);
 	mem &= 0xfff;
 
+	ipuThread.Wait();
+
 	switch (mem)
 	{
 		ipucase(IPU_CMD):
 			IPU_LOG("write64: IPU_CMD=0x%08X", value);
 			IPUCMD_WRITE((u32)value);
-			IPUProcessInterrupt();
+			IPUProcessInterruptAsync();
 		return false;
 	}
 
@@ -747,10 +790,12 @@ static void ipuBCLR(u32 val)
 	// as it is constantly fighting it....
 	while(ipu1ch.chcr.STR)
 	{
+		ipuThread.Wait();
 		ipu_fifo.in.clear();
 		ipu1Interrupt();
 	}
 	
+	ipuThread.Wait();
 	ipu_fifo.in.clear();
 
 	memzero(g_BP);
@@ -810,18 +855,26 @@ static __ri void ipuBDEC(tIPU_CMD_BDEC bdec)
 	memzero_sse_a(decoder.mb16);
 }
 
+void ipuVDECDone(bool fmv_detected)
+{
+	if (fmv_detected && !FMVstarted) {
+		EnableFMV = true;
+		FMVstarted = true;
+	}
+	eecount_on_last_vdec = cpuRegs.cycle;
+}
+
 static __fi bool ipuVDEC(u32 val)
 {
+	// The FMV detection state belongs to the EE, the IPU thread hands it over with an event.
 	if (EmuConfig.GS.FMVAspectRatioSwitch != FMVAspectRatioSwitchType::Off) {
 		static int count = 0;
+		u32 events = IPU_Thread::EVENT_VDEC;
 		if (count++ > 5) {
-			if (!FMVstarted) {
-				EnableFMV = true;
-				FMVstarted = true;
-			}
+			events |= IPU_Thread::EVENT_FMV_DETECTED;
 			count = 0;
 		}
-		eecount_on_last_vdec = cpuRegs.cycle;
+		ipuThread.Signal(events);
 	}
 	switch (ipu_cmd.pos[0])
 	{
@@ -1049,36 +1102,72 @@ static void ipuSETTH(u32 val)
 // --------------------------------------------------------------------------------------
 __fi void ipu_csc(macroblock_8& mb8, macroblock_rgb32& rgb32, int sgn)
 {
-	int i;
-	u8* p = (u8*)&rgb32;
-
 	yuv2rgb();
 
-	if (s_thresh[0] > 0)
+	if (s_thresh[0] == 0 && s_thresh[1] == 0 && !sgn)
+		return;
+
+	// A pixel below thresh[0] on all three channels is cleared, one below thresh[1] gets an
+	// alpha of 0x40. With thresh[0] == 0 nothing is below it, so both cases share one pass.
+#if defined(_M_X86_32) || defined(_M_X86_64)
+	const __m128i rgb_mask = _mm_set1_epi32(0x00ffffff);
+	const __m128i low_mask = _mm_set1_epi32(0xff);
+	const __m128i alpha_half = _mm_set1_epi32(0x40000000);
+	const __m128i thresh0 = _mm_set1_epi32(s_thresh[0]);
+	const __m128i thresh1 = _mm_set1_epi32(s_thresh[1]);
+	const __m128i sign = _mm_set1_epi32(sgn ? 0x808080 : 0);
+
+	__m128i* p = (__m128i*)&rgb32;
+	for (int i = 0; i < 16 * 16 / 4; i++, p++)
 	{
-		for (i = 0; i < 16*16; i++, p += 4)
-		{
-			if ((p[0] < s_thresh[0]) && (p[1] < s_thresh[0]) && (p[2] < s_thresh[0]))
-				*(u32*)p = 0;
-			else if ((p[0] < s_thresh[1]) && (p[1] < s_thresh[1]) && (p[2] < s_thresh[1]))
-				p[3] = 0x40;
-		}
+		const __m128i pix = _mm_loadu_si128(p);
+		const __m128i rgb = _mm_and_si128(pix, rgb_mask);
+		__m128i max = _mm_max_epu8(rgb, _mm_srli_epi32(rgb, 8));
+		max = _mm_and_si128(_mm_max_epu8(max, _mm_srli_epi32(max, 16)), low_mask);
+
+		const __m128i below0 = _mm_cmpgt_epi32(thresh0, max);
+		const __m128i below1 = _mm_cmpgt_epi32(thresh1, max);
+
+		__m128i res = _mm_blendv_epi8(pix, _mm_or_si128(rgb, alpha_half), below1);
+		res = _mm_andnot_si128(below0, res);
+		_mm_storeu_si128(p, _mm_xor_si128(res, sign));
 	}
-	else if (s_thresh[1] > 0)
+#elif defined(_M_ARM64)
+	const uint32x4_t rgb_mask = vdupq_n_u32(0x00ffffff);
+	const uint32x4_t low_mask = vdupq_n_u32(0xff);
+	const uint32x4_t alpha_half = vdupq_n_u32(0x40000000);
+	const uint32x4_t thresh0 = vdupq_n_u32(s_thresh[0]);
+	const uint32x4_t thresh1 = vdupq_n_u32(s_thresh[1]);
+	const uint32x4_t sign = vdupq_n_u32(sgn ? 0x808080 : 0);
+
+	u32* p = (u32*)&rgb32;
+	for (int i = 0; i < 16 * 16 / 4; i++, p += 4)
 	{
-		for (i = 0; i < 16*16; i++, p += 4)
-		{
-			if ((p[0] < s_thresh[1]) && (p[1] < s_thresh[1]) && (p[2] < s_thresh[1]))
-				p[3] = 0x40;
-		}
+		const uint32x4_t pix = vld1q_u32(p);
+		const uint32x4_t rgb = vandq_u32(pix, rgb_mask);
+		uint32x4_t max = vreinterpretq_u32_u8(vmaxq_u8(vreinterpretq_u8_u32(rgb), vreinterpretq_u8_u32(vshrq_n_u32(rgb, 8))));
+		max = vandq_u32(vreinterpretq_u32_u8(vmaxq_u8(vreinterpretq_u8_u32(max), vreinterpretq_u8_u32(vshrq_n_u32(max, 16)))), low_mask);
+
+		const uint32x4_t below0 = vcltq_u32(max, thresh0);
+		const uint32x4_t below1 = vcltq_u32(max, thresh1);
+
+		uint32x4_t res = vbslq_u32(below1, vorrq_u32(rgb, alpha_half), pix);
+		res = vbicq_u32(res, below0);
+		vst1q_u32(p, veorq_u32(res, sign));
 	}
-	if (sgn)
+#else
+	u8* p = (u8*)&rgb32;
+	for (int i = 0; i < 16 * 16; i++, p += 4)
 	{
-		for (i = 0; i < 16*16; i++, p += 4)
-		{
+		if ((p[0] < s_thresh[0]) && (p[1] < s_thresh[0]) && (p[2] < s_thresh[0]))
+			*(u32*)p = 0;
+		else if ((p[0] < s_thresh[1]) && (p[1] < s_thresh[1]) && (p[2] < s_thresh[1]))
+			p[3] = 0x40;
+
+		if (sgn)
 			*(u32*)p ^= 0x808080;
-		}
 	}
+#endif
 }
 
 __fi void ipu_vq(macroblock_rgb16& rgb16, u8* indx4)
@@ -1260,13 +1349,9 @@ __noinline void IPUWorker()
 	// success
 	ipuRegs.ctrl.BUSY = 0;
 	//ipu_cmd.current = 0xffffffff;
-	hwIntcIrq(INTC_IPU);
 
-	// Fill the FIFO ready for the next command
-	if (ipu1ch.chcr.STR && cpuRegs.eCycle[4] == 0x9999)
-	{
-		CPU_INT(DMAC_TO_IPU, 32);
-	}
+	// Raise the interrupt and fill the FIFO ready for the next command
+	ipuThread.Signal(IPU_Thread::EVENT_INTERRUPT | IPU_Thread::EVENT_COMMAND_DONE);
 }
 
 static const DCTtab* tab;
@@ -2481,9 +2566,8 @@ static __fi void BUTTERFLY(int& t0, int& t1, int w0, int w1, int d0, int d1)
 #endif
 }
 
-__ri void mpeg2_idct(s16* block)
+__ri void mpeg2_idct_reference(s16* block)
 {
-	// TODO-some-time: SIMD-ify this
 	for (int i = 0; i < 8; i++)
 	{
 		s16* const rblock = block + 8 * i;
@@ -2591,10 +2675,233 @@ __ri void mpeg2_idct(s16* block)
 	}
 }
 
+#if defined(_M_X86_32) || defined(_M_X86_64) || defined(_M_ARM64)
+
+// Four rows (or columns) of the IDCT at once, in 32-bit lanes so the results match
+// mpeg2_idct_reference() bit for bit, including its truncation to s16 between the passes.
+#if defined(_M_X86_32) || defined(_M_X86_64)
+
+typedef __m128i idct_s16x8;
+typedef __m128i idct_s32x4;
+
+static __fi idct_s32x4 idct_add(idct_s32x4 a, idct_s32x4 b) { return _mm_add_epi32(a, b); }
+static __fi idct_s32x4 idct_sub(idct_s32x4 a, idct_s32x4 b) { return _mm_sub_epi32(a, b); }
+static __fi idct_s32x4 idct_mul(idct_s32x4 a, s32 b) { return _mm_mullo_epi32(a, _mm_set1_epi32(b)); }
+static __fi idct_s32x4 idct_set(s32 a) { return _mm_set1_epi32(a); }
+template <int n> static __fi idct_s32x4 idct_shl(idct_s32x4 a) { return _mm_slli_epi32(a, n); }
+template <int n> static __fi idct_s32x4 idct_sra(idct_s32x4 a) { return _mm_srai_epi32(a, n); }
+
+static __fi idct_s16x8 idct_load(const s16* src) { return _mm_load_si128((const __m128i*)src); }
+static __fi void idct_store(s16* dst, idct_s16x8 a) { _mm_store_si128((__m128i*)dst, a); }
+static __fi idct_s32x4 idct_widen_lo(idct_s16x8 a) { return _mm_cvtepi16_epi32(a); }
+static __fi idct_s32x4 idct_widen_hi(idct_s16x8 a) { return _mm_cvtepi16_epi32(_mm_unpackhi_epi64(a, a)); }
+
+static __fi idct_s16x8 idct_narrow(idct_s32x4 lo, idct_s32x4 hi)
+{
+	// Drop the top 16 bits like a store to s16 would, packs would saturate instead.
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+	return _mm_packs_epi32(lo, hi);
+}
+
+static __fi void idct_transpose(idct_s16x8 (&v)[8])
+{
+	const __m128i a0 = _mm_unpacklo_epi16(v[0], v[1]);
+	const __m128i a1 = _mm_unpackhi_epi16(v[0], v[1]);
+	const __m128i a2 = _mm_unpacklo_epi16(v[2], v[3]);
+	const __m128i a3 = _mm_unpackhi_epi16(v[2], v[3]);
+	const __m128i a4 = _mm_unpacklo_epi16(v[4], v[5]);
+	const __m128i a5 = _mm_unpackhi_epi16(v[4], v[5]);
+	const __m128i a6 = _mm_unpacklo_epi16(v[6], v[7]);
+	const __m128i a7 = _mm_unpackhi_epi16(v[6], v[7]);
+
+	const __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+	const __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+	const __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+	const __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+	const __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+	const __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+	const __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+	const __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+	v[0] = _mm_unpacklo_epi64(b0, b4);
+	v[1] = _mm_unpackhi_epi64(b0, b4);
+	v[2] = _mm_unpacklo_epi64(b1, b5);
+	v[3] = _mm_unpackhi_epi64(b1, b5);
+	v[4] = _mm_unpacklo_epi64(b2, b6);
+	v[5] = _mm_unpackhi_epi64(b2, b6);
+	v[6] = _mm_unpacklo_epi64(b3, b7);
+	v[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+#elif defined(_M_ARM64)
+
+typedef int16x8_t idct_s16x8;
+typedef int32x4_t idct_s32x4;
+
+static __fi idct_s32x4 idct_add(idct_s32x4 a, idct_s32x4 b) { return vaddq_s32(a, b); }
+static __fi idct_s32x4 idct_sub(idct_s32x4 a, idct_s32x4 b) { return vsubq_s32(a, b); }
+static __fi idct_s32x4 idct_mul(idct_s32x4 a, s32 b) { return vmulq_n_s32(a, b); }
+static __fi idct_s32x4 idct_set(s32 a) { return vdupq_n_s32(a); }
+template <int n> static __fi idct_s32x4 idct_shl(idct_s32x4 a) { return vshlq_n_s32(a, n); }
+template <int n> static __fi idct_s32x4 idct_sra(idct_s32x4 a) { return vshrq_n_s32(a, n); }
+
+static __fi idct_s16x8 idct_load(const s16* src) { return vld1q_s16(src); }
+static __fi void idct_store(s16* dst, idct_s16x8 a) { vst1q_s16(dst, a); }
+static __fi idct_s32x4 idct_widen_lo(idct_s16x8 a) { return vmovl_s16(vget_low_s16(a)); }
+static __fi idct_s32x4 idct_widen_hi(idct_s16x8 a) { return vmovl_s16(vget_high_s16(a)); }
+
+// vmovn truncates, which is what a store to s16 does.
+static __fi idct_s16x8 idct_narrow(idct_s32x4 lo, idct_s32x4 hi) { return vcombine_s16(vmovn_s32(lo), vmovn_s32(hi)); }
+
+static __fi void idct_transpose(idct_s16x8 (&v)[8])
+{
+	const int16x8x2_t t0 = vtrnq_s16(v[0], v[1]);
+	const int16x8x2_t t1 = vtrnq_s16(v[2], v[3]);
+	const int16x8x2_t t2 = vtrnq_s16(v[4], v[5]);
+	const int16x8x2_t t3 = vtrnq_s16(v[6], v[7]);
+
+	const int32x4x2_t u0 = vtrnq_s32(vreinterpretq_s32_s16(t0.val[0]), vreinterpretq_s32_s16(t1.val[0]));
+	const int32x4x2_t u1 = vtrnq_s32(vreinterpretq_s32_s16(t0.val[1]), vreinterpretq_s32_s16(t1.val[1]));
+	const int32x4x2_t u2 = vtrnq_s32(vreinterpretq_s32_s16(t2.val[0]), vreinterpretq_s32_s16(t3.val[0]));
+	const int32x4x2_t u3 = vtrnq_s32(vreinterpretq_s32_s16(t2.val[1]), vreinterpretq_s32_s16(t3.val[1]));
+
+	v[0] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u0.val[0]), vget_low_s32(u2.val[0])));
+	v[1] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u1.val[0]), vget_low_s32(u3.val[0])));
+	v[2] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u0.val[1]), vget_low_s32(u2.val[1])));
+	v[3] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u1.val[1]), vget_low_s32(u3.val[1])));
+	v[4] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u0.val[0]), vget_high_s32(u2.val[0])));
+	v[5] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u1.val[0]), vget_high_s32(u3.val[0])));
+	v[6] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u0.val[1]), vget_high_s32(u2.val[1])));
+	v[7] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u1.val[1]), vget_high_s32(u3.val[1])));
+}
+
+#endif
+
+static __fi void BUTTERFLY(idct_s32x4& t0, idct_s32x4& t1, int w0, int w1, idct_s32x4 d0, idct_s32x4 d1)
+{
+	const idct_s32x4 tmp = idct_mul(idct_add(d0, d1), w0);
+	t0 = idct_add(tmp, idct_mul(d1, w1 - w0));
+	t1 = idct_sub(tmp, idct_mul(d0, w1 + w0));
+}
+
+// One pass of mpeg2_idct_reference() on four rows (or columns), x[i] holds element i of each.
+template <bool column>
+static __fi void mpeg2_idct_pass(idct_s32x4 (&x)[8])
+{
+	idct_s32x4 a0, a1, a2, a3;
+	{
+		const idct_s32x4 d0 = idct_add(idct_shl<11>(x[0]), idct_set(column ? 65536 : 128));
+		const idct_s32x4 d2 = idct_shl<11>(x[2]);
+		const idct_s32x4 t0 = idct_add(d0, d2);
+		const idct_s32x4 t1 = idct_sub(d0, d2);
+		idct_s32x4 t2, t3;
+		BUTTERFLY(t2, t3, W6, W2, x[3], x[1]);
+		a0 = idct_add(t0, t2);
+		a1 = idct_add(t1, t3);
+		a2 = idct_sub(t1, t3);
+		a3 = idct_sub(t0, t2);
+	}
+
+	idct_s32x4 b0, b1, b2, b3;
+	{
+		idct_s32x4 t0, t1, t2, t3;
+		BUTTERFLY(t0, t1, W7, W1, x[7], x[4]);
+		BUTTERFLY(t2, t3, W3, W5, x[5], x[6]);
+		b0 = idct_add(t0, t2);
+		b3 = idct_add(t1, t3);
+		t0 = idct_sub(t0, t2);
+		t1 = idct_sub(t1, t3);
+		if (column)
+		{
+			t0 = idct_sra<8>(t0);
+			t1 = idct_sra<8>(t1);
+			b1 = idct_mul(idct_add(t0, t1), 181);
+			b2 = idct_mul(idct_sub(t0, t1), 181);
+		}
+		else
+		{
+			b1 = idct_sra<8>(idct_mul(idct_add(t0, t1), 181));
+			b2 = idct_sra<8>(idct_mul(idct_sub(t0, t1), 181));
+		}
+	}
+
+	constexpr int shift = column ? 17 : 8;
+	x[0] = idct_sra<shift>(idct_add(a0, b0));
+	x[1] = idct_sra<shift>(idct_add(a1, b1));
+	x[2] = idct_sra<shift>(idct_add(a2, b2));
+	x[3] = idct_sra<shift>(idct_add(a3, b3));
+	x[4] = idct_sra<shift>(idct_sub(a3, b3));
+	x[5] = idct_sra<shift>(idct_sub(a2, b2));
+	x[6] = idct_sra<shift>(idct_sub(a1, b1));
+	x[7] = idct_sra<shift>(idct_sub(a0, b0));
+}
+
+// Runs a pass on all eight rows of v, with v[i] holding element i of every row.
+template <bool column>
+static __fi void mpeg2_idct_pass8(idct_s16x8 (&v)[8])
+{
+	idct_s32x4 lo[8], hi[8];
+	for (int i = 0; i < 8; i++)
+	{
+		lo[i] = idct_widen_lo(v[i]);
+		hi[i] = idct_widen_hi(v[i]);
+	}
+
+	mpeg2_idct_pass<column>(lo);
+	mpeg2_idct_pass<column>(hi);
+
+	for (int i = 0; i < 8; i++)
+		v[i] = idct_narrow(lo[i], hi[i]);
+}
+
+__ri void mpeg2_idct_simd(s16* block)
+{
+	idct_s16x8 v[8];
+	for (int i = 0; i < 8; i++)
+		v[i] = idct_load(block + 8 * i);
+
+	// Rows first: transpose so each vector holds one coefficient of all eight rows.
+	idct_transpose(v);
+	mpeg2_idct_pass8<false>(v);
+
+	// And back, each vector now holds one row, which is one element of every column.
+	idct_transpose(v);
+	mpeg2_idct_pass8<true>(v);
+
+	for (int i = 0; i < 8; i++)
+		idct_store(block + 8 * i, v[i]);
+}
+
+#endif
+
 __ri void mpeg2_idct_copy(s16* block, u8* dest, const int stride)
 {
 	mpeg2_idct(block);
 
+#if defined(_M_X86_32) || defined(_M_X86_64)
+	// packus clamps to 0..255 like clip_lut, without reading past it on corrupted streams.
+	const __m128i zero = _mm_setzero_si128();
+	for (int i = 0; i < 8; i++)
+	{
+		const __m128i row = _mm_load_si128((const __m128i*)block);
+		_mm_storel_epi64((__m128i*)dest, _mm_packus_epi16(row, row));
+		_mm_store_si128((__m128i*)block, zero);
+
+		dest += stride;
+		block += 8;
+	}
+#elif defined(_M_ARM64)
+	const int16x8_t zero = vdupq_n_s16(0);
+	for (int i = 0; i < 8; i++)
+	{
+		vst1_u8(dest, vqmovun_s16(vld1q_s16(block)));
+		vst1q_s16(block, zero);
+
+		dest += stride;
+		block += 8;
+	}
+#else
 	for (int i = 0; i < 8; i++)
 	{
 		dest[0] = (clip_lut.data() + 384)[block[0]];
@@ -2611,6 +2918,7 @@ __ri void mpeg2_idct_copy(s16* block, u8* dest, const int stride)
 		dest += stride;
 		block += 8;
 	}
+#endif
 }
 
 
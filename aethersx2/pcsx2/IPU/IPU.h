@@ -295,3 +295,6 @@ extern bool ipuWrite64(u32 mem,u64 value);
 extern void IPUCMD_WRITE(u32 val);
 extern void ipuSoftReset();
 extern void IPUProcessInterrupt();
+extern void IPUProcessInterruptAsync();
+extern void IPUProcessCommand();
+extern void ipuVDECDone(bool fmv_detected);
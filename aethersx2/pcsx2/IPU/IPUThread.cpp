@@ -0,0 +1,134 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Common.h"
+#include "IPU.h"
+#include "IPU/IPUThread.h"
+#include "common/PersistentThread.h"
+
+#include <utility>
+
+IPU_Thread ipuThread;
+
+static thread_local bool s_is_ipu_thread = false;
+
+IPU_Thread::IPU_Thread() = default;
+
+IPU_Thread::~IPU_Thread()
+{
+	Shutdown();
+}
+
+bool IPU_Thread::IsIPUThread()
+{
+	return s_is_ipu_thread;
+}
+
+void IPU_Thread::ThreadEntryPoint()
+{
+	Threading::SetNameOfCurrentThread("IPU Thread");
+	s_is_ipu_thread = true;
+	m_sema_done.Post();
+
+	for (;;)
+	{
+		m_sema_run.WaitWithoutYieldWithSpin();
+		if (m_shutdown.load(std::memory_order_acquire))
+			break;
+
+		try
+		{
+			IPUProcessCommand();
+		}
+		catch (...)
+		{
+			m_exception = std::current_exception();
+		}
+
+		m_sema_done.Post();
+	}
+}
+
+void IPU_Thread::Start()
+{
+	pxAssert(!m_pending && !s_is_ipu_thread);
+
+	if (!m_running.load(std::memory_order_acquire))
+	{
+		m_shutdown.store(false, std::memory_order_relaxed);
+		m_thread = std::thread(&IPU_Thread::ThreadEntryPoint, this);
+		m_sema_done.WaitWithoutYield();
+		m_running.store(true, std::memory_order_release);
+	}
+
+	m_pending = true;
+	m_sema_run.Post();
+}
+
+void IPU_Thread::Wait()
+{
+	if (!m_pending)
+		return;
+
+	pxAssert(!s_is_ipu_thread);
+
+	m_sema_done.WaitWithoutYieldWithSpin();
+	m_pending = false;
+
+	if (m_exception)
+		std::rethrow_exception(std::exchange(m_exception, nullptr));
+
+	RaiseEvents(std::exchange(m_events, 0));
+}
+
+void IPU_Thread::Signal(u32 events)
+{
+	if (s_is_ipu_thread)
+		m_events |= events;
+	else
+		RaiseEvents(events);
+}
+
+void IPU_Thread::RaiseEvents(u32 events)
+{
+	if (events & EVENT_INTERRUPT)
+		hwIntcIrq(INTC_IPU);
+
+	if ((events & EVENT_INPUT_WANTED) || ((events & EVENT_COMMAND_DONE) && ipu1ch.chcr.STR))
+	{
+		if (cpuRegs.eCycle[4] == 0x9999)
+			CPU_INT(DMAC_TO_IPU, 32);
+	}
+
+	if ((events & EVENT_OUTPUT_READY) && ipu0ch.chcr.STR)
+		IPU_INT_FROM(64);
+
+	if (events & EVENT_VDEC)
+		ipuVDECDone((events & EVENT_FMV_DETECTED) != 0);
+}
+
+void IPU_Thread::Shutdown()
+{
+	pxAssert(!m_pending);
+
+	if (!m_running.load(std::memory_order_acquire))
+		return;
+
+	m_shutdown.store(true, std::memory_order_release);
+	m_sema_run.Post();
+	m_thread.join();
+	m_running.store(false, std::memory_order_release);
+}
@@ -0,0 +1,81 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/Threading.h"
+
+#include <atomic>
+#include <exception>
+#include <thread>
+
+// Runs IPU commands on their own host thread (Speedhacks.ipuThread).
+//
+// Writing IPU_CMD, feeding the input FIFO or draining the output FIFO by DMA hands the current
+// command to the IPU thread, which decodes until it runs out of input or fills the output FIFO,
+// while the EE carries on. The IPU thread owns ipuRegs, the FIFOs and the decoder state until
+// the EE takes them back with Wait(), which every EE event test does first, as does any EE code
+// touching the IPU (register and FIFO accesses, the IPU DMA channels, reset and savestates).
+//
+// The IPU thread doesn't write EE state: interrupts, DMA kicks and the FMV detection of VDEC
+// commands are recorded and replayed by the next Wait(), on the EE thread. It still reads
+// EmuConfig, which the EE thread only changes while the IPU is idle.
+class IPU_Thread
+{
+public:
+	enum Event : u32
+	{
+		EVENT_INTERRUPT = 1 << 0,    // hwIntcIrq(INTC_IPU)
+		EVENT_INPUT_WANTED = 1 << 1, // the input FIFO is running low, resume a waiting IPU1 DMA
+		EVENT_COMMAND_DONE = 1 << 2, // as above, if the IPU1 DMA is still active
+		EVENT_OUTPUT_READY = 1 << 3, // the output FIFO has data for the IPU0 DMA
+		EVENT_VDEC = 1 << 4,         // a VDEC command ran, ipuVDECDone()
+		EVENT_FMV_DETECTED = 1 << 5, // as above, enough of them to switch to the FMV aspect ratio
+	};
+
+	IPU_Thread();
+	~IPU_Thread();
+
+	// EE thread: runs the current command on the IPU thread, starting it if needed.
+	void Start();
+
+	// EE thread: waits for the IPU thread, then raises the events it recorded.
+	// Does nothing on the IPU thread.
+	void Wait();
+
+	// Raises the events right away on the EE thread, or leaves them to Wait() on the IPU thread.
+	void Signal(u32 events);
+
+	// Joins the thread, Wait() must have been called before.
+	void Shutdown();
+
+	static bool IsIPUThread();
+
+private:
+	void ThreadEntryPoint();
+	static void RaiseEvents(u32 events);
+
+	std::thread m_thread;
+	Threading::Semaphore m_sema_run;
+	Threading::Semaphore m_sema_done;
+	std::exception_ptr m_exception;
+
+	bool m_pending = false; // EE thread only
+	u32 m_events = 0;       // IPU thread only while a command runs
+	std::atomic<bool> m_running{false};
+	std::atomic<bool> m_shutdown{false};
+};
+
+extern IPU_Thread ipuThread;
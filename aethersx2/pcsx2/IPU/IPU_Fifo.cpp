@@ -17,6 +17,7 @@
 #include "Common.h"
 #include "IPU.h"
 #include "IPU/IPUdma.h"
+#include "IPU/IPUThread.h"
 
 __aligned16 IPU_Fifo ipu_fifo;
 
@@ -87,10 +88,7 @@ int IPU_Fifo_Input::read(void *value)
 	if (g_BP.IFC < 3)
 	{
 		// IPU FIFO is empty and DMA is waiting so lets tell the DMA we are ready to put data in the FIFO
-		if(cpuRegs.eCycle[4] == 0x9999)
-		{
-			CPU_INT( DMAC_TO_IPU, 32 );
-		}
+		ipuThread.Signal(IPU_Thread::EVENT_INPUT_WANTED);
 
 		if (g_BP.IFC == 0) return 0;
 		pxAssert(g_BP.IFC > 0);
@@ -124,8 +122,7 @@ int IPU_Fifo_Output::write(const u32 *value, uint size)
 			--transsize;
 		}
 	/*} while(true);*/
-	if(ipu0ch.chcr.STR)
-		IPU_INT_FROM(64);
+	ipuThread.Signal(IPU_Thread::EVENT_OUTPUT_READY);
 	return origsize - size;
 }
 
@@ -151,6 +148,8 @@ void IPU_Fifo_Output::read(void *value, uint size)
 
 void __fastcall ReadFIFO_IPUout(mem128_t* out)
 {
+	ipuThread.Wait();
+
 	if (!pxAssertDev( ipuRegs.ctrl.OFC > 0, "Attempted read from IPUout's FIFO, but the FIFO is empty!" )) return;
 	ipu_fifo.out.read(out, 1);
 
@@ -161,10 +160,11 @@ void __fastcall ReadFIFO_IPUout(mem128_t* out)
 void __fastcall WriteFIFO_IPUin(const mem128_t* value)
 {
 	IPU_LOG( "WriteFIFO/IPUin <- %ls", WX_STR(value->ToString()) );
+	ipuThread.Wait();
 
 	//committing every 16 bytes
 	if( ipu_fifo.in.write((u32*)value, 1) == 0 )
 	{
-		IPUProcessInterrupt();
+		IPUProcessInterruptAsync();
 	}
 }
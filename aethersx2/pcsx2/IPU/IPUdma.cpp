@@ -17,12 +17,15 @@
 #include "Common.h"
 #include "IPU.h"
 #include "IPU/IPUdma.h"
+#include "IPU/IPUThread.h"
 
 static IPUStatus IPU1Status;
 static tIPU_DMA g_nDMATransfer;
 
 void ipuDmaReset()
 {
+	ipuThread.Wait();
+
 	IPU1Status.InProgress	= false;
 	IPU1Status.DMAMode		= DMA_MODE_NORMAL;
 	IPU1Status.DMAFinished	= true;
@@ -32,6 +35,7 @@ void ipuDmaReset()
 
 void SaveStateBase::ipuDmaFreeze()
 {
+	ipuThread.Wait();
 	FreezeTag( "IPUdma" );
 	Freeze(g_nDMATransfer);
 	Freeze(IPU1Status);
@@ -107,6 +111,8 @@ int IPU1dma()
 	int ipu1cycles = 0;
 	int totalqwc = 0;
 
+	ipuThread.Wait();
+
 	//We need to make sure GIF has flushed before sending IPU data, it seems to REALLY screw FFX videos
 
 	if(!ipu1ch.chcr.STR || IPU1Status.DMAMode == DMA_MODE_INTERLEAVE)
@@ -176,7 +182,7 @@ int IPU1dma()
 	if(totalqwc > 0 || ipu1ch.qwc == 0)
 	{
 		IPU_INT_TO(totalqwc * BIAS);
-		IPUProcessInterrupt();
+		IPUProcessInterruptAsync();
 	}
 	else 
 	{
@@ -189,9 +195,11 @@ int IPU1dma()
 
 void IPU0dma()
 {
+	ipuThread.Wait();
+
 	if(!ipuRegs.ctrl.OFC) 
 	{
-		IPUProcessInterrupt();
+		IPUProcessInterruptAsync();
 		return;
 	}
 
@@ -247,7 +255,7 @@ void IPU0dma()
 	//Note that interrupting based on totalsize is just guessing..
 	
 	IPU_INT_FROM( readsize * BIAS );
-	if (ipuRegs.ctrl.IFC > 0) { IPUProcessInterrupt(); }
+	if (ipuRegs.ctrl.IFC > 0) { IPUProcessInterruptAsync(); }
 
 	//return readsize;
 }
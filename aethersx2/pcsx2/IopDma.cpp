@@ -19,6 +19,7 @@
 
 #include "Sif.h"
 #include "DEV9/DEV9.h"
+#include "MTIOP.h"
 
 using namespace R3000A;
 
@@ -142,6 +143,8 @@ void spu2DMA7Irq()
 void psxDma2(u32 madr, u32 bcr, u32 chcr) // GPU
 {
 	//DevCon.Warning("SIF2 IOP CHCR = %x MADR = %x BCR = %x first 16bits %x", chcr, madr, bcr, iopMemRead16(madr));
+	iopThread.WaitEE();
+
 	sif2.iop.busy = true;
 	sif2.iop.end = false;
 	//SIF2Dma();
@@ -204,6 +207,9 @@ void psxDma9(u32 madr, u32 bcr, u32 chcr)
 {
 	SIF_LOG("IOP: dmaSIF0 chcr = %lx, madr = %lx, bcr = %lx, tadr = %lx", chcr, madr, bcr, HW_DMA9_TADR);
 
+	// SIF transfers run both ends at once, the EE half touches EE memory and the DMAC.
+	iopThread.WaitEE();
+
 	sif0.iop.busy = true;
 	sif0.iop.end = false;
 
@@ -214,6 +220,8 @@ void psxDma10(u32 madr, u32 bcr, u32 chcr)
 {
 	SIF_LOG("IOP: dmaSIF1 chcr = %lx, madr = %lx, bcr = %lx", chcr, madr, bcr);
 
+	iopThread.WaitEE();
+
 	sif1.iop.busy = true;
 	sif1.iop.end = false;
 
@@ -19,6 +19,7 @@
 #include "ps2/pgif.h" // for PSX kernel TTY in iopMemWrite32
 #include "SPU2/spu2.h"
 #include "DEV9/DEV9.h"
+#include "MTIOP.h"
 
 uptr *psxMemWLUT = NULL;
 const uptr *psxMemRLUT = NULL;
@@ -184,6 +185,9 @@ u16 __fastcall iopMemRead16(u32 mem)
 		{
 			if (t == 0x1d00)
 			{
+				// SBUS registers live in EE hardware memory.
+				iopThread.WaitEE();
+
 				u16 ret;
 				switch(mem & 0xF0)
 				{
@@ -244,6 +248,8 @@ u32 __fastcall iopMemRead32(u32 mem)
 		{
 			if (t == 0x1d00)
 			{
+				iopThread.WaitEE();
+
 				u32 ret;
 				switch(mem & 0x8F0)
 				{
@@ -361,6 +367,8 @@ void __fastcall iopMemWrite16(u32 mem, u16 value)
 		{
 			if (t == 0x1d00)
 			{
+				iopThread.WaitEE();
+
 				switch (mem & 0x8f0)
 				{
 					case 0x10:
@@ -434,6 +442,8 @@ void __fastcall iopMemWrite32(u32 mem, u32 value)
 		{
 			if (t == 0x1d00)
 			{
+				iopThread.WaitEE();
+
 				MEM_LOG("iop Sif reg write %x value %x", mem, value);
 				switch (mem & 0x8f0)
 				{
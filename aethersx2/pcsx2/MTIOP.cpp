@@ -0,0 +1,166 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Common.h"
+#include "MTIOP.h"
+#include "R3000A.h"
+
+#include "common/PersistentThread.h"
+
+#include <utility>
+
+IOP_Thread iopThread;
+
+// Spins before WaitEE() starts yielding, the EE is usually parked within a few microseconds.
+static constexpr u32 WAIT_EE_SPIN_COUNT = 4096;
+
+static thread_local bool s_is_iop_thread = false;
+
+// IOP thread only, set once the EE has been parked during the current slice.
+static bool s_ee_synced = false;
+
+IOP_Thread::IOP_Thread() = default;
+
+IOP_Thread::~IOP_Thread()
+{
+	Shutdown();
+}
+
+bool IOP_Thread::IsIOPThread()
+{
+	return s_is_iop_thread;
+}
+
+void IOP_Thread::ThreadEntryPoint()
+{
+	Threading::SetNameOfCurrentThread("IOP Thread");
+	s_is_iop_thread = true;
+	m_cpu_timer = Common::ThreadCPUTimer::GetForCallingThread();
+	m_sema_done.Post();
+
+	for (;;)
+	{
+		m_sema_slice.WaitWithoutYieldWithSpin();
+		if (m_shutdown.load(std::memory_order_acquire))
+			break;
+
+		s_ee_synced = false;
+
+		try
+		{
+			cpuExecuteIOP();
+		}
+		catch (...)
+		{
+			m_exception = std::current_exception();
+		}
+
+		m_slices.fetch_add(1, std::memory_order_relaxed);
+		if (s_ee_synced)
+			m_ee_syncs.fetch_add(1, std::memory_order_relaxed);
+
+		m_sema_done.Post();
+	}
+}
+
+void IOP_Thread::ExecuteSlice()
+{
+	pxAssert(!m_slice_pending);
+
+	if (!m_running.load(std::memory_order_acquire))
+	{
+		m_shutdown.store(false, std::memory_order_relaxed);
+		m_thread = std::thread(&IOP_Thread::ThreadEntryPoint, this);
+		m_sema_done.WaitWithoutYield();
+		m_running.store(true, std::memory_order_release);
+	}
+
+	m_slice_pending = true;
+	m_slice_start_cycle = cpuRegs.cycle;
+	m_sema_slice.Post();
+}
+
+void IOP_Thread::WaitIOP()
+{
+	if (!m_slice_pending)
+		return;
+
+	pxAssert(!s_is_iop_thread);
+
+	const Common::Timer::Value start = Common::Timer::GetCurrentValue();
+
+	m_ee_parked.store(true, std::memory_order_release);
+	m_sema_done.WaitWithoutYieldWithSpin();
+	m_ee_parked.store(false, std::memory_order_relaxed);
+	m_slice_pending = false;
+
+	m_ee_wait_time.fetch_add(Common::Timer::GetCurrentValue() - start, std::memory_order_relaxed);
+
+	const u32 skew = cpuRegs.cycle - m_slice_start_cycle;
+	if (skew > m_max_skew.load(std::memory_order_relaxed))
+		m_max_skew.store(skew, std::memory_order_relaxed);
+
+	if (m_exception)
+		std::rethrow_exception(std::exchange(m_exception, nullptr));
+}
+
+void IOP_Thread::WaitEE()
+{
+	if (!s_is_iop_thread || s_ee_synced)
+		return;
+
+	const Common::Timer::Value start = Common::Timer::GetCurrentValue();
+
+	for (u32 spins = 0; !m_ee_parked.load(std::memory_order_acquire); spins++)
+	{
+		if (spins < WAIT_EE_SPIN_COUNT)
+			Threading::SpinWait();
+		else
+			Threading::Timeslice();
+	}
+
+	s_ee_synced = true;
+	m_iop_wait_time.fetch_add(Common::Timer::GetCurrentValue() - start, std::memory_order_relaxed);
+}
+
+void IOP_Thread::Shutdown()
+{
+	pxAssert(!m_slice_pending);
+
+	if (!m_running.load(std::memory_order_acquire))
+		return;
+
+	m_shutdown.store(true, std::memory_order_release);
+	m_sema_slice.Post();
+	m_thread.join();
+	m_running.store(false, std::memory_order_release);
+}
+
+IOP_Thread::Stats IOP_Thread::GetAndResetStats()
+{
+	Stats stats;
+	stats.ee_wait_time = m_ee_wait_time.exchange(0, std::memory_order_relaxed);
+	stats.iop_wait_time = m_iop_wait_time.exchange(0, std::memory_order_relaxed);
+	stats.slices = m_slices.exchange(0, std::memory_order_relaxed);
+	stats.ee_syncs = m_ee_syncs.exchange(0, std::memory_order_relaxed);
+	stats.max_skew = m_max_skew.exchange(0, std::memory_order_relaxed);
+	return stats;
+}
+
+u64 IOP_Thread::GetCpuTime() const
+{
+	return m_running.load(std::memory_order_acquire) ? m_cpu_timer.GetCurrentValue() : 0;
+}
@@ -0,0 +1,96 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/Threading.h"
+#include "common/Timer.h"
+
+#include <atomic>
+#include <exception>
+#include <thread>
+
+// Runs the IOP on its own host thread (Speedhacks.iopThread).
+//
+// Every EE event test hands the IOP the cycles the EE ran since the previous one and carries
+// on, the IOP catches up in the background. While a slice runs the IOP thread owns psxRegs,
+// IOP memory and EEsCycle. The EE takes them back with WaitIOP(), which every event test does
+// first, as does any EE code touching IOP state (SIF DMA, PS1 mode SBUS registers) and anything
+// running outside of Cpu->Execute().
+//
+// IOP code touching EE state (SIF DMA and SBUS registers) calls WaitEE() first, which blocks
+// until the EE is parked in WaitIOP(); the rest of that slice then runs with the EE stopped.
+// The EE schedules its next event test at most Speedhacks.IopThreadMaxSkew cycles after
+// handing out a slice, which bounds both the skew and how long the IOP can be stalled.
+class IOP_Thread
+{
+public:
+	struct Stats
+	{
+		u64 ee_wait_time;  // Common::Timer ticks the EE spent in WaitIOP()
+		u64 iop_wait_time; // Common::Timer ticks the IOP spent in WaitEE()
+		u32 slices;
+		u32 ee_syncs;      // slices which ended with the EE parked for an IOP access
+		u32 max_skew;      // EE cycles run past the start of a slice, worst case
+	};
+
+	IOP_Thread();
+	~IOP_Thread();
+
+	// EE thread: runs the IOP for EEsCycle on the IOP thread, starting it if needed.
+	void ExecuteSlice();
+
+	// EE thread: waits for the current slice, rethrowing anything the IOP thread threw.
+	void WaitIOP();
+
+	// IOP thread: waits until the EE is parked in WaitIOP(). Does nothing on other threads.
+	void WaitEE();
+
+	// Joins the thread, WaitIOP() must have been called before.
+	void Shutdown();
+
+	// Returns and clears the counters, safe to call from any thread.
+	Stats GetAndResetStats();
+
+	// Common::ThreadCPUTimer value of the IOP thread, 0 when it isn't running.
+	u64 GetCpuTime() const;
+
+	static bool IsIOPThread();
+
+private:
+	void ThreadEntryPoint();
+
+	std::thread m_thread;
+	Threading::Semaphore m_sema_slice;
+	Threading::Semaphore m_sema_done;
+	Common::ThreadCPUTimer m_cpu_timer;
+	std::exception_ptr m_exception;
+
+	bool m_slice_pending = false; // EE thread only
+	u32 m_slice_start_cycle = 0;  // EE thread only
+	std::atomic<bool> m_running{false};
+	std::atomic<bool> m_shutdown{false};
+
+	// Note: keep on its own cache line, the IOP thread spins on it in WaitEE()
+	__aligned(64) std::atomic<bool> m_ee_parked{false};
+
+	std::atomic<u64> m_ee_wait_time{0};
+	std::atomic<u64> m_iop_wait_time{0};
+	std::atomic<u32> m_slices{0};
+	std::atomic<u32> m_ee_syncs{0};
+	std::atomic<u32> m_max_skew{0};
+};
+
+extern IOP_Thread iopThread;
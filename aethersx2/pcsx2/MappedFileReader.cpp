@@ -0,0 +1,152 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "AsyncFileReader.h"
+#include "Config.h"
+#include "common/FileSystem.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+MappedFileReader::MappedFileReader()
+	: m_data(nullptr)
+	, m_size(0)
+	, m_lastReadEnd(0)
+	, m_advisedEnd(0)
+	, m_result(0)
+{
+	m_blocksize = 2048;
+}
+
+MappedFileReader::~MappedFileReader(void)
+{
+	Close();
+}
+
+bool MappedFileReader::Open(std::string fileName)
+{
+	Close();
+	m_filename = std::move(fileName);
+
+	m_data = static_cast<u8*>(FileSystem::MapFileReadOnly(m_filename.c_str(), &m_size));
+	if (!m_data)
+	{
+		m_size = 0;
+		return false;
+	}
+
+	DevCon.WriteLn("isoFile: mapped %zu MB of %s", m_size / _1mb, m_filename.c_str());
+	return true;
+}
+
+void MappedFileReader::Advise(u64 offset, u64 size)
+{
+	const u64 end = std::min<u64>(offset + size, m_size);
+
+	// The range has to start on a page boundary
+	offset &= ~static_cast<u64>(__pagesize - 1);
+	if (offset >= end)
+		return;
+
+#ifdef _WIN32
+	WIN32_MEMORY_RANGE_ENTRY range;
+	range.VirtualAddress = m_data + offset;
+	range.NumberOfBytes = static_cast<SIZE_T>(end - offset);
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+	madvise(m_data + offset, static_cast<size_t>(end - offset), MADV_WILLNEED);
+#endif
+}
+
+const u8* MappedFileReader::MapSectors(uint sector, uint count)
+{
+	const s64 offset = sector * (s64)m_blocksize + m_dataoffset;
+	const u64 size = count * (u64)m_blocksize;
+	if (!m_data || offset < 0 || static_cast<u64>(offset) + size > m_size)
+		return nullptr;
+
+	// A seek only asks for the request itself, streams keep one read-ahead window
+	// ahead of the reads, extended in big steps rather than a syscall per read.
+	const u64 end = static_cast<u64>(offset) + size;
+	const u64 window = EmuConfig.Cdvd.ReadAheadKB * 1024ull;
+	if (static_cast<u64>(offset) != m_lastReadEnd)
+	{
+		Advise(offset, size);
+		m_advisedEnd = end;
+	}
+	else if (m_advisedEnd < end + window / 2)
+	{
+		const u64 from = std::max(m_advisedEnd, static_cast<u64>(offset));
+		Advise(from, end + window - from);
+		m_advisedEnd = end + window;
+	}
+	m_lastReadEnd = end;
+
+	return m_data + offset;
+}
+
+int MappedFileReader::ReadSync(void* pBuffer, uint sector, uint count)
+{
+	BeginRead(pBuffer, sector, count);
+	return FinishRead();
+}
+
+void MappedFileReader::BeginRead(void* pBuffer, uint sector, uint count)
+{
+	const u8* src = MapSectors(sector, count);
+	if (src)
+		std::memcpy(pBuffer, src, count * m_blocksize);
+
+	m_result = src ? 1 : -1;
+}
+
+int MappedFileReader::FinishRead(void)
+{
+	return m_result;
+}
+
+void MappedFileReader::CancelRead(void)
+{
+}
+
+void MappedFileReader::Close(void)
+{
+	if (m_data)
+		FileSystem::UnmapFile(m_data, m_size);
+
+	m_data = nullptr;
+	m_size = 0;
+	m_lastReadEnd = 0;
+	m_advisedEnd = 0;
+}
+
+uint MappedFileReader::GetBlockCount(void) const
+{
+	return static_cast<uint>(m_size / m_blocksize);
+}
+
+void MappedFileReader::Prefetch(uint sector, uint count)
+{
+	const s64 offset = sector * (s64)m_blocksize + m_dataoffset;
+	if (m_data && offset >= 0)
+		Advise(offset, count * (u64)m_blocksize);
+}
+
+const u8* MappedFileReader::GetSectorData(uint sector, uint count)
+{
+	return MapSectors(sector, count);
+}
@@ -0,0 +1,348 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "MemoryCardCache.h"
+
+#include "common/Console.h"
+#include "common/FileSystem.h"
+#include "common/PersistentThread.h"
+#include "common/Timer.h"
+
+#include <chrono>
+#include <zlib.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static constexpr u32 JOURNAL_MAGIC = 0x4a434d50; // PMCJ
+static constexpr u32 JOURNAL_VERSION = 1;
+
+#pragma pack(push, 1)
+struct JournalHeader
+{
+	u32 magic;
+	u32 version;
+	u32 page_count;
+	u32 crc; // of everything following the header
+};
+
+struct JournalPage
+{
+	u32 offset;
+	u32 size;
+};
+#pragma pack(pop)
+
+static bool SyncFile(std::FILE* fp)
+{
+	if (std::fflush(fp) != 0)
+		return false;
+
+#ifdef _WIN32
+	return _commit(_fileno(fp)) == 0;
+#else
+	return fsync(fileno(fp)) == 0;
+#endif
+}
+
+MemoryCardCache::MemoryCardCache() = default;
+
+MemoryCardCache::~MemoryCardCache()
+{
+	Close();
+}
+
+std::string MemoryCardCache::GetJournalPath(const std::string& path)
+{
+	return path + ".journal";
+}
+
+bool MemoryCardCache::Open(const std::string& path)
+{
+	pxAssert(!IsOpened());
+
+	if (!ReplayJournal(path))
+	{
+		Console.Error("(FileMcd) Failed to replay the write journal of %s, leaving the card disabled.", path.c_str());
+		return false;
+	}
+
+	std::optional<std::vector<u8>> data(FileSystem::ReadBinaryFile(path.c_str()));
+	if (!data.has_value() || data->empty())
+		return false;
+
+	m_data = std::move(data.value());
+	m_path = path;
+	m_dirty.assign((m_data.size() + PAGE_SIZE - 1) / PAGE_SIZE, false);
+	m_dirty_count = 0;
+	m_shutdown = false;
+	m_thread = std::thread(&MemoryCardCache::WriterThread, this);
+	return true;
+}
+
+void MemoryCardCache::Close()
+{
+	if (!IsOpened())
+		return;
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_shutdown = true;
+	}
+	m_cv.notify_one();
+	m_thread.join();
+
+	m_path.clear();
+	std::vector<u8>().swap(m_data);
+	m_dirty.clear();
+	m_dirty_count = 0;
+}
+
+bool MemoryCardCache::Read(u8* dest, u32 offset, u32 size) const
+{
+	if (offset > m_data.size() || size > m_data.size() - offset)
+		return false;
+
+	// Only the emulation thread modifies the image, no need to lock against the writer.
+	std::memcpy(dest, &m_data[offset], size);
+	return true;
+}
+
+bool MemoryCardCache::Write(const u8* src, u32 offset, u32 size)
+{
+	if (offset > m_data.size() || size > m_data.size() - offset)
+		return false;
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		std::memcpy(&m_data[offset], src, size);
+		MarkDirty(offset, size);
+		m_last_write = Common::Timer::GetCurrentValue();
+	}
+	m_cv.notify_one();
+
+	return true;
+}
+
+void MemoryCardCache::MarkDirty(u32 offset, u32 size)
+{
+	if (size == 0)
+		return;
+
+	for (u32 page = offset / PAGE_SIZE, last = (offset + size - 1) / PAGE_SIZE; page <= last; page++)
+	{
+		if (!m_dirty[page])
+		{
+			m_dirty[page] = true;
+			m_dirty_count++;
+		}
+	}
+}
+
+std::vector<MemoryCardCache::Page> MemoryCardCache::TakeDirtyPages()
+{
+	std::vector<Page> pages;
+	pages.reserve(m_dirty_count);
+
+	for (u32 page = 0; page < m_dirty.size(); page++)
+	{
+		if (!m_dirty[page])
+			continue;
+
+		const u32 offset = page * PAGE_SIZE;
+		const u32 size = std::min<u32>(PAGE_SIZE, static_cast<u32>(m_data.size()) - offset);
+		pages.push_back({offset, std::vector<u8>(m_data.begin() + offset, m_data.begin() + offset + size)});
+		m_dirty[page] = false;
+	}
+
+	m_dirty_count = 0;
+	return pages;
+}
+
+void MemoryCardCache::WriterThread()
+{
+	Threading::SetNameOfCurrentThread("Memory Card Writer");
+
+	const u64 delay = Common::Timer::ConvertMillisecondsToValue(FLUSH_DELAY_MS);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	for (;;)
+	{
+		m_cv.wait(lock, [this]() { return m_shutdown || m_dirty_count > 0; });
+
+		// Games write a save in many small bursts, wait for the card to go quiet first.
+		while (!m_shutdown && m_dirty_count > 0)
+		{
+			const u64 idle = Common::Timer::GetCurrentValue() - m_last_write;
+			if (idle >= delay)
+				break;
+
+			m_cv.wait_for(lock, std::chrono::milliseconds(static_cast<s64>(Common::Timer::ConvertValueToMilliseconds(delay - idle)) + 1));
+		}
+
+		if (m_dirty_count == 0)
+		{
+			if (m_shutdown)
+				break;
+
+			continue;
+		}
+
+		std::vector<Page> pages(TakeDirtyPages());
+		lock.unlock();
+
+		Common::Timer timer;
+		const bool written = WriteJournal(m_path, pages) && WritePages(m_path, pages) &&
+							 FileSystem::DeleteFilePath(GetJournalPath(m_path).c_str());
+
+		lock.lock();
+
+		if (written)
+		{
+			DevCon.WriteLn("(FileMcd) Flushed %zu pages of %s in %.2f ms.", pages.size(), m_path.c_str(), timer.GetTimeMilliseconds());
+			continue;
+		}
+
+		Console.Error("(FileMcd) Failed to write back %s.", m_path.c_str());
+		if (m_shutdown)
+			break;
+
+		// Retry later. A journal which made it to the disk is replaced by the next one, which holds the same pages.
+		for (const Page& page : pages)
+			MarkDirty(page.offset, static_cast<u32>(page.data.size()));
+		m_last_write = Common::Timer::GetCurrentValue();
+	}
+}
+
+bool MemoryCardCache::WriteJournal(const std::string& path, const std::vector<Page>& pages)
+{
+	const std::string journal_path(GetJournalPath(path));
+	const std::string temp_path(journal_path + ".tmp");
+
+	uLong crc = crc32(0L, Z_NULL, 0);
+	for (const Page& page : pages)
+	{
+		const JournalPage jp = {page.offset, static_cast<u32>(page.data.size())};
+		crc = crc32(crc, reinterpret_cast<const Bytef*>(&jp), sizeof(jp));
+		crc = crc32(crc, page.data.data(), static_cast<uInt>(page.data.size()));
+	}
+
+	{
+		auto fp = FileSystem::OpenManagedCFile(temp_path.c_str(), "wb");
+		if (!fp)
+			return false;
+
+		const JournalHeader header = {JOURNAL_MAGIC, JOURNAL_VERSION, static_cast<u32>(pages.size()), static_cast<u32>(crc)};
+		if (std::fwrite(&header, sizeof(header), 1, fp.get()) != 1)
+			return false;
+
+		for (const Page& page : pages)
+		{
+			const JournalPage jp = {page.offset, static_cast<u32>(page.data.size())};
+			if (std::fwrite(&jp, sizeof(jp), 1, fp.get()) != 1 ||
+				std::fwrite(page.data.data(), page.data.size(), 1, fp.get()) != 1)
+			{
+				return false;
+			}
+		}
+
+		if (!SyncFile(fp.get()))
+			return false;
+	}
+
+	// The rename is the commit point, a journal under its final name is always complete.
+	return FileSystem::RenamePath(temp_path.c_str(), journal_path.c_str());
+}
+
+bool MemoryCardCache::WritePages(const std::string& path, const std::vector<Page>& pages)
+{
+	auto fp = FileSystem::OpenManagedCFile(path.c_str(), "r+b");
+	if (!fp)
+		return false;
+
+	for (const Page& page : pages)
+	{
+		if (FileSystem::FSeek64(fp.get(), page.offset, SEEK_SET) != 0 ||
+			std::fwrite(page.data.data(), page.data.size(), 1, fp.get()) != 1)
+		{
+			return false;
+		}
+	}
+
+	return SyncFile(fp.get());
+}
+
+bool MemoryCardCache::ReplayJournal(const std::string& path)
+{
+	const std::string journal_path(GetJournalPath(path));
+	const std::string temp_path(journal_path + ".tmp");
+
+	// Never renamed, so the card file wasn't touched by that flush.
+	if (FileSystem::FileExists(temp_path.c_str()))
+		FileSystem::DeleteFilePath(temp_path.c_str());
+
+	if (!FileSystem::FileExists(journal_path.c_str()))
+		return true;
+
+	std::optional<std::vector<u8>> journal(FileSystem::ReadBinaryFile(journal_path.c_str()));
+	if (!journal.has_value())
+		return false;
+
+	const std::vector<u8>& data = journal.value();
+	JournalHeader header;
+	if (data.size() < sizeof(header))
+		return false;
+
+	std::memcpy(&header, data.data(), sizeof(header));
+	const u8* ptr = data.data() + sizeof(header);
+	const u8* end = data.data() + data.size();
+
+	if (header.magic != JOURNAL_MAGIC || header.version != JOURNAL_VERSION ||
+		crc32(crc32(0L, Z_NULL, 0), ptr, static_cast<uInt>(end - ptr)) != header.crc)
+	{
+		Console.Error("(FileMcd) Write journal %s is corrupted.", journal_path.c_str());
+		return false;
+	}
+
+	std::vector<Page> pages;
+	pages.reserve(header.page_count);
+
+	for (u32 i = 0; i < header.page_count; i++)
+	{
+		JournalPage jp;
+		if (static_cast<size_t>(end - ptr) < sizeof(jp))
+			return false;
+
+		std::memcpy(&jp, ptr, sizeof(jp));
+		ptr += sizeof(jp);
+
+		if (jp.size > PAGE_SIZE || static_cast<size_t>(end - ptr) < jp.size)
+			return false;
+
+		pages.push_back({jp.offset, std::vector<u8>(ptr, ptr + jp.size)});
+		ptr += jp.size;
+	}
+
+	if (!WritePages(path, pages))
+		return false;
+
+	Console.WriteLn("(FileMcd) Replayed %zu pages from the write journal of %s.", pages.size(), path.c_str());
+	return FileSystem::DeleteFilePath(journal_path.c_str());
+}
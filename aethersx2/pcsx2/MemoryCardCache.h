@@ -0,0 +1,84 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/Pcsx2Defs.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Memory card file held in RAM (EmuConfig.McdWriteBack).
+//
+// Reads and writes only touch the in-memory image, the pages written since the last flush are
+// tracked in a bitmap. Once the card has been left alone for FLUSH_DELAY_MS a writer thread
+// copies them out and commits them to "<card>.journal", which is written under a temporary name,
+// synced and renamed into place. The pages are then written to the card file and the journal is
+// deleted. A journal left behind by a crash is replayed when the card is opened again, so the card
+// file always ends up holding either the old or the new contents of every flush.
+class MemoryCardCache
+{
+public:
+	// A card erase block, 16 sectors of 512 bytes plus ECC.
+	static constexpr u32 PAGE_SIZE = 528 * 16;
+	static constexpr u32 FLUSH_DELAY_MS = 1000;
+
+	MemoryCardCache();
+	~MemoryCardCache();
+
+	// Replays a pending journal and loads the whole file.
+	bool Open(const std::string& path);
+
+	// Writes back everything still pending and stops the writer thread.
+	void Close();
+
+	bool IsOpened() const { return !m_path.empty(); }
+	const std::string& GetPath() const { return m_path; }
+	u32 GetSize() const { return static_cast<u32>(m_data.size()); }
+
+	// Offsets are file offsets, both fail on a range which isn't entirely inside the file.
+	bool Read(u8* dest, u32 offset, u32 size) const;
+	bool Write(const u8* src, u32 offset, u32 size);
+
+private:
+	struct Page
+	{
+		u32 offset;
+		std::vector<u8> data;
+	};
+
+	static std::string GetJournalPath(const std::string& path);
+	static bool ReplayJournal(const std::string& path);
+	static bool WriteJournal(const std::string& path, const std::vector<Page>& pages);
+	static bool WritePages(const std::string& path, const std::vector<Page>& pages);
+
+	void WriterThread();
+	std::vector<Page> TakeDirtyPages();
+	void MarkDirty(u32 offset, u32 size);
+
+	std::string m_path;
+	std::vector<u8> m_data;
+
+	std::thread m_thread;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_cv;
+	std::vector<bool> m_dirty; // per page, m_mutex
+	u32 m_dirty_count = 0;     // m_mutex
+	u64 m_last_write = 0;      // Common::Timer value of the latest Write(), m_mutex
+	bool m_shutdown = false;   // m_mutex
+};
@@ -26,6 +26,7 @@ struct Component_FileMcd;
 
 #include "MemoryCardFile.h"
 #include "MemoryCardFolder.h"
+#include "MemoryCardCache.h"
 
 #include "System.h"
 #include "Config.h"
@@ -153,12 +154,14 @@ static bool ConvertRAWtoNoECC(wxString file_in, wxString file_out)
 // --------------------------------------------------------------------------------------
 //  FileMemoryCard
 // --------------------------------------------------------------------------------------
-// Provides thread-safe direct file IO mapping.
+// Provides thread-safe direct file IO mapping, or with EmuConfig.McdWriteBack, cards held in
+// RAM and written back in the background (see MemoryCardCache).
 //
 class FileMemoryCard
 {
 protected:
 	wxFFile m_file[8];
+	MemoryCardCache m_cache[8];
 	u8 m_effeffs[528 * 16];
 	SafeArray<u8> m_currentdata;
 	u64 m_chksum[8];
@@ -184,7 +187,11 @@ public:
 	u64 GetCRC(uint slot);
 
 protected:
-	bool Seek(wxFFile& f, u32 adr);
+	u32 GetLength(uint slot);
+	u32 GetDataOffset(uint slot);
+	wxString GetFileName(uint slot);
+	bool ReadAt(uint slot, u8* dest, u32 offset, int size);
+	bool WriteAt(uint slot, const u8* src, u32 offset, int size);
 	bool Create(const wxString& mcdFile, uint sizeInMB);
 
 	wxString GetDisabledMessage(uint slot) const
@@ -342,7 +349,8 @@ void FileMemoryCard::Open()
 			str = newname;
 		}
 
-		if (!m_file[slot].Open(str.c_str(), L"r+b"))
+		const bool opened = EmuConfig.McdWriteBack ? m_cache[slot].Open(StringUtil::wxStringToUTF8String(str)) : m_file[slot].Open(str.c_str(), L"r+b");
+		if (!opened)
 		{
 			// Translation note: detailed description should mention that the memory card will be disabled
 			// for the duration of this session.
@@ -354,11 +362,11 @@ void FileMemoryCard::Open()
 		}
 		else // Load checksum
 		{
-			m_ispsx[slot] = m_file[slot].Length() == 0x20000;
+			m_ispsx[slot] = GetLength(slot) == 0x20000;
 			m_chkaddr = 0x210;
 
-			if (!m_ispsx[slot] && !!m_file[slot].Seek(m_chkaddr))
-				m_file[slot].Read(&m_chksum[slot], 8);
+			if (!m_ispsx[slot])
+				ReadAt(slot, reinterpret_cast<u8*>(&m_chksum[slot]), m_chkaddr, 8);
 		}
 	}
 }
@@ -367,17 +375,20 @@ void FileMemoryCard::Close()
 {
 	for (int slot = 0; slot < 8; ++slot)
 	{
-		if (m_file[slot].IsOpened())
+		if (IsPresent(slot))
 		{
 			// Store checksum
-			if (!m_ispsx[slot] && !!m_file[slot].Seek(m_chkaddr))
-				m_file[slot].Write(&m_chksum[slot], 8);
+			if (!m_ispsx[slot])
+				WriteAt(slot, reinterpret_cast<const u8*>(&m_chksum[slot]), m_chkaddr, 8);
 
+			const wxString name = GetFileName(slot);
+
+			// Waits for the cached card to be written back.
+			m_cache[slot].Close();
 			m_file[slot].Close();
 
-			if (m_file[slot].GetName().EndsWith(".binx"))
+			if (name.EndsWith(".binx"))
 			{
-				wxString name = m_file[slot].GetName();
 				wxString name_old = name.SubString(0, name.Last('.')) + "bin";
 				if (ConvertRAWtoNoECC(name, name_old))
 					wxRemoveFile(name);
@@ -386,10 +397,37 @@ void FileMemoryCard::Close()
 	}
 }
 
-// Returns FALSE if the seek failed (is outside the bounds of the file).
-bool FileMemoryCard::Seek(wxFFile& f, u32 adr)
+u32 FileMemoryCard::GetLength(uint slot)
+{
+	return m_cache[slot].IsOpened() ? m_cache[slot].GetSize() : static_cast<u32>(m_file[slot].Length());
+}
+
+wxString FileMemoryCard::GetFileName(uint slot)
+{
+	return m_cache[slot].IsOpened() ? StringUtil::UTF8StringToWxString(m_cache[slot].GetPath()) : m_file[slot].GetName();
+}
+
+// Offsets are from the start of the file, see GetDataOffset() for card addresses.
+bool FileMemoryCard::ReadAt(uint slot, u8* dest, u32 offset, int size)
+{
+	if (m_cache[slot].IsOpened())
+		return m_cache[slot].Read(dest, offset, size);
+
+	return m_file[slot].Seek(offset) && m_file[slot].Read(dest, size) != 0;
+}
+
+bool FileMemoryCard::WriteAt(uint slot, const u8* src, u32 offset, int size)
+{
+	if (m_cache[slot].IsOpened())
+		return m_cache[slot].Write(src, offset, size);
+
+	return m_file[slot].Seek(offset) && m_file[slot].Write(src, size) != 0;
+}
+
+// Returns the file offset of card address 0.
+u32 FileMemoryCard::GetDataOffset(uint slot)
 {
-	const u32 size = f.Length();
+	const u32 size = GetLength(slot);
 
 	// If anyone knows why this filesize logic is here (it appears to be related to legacy PSX
 	// cards, perhaps hacked support for some special emulator-specific memcard formats that
@@ -406,7 +444,7 @@ bool FileMemoryCard::Seek(wxFFile& f, u32 adr)
 		// perform sanity checks here?
 	}
 
-	return f.Seek(adr + offset);
+	return offset;
 }
 
 // returns FALSE if an error occurred (either permission denied or disk full)
@@ -430,7 +468,7 @@ bool FileMemoryCard::Create(const wxString& mcdFile, uint sizeInMB)
 
 s32 FileMemoryCard::IsPresent(uint slot)
 {
-	return m_file[slot].IsOpened();
+	return m_file[slot].IsOpened() || m_cache[slot].IsOpened();
 }
 
 void FileMemoryCard::GetSizeInfo(uint slot, McdSizeInfo& outways)
@@ -439,8 +477,8 @@ void FileMemoryCard::GetSizeInfo(uint slot, McdSizeInfo& outways)
 	outways.EraseBlockSizeInSectors = 16; // 0x0010
 	outways.Xor = 18;                     // 0x12, XOR 02 00 00 10
 
-	if (pxAssert(m_file[slot].IsOpened()))
-		outways.McdSizeInSectors = m_file[slot].Length() / (outways.SectorSize + outways.EraseBlockSizeInSectors);
+	if (pxAssert(IsPresent(slot)))
+		outways.McdSizeInSectors = GetLength(slot) / (outways.SectorSize + outways.EraseBlockSizeInSectors);
 	else
 		outways.McdSizeInSectors = 0x4000;
 
@@ -455,28 +493,25 @@ bool FileMemoryCard::IsPSX(uint slot)
 
 s32 FileMemoryCard::Read(uint slot, u8* dest, u32 adr, int size)
 {
-	wxFFile& mcfp(m_file[slot]);
-	if (!mcfp.IsOpened())
+	if (!IsPresent(slot))
 	{
 		DevCon.Error("(FileMcd) Ignoring attempted read from disabled slot.");
 		memset(dest, 0, size);
 		return 1;
 	}
-	if (!Seek(mcfp, adr))
-		return 0;
-	return mcfp.Read(dest, size) != 0;
+	return ReadAt(slot, dest, GetDataOffset(slot) + adr, size);
 }
 
 s32 FileMemoryCard::Save(uint slot, const u8* src, u32 adr, int size)
 {
-	wxFFile& mcfp(m_file[slot]);
-
-	if (!mcfp.IsOpened())
+	if (!IsPresent(slot))
 	{
 		DevCon.Error("(FileMcd) Ignoring attempted save/write to disabled slot.");
 		return 1;
 	}
 
+	const u32 offset = GetDataOffset(slot) + adr;
+
 	if (m_ispsx[slot])
 	{
 		m_currentdata.MakeRoomFor(size);
@@ -485,10 +520,9 @@ s32 FileMemoryCard::Save(uint slot, const u8* src, u32 adr, int size)
 	}
 	else
 	{
-		if (!Seek(mcfp, adr))
-			return 0;
 		m_currentdata.MakeRoomFor(size);
-		mcfp.Read(m_currentdata.GetPtr(), size);
+		if (!ReadAt(slot, m_currentdata.GetPtr(), offset, size))
+			return 0;
 
 
 		for (int i = 0; i < size; i++)
@@ -511,10 +545,7 @@ s32 FileMemoryCard::Save(uint slot, const u8* src, u32 adr, int size)
 		}
 	}
 
-	if (!Seek(mcfp, adr))
-		return 0;
-
-	int status = mcfp.Write(m_currentdata.GetPtr(), size);
+	const bool status = WriteAt(slot, m_currentdata.GetPtr(), offset, size);
 
 	if (status)
 	{
@@ -524,7 +555,7 @@ s32 FileMemoryCard::Save(uint slot, const u8* src, u32 adr, int size)
 		if (elapsed > std::chrono::seconds(5))
 		{
 			wxString name, ext;
-			wxFileName::SplitPath(m_file[slot].GetName(), NULL, NULL, &name, &ext);
+			wxFileName::SplitPath(GetFileName(slot), NULL, NULL, &name, &ext);
 			Host::AddOSDMessage(StringUtil::StdStringFromFormat("Memory Card %s written.", (const char*)(name + "." + ext).c_str()), 10.0f);
 			last = std::chrono::system_clock::now();
 		}
@@ -536,40 +567,35 @@ s32 FileMemoryCard::Save(uint slot, const u8* src, u32 adr, int size)
 
 s32 FileMemoryCard::EraseBlock(uint slot, u32 adr)
 {
-	wxFFile& mcfp(m_file[slot]);
-
-	if (!mcfp.IsOpened())
+	if (!IsPresent(slot))
 	{
 		DevCon.Error("MemoryCard: Ignoring erase for disabled slot.");
 		return 1;
 	}
 
-	if (!Seek(mcfp, adr))
-		return 0;
-	return mcfp.Write(m_effeffs, sizeof(m_effeffs)) != 0;
+	return WriteAt(slot, m_effeffs, GetDataOffset(slot) + adr, sizeof(m_effeffs));
 }
 
 u64 FileMemoryCard::GetCRC(uint slot)
 {
-	wxFFile& mcfp(m_file[slot]);
-	if (!mcfp.IsOpened())
+	if (!IsPresent(slot))
 		return 0;
 
 	u64 retval = 0;
 
 	if (m_ispsx[slot])
 	{
-		if (!Seek(mcfp, 0))
-			return 0;
-
 		// Process the file in 4k chunks.  Speeds things up significantly.
+		// A cached card is summed from memory, without touching the file.
 
 		u64 buffer[528 * 8]; // use 528 (sector size), ensures even divisibility
 
-		const uint filesize = mcfp.Length() / sizeof(buffer);
-		for (uint i = filesize; i; --i)
+		const uint filesize = GetLength(slot) / sizeof(buffer);
+		u32 offset = GetDataOffset(slot);
+		for (uint i = filesize; i; --i, offset += sizeof(buffer))
 		{
-			mcfp.Read(&buffer, sizeof(buffer));
+			if (!ReadAt(slot, reinterpret_cast<u8*>(buffer), offset, sizeof(buffer)))
+				break;
 			for (uint t = 0; t < ArraySize(buffer); ++t)
 				retval ^= buffer[t];
 		}
@@ -22,12 +22,36 @@
 #include "System.h"
 #include "Config.h"
 
+#include "common/FileSystem.h"
+#include "common/StringUtil.h"
+
 #include "yaml-cpp/yaml.h"
 
+#include <algorithm>
+#include <zlib.h>
+
 #include "svnrev.h"
 
 bool RemoveDirectory(const wxString& dirname);
 
+static const wxChar* ClusterIndexFileName = L"_pcsx2_cluster_index";
+static constexpr u32 ClusterIndexMagic = 0x58444943; // CIDX
+static constexpr u32 ClusterIndexVersion = 1;
+
+#pragma pack(push, 1)
+struct ClusterIndexHeader
+{
+	u32 magic;
+	u32 version;
+	u32 folderFingerprint;
+	u32 superBlockCrc;
+	u32 filteringEnabled;
+	u32 filterCrc;
+	u32 entryClusterCount;
+	u32 crc; // of everything following the header
+};
+#pragma pack(pop)
+
 // A helper function to parse the YAML file
 static YAML::Node LoadYAMLFromFile(const wxString& fileName)
 {
@@ -62,6 +86,11 @@ FolderMemoryCard::FolderMemoryCard()
 	m_timeLastWritten = 0;
 	m_filteringEnabled = false;
 	m_filteringString = L"";
+	m_fileEntryClustersValid = false;
+	m_openTimeMs = 0;
+	m_flushCount = 0;
+	m_flushTimeMs = 0;
+	m_flushedEntries = 0;
 }
 
 void FolderMemoryCard::InitializeInternalData()
@@ -74,13 +103,19 @@ void FolderMemoryCard::InitializeInternalData()
 	m_cache.clear();
 	m_oldDataCache.clear();
 	m_lastAccessedFile.CloseAll();
+	m_fileEntryDict.clear();
 	m_fileMetadataQuickAccess.clear();
+	InvalidateFileEntryClusters();
 	m_timeLastWritten = 0;
 	m_isEnabled = false;
 	m_framesUntilFlush = 0;
 	m_performFileWrites = true;
 	m_filteringEnabled = false;
 	m_filteringString = L"";
+	m_openTimeMs = 0;
+	m_flushCount = 0;
+	m_flushTimeMs = 0;
+	m_flushedEntries = 0;
 }
 
 bool FolderMemoryCard::IsFormatted() const
@@ -162,6 +197,14 @@ void FolderMemoryCard::Close(bool flush)
 	m_oldDataCache.clear();
 	m_lastAccessedFile.CloseAll();
 	m_fileMetadataQuickAccess.clear();
+
+	// The file entries only change when flushing, so even without a flush they match what is on the host file system.
+	if (m_performFileWrites && IsFormatted())
+	{
+		WriteClusterIndex();
+	}
+
+	Console.WriteLn(L"(FolderMcd) Slot %u: opened in %u ms, %u flushes rewriting %u entries took %u ms.", m_slot, m_openTimeMs, m_flushCount, m_flushedEntries, static_cast<u32>(m_flushTimeMs));
 }
 
 bool FolderMemoryCard::ReIndex(bool enableFiltering, const wxString& filter)
@@ -205,19 +248,37 @@ void FolderMemoryCard::LoadMemoryCardData(const u32 sizeInClusters, const bool e
 	// if superblock was valid, load folders and files
 	if (formatted)
 	{
-		if (enableFiltering)
+		const u64 timeOpenStart = wxGetLocalTimeMillis().GetValue();
+
+		if (LoadClusterIndex(enableFiltering, filter))
 		{
-			Console.WriteLn(Color_Green, L"(FolderMcd) Indexing slot %u with filter \"%s\".", m_slot, WX_STR(filter));
+			Console.WriteLn(Color_Green, L"(FolderMcd) Loaded slot %u from its cluster index.", m_slot);
 		}
 		else
 		{
-			Console.WriteLn(Color_Green, L"(FolderMcd) Indexing slot %u without filter.", m_slot);
+			if (enableFiltering)
+			{
+				Console.WriteLn(Color_Green, L"(FolderMcd) Indexing slot %u with filter \"%s\".", m_slot, WX_STR(filter));
+			}
+			else
+			{
+				Console.WriteLn(Color_Green, L"(FolderMcd) Indexing slot %u without filter.", m_slot);
+			}
+
+			CreateFat();
+			CreateRootDir();
+			MemoryCardFileEntry* const rootDirEntry = &m_fileEntryDict[m_superBlock.data.rootdir_cluster].entries[0];
+			AddFolder(rootDirEntry, m_folderName.GetPath(), nullptr, enableFiltering, filter);
+			InvalidateFileEntryClusters();
+
+			if (m_performFileWrites)
+			{
+				WriteClusterIndex();
+			}
 		}
 
-		CreateFat();
-		CreateRootDir();
-		MemoryCardFileEntry* const rootDirEntry = &m_fileEntryDict[m_superBlock.data.rootdir_cluster].entries[0];
-		AddFolder(rootDirEntry, m_folderName.GetPath(), nullptr, enableFiltering, filter);
+		m_openTimeMs = static_cast<u32>(wxGetLocalTimeMillis().GetValue() - timeOpenStart);
+		Console.WriteLn(L"(FolderMcd) Slot %u took %u ms to open.", m_slot, m_openTimeMs);
 
 #ifdef DEBUG_WRITE_FOLDER_CARD_IN_MEMORY_TO_FILE_ON_CHANGE
 		WriteToFile(m_folderName.GetFullPath().RemoveLast() + L"-debug_" + wxDateTime::Now().Format(L"%Y-%m-%d-%H-%M-%S") + L"_load.ps2");
@@ -299,11 +360,11 @@ u32 FolderMemoryCard::GetAmountDataClusters() const
 	return (m_superBlock.data.alloc_end / 1000) * 1000 - 1;
 }
 
-u32 FolderMemoryCard::GetFreeDataCluster() const
+u32 FolderMemoryCard::GetFreeDataCluster(const u32 startCluster) const
 {
 	const u32 countDataClusters = GetAmountDataClusters();
 
-	for (unsigned int i = 0; i < countDataClusters; ++i)
+	for (unsigned int i = startCluster; i < countDataClusters; ++i)
 	{
 		const u32 cluster = m_fat.data[0][0][i];
 
@@ -569,7 +630,8 @@ bool FolderMemoryCard::AddFile(MemoryCardFileEntry* const dirEntry, const wxStri
 			m_fat.data[0][0][dataCluster] = LastDataCluster | DataClusterInUseMask;
 			for (unsigned int i = 0; i < countClusters - 1; ++i)
 			{
-				u32 newCluster = GetFreeDataCluster();
+				// everything up to the previous cluster is in use already, no need to search from the start again
+				u32 newCluster = GetFreeDataCluster(dataCluster + 1);
 				m_fat.data[0][0][dataCluster] = newCluster | DataClusterInUseMask;
 				m_fat.data[0][0][newCluster] = LastDataCluster | DataClusterInUseMask;
 				dataCluster = newCluster;
@@ -674,6 +736,186 @@ MemoryCardFileMetadataReference* FolderMemoryCard::AddFileEntryToMetadataQuickAc
 	return &m_fileMetadataQuickAccess[firstFileCluster & NextDataClusterMask];
 }
 
+void FolderMemoryCard::AddDirToMetadataQuickAccess(const u32 dirCluster, const u32 remainingFiles, MemoryCardFileMetadataReference* parent)
+{
+	MemoryCardFileEntryCluster* entries = &m_fileEntryDict[dirCluster];
+	const u32 filesInThisCluster = std::min(remainingFiles, 2u);
+	for (unsigned int i = 0; i < filesInThisCluster; ++i)
+	{
+		MemoryCardFileEntry* entry = &entries->entries[i];
+		if (!entry->IsValid() || !entry->IsUsed())
+		{
+			continue;
+		}
+
+		if (entry->IsDir())
+		{
+			if (!entry->IsDotDir())
+			{
+				MemoryCardFileMetadataReference* dirRef = AddDirEntryToMetadataQuickAccess(entry, parent);
+				AddDirToMetadataQuickAccess(entry->entry.data.cluster, entry->entry.data.length, dirRef);
+			}
+		}
+		else if (entry->IsFile())
+		{
+			MemoryCardFileMetadataReference* fileRef = AddFileEntryToMetadataQuickAccess(entry, parent);
+			if (fileRef != nullptr)
+			{
+				// acquire a handle on the file so nothing else can change the file contents while the memory card is open
+				m_lastAccessedFile.ReOpen(m_folderName, fileRef);
+			}
+		}
+	}
+
+	// continue to the next cluster of this directory
+	const u32 nextCluster = m_fat.data[0][0][dirCluster];
+	if (nextCluster != (LastDataCluster | DataClusterInUseMask))
+	{
+		AddDirToMetadataQuickAccess(nextCluster & NextDataClusterMask, remainingFiles - 2, parent);
+	}
+}
+
+static u32 GetFilterCrc(const bool enableFiltering, const wxString& filter)
+{
+	if (!enableFiltering)
+	{
+		return 0;
+	}
+
+	const wxCharTypeBuffer filterUTF8(filter.ToUTF8());
+	return static_cast<u32>(crc32(0L, reinterpret_cast<const Bytef*>(filterUTF8.data()), static_cast<uInt>(strlen(filterUTF8.data()))));
+}
+
+u32 FolderMemoryCard::GetFolderFingerprint() const
+{
+	FileSystem::FindResultsArray files;
+	FileSystem::FindFiles(StringUtil::wxStringToUTF8String(m_folderName.GetPath()).c_str(), "*",
+		FILESYSTEM_FIND_RECURSIVE | FILESYSTEM_FIND_RELATIVE_PATHS | FILESYSTEM_FIND_HIDDEN_FILES | FILESYSTEM_FIND_FOLDERS | FILESYSTEM_FIND_FILES, &files);
+
+	std::sort(files.begin(), files.end(), [](const FILESYSTEM_FIND_DATA& lhs, const FILESYSTEM_FIND_DATA& rhs) {
+		return lhs.FileName < rhs.FileName;
+	});
+
+	const std::string indexName(StringUtil::wxStringToUTF8String(ClusterIndexFileName));
+	uLong crc = crc32(0L, Z_NULL, 0);
+	for (const FILESYSTEM_FIND_DATA& file : files)
+	{
+		if (file.FileName == indexName)
+		{
+			continue;
+		}
+
+		const s64 stamp[2] = {file.Size, static_cast<s64>(file.ModificationTime)};
+		crc = crc32(crc, reinterpret_cast<const Bytef*>(file.FileName.c_str()), static_cast<uInt>(file.FileName.size() + 1));
+		crc = crc32(crc, reinterpret_cast<const Bytef*>(stamp), sizeof(stamp));
+	}
+
+	return static_cast<u32>(crc);
+}
+
+bool FolderMemoryCard::LoadClusterIndex(const bool enableFiltering, const wxString& filter)
+{
+	const std::string indexPath(StringUtil::wxStringToUTF8String(wxFileName(m_folderName.GetPath(), ClusterIndexFileName).GetFullPath()));
+	std::optional<std::vector<u8>> data(FileSystem::ReadBinaryFile(indexPath.c_str()));
+	if (!data.has_value() || data->size() < sizeof(ClusterIndexHeader))
+	{
+		return false;
+	}
+
+	ClusterIndexHeader header;
+	memcpy(&header, data->data(), sizeof(header));
+	const u8* ptr = data->data() + sizeof(header);
+	const size_t size = data->size() - sizeof(header);
+	const size_t entryClusterSize = sizeof(u32) + sizeof(MemoryCardFileEntryCluster);
+
+	if (header.magic != ClusterIndexMagic || header.version != ClusterIndexVersion ||
+		size != sizeof(m_indirectFat) + sizeof(m_fat) + static_cast<size_t>(header.entryClusterCount) * entryClusterSize ||
+		header.crc != static_cast<u32>(crc32(0L, ptr, static_cast<uInt>(size))) ||
+		header.superBlockCrc != static_cast<u32>(crc32(0L, m_superBlock.raw, sizeof(m_superBlock.raw))) ||
+		header.filteringEnabled != static_cast<u32>(enableFiltering) || header.filterCrc != GetFilterCrc(enableFiltering, filter))
+	{
+		return false;
+	}
+
+	const u32 fatEntries = sizeof(m_fat.data[0]) / sizeof(m_fat.data[0][0][0]);
+	const u8* entryClusters = ptr + sizeof(m_indirectFat) + sizeof(m_fat);
+	for (u32 i = 0; i < header.entryClusterCount; ++i)
+	{
+		u32 cluster;
+		memcpy(&cluster, entryClusters + i * entryClusterSize, sizeof(cluster));
+		if (cluster >= fatEntries)
+		{
+			return false;
+		}
+	}
+
+	// Checked last, this has to look at everything in the folder.
+	if (header.folderFingerprint != GetFolderFingerprint())
+	{
+		return false;
+	}
+
+	memcpy(&m_indirectFat, ptr, sizeof(m_indirectFat));
+	memcpy(&m_fat, ptr + sizeof(m_indirectFat), sizeof(m_fat));
+
+	m_fileEntryDict.clear();
+	m_fileEntryDict.reserve(header.entryClusterCount);
+	for (u32 i = 0; i < header.entryClusterCount; ++i)
+	{
+		const u8* entry = entryClusters + i * entryClusterSize;
+		u32 cluster;
+		memcpy(&cluster, entry, sizeof(cluster));
+		memcpy(&m_fileEntryDict[cluster], entry + sizeof(cluster), sizeof(MemoryCardFileEntryCluster));
+	}
+
+	InvalidateFileEntryClusters();
+
+	const u32 rootDirCluster = m_superBlock.data.rootdir_cluster;
+	AddDirToMetadataQuickAccess(rootDirCluster, m_fileEntryDict[rootDirCluster].entries[0].entry.data.length);
+	return true;
+}
+
+void FolderMemoryCard::WriteClusterIndex()
+{
+	UpdateFileEntryClusters();
+
+	std::vector<u32> clusters(m_fileEntryClusters.begin(), m_fileEntryClusters.end());
+	std::sort(clusters.begin(), clusters.end());
+
+	const size_t entryClusterSize = sizeof(u32) + sizeof(MemoryCardFileEntryCluster);
+	std::vector<u8> data(sizeof(ClusterIndexHeader) + sizeof(m_indirectFat) + sizeof(m_fat) + clusters.size() * entryClusterSize);
+
+	u8* ptr = data.data() + sizeof(ClusterIndexHeader);
+	memcpy(ptr, &m_indirectFat, sizeof(m_indirectFat));
+	ptr += sizeof(m_indirectFat);
+	memcpy(ptr, &m_fat, sizeof(m_fat));
+	ptr += sizeof(m_fat);
+	for (const u32 cluster : clusters)
+	{
+		memcpy(ptr, &cluster, sizeof(cluster));
+		memcpy(ptr + sizeof(cluster), &m_fileEntryDict[cluster], sizeof(MemoryCardFileEntryCluster));
+		ptr += entryClusterSize;
+	}
+
+	const u8* payload = data.data() + sizeof(ClusterIndexHeader);
+	ClusterIndexHeader header;
+	header.magic = ClusterIndexMagic;
+	header.version = ClusterIndexVersion;
+	header.folderFingerprint = GetFolderFingerprint();
+	header.superBlockCrc = static_cast<u32>(crc32(0L, m_superBlock.raw, sizeof(m_superBlock.raw)));
+	header.filteringEnabled = m_filteringEnabled;
+	header.filterCrc = GetFilterCrc(m_filteringEnabled, m_filteringString);
+	header.entryClusterCount = static_cast<u32>(clusters.size());
+	header.crc = static_cast<u32>(crc32(0L, payload, static_cast<uInt>(data.size() - sizeof(ClusterIndexHeader))));
+	memcpy(data.data(), &header, sizeof(header));
+
+	const std::string indexPath(StringUtil::wxStringToUTF8String(wxFileName(m_folderName.GetPath(), ClusterIndexFileName).GetFullPath()));
+	if (!FileSystem::WriteBinaryFile(indexPath.c_str(), data.data(), data.size()))
+	{
+		Console.Warning(L"(FolderMcd) Could not write the cluster index of slot %u.", m_slot);
+	}
+}
+
 s32 FolderMemoryCard::IsPresent() const
 {
 	return m_isEnabled;
@@ -757,56 +999,59 @@ u8* FolderMemoryCard::GetSystemBlockPointer(const u32 adr)
 
 u8* FolderMemoryCard::GetFileEntryPointer(const u32 searchCluster, const u32 entryNumber, const u32 offset)
 {
-	const u32 fileCount = m_fileEntryDict[m_superBlock.data.rootdir_cluster].entries[0].entry.data.length;
-	MemoryCardFileEntryCluster* ptr = GetFileEntryCluster(m_superBlock.data.rootdir_cluster, searchCluster, fileCount);
-	if (ptr != nullptr)
+	UpdateFileEntryClusters();
+
+	if (m_fileEntryClusters.find(searchCluster) != m_fileEntryClusters.end())
 	{
-		return &ptr->entries[entryNumber].entry.raw[offset];
+		return &m_fileEntryDict[searchCluster].entries[entryNumber].entry.raw[offset];
 	}
 
 	return nullptr;
 }
 
-MemoryCardFileEntryCluster* FolderMemoryCard::GetFileEntryCluster(const u32 currentCluster, const u32 searchCluster, const u32 fileCount)
+void FolderMemoryCard::InvalidateFileEntryClusters()
 {
-	// we found the correct cluster, return pointer to it
-	if (currentCluster == searchCluster)
-	{
-		return &m_fileEntryDict[currentCluster];
-	}
+	m_fileEntryClustersValid = false;
+}
 
-	// check other clusters of this directory
-	const u32 nextCluster = m_fat.data[0][0][currentCluster] & NextDataClusterMask;
-	if (nextCluster != LastDataCluster)
+void FolderMemoryCard::UpdateFileEntryClusters()
+{
+	if (m_fileEntryClustersValid)
 	{
-		MemoryCardFileEntryCluster* ptr = GetFileEntryCluster(nextCluster, searchCluster, fileCount - 2);
-		if (ptr != nullptr)
-		{
-			return ptr;
-		}
+		return;
 	}
 
-	// check subdirectories
-	auto it = m_fileEntryDict.find(currentCluster);
-	if (it != m_fileEntryDict.end())
+	m_fileEntryClusters.clear();
+	const u32 rootDirCluster = m_superBlock.data.rootdir_cluster;
+	IndexFileEntryClusters(rootDirCluster, m_fileEntryDict[rootDirCluster].entries[0].entry.data.length);
+	m_fileEntryClustersValid = true;
+}
+
+void FolderMemoryCard::IndexFileEntryClusters(u32 cluster, u32 fileCount)
+{
+	const u32 fatEntries = sizeof(m_fat.data[0]) / sizeof(m_fat.data[0][0][0]);
+
+	// follow the clusters of this directory, stopping on anything already visited in case the FAT contains a loop
+	while (cluster < fatEntries && m_fileEntryClusters.insert(cluster).second)
 	{
-		const u32 filesInThisCluster = std::min(fileCount, 2u);
-		for (unsigned int i = 0; i < filesInThisCluster; ++i)
+		// and descend into its subdirectories
+		auto it = m_fileEntryDict.find(cluster);
+		if (it != m_fileEntryDict.end())
 		{
-			const MemoryCardFileEntry* const entry = &it->second.entries[i];
-			if (entry->IsValid() && entry->IsUsed() && entry->IsDir() && !entry->IsDotDir())
+			const u32 filesInThisCluster = std::min(fileCount, 2u);
+			for (unsigned int i = 0; i < filesInThisCluster; ++i)
 			{
-				const u32 newFileCount = entry->entry.data.length;
-				MemoryCardFileEntryCluster* ptr = GetFileEntryCluster(entry->entry.data.cluster, searchCluster, newFileCount);
-				if (ptr != nullptr)
+				const MemoryCardFileEntry* const entry = &it->second.entries[i];
+				if (entry->IsValid() && entry->IsUsed() && entry->IsDir() && !entry->IsDotDir())
 				{
-					return ptr;
+					IndexFileEntryClusters(entry->entry.data.cluster, entry->entry.data.length);
 				}
 			}
 		}
-	}
 
-	return nullptr;
+		cluster = m_fat.data[0][0][cluster] & NextDataClusterMask;
+		fileCount -= 2;
+	}
 }
 
 // This method is actually unused since the introduction of m_fileMetadataQuickAccess.
@@ -1052,6 +1297,17 @@ void FolderMemoryCard::Flush()
 	Console.WriteLn(L"(FolderMcd) Writing data for slot %u to file system...", m_slot);
 	const u64 timeFlushStart = wxGetLocalTimeMillis().GetValue();
 
+	// Games rewrite whole erase blocks, only entries whose page actually changed need their host metadata rewritten.
+	m_changedPages.clear();
+	for (const auto& it : m_cache)
+	{
+		auto oldIt = m_oldDataCache.find(it.first);
+		if (oldIt == m_oldDataCache.end() || memcmp(&oldIt->second.raw[0], &it.second.raw[0], PageSize) != 0)
+		{
+			m_changedPages.insert(it.first);
+		}
+	}
+
 	// Keep a copy of the old file entries so we can figure out which files and directories, if any, have been deleted from the memory card.
 	std::vector<MemoryCardFileEntryTreeNode> oldFileEntryTree;
 	if (IsFormatted())
@@ -1102,23 +1358,37 @@ void FolderMemoryCard::Flush()
 	}
 
 	// then all directory and file entries
-	FlushFileEntries();
+	const u32 flushedEntries = FlushFileEntries();
 
 	// Now we have the new file system, compare it to the old one and "delete" any files that were in it before but aren't anymore.
 	FlushDeletedFilesAndRemoveUnchangedDataFromCache(oldFileEntryTree);
 
-	// and finally, flush everything that hasn't been flushed yet
-	for (uint i = 0; i < pageCount; ++i)
+	// and finally, flush everything that hasn't been flushed yet, in card order
+	std::vector<u32> remainingPages;
+	remainingPages.reserve(m_cache.size());
+	for (const auto& it : m_cache)
 	{
-		FlushPage(i);
+		if (it.first < pageCount)
+		{
+			remainingPages.push_back(it.first);
+		}
+	}
+	std::sort(remainingPages.begin(), remainingPages.end());
+	for (const u32 page : remainingPages)
+	{
+		FlushPage(page);
 	}
 
 	m_lastAccessedFile.FlushAll();
 	m_lastAccessedFile.ClearMetadataWriteState();
 	m_oldDataCache.clear();
+	m_changedPages.clear();
 
 	const u64 timeFlushEnd = wxGetLocalTimeMillis().GetValue();
-	Console.WriteLn(L"(FolderMcd) Done! Took %u ms.", timeFlushEnd - timeFlushStart);
+	m_flushCount++;
+	m_flushTimeMs += timeFlushEnd - timeFlushStart;
+	m_flushedEntries += flushedEntries;
+	Console.WriteLn(L"(FolderMcd) Done! Took %u ms, rewrote %u file entries.", static_cast<u32>(timeFlushEnd - timeFlushStart), flushedEntries);
 
 #ifdef DEBUG_WRITE_FOLDER_CARD_IN_MEMORY_TO_FILE_ON_CHANGE
 	WriteToFile(m_folderName.GetFullPath().RemoveLast() + L"-debug_" + wxDateTime::Now().Format(L"%Y-%m-%d-%H-%M-%S") + L"_post-flush.ps2");
@@ -1179,7 +1449,7 @@ void FolderMemoryCard::FlushSuperBlock()
 	}
 }
 
-void FolderMemoryCard::FlushFileEntries()
+u32 FolderMemoryCard::FlushFileEntries()
 {
 	// Flush all file entry data from the cache into m_fileEntryDict.
 	const u32 rootDirCluster = m_superBlock.data.rootdir_cluster;
@@ -1187,12 +1457,16 @@ void FolderMemoryCard::FlushFileEntries()
 	MemoryCardFileEntryCluster* rootEntries = &m_fileEntryDict[rootDirCluster];
 	if (rootEntries->entries[0].IsValid() && rootEntries->entries[0].IsUsed())
 	{
-		FlushFileEntries(rootDirCluster, rootEntries->entries[0].entry.data.length);
+		return FlushFileEntries(rootDirCluster, rootEntries->entries[0].entry.data.length);
 	}
+
+	return 0;
 }
 
-void FolderMemoryCard::FlushFileEntries(const u32 dirCluster, const u32 remainingFiles, const wxString& dirPath, MemoryCardFileMetadataReference* parent)
+u32 FolderMemoryCard::FlushFileEntries(const u32 dirCluster, const u32 remainingFiles, const wxString& dirPath, MemoryCardFileMetadataReference* parent, const bool forceWrite)
 {
+	u32 flushedEntries = 0;
+
 	// flush the current cluster
 	FlushCluster(dirCluster + m_superBlock.data.alloc_offset);
 
@@ -1202,8 +1476,16 @@ void FolderMemoryCard::FlushFileEntries(const u32 dirCluster, const u32 remainin
 	for (unsigned int i = 0; i < filesInThisCluster; ++i)
 	{
 		MemoryCardFileEntry* entry = &entries->entries[i];
+		const u32 entryPage = (dirCluster + m_superBlock.data.alloc_offset) * 2 + i;
+		const bool entryChanged = forceWrite || m_changedPages.find(entryPage) != m_changedPages.end();
+
 		if (entry->IsValid() && entry->IsUsed())
 		{
+			if (entryChanged)
+			{
+				++flushedEntries;
+			}
+
 			if (entry->IsDir())
 			{
 				if (!entry->IsDotDir())
@@ -1214,7 +1496,7 @@ void FolderMemoryCard::FlushFileEntries(const u32 dirCluster, const u32 remainin
 					const wxString subDirName = wxString::FromAscii((const char*)cleanName);
 					const wxString subDirPath = dirPath + L"/" + subDirName;
 
-					if (m_performFileWrites)
+					if (m_performFileWrites && entryChanged)
 					{
 						// if this directory has nonstandard metadata, write that to the file system
 						wxFileName metaFileName(m_folderName.GetFullPath() + subDirPath, L"_pcsx2_meta_directory");
@@ -1258,7 +1540,9 @@ void FolderMemoryCard::FlushFileEntries(const u32 dirCluster, const u32 remainin
 
 					MemoryCardFileMetadataReference* dirRef = AddDirEntryToMetadataQuickAccess(entry, parent);
 
-					FlushFileEntries(entry->entry.data.cluster, entry->entry.data.length, subDirPath, dirRef);
+					// a new or renamed directory has to be written out in full, its contents have moved on the host file system
+					const bool dirMoved = forceWrite || (entryChanged && IsFileEntryMoved(entryPage, entry));
+					flushedEntries += FlushFileEntries(entry->entry.data.cluster, entry->entry.data.length, subDirPath, dirRef, dirMoved);
 				}
 			}
 			else if (entry->IsFile())
@@ -1268,7 +1552,7 @@ void FolderMemoryCard::FlushFileEntries(const u32 dirCluster, const u32 remainin
 				if (entry->entry.data.length == 0)
 				{
 					// empty files need to be explicitly created, as there will be no data cluster referencing it later
-					if (m_performFileWrites)
+					if (m_performFileWrites && entryChanged)
 					{
 						char cleanName[sizeof(entry->entry.data.name)];
 						memcpy(cleanName, (const char*)entry->entry.data.name, sizeof(cleanName));
@@ -1288,7 +1572,7 @@ void FolderMemoryCard::FlushFileEntries(const u32 dirCluster, const u32 remainin
 					}
 				}
 
-				if (m_performFileWrites)
+				if (m_performFileWrites && entryChanged)
 				{
 					FileAccessHelper::WriteIndex(m_folderName.GetFullPath() + dirPath, entry, parent);
 				}
@@ -1300,8 +1584,23 @@ void FolderMemoryCard::FlushFileEntries(const u32 dirCluster, const u32 remainin
 	const u32 nextCluster = m_fat.data[0][0][dirCluster];
 	if (nextCluster != (LastDataCluster | DataClusterInUseMask))
 	{
-		FlushFileEntries(nextCluster & NextDataClusterMask, remainingFiles - 2, dirPath, parent);
+		flushedEntries += FlushFileEntries(nextCluster & NextDataClusterMask, remainingFiles - 2, dirPath, parent, forceWrite);
 	}
+
+	return flushedEntries;
+}
+
+bool FolderMemoryCard::IsFileEntryMoved(const u32 page, const MemoryCardFileEntry* const entry) const
+{
+	auto it = m_oldDataCache.find(page);
+	if (it == m_oldDataCache.end())
+	{
+		return true;
+	}
+
+	const MemoryCardFileEntry* const oldEntry = reinterpret_cast<const MemoryCardFileEntry*>(&it->second.raw[0]);
+	return !oldEntry->IsValid() || !oldEntry->IsUsed() || oldEntry->IsDir() != entry->IsDir() || oldEntry->entry.data.cluster != entry->entry.data.cluster ||
+		   strncmp((const char*)oldEntry->entry.data.name, (const char*)entry->entry.data.name, sizeof(entry->entry.data.name)) != 0;
 }
 
 void FolderMemoryCard::FlushDeletedFilesAndRemoveUnchangedDataFromCache(const std::vector<MemoryCardFileEntryTreeNode>& oldFileEntries)
@@ -1424,6 +1723,9 @@ s32 FolderMemoryCard::WriteWithoutCache(const u8* src, u32 adr, int size)
 		if (dest != nullptr)
 		{
 			memcpy(dest, src, dataLength);
+
+			// may have been the FAT or a directory, which changes what GetFileEntryPointer() can find
+			InvalidateFileEntryClusters();
 		}
 		else
 		{
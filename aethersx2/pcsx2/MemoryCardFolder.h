@@ -19,6 +19,8 @@
 #include <wx/dir.h>
 #include <wx/ffile.h>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "Config.h"
@@ -245,7 +247,7 @@ struct MemoryCardFileHandleStructure
 class FileAccessHelper
 {
 private:
-	std::map<std::string, MemoryCardFileHandleStructure> m_files;
+	std::unordered_map<std::string, MemoryCardFileHandleStructure> m_files;
 	MemoryCardFileMetadataReference* m_lastWrittenFileRef = nullptr; // we remember this to reduce redundant metadata checks/writes
 
 public:
@@ -335,16 +337,24 @@ protected:
 	} m_backupBlock2;
 
 	// stores directory and file metadata
-	std::map<u32, MemoryCardFileEntryCluster> m_fileEntryDict;
+	// may hold stale clusters which are no longer part of the directory tree, see m_fileEntryClusters
+	std::unordered_map<u32, MemoryCardFileEntryCluster> m_fileEntryDict;
 	// quick-access map of related file entry metadata for each memory card FAT cluster that contains file data
-	std::map<u32, MemoryCardFileMetadataReference> m_fileMetadataQuickAccess;
+	std::unordered_map<u32, MemoryCardFileMetadataReference> m_fileMetadataQuickAccess;
+	// clusters of m_fileEntryDict reachable from the root directory, rebuilt on demand after the FAT or
+	// a directory changed so that GetFileEntryPointer() doesn't have to walk the whole tree on every access
+	std::unordered_set<u32> m_fileEntryClusters;
+	bool m_fileEntryClustersValid;
 
 	// holds a copy of modified pages of the memory card before they're flushed to the file system
-	std::map<u32, MemoryCardPage> m_cache;
+	std::unordered_map<u32, MemoryCardPage> m_cache;
 	// contains the state of how the data looked before the first write to it
 	// used to reduce the amount of disk I/O by not re-writing unchanged data that just happened to be
 	// touched in memory due to how actual physical memory cards have to erase and rewrite in blocks
-	std::map<u32, MemoryCardPage> m_oldDataCache;
+	std::unordered_map<u32, MemoryCardPage> m_oldDataCache;
+	// pages of m_cache which actually differ from m_oldDataCache, collected at the start of a flush
+	// only file entries in these pages get their metadata and index rewritten on the host file system
+	std::unordered_set<u32> m_changedPages;
 	// if > 0, the amount of frames until data is flushed to the file system
 	// reset to FramesAfterWriteUntilFlush on each write
 	int m_framesUntilFlush;
@@ -369,6 +379,12 @@ protected:
 	bool m_filteringEnabled;
 	wxString m_filteringString;
 
+	// timing counters, printed when the card is closed
+	u32 m_openTimeMs;
+	u32 m_flushCount;
+	u64 m_flushTimeMs;
+	u32 m_flushedEntries;
+
 public:
 	FolderMemoryCard();
 	virtual ~FolderMemoryCard() = default;
@@ -438,12 +454,16 @@ protected:
 	// - offset: offset of page
 	u8* GetFileEntryPointer(const u32 searchCluster, const u32 entryNumber, const u32 offset);
 
-	// used by GetFileEntryPointer to find the correct cluster
-	// returns nullptr if searchCluster is not a file or directory metadata cluster
-	// - currentCluster: the cluster we're currently traversing
-	// - searchCluster: the cluster we want
-	// - fileCount: the number of files left in the directory currently traversed
-	MemoryCardFileEntryCluster* GetFileEntryCluster(const u32 currentCluster, const u32 searchCluster, const u32 fileCount);
+	// adds all file or directory metadata clusters of a directory and its subdirectories to m_fileEntryClusters
+	// - cluster: the first cluster of the directory
+	// - fileCount: the number of files in the directory
+	void IndexFileEntryClusters(u32 cluster, u32 fileCount);
+
+	// marks m_fileEntryClusters for a rebuild, needs to be called whenever the FAT or a directory changes
+	void InvalidateFileEntryClusters();
+
+	// rebuilds m_fileEntryClusters if it was invalidated
+	void UpdateFileEntryClusters();
 
 	// returns file entry of the file at the given searchCluster
 	// the passed fileName will be filled with a path to the file being accessed
@@ -464,6 +484,19 @@ protected:
 	// - filter: can include multiple filters by separating them with "/"
 	void LoadMemoryCardData(const u32 sizeInClusters, const bool enableFiltering, const wxString& filter);
 
+	// restores the FAT and all file entries from the cluster index file written on the last close, see WriteClusterIndex()
+	// returns false if there is no index, or if the host folder, the superblock or the filter settings changed since it was written
+	bool LoadClusterIndex(const bool enableFiltering, const wxString& filter);
+
+	// stores the FAT and all file entries in the cluster index file, so the next Open() doesn't have to parse every file again
+	void WriteClusterIndex();
+
+	// checksum of names, sizes and modification times of everything in the memory card folder, used to validate the cluster index
+	u32 GetFolderFingerprint() const;
+
+	// adds quick-access references and opens handles for all files in a directory and its subdirectories, as AddFolder() would
+	void AddDirToMetadataQuickAccess(const u32 dirCluster, const u32 remainingFiles, MemoryCardFileMetadataReference* parent = nullptr);
+
 	// creates the FAT and indirect FAT
 	void CreateFat();
 
@@ -480,7 +513,8 @@ protected:
 
 	// returns the lowest unused data cluster, relative to alloc_offset in the superblock
 	// returns 0xFFFFFFFFu when the memory card is full
-	u32 GetFreeDataCluster() const;
+	// - startCluster: where to start searching, every cluster below it must already be in use
+	u32 GetFreeDataCluster(const u32 startCluster = 0) const;
 
 	// returns the amount of unused data clusters
 	u32 GetAmountFreeDataClusters() const;
@@ -544,10 +578,16 @@ protected:
 	void FlushSuperBlock();
 
 	// flush all directory and file entries to the internal data
-	void FlushFileEntries();
+	// returns the number of entries whose metadata was written to the host file system
+	u32 FlushFileEntries();
 
 	// flush a directory's file entries and all its subdirectories to the internal data
-	void FlushFileEntries(const u32 dirCluster, const u32 remainingFiles, const wxString& dirPath = L"", MemoryCardFileMetadataReference* parent = nullptr);
+	// metadata on the host file system is only written for entries in m_changedPages, or for every entry if forceWrite is set
+	// returns the number of entries written
+	u32 FlushFileEntries(const u32 dirCluster, const u32 remainingFiles, const wxString& dirPath = L"", MemoryCardFileMetadataReference* parent = nullptr, const bool forceWrite = false);
+
+	// returns true if the entry in the given page was renamed or moved since the last flush, or didn't exist at all
+	bool IsFileEntryMoved(const u32 page, const MemoryCardFileEntry* const entry) const;
 
 	// "delete" (prepend '_pcsx2_deleted_' to) any files that exist in oldFileEntries but no longer exist in m_fileEntryDict
 	// also calls RemoveUnchangedDataFromCache() since both operate on comparing with the old file entires
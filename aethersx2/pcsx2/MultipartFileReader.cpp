@@ -98,6 +98,9 @@ void MultipartFileReader::FindParts()
 	int bsize = m_parts[0].reader->GetBlockSize();
 	int blocks = m_parts[0].end;
 
+	// Read the other parts the same way as the first one
+	const bool mapped = dynamic_cast<MappedFileReader*>(m_parts[0].reader) != nullptr;
+
 	m_numparts = 1;
 
 	for (; i < MaxParts; ++i)
@@ -109,11 +112,21 @@ void MultipartFileReader::FindParts()
 			break;
 
 		Part* thispart = m_parts + m_numparts;
-		AsyncFileReader* thisreader = thispart->reader = new FlatFileReader();
+		const std::string name(StringUtil::wxStringToUTF8String(nameparts.GetFullPath()));
 
-		wxString name = nameparts.GetFullPath();
+		AsyncFileReader* thisreader = mapped ? new MappedFileReader() : nullptr;
+		if (thisreader && !thisreader->Open(name))
+		{
+			delete thisreader;
+			thisreader = nullptr;
+		}
+		if (!thisreader)
+		{
+			thisreader = new FlatFileReader();
+			thisreader->Open(name);
+		}
 
-		thisreader->Open(StringUtil::wxStringToUTF8String(name));
+		thispart->reader = thisreader;
 		thisreader->SetBlockSize(bsize);
 
 		thispart->start = blocks;
@@ -242,3 +255,31 @@ void MultipartFileReader::SetBlockSize(uint bytes)
 	}
 }
 
+void MultipartFileReader::Prefetch(uint sector, uint count)
+{
+	if (sector >= GetBlockCount())
+		return;
+
+	for (uint i = GetFirstPart(sector); i < m_numparts && count > 0; i++)
+	{
+		uint num = std::min(count, m_parts[i].end - sector);
+
+		m_parts[i].reader->Prefetch(sector - m_parts[i].start, num);
+
+		sector += num;
+		count -= num;
+	}
+}
+
+const u8* MultipartFileReader::GetSectorData(uint sector, uint count)
+{
+	if (sector >= GetBlockCount())
+		return nullptr;
+
+	// Only requests which don't cross into the next part are contiguous in memory
+	const Part& part = m_parts[GetFirstPart(sector)];
+	if (count > part.end - sector)
+		return nullptr;
+
+	return part.reader->GetSectorData(sector - part.start, count);
+}
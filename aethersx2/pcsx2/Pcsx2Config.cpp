@@ -99,6 +99,7 @@ Pcsx2Config::SpeedhackOptions::SpeedhackOptions()
 	IntcStat = true;
 	vuFlagHack = true;
 	vu1Instant = true;
+	IopThreadMaxSkew = 2048;
 }
 
 Pcsx2Config::SpeedhackOptions& Pcsx2Config::SpeedhackOptions::DisableAll()
@@ -122,6 +123,9 @@ void Pcsx2Config::SpeedhackOptions::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapBitBool(vuFlagHack);
 	SettingsWrapBitBool(vuThread);
 	SettingsWrapBitBool(vu1Instant);
+	SettingsWrapBitBool(iopThread);
+	SettingsWrapBitBool(ipuThread);
+	SettingsWrapEntry(IopThreadMaxSkew);
 }
 
 void Pcsx2Config::ProfilerOptions::LoadSave(SettingsWrapper& wrap)
@@ -378,6 +382,8 @@ void Pcsx2Config::GSOptions::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapBitfieldEx(SWBlending, "accurate_blending_unit");
 	SettingsWrapBitfieldEx(SWExtraThreads, "extrathreads");
 	SettingsWrapBitfieldEx(SWExtraThreadsHeight, "extrathreads_height");
+	SettingsWrapBitfieldEx(TextureDecodeThreads, "texture_decode_threads");
+	SettingsWrapBitBoolEx(SWExtraThreadsTiles, "extrathreads_tiles");
 	SettingsWrapBitBoolEx(HWDisableReadbacks, "disable_hw_readbacks");
 	SettingsWrapBitBoolEx(AccurateDATE, "accurate_date");
 	SettingsWrapBitBoolEx(GPUPaletteConversion, "paltex");
@@ -396,6 +402,7 @@ void Pcsx2Config::GSOptions::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapBitBoolEx(UserHacks_MergePPSprite, "UserHacks_merge_pp_sprite");
 	SettingsWrapBitBoolEx(FXAA, "fxaa");
 	SettingsWrapBitBoolEx(PreloadTexture, "preload_texture");
+	SettingsWrapBitBoolEx(TextureHashCache, "texture_hash_cache");
 	Renderer = static_cast<GSRendererType>(wrap.EntryBitfield(CURRENT_SETTINGS_SECTION, "Renderer", static_cast<int>(Renderer), static_cast<int>(Renderer)));
 	HWMipmap = static_cast<HWMipmapLevel>(wrap.EntryBitfield(CURRENT_SETTINGS_SECTION, "mipmap_hw", static_cast<int>(HWMipmap), static_cast<int>(HWMipmap)));
 	InterlaceMode = static_cast<GSInterlaceMode>(wrap.EntryBitfield(CURRENT_SETTINGS_SECTION, "interlace", static_cast<int>(InterlaceMode), static_cast<int>(InterlaceMode)));
@@ -727,6 +734,48 @@ void Pcsx2Config::FramerateOptions::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapEntry(SkipOnTurbo);
 }
 
+void Pcsx2Config::RewindOptions::SanityCheck()
+{
+	Frequency = std::clamp(Frequency, 1u, 600u);
+	BufferSizeMB = std::clamp(BufferSizeMB, 16u, 4096u);
+}
+
+void Pcsx2Config::RewindOptions::LoadSave(SettingsWrapper& wrap)
+{
+	SettingsWrapSection("EmuCore/Rewind");
+
+	SettingsWrapEntry(Enabled);
+	SettingsWrapEntry(Frequency);
+	SettingsWrapEntry(BufferSizeMB);
+
+	if (wrap.IsLoading())
+		SanityCheck();
+}
+
+void Pcsx2Config::CdvdOptions::SanityCheck()
+{
+	ReadAheadKB = std::min(ReadAheadKB, 16384u);
+	CacheSizeMB = std::clamp(CacheSizeMB, 4u, 1024u);
+	DecompressThreads = std::clamp(DecompressThreads, 1u, 8u);
+	// Gzip extraction works in 256KB chunks, spans are kept on chunk boundaries.
+	GzipIndexSpanKB = std::clamp(GzipIndexSpanKB, 256u, 16384u) / 256u * 256u;
+	PrefetchMB = std::min(PrefetchMB, 512u);
+}
+
+void Pcsx2Config::CdvdOptions::LoadSave(SettingsWrapper& wrap)
+{
+	SettingsWrapSection("EmuCore/CDVD");
+
+	SettingsWrapEntry(ReadAheadKB);
+	SettingsWrapEntry(CacheSizeMB);
+	SettingsWrapEntry(DecompressThreads);
+	SettingsWrapEntry(GzipIndexSpanKB);
+	SettingsWrapEntry(PrefetchMB);
+
+	if (wrap.IsLoading())
+		SanityCheck();
+}
+
 Pcsx2Config::Pcsx2Config()
 {
 	bitset = 0;
@@ -760,6 +809,7 @@ void Pcsx2Config::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapBitBool(CdvdVerboseReads);
 	SettingsWrapBitBool(CdvdDumpBlocks);
 	SettingsWrapBitBool(CdvdShareWrite);
+	SettingsWrapBitBool(CdvdMapImages);
 	SettingsWrapBitBool(EnablePatches);
 	SettingsWrapBitBool(EnableCheats);
 	SettingsWrapBitBool(EnableIPC);
@@ -773,6 +823,7 @@ void Pcsx2Config::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapBitBool(BackupSavestate);
 	SettingsWrapBitBool(McdEnableEjection);
 	SettingsWrapBitBool(McdFolderAutoManage);
+	SettingsWrapBitBool(McdWriteBack);
 	SettingsWrapBitBool(MultitapPort0_Enabled);
 	SettingsWrapBitBool(MultitapPort1_Enabled);
 
@@ -784,6 +835,8 @@ void Pcsx2Config::LoadSave(SettingsWrapper& wrap)
 	SPU2.LoadSave(wrap);
 	Gamefixes.LoadSave(wrap);
 	Profiler.LoadSave(wrap);
+	Rewind.LoadSave(wrap);
+	Cdvd.LoadSave(wrap);
 
 	Debugger.LoadSave(wrap);
 	Trace.LoadSave(wrap);
@@ -861,6 +914,8 @@ bool Pcsx2Config::operator==(const Pcsx2Config& right) const
 		OpEqu(Profiler) &&
 		OpEqu(Debugger) &&
 		OpEqu(Framerate) &&
+		OpEqu(Rewind) &&
+		OpEqu(Cdvd) &&
 		OpEqu(Trace) &&
 		OpEqu(BaseFilenames) &&
 		OpEqu(GzipIsoIndexTemplate);
@@ -884,6 +939,8 @@ void Pcsx2Config::CopyConfig(const Pcsx2Config& cfg)
 	Trace = cfg.Trace;
 	BaseFilenames = cfg.BaseFilenames;
 	Framerate = cfg.Framerate;
+	Rewind = cfg.Rewind;
+	Cdvd = cfg.Cdvd;
 	for (u32 i = 0; i < sizeof(Mcd) / sizeof(Mcd[0]); i++)
 	{
 		// Type will be File here, even if it's a folder, so we preserve the old value.
@@ -897,6 +954,7 @@ void Pcsx2Config::CopyConfig(const Pcsx2Config& cfg)
 	CdvdVerboseReads = cfg.CdvdVerboseReads;
 	CdvdDumpBlocks = cfg.CdvdDumpBlocks;
 	CdvdShareWrite = cfg.CdvdShareWrite;
+	CdvdMapImages = cfg.CdvdMapImages;
 	EnablePatches = cfg.EnablePatches;
 	EnableCheats = cfg.EnableCheats;
 	EnableIPC = cfg.EnableIPC;
@@ -908,6 +966,7 @@ void Pcsx2Config::CopyConfig(const Pcsx2Config& cfg)
 	BackupSavestate = cfg.BackupSavestate;
 	McdEnableEjection = cfg.McdEnableEjection;
 	McdFolderAutoManage = cfg.McdFolderAutoManage;
+	McdWriteBack = cfg.McdWriteBack;
 	MultitapPort0_Enabled = cfg.MultitapPort0_Enabled;
 	MultitapPort1_Enabled = cfg.MultitapPort1_Enabled;
 	ConsoleToStdio = cfg.ConsoleToStdio;
@@ -23,6 +23,8 @@
 
 #include "GS.h"
 #include "MTVU.h"
+#include "MTIOP.h"
+#include "R5900.h"
 
 static const float UPDATE_INTERVAL = 0.5f;
 
@@ -39,6 +41,7 @@ static Common::Timer s_last_frame_time;
 static Common::ThreadCPUTimer s_cpu_thread_timer;
 static u64 s_last_gs_time = 0;
 static u64 s_last_vu_time = 0;
+static u64 s_last_iop_time = 0;
 static u64 s_last_ticks = 0;
 
 static double s_cpu_thread_usage = 0.0f;
@@ -47,6 +50,17 @@ static float s_gs_thread_usage = 0.0f;
 static float s_gs_thread_time = 0.0f;
 static float s_vu_thread_usage = 0.0f;
 static float s_vu_thread_time = 0.0f;
+static float s_iop_thread_usage = 0.0f;
+static float s_iop_thread_time = 0.0f;
+
+static u32 s_last_ee_event_tests = 0;
+static u32 s_last_ee_events = 0;
+static float s_ee_event_tests_per_frame = 0.0f;
+static float s_ee_events_per_frame = 0.0f;
+
+static float s_ee_wait_for_iop_time = 0.0f;
+static float s_iop_wait_for_ee_time = 0.0f;
+static u32 s_iop_max_skew = 0;
 
 void PerformanceMetrics::Clear()
 {
@@ -62,6 +76,13 @@ void PerformanceMetrics::Clear()
 	s_gs_thread_time = 0.0f;
 	s_vu_thread_usage = 0.0f;
 	s_vu_thread_time = 0.0f;
+	s_iop_thread_usage = 0.0f;
+	s_iop_thread_time = 0.0f;
+	s_ee_event_tests_per_frame = 0.0f;
+	s_ee_events_per_frame = 0.0f;
+	s_ee_wait_for_iop_time = 0.0f;
+	s_iop_wait_for_ee_time = 0.0f;
+	s_iop_max_skew = 0;
 }
 
 void PerformanceMetrics::Reset()
@@ -75,7 +96,11 @@ void PerformanceMetrics::Reset()
 	s_cpu_thread_timer.Reset();
 	s_last_gs_time = GetMTGS().GetCpuTime();
 	s_last_vu_time = THREAD_VU1 ? vu1Thread.GetCpuTime() : 0;
+	s_last_iop_time = iopThread.GetCpuTime();
 	s_last_ticks = GetCPUTicks();
+	s_last_ee_event_tests = g_eeEventTestCount;
+	s_last_ee_events = g_eeEventDispatchCount;
+	iopThread.GetAndResetStats();
 }
 
 void PerformanceMetrics::Update()
@@ -123,6 +148,25 @@ void PerformanceMetrics::Update()
 	s_last_vu_time = vu_time;
 	s_last_ticks = ticks;
 
+	// Written by the EE thread, a count that is a few events stale doesn't matter here.
+	const u32 ee_event_tests = g_eeEventTestCount;
+	const u32 ee_events = g_eeEventDispatchCount;
+	s_ee_event_tests_per_frame = static_cast<float>(ee_event_tests - s_last_ee_event_tests) / static_cast<float>(s_frames_since_last_update);
+	s_ee_events_per_frame = static_cast<float>(ee_events - s_last_ee_events) / static_cast<float>(s_frames_since_last_update);
+	s_last_ee_event_tests = ee_event_tests;
+	s_last_ee_events = ee_events;
+
+	const u64 iop_time = iopThread.GetCpuTime();
+	const u64 iop_delta = (iop_time >= s_last_iop_time) ? (iop_time - s_last_iop_time) : 0;
+	s_iop_thread_usage = static_cast<float>(Common::ThreadCPUTimer::GetUtilizationPercentage(ticks_diff, iop_delta));
+	s_iop_thread_time = static_cast<float>(Common::ThreadCPUTimer::ConvertValueToMilliseconds(iop_delta)) / static_cast<float>(s_frames_since_last_update);
+	s_last_iop_time = iop_time;
+
+	const IOP_Thread::Stats iop_stats = iopThread.GetAndResetStats();
+	s_ee_wait_for_iop_time = static_cast<float>(Common::Timer::ConvertValueToMilliseconds(iop_stats.ee_wait_time)) / static_cast<float>(s_frames_since_last_update);
+	s_iop_wait_for_ee_time = static_cast<float>(Common::Timer::ConvertValueToMilliseconds(iop_stats.iop_wait_time)) / static_cast<float>(s_frames_since_last_update);
+	s_iop_max_skew = iop_stats.max_skew;
+
 	s_last_update_time.ResetTo(now_ticks);
 	s_frames_since_last_update = 0;
 }
@@ -186,3 +230,38 @@ float PerformanceMetrics::GetVUThreadAverageTime()
 {
 	return s_vu_thread_time;
 }
+
+float PerformanceMetrics::GetEEEventTestsPerFrame()
+{
+	return s_ee_event_tests_per_frame;
+}
+
+float PerformanceMetrics::GetEEEventsPerFrame()
+{
+	return s_ee_events_per_frame;
+}
+
+float PerformanceMetrics::GetIOPThreadUsage()
+{
+	return s_iop_thread_usage;
+}
+
+float PerformanceMetrics::GetIOPThreadAverageTime()
+{
+	return s_iop_thread_time;
+}
+
+float PerformanceMetrics::GetEEWaitForIOPTime()
+{
+	return s_ee_wait_for_iop_time;
+}
+
+float PerformanceMetrics::GetIOPWaitForEETime()
+{
+	return s_iop_wait_for_ee_time;
+}
+
+u32 PerformanceMetrics::GetIOPMaxSkew()
+{
+	return s_iop_max_skew;
+}
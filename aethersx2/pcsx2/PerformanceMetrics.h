@@ -39,5 +39,17 @@ namespace PerformanceMetrics
 	float GetGSThreadAverageTime();
 	float GetVUThreadUsage();
 	float GetVUThreadAverageTime();
+	float GetIOPThreadUsage();
+	float GetIOPThreadAverageTime();
+
+	/// EE event tests, and DMA/VU events they dispatched, per frame.
+	float GetEEEventTestsPerFrame();
+	float GetEEEventsPerFrame();
+
+	/// IOP thread synchronization: milliseconds per frame the EE waited for IOP slices and the
+	/// IOP waited for the EE, and the furthest the EE ran ahead of the IOP, in EE cycles.
+	float GetEEWaitForIOPTime();
+	float GetIOPWaitForEETime();
+	u32 GetIOPMaxSkew();
 } // namespace PerformanceMetrics
 
@@ -19,6 +19,7 @@
 
 #include "Sio.h"
 #include "Sif.h"
+#include "MTIOP.h"
 //#include "DebugTools/Breakpoints.h"
 #include "R5900OpcodeTables.h"
 
@@ -148,7 +149,7 @@ __fi void PSX_INT( IopEventId n, s32 ecycle )
 
 	psxSetNextBranchDelta( ecycle );
 
-	if( iopCycleEE < 0 )
+	if( iopCycleEE < 0 && !IOP_Thread::IsIOPThread() )
 	{
 		// The EE called this int, so inform it to branch as needed:
 		// fixme - this doesn't take into account EE/IOP sync (the IOP may be running
@@ -235,7 +236,14 @@ void iopTestIntc()
 	if( psxHu32(0x1078) == 0 ) return;
 	if( (psxHu32(0x1070) & psxHu32(0x1074)) == 0 ) return;
 
-	if( !eeEventTestIsActive )
+	if( THREAD_IOP )
+	{
+		// The EE never runs IOP code in this mode, the IOP thread (or the next slice) picks
+		// the exception up at its own event test.
+		if( !iopEventTestIsActive )
+			psxSetNextBranchDelta( 2 );
+	}
+	else if( !eeEventTestIsActive )
 	{
 		// An iop exception has occurred while the EE is running code.
 		// Inform the EE to branch so the IOP can handle it promptly:
@@ -25,6 +25,8 @@
 #include "VUmicro.h"
 #include "COP0.h"
 #include "MTVU.h"
+#include "MTIOP.h"
+#include "IPU/IPUThread.h"
 
 #include "System/SysThreads.h"
 #include "R5900Exceptions.h"
@@ -38,6 +40,7 @@
 #include "Patch.h"
 #include "GameDatabase.h"
 #include "VMManager.h"
+#include "Rewind.h"
 
 //#include "DebugTools/Breakpoints.h"
 #include "DebugTools/MIPSAnalyst.h"
@@ -62,6 +65,119 @@ static const uint eeWaitCycles = 3072;
 
 bool eeEventTestIsActive = false;
 
+u32 g_eeEventTestCount = 0;
+u32 g_eeEventDispatchCount = 0;
+
+// Pending cpuRegs.interrupt events in a binary min-heap keyed on their deadline (sCycle + eCycle),
+// so the event test only touches the ones which are due. cpuRegs stays the authoritative state (it
+// is what savestates carry): a few DMA paths clear bits or push eCycle out behind CPU_INT's back,
+// entries are checked against it again once they reach the top.
+class EEEventQueue
+{
+public:
+	EEEventQueue() { Clear(); }
+
+	void Clear()
+	{
+		m_size = 0;
+		std::memset(m_pos, INVALID, sizeof(m_pos));
+	}
+
+	void Rebuild()
+	{
+		Clear();
+
+		for (uint n = 0; n < 32; n++)
+		{
+			if (cpuRegs.interrupt & (1 << n))
+				Schedule(n);
+		}
+	}
+
+	bool Empty() const { return m_size == 0; }
+	uint Top() const { return m_heap[0]; }
+	u32 TopDeadline() const { return m_deadline[m_heap[0]]; }
+
+	// Inserts the event or moves it to its current deadline.
+	void Schedule(uint n)
+	{
+		m_deadline[n] = cpuRegs.sCycle[n] + cpuRegs.eCycle[n];
+
+		if (m_pos[n] == INVALID)
+		{
+			m_pos[n] = m_size;
+			m_heap[m_size++] = n;
+		}
+
+		SiftUp(SiftDown(m_pos[n]));
+	}
+
+	void Remove(uint n)
+	{
+		const u8 pos = m_pos[n];
+		if (pos == INVALID)
+			return;
+
+		m_pos[n] = INVALID;
+		if (pos == --m_size)
+			return;
+
+		m_heap[pos] = m_heap[m_size];
+		m_pos[m_heap[pos]] = pos;
+		SiftUp(SiftDown(pos));
+	}
+
+private:
+	static constexpr u8 INVALID = 0xff;
+
+	bool Before(uint a, uint b) const
+	{
+		return (s32)(m_deadline[m_heap[a]] - m_deadline[m_heap[b]]) < 0;
+	}
+
+	void Swap(uint a, uint b)
+	{
+		std::swap(m_heap[a], m_heap[b]);
+		m_pos[m_heap[a]] = a;
+		m_pos[m_heap[b]] = b;
+	}
+
+	uint SiftDown(uint pos)
+	{
+		for (;;)
+		{
+			uint child = pos * 2 + 1;
+			if (child >= m_size)
+				return pos;
+
+			if (child + 1 < m_size && Before(child + 1, child))
+				child++;
+
+			if (!Before(child, pos))
+				return pos;
+
+			Swap(pos, child);
+			pos = child;
+		}
+	}
+
+	void SiftUp(uint pos)
+	{
+		while (pos > 0 && Before(pos, (pos - 1) / 2))
+		{
+			Swap(pos, (pos - 1) / 2);
+			pos = (pos - 1) / 2;
+		}
+	}
+
+	u32 m_deadline[32];
+	u8 m_heap[32];
+	u8 m_pos[32];
+	u32 m_size;
+};
+
+static EEEventQueue s_eventQueue;
+
 u32 g_eeloadMain = 0, g_eeloadExec = 0, g_osdsys_str = 0;
 
 /* I don't know how much space for args there is in the memory block used for args in full boot mode,
@@ -78,14 +194,20 @@ extern SysMainMemory& GetVmMemory();
 void cpuReset()
 {
 	vu1Thread.WaitVU();
+	iopThread.WaitIOP();
+	ipuThread.Wait();
 	if (GetMTGS().IsOpen())
 		GetMTGS().WaitGS();		// GS better be done processing before we reset the EE, just in case.
 
+	// Snapshots from before the reset belong to a different boot.
+	Rewind::Shutdown();
+
 	GetVmMemory().ResetAll();
 
 	memzero(cpuRegs);
 	memzero(fpuRegs);
 	memzero(tlb);
+	s_eventQueue.Clear();
 
 	cpuRegs.pc				= 0xbfc00000; //set pc reg to stack
 	cpuRegs.CP0.n.Config	= 0x440;
@@ -268,6 +390,12 @@ __fi void cpuClearInt( uint i )
 {
 	pxAssume( i < 32 );
 	cpuRegs.interrupt &= ~(1 << i);
+	s_eventQueue.Remove(i);
+}
+
+void cpuRebuildEventQueue()
+{
+	s_eventQueue.Rebuild();
 }
 
 static __fi void TESTINT( u8 n, void (*callback)() )
@@ -278,9 +406,10 @@ static __fi void TESTINT( u8 n, void (*callback)() )
 	{
 		cpuClearInt( n );
 		callback();
+		g_eeEventDispatchCount++;
 	}
 	else
-		cpuSetNextEvent( cpuRegs.sCycle[n], cpuRegs.eCycle[n] );
+		s_eventQueue.Schedule(n); // an earlier handler moved it
 }
 
 // [TODO] move this function to LegacyDmac.cpp, and remove most of the DMAC-related headers from
@@ -295,32 +424,58 @@ static __fi void _cpuTestInterrupts()
 	/* These are 'pcsx2 interrupts', they handle asynchronous stuff
 	   that depends on the cycle timings */
 
-	TESTINT(DMAC_VIF1,		vif1Interrupt);	
-	TESTINT(DMAC_GIF,		gifInterrupt);
-	TESTINT(DMAC_SIF0,		EEsif0Interrupt);
-	TESTINT(DMAC_SIF1,		EEsif1Interrupt);
-	
-	// Profile-guided Optimization (sorta)
-	// The following ints are rarely called.  Encasing them in a conditional
-	// as follows helps speed up most games.
+	// Take everything that is due off the queue first, handlers are free to schedule new events.
+	u32 due = 0;
+	while (!s_eventQueue.Empty())
+	{
+		const uint n = s_eventQueue.Top();
 
-	if (cpuRegs.interrupt & ((1 << DMAC_VIF0) | (1 << DMAC_FROM_IPU) | (1 << DMAC_TO_IPU)
-		| (1 << DMAC_FROM_SPR) | (1 << DMAC_TO_SPR) | (1 << DMAC_MFIFO_VIF) | (1 << DMAC_MFIFO_GIF)
-		| (1 << VIF_VU0_FINISH) | (1 << VIF_VU1_FINISH)))
+		if (!(cpuRegs.interrupt & (1 << n)))
+		{
+			s_eventQueue.Remove(n);
+			continue;
+		}
+
+		if (s_eventQueue.TopDeadline() != cpuRegs.sCycle[n] + cpuRegs.eCycle[n])
+		{
+			s_eventQueue.Schedule(n);
+			continue;
+		}
+
+		if (g_GameStarted && !cpuTestCycle(cpuRegs.sCycle[n], cpuRegs.eCycle[n]))
+			break;
+
+		s_eventQueue.Remove(n);
+		due |= 1 << n;
+	}
+
+	// Due events still run in the usual channel order.
+	if (due)
 	{
-		TESTINT(DMAC_VIF0,		vif0Interrupt);
+		if (due & (1 << DMAC_VIF1))			TESTINT(DMAC_VIF1,		vif1Interrupt);
+		if (due & (1 << DMAC_GIF))			TESTINT(DMAC_GIF,		gifInterrupt);
+		if (due & (1 << DMAC_SIF0))			TESTINT(DMAC_SIF0,		EEsif0Interrupt);
+		if (due & (1 << DMAC_SIF1))			TESTINT(DMAC_SIF1,		EEsif1Interrupt);
+
+		if (due & (1 << DMAC_VIF0))			TESTINT(DMAC_VIF0,		vif0Interrupt);
+
+		if (due & (1 << DMAC_FROM_IPU))		TESTINT(DMAC_FROM_IPU,	ipu0Interrupt);
+		if (due & (1 << DMAC_TO_IPU))		TESTINT(DMAC_TO_IPU,	ipu1Interrupt);
 
-		TESTINT(DMAC_FROM_IPU,	ipu0Interrupt);
-		TESTINT(DMAC_TO_IPU,	ipu1Interrupt);
+		if (due & (1 << DMAC_FROM_SPR))		TESTINT(DMAC_FROM_SPR,	SPRFROMinterrupt);
+		if (due & (1 << DMAC_TO_SPR))		TESTINT(DMAC_TO_SPR,	SPRTOinterrupt);
 
-		TESTINT(DMAC_FROM_SPR,	SPRFROMinterrupt);
-		TESTINT(DMAC_TO_SPR,	SPRTOinterrupt);
+		if (due & (1 << DMAC_MFIFO_VIF))	TESTINT(DMAC_MFIFO_VIF, vifMFIFOInterrupt);
+		if (due & (1 << DMAC_MFIFO_GIF))	TESTINT(DMAC_MFIFO_GIF, gifMFIFOInterrupt);
 
-		TESTINT(DMAC_MFIFO_VIF, vifMFIFOInterrupt);
-		TESTINT(DMAC_MFIFO_GIF, gifMFIFOInterrupt);
+		if (due & (1 << VIF_VU0_FINISH))	TESTINT(VIF_VU0_FINISH, vif0VUFinish);
+		if (due & (1 << VIF_VU1_FINISH))	TESTINT(VIF_VU1_FINISH, vif1VUFinish);
+	}
 
-		TESTINT(VIF_VU0_FINISH, vif0VUFinish);
-		TESTINT(VIF_VU1_FINISH, vif1VUFinish);
+	if (!s_eventQueue.Empty())
+	{
+		const uint n = s_eventQueue.Top();
+		cpuSetNextEvent(cpuRegs.sCycle[n], cpuRegs.eCycle[n]);
 	}
 }
 
@@ -365,12 +520,44 @@ static bool cpuIntsEnabled(int Interrupt)
 		!cpuRegs.CP0.n.Status.b.EXL && (cpuRegs.CP0.n.Status.b.ERL == 0);
 }
 
+// The EE can only cut the IOP's current block short when it runs on the same thread, the IOP
+// thread breaks out on its own.
+static __fi bool cpuCanBreakIOP()
+{
+	return !THREAD_IOP || IOP_Thread::IsIOPThread();
+}
+
+// Runs the IOP up to the EE's position (EEsCycle), on the IOP thread when it is enabled.
+void cpuExecuteIOP()
+{
+	if( EEsCycle > 0 )
+		iopEventAction = true;
+
+	iopEventTest();
+
+	if( iopEventAction )
+	{
+		//if( EEsCycle < -450 )
+		//	Console.WriteLn( " IOP ahead by: %d cycles", -EEsCycle );
+
+		EEsCycle = psxCpu->ExecuteBlock( EEsCycle );
+
+		iopEventAction = false;
+	}
+}
+
 // Shared portion of the branch test, called from both the Interpreter
 // and the recompiler.  (moved here to help alleviate redundant code)
 __fi void _cpuEventTest_Shared()
 {
+	// Everything below may touch IOP state, take it back from the IOP thread first.
+	iopThread.WaitIOP();
+	// Same for the IPU, this also raises the interrupts and DMA events it left pending.
+	ipuThread.Wait();
+
 	eeEventTestIsActive = true;
 	cpuRegs.nextEventCycle = cpuRegs.cycle + eeWaitCycles;
+	g_eeEventTestCount++;
 
 	// ---- INTC / DMAC (CPU-level Exceptions) -----------------
 	// Done first because exceptions raised during event tests need to be postponed a few
@@ -424,20 +611,13 @@ __fi void _cpuEventTest_Shared()
 	EEsCycle += cpuRegs.cycle - EEoCycle;
 	EEoCycle = cpuRegs.cycle;
 
-	if( EEsCycle > 0 )
-		iopEventAction = true;
-
-	iopEventTest();
+	// * With the IOP thread, the slice runs while the EE carries on, the rest of this
+	//   function must not touch IOP state anymore.
 
-	if( iopEventAction )
-	{
-		//if( EEsCycle < -450 )
-		//	Console.WriteLn( " IOP ahead by: %d cycles", -EEsCycle );
-
-		EEsCycle = psxCpu->ExecuteBlock( EEsCycle );
-
-		iopEventAction = false;
-	}
+	if( THREAD_IOP )
+		iopThread.ExecuteSlice();
+	else
+		cpuExecuteIOP();
 
 	// ---- VU Sync -------------
 	// We're in a EventTest.  All dynarec registers are flushed
@@ -447,7 +627,13 @@ __fi void _cpuEventTest_Shared()
 
 	// ---- Schedule Next Event Test --------------
 
-	if( EEsCycle > 192 )
+	if( THREAD_IOP )
+	{
+		// The IOP catches up on its own thread, the EE only has to come back before it
+		// gets too far ahead (or leaves an IOP access to EE state waiting for too long).
+		cpuSetNextEventDelta( std::clamp<uint>( EmuConfig.Speedhacks.IopThreadMaxSkew, 64, eeWaitCycles ) );
+	}
+	else if( EEsCycle > 192 )
 	{
 		// EE's running way ahead of the IOP still, so we should branch quickly to give the
 		// IOP extra timeslices in short order.
@@ -458,7 +644,8 @@ __fi void _cpuEventTest_Shared()
 
 	// The IOP could be running ahead/behind of us, so adjust the iop's next branch by its
 	// relative position to the EE (via EEsCycle)
-	cpuSetNextEventDelta( ((g_iopNextEventCycle-psxRegs.cycle)*8) - EEsCycle );
+	if( !THREAD_IOP )
+		cpuSetNextEventDelta( ((g_iopNextEventCycle-psxRegs.cycle)*8) - EEsCycle );
 
 	// Apply the hsync counter's nextCycle
 	cpuSetNextEvent( hsyncCounter.sCycle, hsyncCounter.CycleT );
@@ -478,7 +665,7 @@ __ri void cpuTestINTCInts()
 	if( (psHu32(INTC_STAT) & psHu32(INTC_MASK)) == 0 ) return;
 
 	cpuSetNextEventDelta( 4 );
-	if(eeEventTestIsActive && (iopCycleEE > 0))
+	if(eeEventTestIsActive && cpuCanBreakIOP() && (iopCycleEE > 0))
 	{
 		iopBreak += iopCycleEE;		// record the number of cycles the IOP didn't run.
 		iopCycleEE = 0;
@@ -495,7 +682,7 @@ __fi void cpuTestDMACInts()
 		 ( (psHu16(0xe010) & 0x8000) == 0) ) return;
 
 	cpuSetNextEventDelta( 4 );
-	if(eeEventTestIsActive && (iopCycleEE > 0))
+	if(eeEventTestIsActive && cpuCanBreakIOP() && (iopCycleEE > 0))
 	{
 		iopBreak += iopCycleEE;		// record the number of cycles the IOP didn't run.
 		iopCycleEE = 0;
@@ -525,10 +712,11 @@ __fi void CPU_INT( EE_EventType n, s32 ecycle)
 	cpuRegs.interrupt|= 1 << n;
 	cpuRegs.sCycle[n] = cpuRegs.cycle;
 	cpuRegs.eCycle[n] = ecycle;
+	s_eventQueue.Schedule(n);
 
 	// Interrupt is happening soon: make sure both EE and IOP are aware.
 
-	if( ecycle <= 28 && iopCycleEE > 0 )
+	if( ecycle <= 28 && cpuCanBreakIOP() && iopCycleEE > 0 )
 	{
 		// If running in the IOP, force it to break immediately into the EE.
 		// the EE's branch test is due to run.
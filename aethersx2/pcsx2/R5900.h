@@ -440,6 +440,8 @@ extern void cpuTlbMissR(u32 addr, u32 bd);
 extern void cpuTlbMissW(u32 addr, u32 bd);
 extern void cpuTestHwInts();
 extern void cpuClearInt(uint n);
+extern void cpuRebuildEventQueue();
+extern void cpuExecuteIOP();
 extern void __fastcall GoemonPreloadTlb();
 extern void __fastcall GoemonUnloadTlb(u32 key);
 
@@ -450,6 +452,11 @@ extern void cpuSetEvent();
 
 extern void _cpuEventTest_Shared();		// for internal use by the Dynarecs and Ints inside R5900:
 
+// Number of EE event tests and of DMA/VU events they dispatched since boot, only ever
+// written by the EE thread.
+extern u32 g_eeEventTestCount;
+extern u32 g_eeEventDispatchCount;
+
 extern void cpuTestINTCInts();
 extern void cpuTestDMACInts();
 extern void cpuTestTIMRInts();
@@ -0,0 +1,634 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Rewind.h"
+
+#include "IopCommon.h"
+#include "Memory.h"
+#include "SaveState.h"
+#include "SaveStateArchive.h"
+
+#include "common/Console.h"
+#include "common/PersistentThread.h"
+#include "common/SafeArray.inl"
+#include "common/Timer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <zlib.h>
+
+namespace Rewind
+{
+	static constexpr u32 PAGE_SHIFT = 12;
+	static constexpr u32 PAGE_SIZE = 1u << PAGE_SHIFT;
+
+	// Pages are deflated on their own, a window bigger than the page buys nothing.
+	static constexpr int WINDOW_BITS = PAGE_SHIFT;
+
+	// Hashing and inflating is split in tasks of this many pages for ParallelFor.
+	static constexpr u32 PAGES_PER_TASK = 256;
+
+	// Raw snapshots waiting for the compression thread, vsyncs beyond this don't capture.
+	static constexpr u32 MAX_PENDING = 2;
+
+	enum Region : u32
+	{
+		Region_EEMemory,
+		Region_IOPMemory,
+		Region_State,
+		Region_Count
+	};
+
+	static constexpr u32 REGION_SHIFT = 24;
+
+	struct PendingSnapshot
+	{
+		u32 state_size;
+		std::vector<u32> keys; // region << REGION_SHIFT | page
+		std::vector<u8> data; // PAGE_SIZE per key
+	};
+
+	struct PageRecord
+	{
+		u32 key;
+		u32 offset;
+		u32 length; // 0 for a zeroed page, PAGE_SIZE for a stored one
+	};
+
+	struct Snapshot
+	{
+		u32 state_size;
+		std::vector<PageRecord> pages; // sorted by key
+		std::vector<u8> data;
+
+		u64 GetMemoryUsage() const { return sizeof(Snapshot) + pages.size() * sizeof(PageRecord) + data.size(); }
+	};
+
+	static u8* GetRegionData(u32 region);
+	static u32 GetRegionPageCount(u32 region);
+	static u64 HashPage(const u8* data);
+	static bool IsZeroPage(const u8* data);
+	static void HashRegion(u32 region, bool force, std::vector<u8>* dirty);
+	static void PrepareStateBuffer();
+	static bool Capture();
+	static Snapshot CompressSnapshot(z_stream* zs, const PendingSnapshot& pending);
+	static void FoldOldestSnapshot();
+	static void ClearSnapshots();
+	static void WorkerThread();
+
+	// CPU thread only.
+	static VmStateBuffer s_state_buffer(L"RewindStateBuffer");
+	static u32 s_state_size = 0;
+	static std::vector<u64> s_page_hashes[Region_Count];
+	static bool s_hashes_valid = false;
+	static u32 s_frames_since_capture = 0;
+
+	// Shared with the compression thread, guarded by s_mutex.
+	static std::thread s_thread;
+	static std::mutex s_mutex;
+	static std::condition_variable s_work_cv;
+	static std::condition_variable s_done_cv;
+	static std::deque<std::unique_ptr<PendingSnapshot>> s_pending;
+	static std::deque<Snapshot> s_ring;
+	static u64 s_memory_used = 0;
+	static u64 s_budget = 0;
+	static float s_last_capture_ms = 0.0f;
+	static float s_last_compress_ms = 0.0f;
+	static bool s_busy = false;
+	static bool s_shutdown = false;
+
+	// Set from any thread by RequestLoadPrevious().
+	static std::atomic<bool> s_load_requested{false};
+
+	// Set by OnVSync(), the capture runs at the next state check.
+	static std::atomic<bool> s_capture_requested{false};
+} // namespace Rewind
+
+u8* Rewind::GetRegionData(u32 region)
+{
+	switch (region)
+	{
+		case Region_EEMemory:
+			return eeMem->Main;
+		case Region_IOPMemory:
+			return iopMem->Main;
+		default:
+			return s_state_buffer.GetPtr();
+	}
+}
+
+u32 Rewind::GetRegionPageCount(u32 region)
+{
+	switch (region)
+	{
+		case Region_EEMemory:
+			return sizeof(eeMem->Main) / PAGE_SIZE;
+		case Region_IOPMemory:
+			return sizeof(iopMem->Main) / PAGE_SIZE;
+		default:
+			return (s_state_size + PAGE_SIZE - 1) / PAGE_SIZE;
+	}
+}
+
+u64 Rewind::HashPage(const u8* data)
+{
+	static constexpr u64 PRIME1 = 0x9E3779B185EBCA87ULL;
+	static constexpr u64 PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+
+	// Four independent lanes so the multiplies overlap, this only has to spot changes.
+	u64 lanes[4] = {PRIME1, PRIME2, ~PRIME1, ~PRIME2};
+	for (u32 i = 0; i < PAGE_SIZE; i += sizeof(lanes))
+	{
+		for (u32 j = 0; j < 4; j++)
+		{
+			u64 value;
+			std::memcpy(&value, data + i + j * sizeof(u64), sizeof(value));
+			lanes[j] = (lanes[j] ^ value) * PRIME1;
+			lanes[j] ^= lanes[j] >> 29;
+		}
+	}
+
+	const u64 hash = lanes[0] ^ ((lanes[1] << 17) | (lanes[1] >> 47)) ^
+		((lanes[2] << 31) | (lanes[2] >> 33)) ^ ((lanes[3] << 47) | (lanes[3] >> 17));
+	return hash * PRIME2;
+}
+
+bool Rewind::IsZeroPage(const u8* data)
+{
+	u64 bits = 0;
+	for (u32 i = 0; i < PAGE_SIZE; i += sizeof(u64))
+	{
+		u64 value;
+		std::memcpy(&value, data + i, sizeof(value));
+		bits |= value;
+	}
+
+	return (bits == 0);
+}
+
+void Rewind::HashRegion(u32 region, bool force, std::vector<u8>* dirty)
+{
+	const u8* data = GetRegionData(region);
+	const u32 count = GetRegionPageCount(region);
+	std::vector<u64>& hashes = s_page_hashes[region];
+
+	hashes.resize(count);
+	dirty->assign(count, 0);
+
+	SaveStateArchive::ParallelFor((count + PAGES_PER_TASK - 1) / PAGES_PER_TASK, [data, count, force, &hashes, dirty](size_t task) {
+		const u32 first = static_cast<u32>(task) * PAGES_PER_TASK;
+		const u32 last = std::min(count, first + PAGES_PER_TASK);
+		for (u32 i = first; i < last; i++)
+		{
+			const u64 hash = HashPage(data + i * PAGE_SIZE);
+			if (force || hash != hashes[i])
+			{
+				hashes[i] = hash;
+				(*dirty)[i] = 1;
+			}
+		}
+	});
+}
+
+void Rewind::PrepareStateBuffer()
+{
+	// The last page of the machine state is padded with zeros so it hashes the same every time.
+	const u32 padded_size = GetRegionPageCount(Region_State) * PAGE_SIZE;
+	s_state_buffer.MakeRoomFor(padded_size);
+	std::memset(s_state_buffer.GetPtr(s_state_size), 0, padded_size - s_state_size);
+}
+
+bool Rewind::Capture()
+{
+	{
+		std::unique_lock<std::mutex> lock(s_mutex);
+		if (s_pending.size() >= MAX_PENDING)
+			return false;
+
+		s_budget = static_cast<u64>(EmuConfig.Rewind.BufferSizeMB) * _1mb;
+	}
+
+	Common::Timer timer;
+
+	uint state_size;
+	SaveState_FreezeWithoutMainMemory(s_state_buffer, &state_size);
+	if (state_size != s_state_size)
+	{
+		// Page indices of the machine state shift around, start over with a full snapshot.
+		if (s_state_size != 0)
+			DevCon.WriteLn("Rewind: Machine state size changed (%u -> %u bytes), dropping snapshots.", s_state_size, state_size);
+
+		ClearSnapshots();
+		s_state_size = state_size;
+		s_hashes_valid = false;
+	}
+
+	PrepareStateBuffer();
+
+	std::unique_ptr<PendingSnapshot> snapshot = std::make_unique<PendingSnapshot>();
+	snapshot->state_size = state_size;
+
+	std::vector<u8> dirty;
+	for (u32 region = 0; region < Region_Count; region++)
+	{
+		HashRegion(region, !s_hashes_valid, &dirty);
+
+		const u8* data = GetRegionData(region);
+		for (u32 i = 0; i < static_cast<u32>(dirty.size()); i++)
+		{
+			if (!dirty[i])
+				continue;
+
+			snapshot->keys.push_back((region << REGION_SHIFT) | i);
+			snapshot->data.insert(snapshot->data.end(), data + i * PAGE_SIZE, data + (i + 1) * PAGE_SIZE);
+		}
+	}
+
+	s_hashes_valid = true;
+
+	{
+		std::unique_lock<std::mutex> lock(s_mutex);
+		s_last_capture_ms = static_cast<float>(timer.GetTimeMilliseconds());
+		s_pending.push_back(std::move(snapshot));
+	}
+	s_work_cv.notify_one();
+
+	return true;
+}
+
+Rewind::Snapshot Rewind::CompressSnapshot(z_stream* zs, const PendingSnapshot& pending)
+{
+	Snapshot snapshot;
+	snapshot.state_size = pending.state_size;
+	snapshot.pages.reserve(pending.keys.size());
+
+	u8 packed[PAGE_SIZE];
+
+	for (size_t i = 0; i < pending.keys.size(); i++)
+	{
+		const u8* src = &pending.data[i * PAGE_SIZE];
+
+		PageRecord record = {pending.keys[i], static_cast<u32>(snapshot.data.size()), 0};
+		if (!IsZeroPage(src))
+		{
+			// Output is capped one byte short of a page, anything that doesn't fit is stored.
+			deflateReset(zs);
+			zs->next_in = const_cast<Bytef*>(src);
+			zs->avail_in = PAGE_SIZE;
+			zs->next_out = packed;
+			zs->avail_out = PAGE_SIZE - 1;
+
+			if (deflate(zs, Z_FINISH) == Z_STREAM_END)
+			{
+				record.length = PAGE_SIZE - 1 - zs->avail_out;
+				snapshot.data.insert(snapshot.data.end(), packed, packed + record.length);
+			}
+			else
+			{
+				record.length = PAGE_SIZE;
+				snapshot.data.insert(snapshot.data.end(), src, src + PAGE_SIZE);
+			}
+		}
+
+		snapshot.pages.push_back(record);
+	}
+
+	snapshot.data.shrink_to_fit();
+	return snapshot;
+}
+
+void Rewind::FoldOldestSnapshot()
+{
+	// The oldest snapshot has every page, the pages its successor didn't capture move over to it.
+	Snapshot& oldest = s_ring[0];
+	Snapshot& next = s_ring[1];
+
+	std::vector<PageRecord> pages;
+	std::vector<u8> data;
+	pages.reserve(oldest.pages.size());
+	data.reserve(oldest.data.size());
+
+	auto append = [&pages, &data](const Snapshot& from, const PageRecord& record) {
+		pages.push_back({record.key, static_cast<u32>(data.size()), record.length});
+		data.insert(data.end(), from.data.begin() + record.offset, from.data.begin() + record.offset + record.length);
+	};
+
+	size_t i = 0, j = 0;
+	while (i < oldest.pages.size() || j < next.pages.size())
+	{
+		if (j == next.pages.size() || (i < oldest.pages.size() && oldest.pages[i].key < next.pages[j].key))
+		{
+			append(oldest, oldest.pages[i++]);
+		}
+		else
+		{
+			if (i < oldest.pages.size() && oldest.pages[i].key == next.pages[j].key)
+				i++;
+
+			append(next, next.pages[j++]);
+		}
+	}
+
+	s_memory_used -= oldest.GetMemoryUsage() + next.GetMemoryUsage();
+	next.pages = std::move(pages);
+	next.data = std::move(data);
+	s_memory_used += next.GetMemoryUsage();
+
+	s_ring.pop_front();
+}
+
+void Rewind::ClearSnapshots()
+{
+	std::unique_lock<std::mutex> lock(s_mutex);
+	s_pending.clear();
+	s_done_cv.wait(lock, []() { return !s_busy; });
+	s_ring.clear();
+	s_memory_used = 0;
+}
+
+void Rewind::WorkerThread()
+{
+	Threading::SetNameOfCurrentThread("Rewind Compress");
+
+	z_stream zs = {};
+	if (deflateInit2(&zs, Z_BEST_SPEED, Z_DEFLATED, WINDOW_BITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+	{
+		Console.Error("Rewind: Failed to initialize deflate.");
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(s_mutex);
+	for (;;)
+	{
+		s_work_cv.wait(lock, []() { return s_shutdown || !s_pending.empty(); });
+		if (s_shutdown)
+			break;
+
+		std::unique_ptr<PendingSnapshot> pending = std::move(s_pending.front());
+		s_pending.pop_front();
+		s_busy = true;
+		lock.unlock();
+
+		Common::Timer timer;
+		Snapshot snapshot = CompressSnapshot(&zs, *pending);
+		pending.reset();
+		const float compress_ms = static_cast<float>(timer.GetTimeMilliseconds());
+
+		lock.lock();
+		s_memory_used += snapshot.GetMemoryUsage();
+		s_ring.push_back(std::move(snapshot));
+		while (s_ring.size() > 1 && s_memory_used > s_budget)
+			FoldOldestSnapshot();
+
+		s_last_compress_ms = compress_ms;
+		s_busy = false;
+		s_done_cv.notify_all();
+	}
+
+	deflateEnd(&zs);
+}
+
+void Rewind::OnVSync()
+{
+	if (!EmuConfig.Rewind.Enabled)
+	{
+		if (s_thread.joinable())
+			Shutdown();
+
+		return;
+	}
+
+	if (!s_thread.joinable())
+		s_thread = std::thread(WorkerThread);
+
+	// Serializing the machine from here would catch the counters halfway through their update.
+	if (++s_frames_since_capture >= EmuConfig.Rewind.Frequency)
+		s_capture_requested.store(true, std::memory_order_release);
+}
+
+bool Rewind::HasPendingCapture()
+{
+	return s_capture_requested.load(std::memory_order_acquire);
+}
+
+bool Rewind::ProcessPendingCapture()
+{
+	if (!s_capture_requested.exchange(false, std::memory_order_acq_rel) || !s_thread.joinable())
+		return false;
+
+	// A skipped capture is requested again on the next vsync.
+	if (!Capture())
+		return false;
+
+	s_frames_since_capture = 0;
+	return true;
+}
+
+bool Rewind::LoadPrevious()
+{
+	if (!s_thread.joinable())
+		return false;
+
+	std::unique_lock<std::mutex> lock(s_mutex);
+	s_done_cv.wait(lock, []() { return s_pending.empty() && !s_busy; });
+
+	// Right after a capture (or a previous rewind) we are sitting on the newest snapshot, skip it.
+	size_t target = s_ring.size();
+	if (target == 0 || (s_frames_since_capture == 0 && target == 1))
+		return false;
+
+	target -= (s_frames_since_capture == 0) ? 2 : 1;
+
+	Common::Timer timer;
+
+	while (s_ring.size() > target + 1)
+	{
+		s_memory_used -= s_ring.back().GetMemoryUsage();
+		s_ring.pop_back();
+	}
+
+	s_state_size = s_ring.back().state_size;
+	PrepareStateBuffer();
+
+	// Walk from the target back to the full snapshot, the newest copy of each page wins.
+	struct Job
+	{
+		const Snapshot* snapshot;
+		const PageRecord* record;
+	};
+	std::vector<Job> jobs;
+	std::vector<u8> restored[Region_Count];
+	for (u32 region = 0; region < Region_Count; region++)
+		restored[region].assign(GetRegionPageCount(region), 0);
+
+	for (size_t i = s_ring.size(); i-- > 0;)
+	{
+		for (const PageRecord& record : s_ring[i].pages)
+		{
+			u8& done = restored[record.key >> REGION_SHIFT][record.key & ((1u << REGION_SHIFT) - 1)];
+			if (done)
+				continue;
+
+			done = 1;
+			jobs.push_back({&s_ring[i], &record});
+		}
+	}
+
+	std::atomic<bool> failed{false};
+	SaveStateArchive::ParallelFor((jobs.size() + PAGES_PER_TASK - 1) / PAGES_PER_TASK, [&jobs, &failed](size_t task) {
+		z_stream zs = {};
+		if (inflateInit2(&zs, WINDOW_BITS) != Z_OK)
+		{
+			failed.store(true, std::memory_order_relaxed);
+			return;
+		}
+
+		const size_t last = std::min(jobs.size(), (task + 1) * PAGES_PER_TASK);
+		for (size_t i = task * PAGES_PER_TASK; i < last; i++)
+		{
+			const PageRecord& record = *jobs[i].record;
+			const u8* src = jobs[i].snapshot->data.data() + record.offset;
+			u8* dst = GetRegionData(record.key >> REGION_SHIFT) + (record.key & ((1u << REGION_SHIFT) - 1)) * PAGE_SIZE;
+
+			if (record.length == 0)
+			{
+				std::memset(dst, 0, PAGE_SIZE);
+			}
+			else if (record.length == PAGE_SIZE)
+			{
+				std::memcpy(dst, src, PAGE_SIZE);
+			}
+			else
+			{
+				inflateReset(&zs);
+				zs.next_in = const_cast<Bytef*>(src);
+				zs.avail_in = record.length;
+				zs.next_out = dst;
+				zs.avail_out = PAGE_SIZE;
+				if (inflate(&zs, Z_FINISH) != Z_STREAM_END || zs.avail_out != 0)
+					failed.store(true, std::memory_order_relaxed);
+			}
+		}
+
+		inflateEnd(&zs);
+	});
+
+	const size_t snapshot_count = s_ring.size();
+	lock.unlock();
+
+	if (failed.load())
+	{
+		// Main memory is half restored at this point, there is no state to fall back to.
+		Console.Error("Rewind: Failed to inflate snapshot, dropping rewind buffer.");
+		ClearSnapshots();
+		s_hashes_valid = false;
+		return false;
+	}
+
+	SaveState_DefrostWithoutMainMemory(s_state_buffer);
+
+	// The next capture is diffed against the snapshot we just went back to.
+	std::vector<u8> dirty;
+	for (u32 region = 0; region < Region_Count; region++)
+		HashRegion(region, true, &dirty);
+
+	s_hashes_valid = true;
+	s_frames_since_capture = 0;
+	s_capture_requested.store(false, std::memory_order_relaxed);
+
+	DevCon.WriteLn("Rewind: Restored snapshot %zu (%zu pages) in %.2f ms.", snapshot_count, jobs.size(), timer.GetTimeMilliseconds());
+	return true;
+}
+
+void Rewind::RequestLoadPrevious()
+{
+	s_load_requested.store(true, std::memory_order_release);
+}
+
+bool Rewind::HasPendingLoad()
+{
+	return s_load_requested.load(std::memory_order_acquire);
+}
+
+bool Rewind::ProcessPendingLoad()
+{
+	if (!s_load_requested.exchange(false, std::memory_order_acq_rel))
+		return false;
+
+	if (!LoadPrevious())
+	{
+		Console.Warning("Rewind: Nothing to rewind to.");
+		return false;
+	}
+
+	const Stats stats = GetStats();
+	Console.WriteLn("Rewind: Went back one snapshot, %u left (%.2f MB).", stats.snapshots,
+		static_cast<double>(stats.memory_used) / (1024.0 * 1024.0));
+	return true;
+}
+
+void Rewind::LogStats()
+{
+	const Stats stats = GetStats();
+	Console.WriteLn("Rewind: %u snapshots, %u pending, %.2f MB used, last capture %.2f ms, last compress %.2f ms.",
+		stats.snapshots, stats.pending, static_cast<double>(stats.memory_used) / (1024.0 * 1024.0),
+		stats.last_capture_ms, stats.last_compress_ms);
+}
+
+void Rewind::Shutdown()
+{
+	if (s_thread.joinable())
+	{
+		{
+			std::unique_lock<std::mutex> lock(s_mutex);
+			s_shutdown = true;
+		}
+		s_work_cv.notify_one();
+		s_thread.join();
+		s_shutdown = false;
+	}
+
+	s_pending.clear();
+	s_ring.clear();
+	s_memory_used = 0;
+
+	for (std::vector<u64>& hashes : s_page_hashes)
+		std::vector<u64>().swap(hashes);
+
+	s_state_buffer.Dispose();
+	s_state_size = 0;
+	s_hashes_valid = false;
+	s_frames_since_capture = 0;
+	s_load_requested.store(false, std::memory_order_relaxed);
+	s_capture_requested.store(false, std::memory_order_relaxed);
+}
+
+Rewind::Stats Rewind::GetStats()
+{
+	std::unique_lock<std::mutex> lock(s_mutex);
+
+	Stats stats;
+	stats.snapshots = static_cast<u32>(s_ring.size());
+	stats.pending = static_cast<u32>(s_pending.size());
+	stats.memory_used = s_memory_used;
+	stats.last_capture_ms = s_last_capture_ms;
+	stats.last_compress_ms = s_last_compress_ms;
+	return stats;
+}
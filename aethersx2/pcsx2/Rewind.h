@@ -0,0 +1,67 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/Pcsx2Defs.h"
+
+// In-memory ring of recent machine states.
+//
+// Every EmuConfig.Rewind.Frequency vsyncs the machine is split in 4KB pages (EE main memory,
+// IOP main memory, and the serialized remainder which holds GS local memory, SPU2 memory and
+// the register state). Only pages whose hash changed since the previous snapshot are copied,
+// a worker thread deflates them page by page. The oldest snapshot always holds every page;
+// once the ring is over EmuConfig.Rewind.BufferSizeMB it is folded into its successor.
+namespace Rewind
+{
+	struct Stats
+	{
+		u32 snapshots;
+		u32 pending;
+		u64 memory_used;
+		float last_capture_ms;
+		float last_compress_ms;
+	};
+
+	// CPU thread, once per vsync, from inside Cpu->Execute(). Only counts frames, a capture that
+	// is due is queued for ProcessPendingCapture() and Execute() is left to take it.
+	void OnVSync();
+	bool HasPendingCapture();
+
+	// CPU thread, outside of Cpu->Execute(). Takes the snapshot queued by OnVSync(), returns
+	// true if one was captured.
+	bool ProcessPendingCapture();
+
+	// CPU thread, outside of Cpu->Execute(). Restores the latest snapshot taken before the
+	// current frame and drops everything newer. Returns false if there is nothing to go back to.
+	bool LoadPrevious();
+
+	// Any thread. Asks the CPU thread to run LoadPrevious() at its next state check; the
+	// rewind hotkey goes through here.
+	void RequestLoadPrevious();
+	bool HasPendingLoad();
+
+	// CPU thread, outside of Cpu->Execute(). Runs a rewind queued by RequestLoadPrevious(),
+	// returns true if the machine was rewound.
+	bool ProcessPendingLoad();
+
+	// Drops every snapshot and stops the compression thread.
+	void Shutdown();
+
+	Stats GetStats();
+
+	// Prints GetStats() to the console.
+	void LogStats();
+} // namespace Rewind
@@ -37,7 +37,7 @@ void InitADSR() // INIT ADSR
 	}
 }
 
-bool V_ADSR::Calculate()
+bool V_ADSR::Calculate(s32& Value)
 {
 	pxAssume(Phase != 0);
 
@@ -65,6 +65,8 @@ extern wxString MemDumpFileName;
 extern wxString RegDumpFileName;
 
 extern int Interpolation;
+extern bool BlockMixing;
+extern bool ThreadedMixing;
 extern int numSpeakers;
 extern float FinalVolume; // Global / pre-scale
 extern bool AdvancedVolumeControl;
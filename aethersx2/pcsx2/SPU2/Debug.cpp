@@ -96,6 +96,16 @@ void V_VolumeLR::DebugDump(FILE* dump, const char* title)
 
 void DoFullDump()
 {
+#ifdef SPU2_LOG
+	if (CoresDump())
+	{
+		const VoiceMixBenchmark bench(BenchmarkVoiceMix(60));
+		ConLog("* SPU2: Voice mix cost over %u frames, %u voices playing: %.3f ms/frame one at a time, %.3f ms/frame in lanes%s\n",
+			bench.frames, bench.active_voices, bench.serial_ms, bench.parallel_ms,
+			bench.parallel_eligible ? "" : " (lanes not used here, modulated or dynamic range voices)");
+	}
+#endif
+
 #ifdef _MSC_VER
 #ifdef SPU2_LOG
 	FILE* dump;
@@ -194,9 +204,9 @@ void DoFullDump()
 						Cores[c].Voices[v].ADSR.ReleaseRate,
 						Cores[c].Voices[v].ADSR.ReleaseMode,
 						Cores[c].Voices[v].ADSR.Phase,
-						Cores[c].Voices[v].ADSR.Value);
+						Cores[c].VoiceLanes.Env[v]);
 
-				fprintf(dump, "  - Pitch:     %x\n", Cores[c].Voices[v].Pitch);
+				fprintf(dump, "  - Pitch:     %x\n", Cores[c].VoiceLanes.Pitch[v]);
 				fprintf(dump, "  - Modulated: %s\n", Cores[c].Voices[v].Modulated ? "Yes" : "No");
 				fprintf(dump, "  - Source:    %s\n", Cores[c].Voices[v].Noise ? "Noise" : "Wave");
 				fprintf(dump, "  - Direct Output for Left Channel:   %s\n", Cores[c].VoiceGates[v].DryL ? "Yes" : "No");
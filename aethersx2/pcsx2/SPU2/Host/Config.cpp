@@ -36,6 +36,8 @@ int Interpolation = 5;
 		4. Catmull-Rom interpolation
 		5. Gaussian interpolation
 */
+bool BlockMixing = false; // mix voices several ticks at a time, see MixBlock()
+bool ThreadedMixing = false; // replay SPU2 accesses on a mixer thread when possible, see MixerThread.h
 
 float FinalVolume; // global
 bool AdvancedVolumeControl;
@@ -72,6 +74,8 @@ bool temp_debug_state;
 void ReadSettings()
 {
 	Interpolation = Host::GetIntSettingValue("SPU2/Mixing", "Interpolation", 5);
+	BlockMixing = Host::GetBoolSettingValue("SPU2/Mixing", "BlockMixing", false);
+	ThreadedMixing = Host::GetBoolSettingValue("SPU2/Mixing", "ThreadedMixing", false);
 	FinalVolume = ((float)Host::GetIntSettingValue("SPU2/Mixing", "FinalVolume", 100)) / 100;
 	if (FinalVolume > 1.0f)
 		FinalVolume = 1.0f;
@@ -65,6 +65,8 @@ static __forceinline bool RegDump() { return _RegDump & DebugEnabled; }*/
 //extern wchar_t RegDumpFileName[255];
 
 extern int Interpolation;
+extern bool BlockMixing;
+extern bool ThreadedMixing;
 extern float FinalVolume;
 
 extern int AutoDMAPlayRate[2];
@@ -38,6 +38,8 @@ int Interpolation = 5;
 		4. Catmull-Rom interpolation
 		5. Gaussian interpolation
 */
+bool BlockMixing = false; // mix voices several ticks at a time, see MixBlock()
+bool ThreadedMixing = false; // replay SPU2 accesses on a mixer thread when possible, see MixerThread.h
 
 float FinalVolume; // global
 bool AdvancedVolumeControl;
@@ -83,6 +85,8 @@ void ReadSettings()
 		initIni();
 
 	Interpolation = CfgReadInt(L"MIXING", L"Interpolation", 5);
+	BlockMixing = CfgReadBool(L"MIXING", L"BlockMixing", false);
+	ThreadedMixing = CfgReadBool(L"MIXING", L"ThreadedMixing", false);
 	FinalVolume = ((float)CfgReadInt(L"MIXING", L"FinalVolume", 100)) / 100;
 	if (FinalVolume > 1.0f)
 		FinalVolume = 1.0f;
@@ -183,6 +187,8 @@ void WriteSettings()
 	}
 
 	CfgWriteInt(L"MIXING", L"Interpolation", Interpolation);
+	CfgWriteBool(L"MIXING", L"BlockMixing", BlockMixing);
+	CfgWriteBool(L"MIXING", L"ThreadedMixing", ThreadedMixing);
 	CfgWriteInt(L"MIXING", L"FinalVolume", (int)(FinalVolume * 100));
 
 	CfgWriteBool(L"MIXING", L"AdvancedVolumeControl", AdvancedVolumeControl);
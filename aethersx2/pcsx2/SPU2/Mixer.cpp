@@ -16,6 +16,18 @@
 #include "PrecompiledHeader.h"
 #include "Global.h"
 
+#include "common/Timer.h"
+
+#if defined(_M_X86_32) || defined(_M_X86_64)
+#include <immintrin.h>
+#elif defined(_M_ARM64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
 void ADMAOutLogWrite(void* lpData, u32 ulSize);
 
 #include "interpolate_table.h"
@@ -83,25 +95,26 @@ static void __forceinline XA_decode_block(s16* buffer, const s16* block, s32& pr
 	const s32 pred1 = tbl_XA_Factor[id][0];
 	const s32 pred2 = tbl_XA_Factor[id][1];
 
-	const s8* blockbytes = (s8*)&block[1];
-	const s8* blockend = &blockbytes[13];
+	// Unpack and scale the whole block first, that part has no dependencies between samples
+	// and gets vectorized. Only the prediction filter has to go one sample at a time.
+	const u8* blockbytes = (const u8*)&block[1];
+	s32 data[pcm_DecodedSamplesPerBlock];
 
-	for (; blockbytes <= blockend; ++blockbytes)
+	for (int i = 0; i < pcm_DecodedSamplesPerBlock / 2; i++)
 	{
-		s32 data = ((*blockbytes) << 28) & 0xF0000000;
-		s32 pcm = (data >> shift) + (((pred1 * prev1) + (pred2 * prev2) + 32) >> 6);
-
-		Clampify(pcm, -0x8000, 0x7fff);
-		*(buffer++) = pcm;
+		data[i * 2 + 0] = (s32)((u32)blockbytes[i] << 28) >> shift;
+		data[i * 2 + 1] = (s32)((u32)(blockbytes[i] & 0xF0) << 24) >> shift;
+	}
 
-		data = ((*blockbytes) << 24) & 0xF0000000;
-		s32 pcm2 = (data >> shift) + (((pred1 * pcm) + (pred2 * prev1) + 32) >> 6);
+	for (int i = 0; i < pcm_DecodedSamplesPerBlock; i++)
+	{
+		s32 pcm = data[i] + (((pred1 * prev1) + (pred2 * prev2) + 32) >> 6);
 
-		Clampify(pcm2, -0x8000, 0x7fff);
-		*(buffer++) = pcm2;
+		Clampify(pcm, -0x8000, 0x7fff);
+		buffer[i] = pcm;
 
-		prev2 = pcm;
-		prev1 = pcm2;
+		prev2 = prev1;
+		prev1 = pcm;
 	}
 }
 
@@ -177,7 +190,7 @@ static __forceinline s32 GetNextDataBuffered(V_Core& thiscore, uint voiceidx)
 				vc.NextA = vc.LoopStartA | 1;
 				if (!(vc.LoopFlags & XAFLAG_LOOP))
 				{
-					vc.Stop();
+					thiscore.StopVoice(voiceidx);
 
 					if (IsDevBuild)
 					{
@@ -283,7 +296,7 @@ static __forceinline void GetNextDataDummy(V_Core& thiscore, uint voiceidx)
 		vc.SCurrent = 0;
 	}
 
-	vc.SP -= 4096 * (4 - (vc.SCurrent & 3));
+	thiscore.VoiceLanes.SP[voiceidx] -= 4096 * (4 - (vc.SCurrent & 3));
 	vc.SCurrent += 4 - (vc.SCurrent & 3);
 }
 
@@ -314,45 +327,53 @@ static __forceinline StereoOut32 ApplyVolume(const StereoOut32& data, const V_Vo
 		ApplyVolume(data.Right, volume.Right.Value));
 }
 
-static void __forceinline UpdatePitch(uint coreidx, uint voiceidx)
+// prev_outx is the OutX of the previous voice, only read when this one is modulated.
+static void __forceinline UpdatePitch(V_Core& thiscore, uint voiceidx, s32 prev_outx)
 {
-	V_Voice& vc(Cores[coreidx].Voices[voiceidx]);
+	V_VoiceLanes& lanes(thiscore.VoiceLanes);
 	s32 pitch;
 
 	// [Air] : re-ordered comparisons: Modulated is much more likely to be zero than voice,
 	//   and so the way it was before it's have to check both voice and modulated values
 	//   most of the time.  Now it'll just check Modulated and short-circuit past the voice
 	//   check (not that it amounts to much, but eh every little bit helps).
-	if ((vc.Modulated == 0) || (voiceidx == 0))
-		pitch = vc.Pitch;
+	if ((thiscore.Voices[voiceidx].Modulated == 0) || (voiceidx == 0))
+		pitch = lanes.Pitch[voiceidx];
 	else
-		pitch = GetClamped((vc.Pitch * (32768 + Cores[coreidx].Voices[voiceidx - 1].OutX)) >> 15, 0, 0x3fff);
+		pitch = GetClamped((lanes.Pitch[voiceidx] * (32768 + prev_outx)) >> 15, 0, 0x3fff);
+
+	lanes.SP[voiceidx] += pitch;
+}
 
-	vc.SP += pitch;
+static void __forceinline UpdatePitch(uint coreidx, uint voiceidx)
+{
+	V_Core& thiscore(Cores[coreidx]);
+	UpdatePitch(thiscore, voiceidx, (voiceidx == 0) ? 0 : thiscore.VoiceLanes.OutX[voiceidx - 1]);
 }
 
 
 static __forceinline void CalculateADSR(V_Core& thiscore, uint voiceidx)
 {
 	V_Voice& vc(thiscore.Voices[voiceidx]);
+	s32& env(thiscore.VoiceLanes.Env[voiceidx]);
 
 	if (vc.ADSR.Phase == 0)
 	{
-		vc.ADSR.Value = 0;
+		env = 0;
 		return;
 	}
 
-	if (!vc.ADSR.Calculate())
+	if (!vc.ADSR.Calculate(env))
 	{
 		if (IsDevBuild)
 		{
 			if (MsgVoiceOff())
 				ConLog("* SPU2: Voice Off by ADSR: %d \n", voiceidx);
 		}
-		vc.Stop();
+		thiscore.StopVoice(voiceidx);
 	}
 
-	pxAssume(vc.ADSR.Value >= 0); // ADSR should never be negative...
+	pxAssume(env >= 0); // ADSR should never be negative...
 }
 
 
@@ -439,43 +460,46 @@ __forceinline static s32 CubicInterpolate(
 	return (val + y1);
 }
 
-// Returns a 16 bit result in Value.
-// Uses standard template-style optimization techniques to statically generate five different
-// versions of this function (one for each type of interpolation).
+// Advances the sample pointer, pulling in new samples as needed, and returns the
+// interpolation position (0.12) between PV2 and PV1.
 template <int InterpType>
-static __forceinline s32 GetVoiceValues(V_Core& thiscore, uint voiceidx)
+static __forceinline s32 FetchVoiceValues(V_Core& thiscore, uint voiceidx)
 {
-	V_Voice& vc(thiscore.Voices[voiceidx]);
+	V_VoiceLanes& lanes(thiscore.VoiceLanes);
 
-	while (vc.SP >= 0)
+	while (lanes.SP[voiceidx] >= 0)
 	{
 		if (InterpType >= 2)
 		{
-			vc.PV4 = vc.PV3;
-			vc.PV3 = vc.PV2;
+			lanes.PV4[voiceidx] = lanes.PV3[voiceidx];
+			lanes.PV3[voiceidx] = lanes.PV2[voiceidx];
 		}
-		vc.PV2 = vc.PV1;
-		vc.PV1 = GetNextDataBuffered(thiscore, voiceidx);
-		vc.SP -= 4096;
+		lanes.PV2[voiceidx] = lanes.PV1[voiceidx];
+		lanes.PV1[voiceidx] = GetNextDataBuffered(thiscore, voiceidx);
+		lanes.SP[voiceidx] -= 4096;
 	}
 
-	const s32 mu = vc.SP + 4096;
+	return lanes.SP[voiceidx] + 4096;
+}
 
+template <int InterpType>
+static __forceinline s32 InterpolateVoice(s32 pv4, s32 pv3, s32 pv2, s32 pv1, s32 mu)
+{
 	switch (InterpType)
 	{
 		case 0:
-			return vc.PV1;
+			return pv1;
 		case 1:
-			return (vc.PV1) - (((vc.PV2 - vc.PV1) * mu) >> 12);
+			return (pv1) - (((pv2 - pv1) * mu) >> 12);
 
 		case 2:
-			return CubicInterpolate(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
+			return CubicInterpolate(pv4, pv3, pv2, pv1, mu);
 		case 3:
-			return HermiteInterpolate<16384>(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
+			return HermiteInterpolate<16384>(pv4, pv3, pv2, pv1, mu);
 		case 4:
-			return CatmullRomInterpolate(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
+			return CatmullRomInterpolate(pv4, pv3, pv2, pv1, mu);
 		case 5:
-			return GaussianInterpolate(vc.PV4, vc.PV3, vc.PV2, vc.PV1, (mu & 0x0ff0) >> 4);
+			return GaussianInterpolate(pv4, pv3, pv2, pv1, (mu & 0x0ff0) >> 4);
 
 			jNO_DEFAULT;
 	}
@@ -483,9 +507,21 @@ static __forceinline s32 GetVoiceValues(V_Core& thiscore, uint voiceidx)
 	return 0; // technically unreachable!
 }
 
+// Returns a 16 bit result in Value.
+// Uses standard template-style optimization techniques to statically generate five different
+// versions of this function (one for each type of interpolation).
+template <int InterpType>
+static __forceinline s32 GetVoiceValues(V_Core& thiscore, uint voiceidx)
+{
+	const V_VoiceLanes& lanes(thiscore.VoiceLanes);
+
+	const s32 mu = FetchVoiceValues<InterpType>(thiscore, voiceidx);
+	return InterpolateVoice<InterpType>(lanes.PV4[voiceidx], lanes.PV3[voiceidx], lanes.PV2[voiceidx], lanes.PV1[voiceidx], mu);
+}
+
 // This is Dr. Hell's noise algorithm as implemented in pcsxr
 // Supposedly this is 100% accurate
-static __forceinline void UpdateNoise(V_Core& thiscore)
+static __forceinline void UpdateNoise(u8 NoiseClk, u32& NoiseCnt, u32& NoiseOut)
 {
 	static const uint8_t noise_add[64] = {
 		1, 0, 0, 1, 0, 1, 1, 0,
@@ -501,27 +537,32 @@ static __forceinline void UpdateNoise(V_Core& thiscore)
 		0, 84, 140, 180, 210};
 
 
-	u32 level = 0x8000 >> (thiscore.NoiseClk >> 2);
+	u32 level = 0x8000 >> (NoiseClk >> 2);
 	level <<= 16;
 
-	thiscore.NoiseCnt += 0x10000;
+	NoiseCnt += 0x10000;
 
-	thiscore.NoiseCnt += noise_freq_add[thiscore.NoiseClk & 3];
-	if ((thiscore.NoiseCnt & 0xffff) >= noise_freq_add[4])
+	NoiseCnt += noise_freq_add[NoiseClk & 3];
+	if ((NoiseCnt & 0xffff) >= noise_freq_add[4])
 	{
-		thiscore.NoiseCnt += 0x10000;
-		thiscore.NoiseCnt -= noise_freq_add[thiscore.NoiseClk & 3];
+		NoiseCnt += 0x10000;
+		NoiseCnt -= noise_freq_add[NoiseClk & 3];
 	}
 
-	if (thiscore.NoiseCnt >= level)
+	if (NoiseCnt >= level)
 	{
-		while (thiscore.NoiseCnt >= level)
-			thiscore.NoiseCnt -= level;
+		while (NoiseCnt >= level)
+			NoiseCnt -= level;
 
-		thiscore.NoiseOut = (thiscore.NoiseOut << 1) | noise_add[(thiscore.NoiseOut >> 10) & 63];
+		NoiseOut = (NoiseOut << 1) | noise_add[(NoiseOut >> 10) & 63];
 	}
 }
 
+static __forceinline void UpdateNoise(V_Core& thiscore)
+{
+	UpdateNoise(thiscore.NoiseClk, thiscore.NoiseCnt, thiscore.NoiseOut);
+}
+
 static __forceinline s32 GetNoiseValues(V_Core& thiscore)
 {
 	return (s16)thiscore.NoiseOut;
@@ -553,6 +594,153 @@ static __forceinline void spu2M_WriteFast(u32 addr, s16 value)
 }
 
 
+/////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                     //
+
+// Four lane versions of the above, shared by the voice parallel mixer (across voices, on the
+// V_VoiceLanes arrays) and the block mixer (across ticks). The V_VoiceLanes arrays are not
+// aligned, hence the unaligned loads.
+
+#if defined(_M_X86_32) || defined(_M_X86_64)
+
+// MulShr32() on four lanes.
+static __forceinline __m128i MulShr32x4(__m128i a, __m128i b)
+{
+	const __m128i even = _mm_mul_epi32(a, b);
+	const __m128i odd = _mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_blend_epi16(_mm_srli_epi64(even, 32), odd, 0xCC);
+}
+
+static __forceinline void ApplyVolumeBlock(s32* dst, const s32* src, const s32* vol, uint count)
+{
+	uint i = 0;
+	for (; (i + 4) <= count; i += 4)
+	{
+		const __m128i data = _mm_slli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i])), 1);
+		const __m128i volume = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&vol[i]));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i]), MulShr32x4(data, volume));
+	}
+
+	for (; i < count; i++)
+		dst[i] = ApplyVolume(src[i], vol[i]);
+}
+
+static __forceinline void GateAccumulateBlock(s32* acc, const s32* src, s32 gate, uint count)
+{
+	const __m128i mask = _mm_set1_epi32(gate);
+
+	uint i = 0;
+	for (; (i + 4) <= count; i += 4)
+	{
+		const __m128i data = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i])), mask);
+		const __m128i sum = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&acc[i]));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&acc[i]), _mm_add_epi32(sum, data));
+	}
+
+	for (; i < count; i++)
+		acc[i] += src[i] & gate;
+}
+
+static __forceinline void GaussianInterpolateBlock(s32* dst, const s32* pv4, const s32* pv3, const s32* pv2, const s32* pv1, const s32* mu, uint count)
+{
+	uint i = 0;
+	for (; (i + 4) <= count; i += 4)
+	{
+		s32 pos[4];
+		for (uint j = 0; j < 4; j++)
+			pos[j] = (mu[i + j] & 0x0ff0) >> 4;
+
+		const __m128i c4 = _mm_setr_epi32(interpTable[0x0FF - pos[0]], interpTable[0x0FF - pos[1]], interpTable[0x0FF - pos[2]], interpTable[0x0FF - pos[3]]);
+		const __m128i c3 = _mm_setr_epi32(interpTable[0x1FF - pos[0]], interpTable[0x1FF - pos[1]], interpTable[0x1FF - pos[2]], interpTable[0x1FF - pos[3]]);
+		const __m128i c2 = _mm_setr_epi32(interpTable[0x100 + pos[0]], interpTable[0x100 + pos[1]], interpTable[0x100 + pos[2]], interpTable[0x100 + pos[3]]);
+		const __m128i c1 = _mm_setr_epi32(interpTable[0x000 + pos[0]], interpTable[0x000 + pos[1]], interpTable[0x000 + pos[2]], interpTable[0x000 + pos[3]]);
+
+		__m128i out = _mm_srai_epi32(_mm_mullo_epi32(c4, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pv4[i]))), 15);
+		out = _mm_add_epi32(out, _mm_srai_epi32(_mm_mullo_epi32(c3, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pv3[i]))), 15));
+		out = _mm_add_epi32(out, _mm_srai_epi32(_mm_mullo_epi32(c2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pv2[i]))), 15));
+		out = _mm_add_epi32(out, _mm_srai_epi32(_mm_mullo_epi32(c1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pv1[i]))), 15));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i]), out);
+	}
+
+	for (; i < count; i++)
+		dst[i] = GaussianInterpolate(pv4[i], pv3[i], pv2[i], pv1[i], (mu[i] & 0x0ff0) >> 4);
+}
+
+#elif defined(_M_ARM64)
+
+// MulShr32() on four lanes.
+static __forceinline int32x4_t MulShr32x4(int32x4_t a, int32x4_t b)
+{
+	const int64x2_t lo = vmull_s32(vget_low_s32(a), vget_low_s32(b));
+	const int64x2_t hi = vmull_high_s32(a, b);
+	return vcombine_s32(vshrn_n_s64(lo, 32), vshrn_n_s64(hi, 32));
+}
+
+static __forceinline void ApplyVolumeBlock(s32* dst, const s32* src, const s32* vol, uint count)
+{
+	uint i = 0;
+	for (; (i + 4) <= count; i += 4)
+		vst1q_s32(&dst[i], MulShr32x4(vshlq_n_s32(vld1q_s32(&src[i]), 1), vld1q_s32(&vol[i])));
+
+	for (; i < count; i++)
+		dst[i] = ApplyVolume(src[i], vol[i]);
+}
+
+static __forceinline void GateAccumulateBlock(s32* acc, const s32* src, s32 gate, uint count)
+{
+	const int32x4_t mask = vdupq_n_s32(gate);
+
+	uint i = 0;
+	for (; (i + 4) <= count; i += 4)
+		vst1q_s32(&acc[i], vaddq_s32(vld1q_s32(&acc[i]), vandq_s32(vld1q_s32(&src[i]), mask)));
+
+	for (; i < count; i++)
+		acc[i] += src[i] & gate;
+}
+
+static __forceinline void GaussianInterpolateBlock(s32* dst, const s32* pv4, const s32* pv3, const s32* pv2, const s32* pv1, const s32* mu, uint count)
+{
+	uint i = 0;
+	for (; (i + 4) <= count; i += 4)
+	{
+		alignas(16) s32 c4[4], c3[4], c2[4], c1[4];
+		for (uint j = 0; j < 4; j++)
+		{
+			const s32 pos = (mu[i + j] & 0x0ff0) >> 4;
+			c4[j] = interpTable[0x0FF - pos];
+			c3[j] = interpTable[0x1FF - pos];
+			c2[j] = interpTable[0x100 + pos];
+			c1[j] = interpTable[0x000 + pos];
+		}
+
+		int32x4_t out = vshrq_n_s32(vmulq_s32(vld1q_s32(c4), vld1q_s32(&pv4[i])), 15);
+		out = vaddq_s32(out, vshrq_n_s32(vmulq_s32(vld1q_s32(c3), vld1q_s32(&pv3[i])), 15));
+		out = vaddq_s32(out, vshrq_n_s32(vmulq_s32(vld1q_s32(c2), vld1q_s32(&pv2[i])), 15));
+		out = vaddq_s32(out, vshrq_n_s32(vmulq_s32(vld1q_s32(c1), vld1q_s32(&pv1[i])), 15));
+		vst1q_s32(&dst[i], out);
+	}
+
+	for (; i < count; i++)
+		dst[i] = GaussianInterpolate(pv4[i], pv3[i], pv2[i], pv1[i], (mu[i] & 0x0ff0) >> 4);
+}
+
+#endif
+
+template <int InterpType>
+static __forceinline void InterpolateBlock(s32* dst, const s32* pv4, const s32* pv3, const s32* pv2, const s32* pv1, const s32* mu, uint count)
+{
+	if (InterpType == 5)
+	{
+		GaussianInterpolateBlock(dst, pv4, pv3, pv2, pv1, mu, count);
+		return;
+	}
+
+	// The polynomial ones are plain 32-bit arithmetic, the compiler vectorizes these.
+	for (uint i = 0; i < count; i++)
+		dst[i] = InterpolateVoice<InterpType>(pv4[i], pv3[i], pv2[i], pv1[i], mu[i]);
+}
+
 static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
 {
 	V_Core& thiscore(Cores[coreidx]);
@@ -619,17 +807,17 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
 		// use a full 64-bit multiply/result here.
 
 		CalculateADSR(thiscore, voiceidx);
-		Value = ApplyVolume(Value, vc.ADSR.Value);
-		vc.OutX = Value;
+		Value = ApplyVolume(Value, thiscore.VoiceLanes.Env[voiceidx]);
+		thiscore.VoiceLanes.OutX[voiceidx] = Value;
 
 		if (IsDevBuild)
-			DebugCores[coreidx].Voices[voiceidx].displayPeak = std::max(DebugCores[coreidx].Voices[voiceidx].displayPeak, (s32)vc.OutX);
+			DebugCores[coreidx].Voices[voiceidx].displayPeak = std::max(DebugCores[coreidx].Voices[voiceidx].displayPeak, Value);
 
 		voiceOut = ApplyVolume(StereoOut32(Value, Value), vc.Volume);
 	}
 	else
 	{
-		while (vc.SP > 0)
+		while (thiscore.VoiceLanes.SP[voiceidx] > 0)
 			GetNextDataDummy(thiscore, voiceidx); // Dummy is enough
 	}
 
@@ -642,9 +830,146 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
 	return voiceOut;
 }
 
+// True if [a, a + a_len) and [b, b + b_len) overlap, in the wrapping SPU2 address space.
+static __forceinline bool MemRangesOverlap(u32 a, u32 a_len, u32 b, u32 b_len)
+{
+	return ((b - a) & 0xFFFFF) < a_len || ((a - b) & 0xFFFFF) < b_len;
+}
+
+// Voice parallel mixing
+//
+// MixCoreVoicesParallel() splits a tick in three passes: the per-voice state machine (volume
+// slides, pitch, ADPCM fetch and ADSR) voice by voice, then interpolation and envelope over
+// the V_VoiceLanes arrays four voices at a time, then volumes, gates and the write-back of
+// voices 1 and 3. That's the same work MixVoice() does, only the write-back moves behind the
+// fetches of the voices after 1 and 3, and pitch modulation needs the OutX of the voice
+// before from the same tick. So it's only used when no voice is modulated and none can read
+// from the dynamic range this tick.
+
+static __forceinline bool CanMixVoicesParallel(const V_Core& thiscore)
+{
+	for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+	{
+		const V_Voice& vc(thiscore.Voices[voiceidx]);
+
+		// A voice reads at most one block header and one word per tick (Pitch is at most
+		// 0x3fff), or jumps to LoopStartA.
+		if ((vc.Modulated && voiceidx != 0) ||
+			MemRangesOverlap(vc.NextA & 0xFFFF8, pcm_WordsPerBlock * 2, 0, SPU2_DYN_MEMLINE) ||
+			MemRangesOverlap(vc.LoopStartA, pcm_WordsPerBlock, 0, SPU2_DYN_MEMLINE))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template <int InterpType>
+static void MixCoreVoicesParallel(VoiceMixSet& dest, uint coreidx)
+{
+	V_Core& thiscore(Cores[coreidx]);
+	V_VoiceLanes& lanes(thiscore.VoiceLanes);
+
+	s32 mu[V_Core::NumVoices];
+	s32 value[V_Core::NumVoices];
+	u32 active = 0;
+
+	for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+	{
+		V_Voice& vc(thiscore.Voices[voiceidx]);
+
+		pxAssertMsg((vc.SCurrent <= 28) && (vc.SCurrent != 0), "Current sample should always range from 1->28");
+
+		vc.Volume.Update();
+		UpdatePitch(thiscore, voiceidx, 0);
+
+		mu[voiceidx] = 0;
+
+		if (vc.ADSR.Phase > 0)
+		{
+			active |= 1u << voiceidx;
+
+			if (!vc.Noise)
+				mu[voiceidx] = FetchVoiceValues<InterpType>(thiscore, voiceidx);
+
+			CalculateADSR(thiscore, voiceidx);
+		}
+		else
+		{
+			while (lanes.SP[voiceidx] > 0)
+				GetNextDataDummy(thiscore, voiceidx); // Dummy is enough
+		}
+	}
+
+	InterpolateBlock<InterpType>(value, lanes.PV4, lanes.PV3, lanes.PV2, lanes.PV1, mu, V_Core::NumVoices);
+
+	for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+	{
+		if (thiscore.Voices[voiceidx].Noise)
+			value[voiceidx] = GetNoiseValues(thiscore);
+	}
+
+	ApplyVolumeBlock(value, value, lanes.Env, V_Core::NumVoices);
+
+	for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+	{
+		V_Voice& vc(thiscore.Voices[voiceidx]);
+		s32 Value = 0;
+
+		if (active & (1u << voiceidx))
+		{
+			Value = value[voiceidx];
+			lanes.OutX[voiceidx] = Value;
+
+			if (IsDevBuild)
+				DebugCores[coreidx].Voices[voiceidx].displayPeak = std::max(DebugCores[coreidx].Voices[voiceidx].displayPeak, Value);
+
+			const StereoOut32 VVal(ApplyVolume(StereoOut32(Value, Value), vc.Volume));
+			dest.Dry.Left += VVal.Left & thiscore.VoiceGates[voiceidx].DryL;
+			dest.Dry.Right += VVal.Right & thiscore.VoiceGates[voiceidx].DryR;
+			dest.Wet.Left += VVal.Left & thiscore.VoiceGates[voiceidx].WetL;
+			dest.Wet.Right += VVal.Right & thiscore.VoiceGates[voiceidx].WetR;
+		}
+
+		// Write-back of raw voice data (post ADSR applied)
+		if (voiceidx == 1)
+			spu2M_WriteFast(((0 == coreidx) ? 0x400 : 0xc00) + OutPos, Value);
+		else if (voiceidx == 3)
+			spu2M_WriteFast(((0 == coreidx) ? 0x600 : 0xe00) + OutPos, Value);
+	}
+}
+
 const VoiceMixSet VoiceMixSet::Empty((StereoOut32()), (StereoOut32())); // Don't use SteroOut32::Empty because C++ doesn't make any dep/order checks on global initializers.
 
-static __forceinline void MixCoreVoices(VoiceMixSet& dest, const uint coreidx)
+static __forceinline void MixCoreVoicesParallel(VoiceMixSet& dest, uint coreidx)
+{
+	switch (Interpolation)
+	{
+		case 0:
+			MixCoreVoicesParallel<0>(dest, coreidx);
+			break;
+		case 1:
+			MixCoreVoicesParallel<1>(dest, coreidx);
+			break;
+		case 2:
+			MixCoreVoicesParallel<2>(dest, coreidx);
+			break;
+		case 3:
+			MixCoreVoicesParallel<3>(dest, coreidx);
+			break;
+		case 4:
+			MixCoreVoicesParallel<4>(dest, coreidx);
+			break;
+		case 5:
+			MixCoreVoicesParallel<5>(dest, coreidx);
+			break;
+
+			jNO_DEFAULT;
+	}
+}
+
+static __forceinline void MixCoreVoicesSerial(VoiceMixSet& dest, uint coreidx)
 {
 	V_Core& thiscore(Cores[coreidx]);
 
@@ -661,6 +986,14 @@ static __forceinline void MixCoreVoices(VoiceMixSet& dest, const uint coreidx)
 	}
 }
 
+static __forceinline void MixCoreVoices(VoiceMixSet& dest, const uint coreidx)
+{
+	if (CanMixVoicesParallel(Cores[coreidx]))
+		MixCoreVoicesParallel(dest, coreidx);
+	else
+		MixCoreVoicesSerial(dest, coreidx);
+}
+
 StereoOut32 V_Core::Mix(const VoiceMixSet& inVoices, const StereoOut32& Input, const StereoOut32& Ext)
 {
 	MasterVol.Update();
@@ -747,34 +1080,26 @@ StereoOut32 V_Core::Mix(const VoiceMixSet& inVoices, const StereoOut32& Input, c
 // used to throttle the output rate of cache stat reports
 static int p_cachestat_counter = 0;
 
-// Gcc does not want to inline it when lto is enabled because some functions growth too much.
-// The function is big enought to see any speed impact. -- Gregory
-#ifndef __POSIX__
-__forceinline
-#endif
-	void
-	Mix()
+static __forceinline void ReadCoreInputs(StereoOut32 (&InputData)[2])
 {
 	// Note: Playmode 4 is SPDIF, which overrides other inputs.
-	StereoOut32 InputData[2] =
-		{
-			// SPDIF is on Core 0:
-			// Fixme:
-			// 1. We do not have an AC3 decoder for the bitstream.
-			// 2. Games usually provide a normal ADMA stream as well and want to see it getting read!
-			/*(PlayMode&4) ? StereoOut32::Empty : */ ApplyVolume(Cores[0].ReadInput(), Cores[0].InpVol),
 
-			// CDDA is on Core 1:
-			(PlayMode & 8) ? StereoOut32::Empty : ApplyVolume(Cores[1].ReadInput(), Cores[1].InpVol)};
+	// SPDIF is on Core 0:
+	// Fixme:
+	// 1. We do not have an AC3 decoder for the bitstream.
+	// 2. Games usually provide a normal ADMA stream as well and want to see it getting read!
+	InputData[0] = /*(PlayMode&4) ? StereoOut32::Empty : */ ApplyVolume(Cores[0].ReadInput(), Cores[0].InpVol);
+
+	// CDDA is on Core 1:
+	InputData[1] = (PlayMode & 8) ? StereoOut32::Empty : ApplyVolume(Cores[1].ReadInput(), Cores[1].InpVol);
 
 	WaveDump::WriteCore(0, CoreSrc_Input, InputData[0]);
 	WaveDump::WriteCore(1, CoreSrc_Input, InputData[1]);
+}
 
-	// Todo: Replace me with memzero initializer!
-	VoiceMixSet VoiceData[2] = {VoiceMixSet::Empty, VoiceMixSet::Empty}; // mixed voice data for each core.
-	MixCoreVoices(VoiceData[0], 0);
-	MixCoreVoices(VoiceData[1], 1);
-
+// Runs both cores on the mixed voices of the current tick and outputs the result.
+static __forceinline void MixCores(const VoiceMixSet (&VoiceData)[2], const StereoOut32 (&InputData)[2])
+{
 	StereoOut32 Ext(Cores[0].Mix(VoiceData[0], InputData[0], StereoOut32::Empty));
 
 	if ((PlayMode & 4) || (Cores[0].Mute != 0))
@@ -849,3 +1174,359 @@ __forceinline
 		}
 	}
 }
+
+// Gcc does not want to inline it when lto is enabled because some functions growth too much.
+// The function is big enought to see any speed impact. -- Gregory
+#ifndef __POSIX__
+__forceinline
+#endif
+	void
+	Mix()
+{
+	StereoOut32 InputData[2];
+	ReadCoreInputs(InputData);
+
+	// Todo: Replace me with memzero initializer!
+	VoiceMixSet VoiceData[2] = {VoiceMixSet::Empty, VoiceMixSet::Empty}; // mixed voice data for each core.
+	MixCoreVoices(VoiceData[0], 0);
+	MixCoreVoices(VoiceData[1], 1);
+
+	MixCores(VoiceData, InputData);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                     //
+
+// Block mixing (BlockMixing option)
+//
+// MixBlock() runs each voice over a number of ticks before moving on to the next one, rather
+// than every voice once per tick. The part of a voice which carries state from one tick to the
+// next (pitch, ADPCM fetch and decode, ADSR and volume slides) still runs tick by tick and
+// fills per-tick arrays, interpolation, envelope and volume application and the dry/wet sums
+// then run over the whole block four ticks at a time.
+//
+// Voices read exactly the same SPU2 memory and test IRQA against exactly the same addresses
+// as they do in Mix(), it's only their order relative to the rest of the tick (ADMA input,
+// core output write-back, reverb) which changes. So a block is only mixed when nothing a voice
+// can reach within it gets written by the rest of the tick, or the other way around.
+//
+// An IRQ raised in a block is delivered by TimeUpdate at the start of the tick which follows
+// it instead of the one following the tick it happened in. That's unobservable as long as
+// it's delivered before TimeUpdate returns, so there's always one more tick after a block.
+
+struct MixBlockCore
+{
+	alignas(16) s32 DryL[MixBlockMaxTicks];
+	alignas(16) s32 DryR[MixBlockMaxTicks];
+	alignas(16) s32 WetL[MixBlockMaxTicks];
+	alignas(16) s32 WetR[MixBlockMaxTicks];
+
+	// Noise generator output for each tick, as seen by the voices before the core advances it.
+	s32 Noise[MixBlockMaxTicks];
+
+	// OutX of the voice mixed last for each tick, for pitch modulation of the next one.
+	s32 ModOutX[MixBlockMaxTicks];
+};
+
+struct MixBlockVoice
+{
+	alignas(16) s32 PV4[MixBlockMaxTicks];
+	alignas(16) s32 PV3[MixBlockMaxTicks];
+	alignas(16) s32 PV2[MixBlockMaxTicks];
+	alignas(16) s32 PV1[MixBlockMaxTicks];
+	alignas(16) s32 Mu[MixBlockMaxTicks];
+	alignas(16) s32 Env[MixBlockMaxTicks];
+	alignas(16) s32 VolL[MixBlockMaxTicks];
+	alignas(16) s32 VolR[MixBlockMaxTicks];
+
+	alignas(16) s32 Value[MixBlockMaxTicks];
+	alignas(16) s32 OutL[MixBlockMaxTicks];
+	alignas(16) s32 OutR[MixBlockMaxTicks];
+};
+
+static MixBlockCore s_block_cores[2];
+static MixBlockVoice s_block_voice;
+
+template <int InterpType>
+static void MixVoiceBlock(uint coreidx, uint voiceidx, uint ticks, u32 first_cycle)
+{
+	V_Core& thiscore(Cores[coreidx]);
+	V_Voice& vc(thiscore.Voices[voiceidx]);
+	V_VoiceLanes& lanes(thiscore.VoiceLanes);
+	MixBlockCore& mix(s_block_cores[coreidx]);
+	MixBlockVoice& v(s_block_voice);
+
+	pxAssertMsg((vc.SCurrent <= 28) && (vc.SCurrent != 0), "Current sample should always range from 1->28");
+
+	// Nothing can key a voice on within a block, so once the envelope reaches phase 0 the
+	// voice stays silent: the audible ticks are always the first ones.
+	uint active = 0;
+	for (; active < ticks && vc.ADSR.Phase > 0; active++)
+	{
+		Cycles = first_cycle + active;
+
+		vc.Volume.Update();
+		UpdatePitch(thiscore, voiceidx, mix.ModOutX[active]);
+
+		if (vc.Noise)
+		{
+			v.Value[active] = mix.Noise[active];
+		}
+		else
+		{
+			v.Mu[active] = FetchVoiceValues<InterpType>(thiscore, voiceidx);
+			v.PV4[active] = lanes.PV4[voiceidx];
+			v.PV3[active] = lanes.PV3[voiceidx];
+			v.PV2[active] = lanes.PV2[voiceidx];
+			v.PV1[active] = lanes.PV1[voiceidx];
+		}
+
+		CalculateADSR(thiscore, voiceidx);
+		v.Env[active] = lanes.Env[voiceidx];
+		v.VolL[active] = vc.Volume.Left.Value;
+		v.VolR[active] = vc.Volume.Right.Value;
+	}
+
+	for (uint t = active; t < ticks; t++)
+	{
+		Cycles = first_cycle + t;
+
+		vc.Volume.Update();
+		UpdatePitch(thiscore, voiceidx, mix.ModOutX[t]);
+
+		while (lanes.SP[voiceidx] > 0)
+			GetNextDataDummy(thiscore, voiceidx); // Dummy is enough
+	}
+
+	if (active > 0)
+	{
+		if (!vc.Noise)
+			InterpolateBlock<InterpType>(v.Value, v.PV4, v.PV3, v.PV2, v.PV1, v.Mu, active);
+
+		ApplyVolumeBlock(v.Value, v.Value, v.Env, active);
+		ApplyVolumeBlock(v.OutL, v.Value, v.VolL, active);
+		ApplyVolumeBlock(v.OutR, v.Value, v.VolR, active);
+
+		const V_VoiceGates& gates(thiscore.VoiceGates[voiceidx]);
+		GateAccumulateBlock(mix.DryL, v.OutL, gates.DryL, active);
+		GateAccumulateBlock(mix.DryR, v.OutR, gates.DryR, active);
+		GateAccumulateBlock(mix.WetL, v.OutL, gates.WetL, active);
+		GateAccumulateBlock(mix.WetR, v.OutR, gates.WetR, active);
+
+		lanes.OutX[voiceidx] = v.Value[active - 1];
+
+		if (IsDevBuild)
+		{
+			s32& peak = DebugCores[coreidx].Voices[voiceidx].displayPeak;
+			for (uint t = 0; t < active; t++)
+				peak = std::max(peak, v.Value[t]);
+		}
+	}
+
+	// OutX holds still while the voice is silent.
+	for (uint t = 0; t < ticks; t++)
+		mix.ModOutX[t] = (t < active) ? v.Value[t] : lanes.OutX[voiceidx];
+
+	// Write-back of raw voice data (post ADSR applied)
+	if (voiceidx == 1 || voiceidx == 3)
+	{
+		const u32 base = (voiceidx == 1) ? ((0 == coreidx) ? 0x400 : 0xc00) : ((0 == coreidx) ? 0x600 : 0xe00);
+		for (uint t = 0; t < ticks; t++)
+			spu2M_WriteFast(base + ((OutPos + t) & 0x1FF), (t < active) ? v.Value[t] : 0);
+	}
+}
+
+static void MixCoreVoicesBlock(uint coreidx, uint ticks, u32 first_cycle)
+{
+	V_Core& thiscore(Cores[coreidx]);
+	MixBlockCore& mix(s_block_cores[coreidx]);
+
+	std::fill_n(mix.DryL, ticks, 0);
+	std::fill_n(mix.DryR, ticks, 0);
+	std::fill_n(mix.WetL, ticks, 0);
+	std::fill_n(mix.WetR, ticks, 0);
+
+	u32 noise_cnt = thiscore.NoiseCnt;
+	u32 noise_out = thiscore.NoiseOut;
+	for (uint t = 0; t < ticks; t++)
+	{
+		mix.Noise[t] = (s16)noise_out;
+		UpdateNoise(thiscore.NoiseClk, noise_cnt, noise_out);
+	}
+
+	for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+	{
+		switch (Interpolation)
+		{
+			case 0:
+				MixVoiceBlock<0>(coreidx, voiceidx, ticks, first_cycle);
+				break;
+			case 1:
+				MixVoiceBlock<1>(coreidx, voiceidx, ticks, first_cycle);
+				break;
+			case 2:
+				MixVoiceBlock<2>(coreidx, voiceidx, ticks, first_cycle);
+				break;
+			case 3:
+				MixVoiceBlock<3>(coreidx, voiceidx, ticks, first_cycle);
+				break;
+			case 4:
+				MixVoiceBlock<4>(coreidx, voiceidx, ticks, first_cycle);
+				break;
+			case 5:
+				MixVoiceBlock<5>(coreidx, voiceidx, ticks, first_cycle);
+				break;
+
+				jNO_DEFAULT;
+		}
+	}
+}
+
+static bool CanMixBlock(uint ticks)
+{
+	// Queued voices start at tick boundaries, and loop points written right after a key on
+	// are decided on the tick they get applied.
+	if (Cores[0].KeyOn || Cores[1].KeyOn)
+		return false;
+
+	// The rest of the tick writes the dynamic range (core output, ADMA input) and reverb its
+	// effects area. Voices 1 and 3 write back to the dynamic range, which reverb must not use.
+	u32 fx_start[2] = {};
+	u32 fx_len[2] = {};
+	for (uint coreidx = 0; coreidx < 2; coreidx++)
+	{
+		const V_Core& core(Cores[coreidx]);
+		if (!core.FxEnable || core.EffectsEndA >= 0x100000 || core.EffectsEndA < core.EffectsStartA)
+			continue;
+
+		fx_start[coreidx] = core.EffectsStartA;
+		fx_len[coreidx] = core.EffectsEndA - core.EffectsStartA + 1;
+		if (MemRangesOverlap(fx_start[coreidx], fx_len[coreidx], 0, SPU2_DYN_MEMLINE))
+			return false;
+	}
+
+	// Pitch is at most 0x3fff, so a voice reads at most one word of ADPCM data per tick, plus
+	// the header of every block it enters. Jumps only ever go back to LoopStartA, and
+	// LOOP_START only moves that to a block the voice is reading anyway.
+	const u32 reach = ticks * 2 + pcm_WordsPerBlock;
+	const auto unsafe = [&fx_start, &fx_len, reach](u32 addr) {
+		return MemRangesOverlap(addr, reach, 0, SPU2_DYN_MEMLINE) ||
+			   (fx_len[0] && MemRangesOverlap(addr, reach, fx_start[0], fx_len[0])) ||
+			   (fx_len[1] && MemRangesOverlap(addr, reach, fx_start[1], fx_len[1]));
+	};
+
+	for (const V_Core& core : Cores)
+	{
+		for (const V_Voice& vc : core.Voices)
+		{
+			if (vc.PendingLoopStart || unsafe(vc.NextA & 0xFFFF8) || unsafe(vc.LoopStartA))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+// Mixes the current tick and the following ticks - 1 in one go, leaving Cycles on the last
+// one. Returns false without mixing anything when the block could be told apart from mixing
+// tick by tick, see above. The caller must mix at least one more tick before returning to
+// the IOP.
+bool MixBlock(uint ticks)
+{
+	pxAssert(ticks <= MixBlockMaxTicks);
+
+	if (!CanMixBlock(ticks))
+		return false;
+
+	const u32 first_cycle = Cycles;
+
+	MixCoreVoicesBlock(0, ticks, first_cycle);
+	MixCoreVoicesBlock(1, ticks, first_cycle);
+
+	for (uint t = 0; t < ticks; t++)
+	{
+		Cycles = first_cycle + t;
+
+		StereoOut32 InputData[2];
+		ReadCoreInputs(InputData);
+
+		const VoiceMixSet VoiceData[2] = {
+			VoiceMixSet(StereoOut32(s_block_cores[0].DryL[t], s_block_cores[0].DryR[t]), StereoOut32(s_block_cores[0].WetL[t], s_block_cores[0].WetR[t])),
+			VoiceMixSet(StereoOut32(s_block_cores[1].DryL[t], s_block_cores[1].DryR[t]), StereoOut32(s_block_cores[1].WetL[t], s_block_cores[1].WetR[t])),
+		};
+
+		MixCores(VoiceData, InputData);
+	}
+
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                     //
+
+// Times both voice mixers on the current voices, for the cores dump. Mixing decodes ADPCM,
+// writes back voices 1 and 3, raises IRQ flags and of course moves every voice along, so both
+// runs start from the same copy of the state and everything is put back afterwards.
+VoiceMixBenchmark BenchmarkVoiceMix(uint frames)
+{
+	static constexpr uint TicksPerFrame = 48000 / 60;
+
+	VoiceMixBenchmark result = {};
+	result.frames = frames;
+	result.parallel_eligible = CanMixVoicesParallel(Cores[0]) && CanMixVoicesParallel(Cores[1]);
+	for (const V_Core& core : Cores)
+	{
+		for (const V_Voice& vc : core.Voices)
+			result.active_voices += (vc.ADSR.Phase > 0) ? 1 : 0;
+	}
+
+	if (frames == 0 || _spu2mem == nullptr)
+		return result;
+
+	std::vector<u8> saved_cores(sizeof(Cores));
+	std::vector<u8> saved_debug(sizeof(DebugCores));
+	std::vector<s16> saved_mem(_spu2mem, _spu2mem + 0x100000);
+	const bool saved_irq[2] = {has_to_call_irq[0], has_to_call_irq[1]};
+	const u32 saved_cycles = Cycles;
+	const s16 saved_outpos = OutPos;
+
+	memcpy(saved_cores.data(), Cores, sizeof(Cores));
+	memcpy(saved_debug.data(), DebugCores, sizeof(DebugCores));
+
+	const auto run = [&](bool parallel) {
+		const Common::Timer::Value start = Common::Timer::GetCurrentValue();
+
+		for (uint tick = 0; tick < frames * TicksPerFrame; tick++)
+		{
+			VoiceMixSet VoiceData[2] = {VoiceMixSet::Empty, VoiceMixSet::Empty};
+			for (uint coreidx = 0; coreidx < 2; coreidx++)
+			{
+				if (parallel)
+					MixCoreVoicesParallel(VoiceData[coreidx], coreidx);
+				else
+					MixCoreVoicesSerial(VoiceData[coreidx], coreidx);
+			}
+
+			Cycles++;
+			OutPos = (OutPos + 1) & 0x1FF;
+		}
+
+		const double ms = Common::Timer::ConvertValueToMilliseconds(Common::Timer::GetCurrentValue() - start);
+
+		memcpy(Cores, saved_cores.data(), sizeof(Cores));
+		memcpy(DebugCores, saved_debug.data(), sizeof(DebugCores));
+		memcpy(_spu2mem, saved_mem.data(), saved_mem.size() * sizeof(s16));
+		has_to_call_irq[0] = saved_irq[0];
+		has_to_call_irq[1] = saved_irq[1];
+		Cycles = saved_cycles;
+		OutPos = saved_outpos;
+
+		return ms / frames;
+	};
+
+	result.serial_ms = run(false);
+	result.parallel_ms = run(true);
+	return result;
+}
@@ -126,7 +126,22 @@ struct FrequencyResponseFilter
 	}
 };
 
+// Largest number of ticks MixBlock() takes at once.
+static const uint MixBlockMaxTicks = 64;
+
+// Per frame cost of mixing the current voices, see BenchmarkVoiceMix().
+struct VoiceMixBenchmark
+{
+	uint frames;
+	uint active_voices;
+	bool parallel_eligible; // Mix() currently takes the voice parallel path
+	double serial_ms;       // one voice at a time (MixVoice())
+	double parallel_ms;     // four voices at a time over V_VoiceLanes
+};
+
 extern void Mix();
+extern bool MixBlock(uint ticks);
+extern VoiceMixBenchmark BenchmarkVoiceMix(uint frames);
 extern s32 clamp_mix(s32 x, u8 bitshift = 0);
 
 extern StereoOut32 clamp_mix(const StereoOut32& sample, u8 bitshift = 0);
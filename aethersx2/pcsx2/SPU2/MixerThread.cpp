@@ -0,0 +1,220 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Global.h"
+#include "spu2.h"
+#include "MixerThread.h"
+
+#include "common/boost_spsc_queue.hpp"
+#include "common/PersistentThread.h"
+#include "common/Threading.h"
+
+#include <atomic>
+#include <thread>
+
+namespace MixerThread
+{
+	struct Command
+	{
+		enum : u32
+		{
+			TimeUpdate,
+			Write,
+		};
+
+		u32 type;
+		u32 cycle;
+		u32 rmem;
+		u16 value;
+	};
+
+	// A TimeUpdate() every SPU2async() is a few hundred per frame, the writes come on top.
+	static constexpr u32 QUEUE_SIZE = 8192;
+
+	// Spins before Sync() starts yielding, the mixer is usually done within a few ticks.
+	static constexpr u32 SYNC_SPIN_COUNT = 4096;
+
+	static void ThreadEntryPoint();
+	static bool IsDeferrable();
+	static bool IsJournaledWrite(u32 rmem);
+	static bool StartQueueing();
+	static void Push(const Command& cmd);
+
+	static ringbuffer_base<Command, QUEUE_SIZE> s_queue;
+	static std::thread s_thread;
+	static Threading::Semaphore s_sema_work;
+	static std::atomic<bool> s_shutdown{false};
+
+	// IOP thread only, the mixer thread owns the SPU2 while this is set.
+	static bool s_queueing = false;
+	static u32 s_queued = 0;
+
+	// Note: keep on its own cache line, Sync() spins on it
+	__aligned(64) static std::atomic<u32> s_done{0};
+} // namespace MixerThread
+
+void MixerThread::ThreadEntryPoint()
+{
+	Threading::SetNameOfCurrentThread("SPU2 Mixer");
+
+	for (;;)
+	{
+		s_sema_work.WaitWithoutYield();
+		if (s_shutdown.load(std::memory_order_acquire))
+			break;
+
+		Command cmd;
+		while (s_queue.pop(cmd))
+		{
+			::TimeUpdate(cmd.cycle);
+
+			if (cmd.type == Command::Write)
+			{
+				SPU2writeLog("write", cmd.rmem, cmd.value);
+				SPU2_FastWrite(cmd.rmem, cmd.value);
+			}
+
+			s_done.fetch_add(1, std::memory_order_release);
+		}
+	}
+}
+
+bool MixerThread::IsDeferrable()
+{
+	if (psxmode)
+		return false;
+
+	for (int i = 0; i < 2; i++)
+	{
+		const V_Core& core = Cores[i];
+
+		// Nothing may raise or be waiting to raise an IOP interrupt ...
+		if (core.IRQEnable || has_to_call_irq[i] || has_to_call_irq_dma[i])
+			return false;
+
+		// ... or touch the IOP DMA registers from TimeUpdate()/ReadInput().
+		if (core.DMAICounter > 0 || core.AdmaInProgress || core.InputDataLeft || core.InputDataTransferred)
+			return false;
+	}
+
+	return true;
+}
+
+bool MixerThread::IsJournaledWrite(u32 rmem)
+{
+	if ((rmem >> 16) == 0x1f80)
+		return false;
+
+	const u32 mem = rmem & 0x7ff;
+
+	// SPDIF and friends, Spdif.Info holds the IRQ status.
+	if (mem >= 0x7c0)
+		return false;
+
+	// Master and effect volumes.
+	if (mem >= 0x760)
+		return true;
+
+	// Both can enable IRQs or start a transfer.
+	const u32 omem = mem & 0x3ff;
+	return omem != REG_C_ATTR && omem != REG_S_ADMAS;
+}
+
+bool MixerThread::StartQueueing()
+{
+	if (s_queueing)
+		return true;
+
+	// The mixer is idle here, so the SPU2 state can be looked at directly.
+	if (!ThreadedMixing || !IsDeferrable())
+		return false;
+
+	if (!s_thread.joinable())
+	{
+		s_shutdown.store(false, std::memory_order_relaxed);
+		s_thread = std::thread(&MixerThread::ThreadEntryPoint);
+	}
+
+	s_queueing = true;
+	return true;
+}
+
+void MixerThread::Push(const Command& cmd)
+{
+	while (!s_queue.push(cmd))
+	{
+		s_sema_work.Post();
+		Threading::Timeslice();
+	}
+
+	s_queued++;
+}
+
+bool MixerThread::QueueTimeUpdate(u32 cycle)
+{
+	if (!StartQueueing())
+		return false;
+
+	Push({Command::TimeUpdate, cycle, 0, 0});
+	s_sema_work.Post();
+	return true;
+}
+
+bool MixerThread::QueueWrite(u32 cycle, u32 rmem, u16 value)
+{
+	if (!IsJournaledWrite(rmem))
+	{
+		Sync();
+		return false;
+	}
+
+	if (!StartQueueing())
+		return false;
+
+	// Writes are picked up with the next tick, there's no rush.
+	Push({Command::Write, cycle, rmem, value});
+	return true;
+}
+
+void MixerThread::Sync()
+{
+	if (!s_queueing)
+		return;
+
+	s_sema_work.Post();
+
+	for (u32 spins = 0; s_done.load(std::memory_order_acquire) != s_queued; spins++)
+	{
+		if (spins < SYNC_SPIN_COUNT)
+			Threading::SpinWait();
+		else
+			Threading::Timeslice();
+	}
+
+	s_queueing = false;
+}
+
+void MixerThread::Shutdown()
+{
+	Sync();
+
+	if (!s_thread.joinable())
+		return;
+
+	s_shutdown.store(true, std::memory_order_release);
+	s_sema_work.Post();
+	s_thread.join();
+}
@@ -0,0 +1,43 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Optional SPU2 mixer thread (ThreadedMixing).
+//
+// While both cores have their IRQs disabled and no DMA or AutoDMA transfer is in flight, the
+// SPU2 doesn't need anything from the IOP between two register accesses. In that state the
+// IOP only journals SPU2async() ticks and register writes with the cycle they happened on, and
+// the mixer thread replays them in order (TimeUpdate() up to that cycle, then the write), which
+// is exactly what would have run inline.
+//
+// Everything else - reads, DMA, savestates, and the writes which can leave that state (ATTR,
+// ADMAS, SPDIF, PS1 mode) - calls Sync() first and then runs on the calling thread, which owns
+// the SPU2 again until the next journaled access.
+namespace MixerThread
+{
+	// IOP thread. Journals a TimeUpdate() up to cycle, returns false if it has to run inline.
+	bool QueueTimeUpdate(u32 cycle);
+
+	// IOP thread. Journals a TimeUpdate() up to cycle followed by a register write, returns
+	// false (after syncing) if it has to run inline.
+	bool QueueWrite(u32 cycle, u32 rmem, u16 value);
+
+	// Waits until the mixer thread has replayed everything journaled so far.
+	void Sync();
+
+	// Syncs and joins the thread.
+	void Shutdown();
+} // namespace MixerThread
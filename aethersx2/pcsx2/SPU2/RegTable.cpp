@@ -26,10 +26,10 @@
 	PVCP(c, v, Volume.Left.Reg_VOL)        \
 	,                                      \
 		PVCP(c, v, Volume.Right.Reg_VOL),  \
-		PVCP(c, v, Pitch),                 \
+		PCORE(c, VoiceLanes.Pitch[v]),     \
 		PVCP(c, v, ADSR.regADSR1),         \
 		PVCP(c, v, ADSR.regADSR2),         \
-		PVCP(c, v, ADSR.Value) + 1,        \
+		PCORE(c, VoiceLanes.Env[v]) + 1,   \
 		PVCP(c, v, Volume.Left.Value) + 1, \
 		PVCP(c, v, Volume.Right.Value) + 1
 
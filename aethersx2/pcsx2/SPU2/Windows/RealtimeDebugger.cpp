@@ -121,7 +121,7 @@ void UpdateDebugDialog()
 				FillRectangle(hdc, IX + 58, IY + 42 - vl, 4, vl);
 				FillRectangle(hdc, IX + 62, IY + 42 - vr, 4, vr);
 
-				int adsr = ((vc.ADSR.Value >> 16) * 38) / 32768;
+				int adsr = ((cx.VoiceLanes.Env[v] >> 16) * 38) / 32768;
 
 				FillRectangle(hdc, IX + 66, IY + 42 - adsr, 4, adsr);
 
@@ -134,7 +134,7 @@ void UpdateDebugDialog()
 
 				FillRectangle(hdc, IX + 70, IY + 42 - peak, 4, peak);
 
-				if (vc.ADSR.Value > 0)
+				if (cx.VoiceLanes.Env[v] > 0)
 				{
 					if (vc.SBuffer)
 						for (int i = 0; i < 28; i++)
@@ -124,12 +124,12 @@ struct V_ADSR
 		};
 	};
 
-	s32 Value;      // Ranges from 0 to 0x7fffffff (signed values are clamped to 0) [Reg_ENVX]
+	// Note: the envelope level itself lives in V_VoiceLanes::Env.
 	u8 Phase;       // monitors current phase of ADSR envelope
 	bool Releasing; // Ready To Release, triggered by Voice.Stop();
 
 public:
-	bool Calculate();
+	bool Calculate(s32& Value);
 };
 
 
@@ -145,8 +145,6 @@ struct V_Voice
 
 	// Envelope
 	V_ADSR ADSR;
-	// Pitch (also Reg_PITCH)
-	u16 Pitch;
 	// Loop Start address (also Reg_LSAH/L)
 	u32 LoopStartA;
 	// Sound Start address (also Reg_SSAH/L)
@@ -165,25 +163,6 @@ struct V_Voice
 	s8 LoopMode;
 	s8 LoopFlags;
 
-	// Sample pointer (19:12 bit fixed point)
-	s32 SP;
-
-	// Sample pointer for Cubic Interpolation
-	// Cubic interpolation mixes a sample behind Linear, so that it
-	// can have sample data to either side of the end points from which
-	// to extrapolate.  This SP represents that late sample position.
-	s32 SPc;
-
-	// Previous sample values - used for interpolation
-	// Inverted order of these members to match the access order in the
-	//   code (might improve cache hits).
-	s32 PV4;
-	s32 PV3;
-	s32 PV2;
-	s32 PV1;
-
-	// Last outputted audio value, used for voice modulation.
-	s32 OutX;
 	s32 NextCrest; // temp value for Crest calculation
 
 	// SBuffer now points directly to an ADPCM cache entry.
@@ -194,7 +173,34 @@ struct V_Voice
 
 	// it takes a few ticks for voices to start on the real SPU2?
 	void Start();
-	void Stop();
+};
+
+// Per-voice state touched by every voice on every tick, stored one array per field (one lane
+// per voice) instead of inside V_Voice, so the mixer can interpolate and apply envelopes to
+// four or eight voices at once. Every array is 24 lanes, a whole number of 4 and 8 lane
+// vectors; they're not aligned in memory though (V_Core gets memcpy'd in and out of
+// savestates), so use unaligned loads.
+struct V_VoiceLanes
+{
+	static const uint NumLanes = 24;
+
+	// Envelope level, ranges from 0 to 0x7fffffff (signed values are clamped to 0) [Reg_ENVX]
+	s32 Env[NumLanes];
+
+	// Sample pointer (19:12 bit fixed point)
+	s32 SP[NumLanes];
+
+	// Previous sample values - used for interpolation
+	s32 PV4[NumLanes];
+	s32 PV3[NumLanes];
+	s32 PV2[NumLanes];
+	s32 PV1[NumLanes];
+
+	// Last outputted audio value, used for voice modulation.
+	s32 OutX[NumLanes];
+
+	// Pitch (also Reg_PITCH)
+	u16 Pitch[NumLanes];
 };
 
 // ** Begin Debug-only variables section **
@@ -386,6 +392,8 @@ struct V_Core
 	V_CoreGates DryGate;
 	V_CoreGates WetGate;
 
+	V_VoiceLanes VoiceLanes; // hot per-voice mixing state, see V_VoiceLanes
+
 	V_VolumeSlideLR MasterVol; // Master Volume
 	V_VolumeLR ExtVol;         // Volume for External Data Input
 	V_VolumeLR InpVol;         // Volume for Sound Data Input
@@ -477,6 +485,7 @@ struct V_Core
 	~V_Core() throw();
 
 	void Init(int index);
+	void StopVoice(uint voiceidx);
 	void UpdateEffectsBufferSize();
 	void AnalyzeReverbPreset();
 
@@ -550,6 +559,8 @@ struct V_Core
 	void FinishDMAwrite();
 };
 
+static_assert(V_VoiceLanes::NumLanes == V_Core::NumVoices, "One lane per voice");
+
 extern V_Core Cores[2];
 extern V_SPDIF Spdif;
 
@@ -564,6 +575,9 @@ extern s16* spu2regs;
 extern s16* _spu2mem;
 extern int PlayMode;
 
+extern bool has_to_call_irq[2];
+extern bool has_to_call_irq_dma[2];
+
 extern void SetIrqCall(int core);
 extern void SetIrqCallDMA(int core);
 extern void StartVoices(int core, u32 value);
@@ -17,6 +17,7 @@
 #include "Global.h"
 #include "spu2.h"
 #include "Dma.h"
+#include "MixerThread.h"
 #ifndef PCSX2_CORE
 #if defined(_WIN32)
 #include "Windows/Dialogs.h"
@@ -71,6 +72,7 @@ void SPU2setLogDir(const char* dir)
 
 void SPU2readDMA4Mem(u16* pMem, u32 size) // size now in 16bit units
 {
+	MixerThread::Sync();
 	TimeUpdate(psxRegs.cycle);
 
 	FileLog("[%10d] SPU2 readDMA4Mem size %x\n", Cycles, size << 1);
@@ -79,6 +81,7 @@ void SPU2readDMA4Mem(u16* pMem, u32 size) // size now in 16bit units
 
 void SPU2writeDMA4Mem(u16* pMem, u32 size) // size now in 16bit units
 {
+	MixerThread::Sync();
 	TimeUpdate(psxRegs.cycle);
 
 	FileLog("[%10d] SPU2 writeDMA4Mem size %x at address %x\n", Cycles, size << 1, Cores[0].TSA);
@@ -88,6 +91,7 @@ void SPU2writeDMA4Mem(u16* pMem, u32 size) // size now in 16bit units
 
 void SPU2interruptDMA4()
 {
+	MixerThread::Sync();
 	FileLog("[%10d] SPU2 interruptDMA4\n", Cycles);
 	if (Cores[0].DmaMode)
 		Cores[0].Regs.STATX |= 0x80;
@@ -97,6 +101,7 @@ void SPU2interruptDMA4()
 
 void SPU2interruptDMA7()
 {
+	MixerThread::Sync();
 	FileLog("[%10d] SPU2 interruptDMA7\n", Cycles);
 	if (Cores[1].DmaMode)
 		Cores[1].Regs.STATX |= 0x80;
@@ -106,6 +111,7 @@ void SPU2interruptDMA7()
 
 void SPU2readDMA7Mem(u16* pMem, u32 size)
 {
+	MixerThread::Sync();
 	TimeUpdate(psxRegs.cycle);
 
 	FileLog("[%10d] SPU2 readDMA7Mem size %x\n", Cycles, size << 1);
@@ -114,6 +120,7 @@ void SPU2readDMA7Mem(u16* pMem, u32 size)
 
 void SPU2writeDMA7Mem(u16* pMem, u32 size)
 {
+	MixerThread::Sync();
 	TimeUpdate(psxRegs.cycle);
 
 	FileLog("[%10d] SPU2 writeDMA7Mem size %x at address %x\n", Cycles, size << 1, Cores[1].TSA);
@@ -123,6 +130,8 @@ void SPU2writeDMA7Mem(u16* pMem, u32 size)
 
 s32 SPU2reset(PS2Modes isRunningPSXMode)
 {
+	MixerThread::Sync();
+
 	int requiredSampleRate = (isRunningPSXMode == PS2Modes::PSX) ? 44100 : 48000;
 
 	if (isRunningPSXMode == PS2Modes::PS2)
@@ -285,6 +294,8 @@ s32 SPU2open()
 #endif
 #endif
 
+	MixerThread::Sync();
+
 	IsOpened = true;
 	lClocks = psxRegs.cycle;
 
@@ -313,6 +324,8 @@ void SPU2close()
 		return;
 	IsOpened = false;
 
+	MixerThread::Shutdown();
+
 	FileLog("[%10d] SPU2 Close\n", Cycles);
 
 #if defined(_WIN32) && !defined(PCSX2_CORE)
@@ -331,6 +344,7 @@ void SPU2shutdown()
 	ConLog("* SPU2: Shutting down.\n");
 
 	SPU2close();
+	MixerThread::Shutdown();
 
 	DoFullDump();
 #ifdef STREAM_DUMP
@@ -368,7 +382,8 @@ void SPU2async(u32 cycles)
 {
 	DspUpdate();
 
-	TimeUpdate(psxRegs.cycle);
+	if (!MixerThread::QueueTimeUpdate(psxRegs.cycle))
+		TimeUpdate(psxRegs.cycle);
 
 #ifdef DEBUG_KEYS
 	u32 curTicks = GetTickCount();
@@ -422,6 +437,9 @@ void SPU2async(u32 cycles)
 
 u16 SPU2read(u32 rmem)
 {
+	// Reads need the SPU2 up to date (ENDX, NAX, ...), so they never go through the mixer thread.
+	MixerThread::Sync();
+
 	u16 ret = 0xDEAD;
 	u32 core = 0, mem = rmem & 0xFFFF, omem = mem;
 
@@ -473,6 +491,9 @@ void SPU2write(u32 rmem, u16 value)
 	// If the SPU2 isn't in in sync with the IOP, samples can end up playing at rather
 	// incorrect pitches and loop lengths.
 
+	if (MixerThread::QueueWrite(psxRegs.cycle, rmem, value))
+		return;
+
 	TimeUpdate(psxRegs.cycle);
 
 	if (rmem >> 16 == 0x1f80)
@@ -519,6 +540,8 @@ s32 SPU2freeze(FreezeAction mode, freezeData* data)
 		return -1;
 	}
 
+	MixerThread::Sync();
+
 	auto& spud = (SPU2Savestate::DataBlock&)*(data->data);
 
 	switch (mode)
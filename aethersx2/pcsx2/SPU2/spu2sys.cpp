@@ -203,9 +203,9 @@ void V_Core::Init(int index)
 		Voices[v].Volume = V_VolumeSlideLR(0, 0); // V_VolumeSlideLR::Max;
 		Voices[v].SCurrent = 28;
 
-		Voices[v].ADSR.Value = 0;
+		VoiceLanes.Env[v] = 0;
 		Voices[v].ADSR.Phase = 0;
-		Voices[v].Pitch = 0x3FFF;
+		VoiceLanes.Pitch[v] = 0x3FFF;
 		Voices[v].NextA = 0x2801;
 		Voices[v].StartA = 0x2800;
 		Voices[v].LoopStartA = 0x2800;
@@ -345,10 +345,10 @@ void V_Voice::Start()
 	PendingLoopStart = false;
 }
 
-void V_Voice::Stop()
+void V_Core::StopVoice(uint voiceidx)
 {
-	ADSR.Value = 0;
-	ADSR.Phase = 0;
+	VoiceLanes.Env[voiceidx] = 0;
+	Voices[voiceidx].ADSR.Phase = 0;
 }
 
 uint TickInterval = 768;
@@ -357,6 +357,7 @@ extern void UpdateDebugDialog();
 
 __forceinline bool StartQueuedVoice(uint coreidx, uint voiceidx)
 {
+	V_VoiceLanes& lanes(Cores[coreidx].VoiceLanes);
 	V_Voice& vc(Cores[coreidx].Voices[voiceidx]);
 
 	if ((Cycles - vc.PlayCycle) < 2)
@@ -369,18 +370,18 @@ __forceinline bool StartQueuedVoice(uint coreidx, uint voiceidx)
 	}
 
 	vc.ADSR.Releasing = false;
-	vc.ADSR.Value = 1;
+	lanes.Env[voiceidx] = 1;
 	vc.ADSR.Phase = 1;
 	vc.SCurrent = 28;
 	vc.LoopMode = 0;
-	vc.SP = 0;
+	lanes.SP[voiceidx] = 0;
 	vc.LoopFlags = 0;
 	vc.NextA = vc.StartA | 1;
 	vc.Prev1 = 0;
 	vc.Prev2 = 0;
 
-	vc.PV1 = vc.PV2 = 0;
-	vc.PV3 = vc.PV4 = 0;
+	lanes.PV1[voiceidx] = lanes.PV2[voiceidx] = 0;
+	lanes.PV3[voiceidx] = lanes.PV4[voiceidx] = 0;
 	vc.NextCrest = -0x8000;
 
 	return true;
@@ -446,6 +447,20 @@ __forceinline void TimeUpdate(u32 cClocks)
 				if(Cores[c].KeyOn & (1 << v))
 					if(StartQueuedVoice(c, v))
 						Cores[c].KeyOn &= ~(1 << v);
+
+		// Everything but the last tick can go through MixBlock(), which delivers its IRQs
+		// one tick late: they must still be raised before we return.
+		if (BlockMixing)
+		{
+			const uint ticks = std::min<uint>(dClocks / TickInterval, MixBlockMaxTicks);
+			if (ticks >= 2 && MixBlock(ticks))
+			{
+				dClocks -= TickInterval * (ticks - 1);
+				lClocks += TickInterval * (ticks - 1);
+				continue;
+			}
+		}
+
 		// Note: IOP does not use MMX regs, so no need to save them.
 		//SaveMMXRegs();
 		Mix();
@@ -659,8 +674,8 @@ void V_Core::WriteRegPS1(u32 mem, u16 value)
 			case 0x4:
 				if (value > 0x3fff)
 					ConLog("* SPU2: Pitch setting too big: 0x%x\n", value);
-				Voices[voice].Pitch = value & 0x3fff;
-				//ConLog("voice %x Pitch write: %x\n", voice, Voices[voice].Pitch);
+				VoiceLanes.Pitch[voice] = value & 0x3fff;
+				//ConLog("voice %x Pitch write: %x\n", voice, VoiceLanes.Pitch[voice]);
 				break;
 			case 0x6:
 				Voices[voice].StartA = map_spu1to2(value);
@@ -678,8 +693,8 @@ void V_Core::WriteRegPS1(u32 mem, u16 value)
 				break;
 			case 0xc: // Voice 0..23 ADSR Current Volume
 				// not commonly set by games
-				Voices[voice].ADSR.Value = value * 0x10001U;
-				ConLog("voice %x ADSR.Value write: %x\n", voice, Voices[voice].ADSR.Value);
+				VoiceLanes.Env[voice] = value * 0x10001U;
+				ConLog("voice %x ADSR.Value write: %x\n", voice, VoiceLanes.Env[voice]);
 				break;
 			case 0xe:
 				Voices[voice].LoopStartA = map_spu1to2(value);
@@ -980,7 +995,7 @@ u16 V_Core::ReadRegPS1(u32 mem)
 				break;
 
 			case 0x4:
-				value = Voices[voice].Pitch;
+				value = VoiceLanes.Pitch[voice];
 				//ConLog("voice %d read pitch result = %x\n", voice, value);
 				break;
 			case 0x6:
@@ -994,7 +1009,7 @@ u16 V_Core::ReadRegPS1(u32 mem)
 				value = Voices[voice].ADSR.regADSR2;
 				break;
 			case 0xc:                                   // Voice 0..23 ADSR Current Volume
-				value = Voices[voice].ADSR.Value >> 16; // no clue
+				value = VoiceLanes.Env[voice] >> 16; // no clue
 				//if (value != 0) ConLog("voice %d read ADSR.Value result = %x\n", voice, value);
 				break;
 			case 0xe:
@@ -1157,7 +1172,7 @@ static void __fastcall RegWrite_VoiceParams(u16 value)
 		case 2:
 			if (value > 0x3fff)
 				ConLog("* SPU2: Pitch setting too big: 0x%x\n", value);
-			thisvoice.Pitch = value & 0x3fff;
+			Cores[core].VoiceLanes.Pitch[voice] = value & 0x3fff;
 			break;
 
 		case 3: // ADSR1 (Envelope)
@@ -1174,7 +1189,7 @@ static void __fastcall RegWrite_VoiceParams(u16 value)
 		case 5:
 			// [Air] : Mysterious ADSR set code.  Too bad none of my games ever use it.
 			//      (as usual... )
-			//thisvoice.ADSR.Value = (value << 16) | value;
+			//Cores[core].VoiceLanes.Env[voice] = (value << 16) | value;
 			//ConLog("* SPU2: Mysterious ADSR Volume Set to 0x%x\n", value);
 			break;
 
@@ -1551,9 +1566,9 @@ static void __fastcall RegWrite_Core(u16 value)
 					Cores[1].Voices[v].Volume = V_VolumeSlideLR(0, 0); // V_VolumeSlideLR::Max;
 					Cores[1].Voices[v].SCurrent = 28;
 
-					Cores[1].Voices[v].ADSR.Value = 0;
+					Cores[1].VoiceLanes.Env[v] = 0;
 					Cores[1].Voices[v].ADSR.Phase = 0;
-					Cores[1].Voices[v].Pitch = 0x0;
+					Cores[1].VoiceLanes.Pitch[v] = 0x0;
 					Cores[1].Voices[v].NextA = 0x6FFFF;
 					Cores[1].Voices[v].StartA = 0x6FFFF;
 					Cores[1].Voices[v].LoopStartA = 0x6FFFF;
@@ -1997,7 +2012,7 @@ void StartVoices(int core, u32 value)
 					   (Cores[core].VoiceGates[vc].DryL) ? "+" : "-", (Cores[core].VoiceGates[vc].DryR) ? "+" : "-",
 					   (Cores[core].VoiceGates[vc].WetL) ? "+" : "-", (Cores[core].VoiceGates[vc].WetR) ? "+" : "-",
 					   *(u16*)GetMemPtr(thisvc.StartA),
-					   thisvc.Pitch,
+					   Cores[core].VoiceLanes.Pitch[vc],
 					   thisvc.Volume.Left.Value >> 16, thisvc.Volume.Right.Value >> 16,
 					   thisvc.ADSR.regADSR1, thisvc.ADSR.regADSR2);
 		}
@@ -22,6 +22,8 @@
 #include "COP0.h"
 #include "VUmicro.h"
 #include "MTVU.h"
+#include "MTIOP.h"
+#include "IPU/IPUThread.h"
 #include "Cache.h"
 #include "Config.h"
 
@@ -37,6 +39,7 @@
 #include "common/SafeArray.inl"
 #include "common/ScopedGuard.h"
 #include "common/StringUtil.h"
+#include "common/Timer.h"
 #include "GS/GS.h"
 #include "SPU2/spu2.h"
 #include "USB/USB.h"
@@ -58,6 +61,9 @@
 #endif
 
 #include "common/pxStreams.h"
+#include "common/FileSystem.h"
+#include "SaveStateArchive.h"
+#include <wx/mstream.h>
 #include <wx/wfstream.h>
 #include <wx/zipstrm.h>
 
@@ -116,6 +122,7 @@ void SaveStateBase::Init( SafeArray<u8>* memblock )
 	m_memory	= memblock;
 	m_version	= g_SaveVersion;
 	m_idx		= 0;
+	m_raw		= false;
 }
 
 void SaveStateBase::PrepBlock( int size )
@@ -134,6 +141,8 @@ void SaveStateBase::PrepBlock( int size )
 
 void SaveStateBase::FreezeTag( const char* src )
 {
+	if( m_raw ) return;
+
 	const uint allowedlen = sizeof( m_tagspace )-1;
 	pxAssertDev( strlen(src) < allowedlen, pxsFmt( L"Tag name exceeds the allowed length of %d chars.", allowedlen) );
 
@@ -187,6 +196,8 @@ static const uint MainMemorySizeInBytes =
 SaveStateBase& SaveStateBase::FreezeMainMemory()
 {
 	vu1Thread.WaitVU(); // Finish VU1 just in-case...
+	iopThread.WaitIOP();
+	ipuThread.Wait();
 	if (IsLoading()) PreLoadPrep();
 	else m_memory->MakeRoomFor( m_idx + MainMemorySizeInBytes );
 
@@ -211,15 +222,19 @@ SaveStateBase& SaveStateBase::FreezeMainMemory()
 SaveStateBase& SaveStateBase::FreezeInternals()
 {
 	vu1Thread.WaitVU(); // Finish VU1 just in-case...
+	iopThread.WaitIOP();
+	ipuThread.Wait();
 	// Print this until the MTVU problem in gifPathFreeze is taken care of (rama)
-	if (THREAD_VU1) Console.Warning("MTVU speedhack is enabled, saved states may not be stable");
+	if (THREAD_VU1 && !m_raw) Console.Warning("MTVU speedhack is enabled, saved states may not be stable");
 	
-	if (IsLoading()) PreLoadPrep();
+	if (IsLoading() && !m_raw) PreLoadPrep();
 
 	// Second Block - Various CPU Registers and States
 	// -----------------------------------------------
 	FreezeTag( "cpuRegs" );
 	Freeze(cpuRegs);		// cpu regs + COP0
+	if (IsLoading())
+		cpuRebuildEventQueue();
 	Freeze(psxRegs);		// iop regs
 	Freeze(fpuRegs);
 	Freeze(tlb);			// tlbs
@@ -479,7 +494,6 @@ public:
 	virtual void FreezeOut(SaveStateBase& writer) const;
 	virtual bool IsRequired() const { return true; }
 
-protected:
 	virtual u8* GetDataPtr() const = 0;
 	virtual uint GetDataSize() const = 0;
 };
@@ -680,32 +694,36 @@ static const std::unique_ptr<BaseSavestateEntry> SavestateEntries[] = {
 
 // It's bad mojo to have savestates trying to read and write from the same file at the
 // same time.  To prevent that we use this mutex lock, which is used by both the
-// CompressThread and the UnzipFromDisk events.  (note that CompressThread locks the
-// mutex during OnStartInThread, which ensures that the ZipToDisk event blocks; preventing
+// CompressThread and the LoadFromDisk events.  (note that CompressThread locks the
+// mutex during OnStartInThread, which ensures that the WriteToDisk event blocks; preventing
 // the SysExecutor's Idle Event from re-enabing savestates and slots.)
 //
 static Mutex mtx_CompressToDisk;
 
-static void CheckVersion(pxInputStream& thr)
+static void CheckVersion(const wxString& filename, u32 savever)
 {
-	u32 savever;
-	thr.Read(savever);
-
 	// Major version mismatch.  Means we can't load this savestate at all.  Support for it
 	// was removed entirely.
 	if (savever > g_SaveVersion)
-		throw Exception::SaveStateLoadError(thr.GetStreamName())
+		throw Exception::SaveStateLoadError(filename)
 		.SetDiagMsg(pxsFmt(L"Savestate uses an unsupported or unknown savestate version.\n(PCSX2 ver=%x, state ver=%x)", g_SaveVersion, savever))
 		.SetUserMsg(_("Cannot load this savestate. The state is an unsupported version."));
 
 	// check for a "minor" version incompatibility; which happens if the savestate being loaded is a newer version
 	// than the emulator recognizes.  99% chance that trying to load it will just corrupt emulation or crash.
 	if ((savever >> 16) != (g_SaveVersion >> 16))
-		throw Exception::SaveStateLoadError(thr.GetStreamName())
+		throw Exception::SaveStateLoadError(filename)
 		.SetDiagMsg(pxsFmt(L"Savestate uses an unknown savestate version.\n(PCSX2 ver=%x, state ver=%x)", g_SaveVersion, savever))
 		.SetUserMsg(_("Cannot load this savestate. The state is an unsupported version."));
 };
 
+static void CheckVersion(pxInputStream& thr)
+{
+	u32 savever;
+	thr.Read(savever);
+	CheckVersion(thr.GetStreamName(), savever);
+}
+
 void SaveState_DownloadState(ArchiveEntryList* destlist)
 {
 #ifndef PCSX2_CORE
@@ -735,6 +753,234 @@ void SaveState_DownloadState(ArchiveEntryList* destlist)
 	}
 }
 
+static bool IsMainMemoryEntry(const BaseSavestateEntry* entry)
+{
+	return (dynamic_cast<const SavestateEntry_EmotionMemory*>(entry) || dynamic_cast<const SavestateEntry_IopMemory*>(entry));
+}
+
+void SaveState_FreezeWithoutMainMemory(VmStateBuffer& buffer, uint* size)
+{
+	memSavingState saveme(buffer);
+
+	// Each entry is prefixed with its size, so it can be handed back to FreezeIn as a stream.
+	for (uint i = 0; i < ArraySize(SavestateEntries); ++i)
+	{
+		if (IsMainMemoryEntry(SavestateEntries[i].get()))
+			continue;
+
+		const uint sizepos = saveme.GetCurrentPos();
+		u32 entrysize = 0;
+		saveme.Freeze(entrysize);
+
+		const uint startpos = saveme.GetCurrentPos();
+		SavestateEntries[i]->FreezeOut(saveme);
+
+		entrysize = saveme.GetCurrentPos() - startpos;
+		std::memcpy(buffer.GetPtr(sizepos), &entrysize, sizeof(entrysize));
+	}
+
+	saveme.FreezeBios();
+	saveme.FreezeInternals();
+
+	*size = saveme.GetCurrentPos();
+}
+
+void SaveState_DefrostWithoutMainMemory(const VmStateBuffer& buffer)
+{
+	memLoadingState loadme(buffer);
+
+	// Main memory was replaced behind the recompilers' back by the caller.
+	SysClearExecutionCache();
+
+	for (uint i = 0; i < ArraySize(SavestateEntries); ++i)
+	{
+		if (IsMainMemoryEntry(SavestateEntries[i].get()))
+			continue;
+
+		u32 entrysize;
+		loadme.Freeze(entrysize);
+		loadme.PrepBlock(entrysize);
+
+		pxInputStream reader(SavestateEntries[i]->GetFilename(), new wxMemoryInputStream(loadme.GetBlockPtr(), entrysize));
+		SavestateEntries[i]->FreezeIn(reader);
+		loadme.CommitBlock(entrysize);
+	}
+
+	loadme.FreezeBios();
+	loadme.FreezeInternals();
+}
+
+// --------------------------------------------------------------------------------------
+//  FastSnapshot  (implementations)
+// --------------------------------------------------------------------------------------
+class memRawSavingState final : public memSavingState
+{
+public:
+	memRawSavingState(VmStateBuffer& save_to)
+		: memSavingState(save_to)
+	{
+		m_raw = true;
+	}
+};
+
+class memRawLoadingState final : public memLoadingState
+{
+public:
+	memRawLoadingState(const VmStateBuffer& load_from)
+		: memLoadingState(load_from)
+	{
+		m_raw = true;
+	}
+};
+
+// Same order as the component entries of SavestateEntries.
+static const SysState_Component* const FastSnapshotComponents[] = {
+	&SPU2,
+#ifndef PCSX2_CORE
+	&USB,
+#endif
+	&PAD_,
+	&GS,
+};
+
+static constexpr uint FastSnapshotPageSize = 4096;
+
+template <typename Func>
+static void FastSnapshot_ForEachMemoryEntry(Func func)
+{
+	for (uint i = 0; i < ArraySize(SavestateEntries); ++i)
+	{
+		if (const MemorySavestateEntry* entry = dynamic_cast<const MemorySavestateEntry*>(SavestateEntries[i].get()))
+			func(entry->GetDataPtr(), entry->GetDataSize());
+	}
+}
+
+// Drops recompiled code for memory which is about to be overwritten by a snapshot.
+static void FastSnapshot_ClearRecompilers(const u8* base, u32 offset, u32 size)
+{
+	// EE main memory needs nothing here: pages holding recompiled code are write protected,
+	// the page fault handler clears their blocks like it does for DMA writes.
+	if (base == iopMem->Main)
+		psxCpu->Clear(offset, size / 4);
+	else if (base == vuRegs[0].Micro)
+		CpuVU0->Clear(offset, size);
+	else if (base == vuRegs[1].Micro)
+		CpuVU1->Clear(offset, size);
+}
+
+FastSnapshot::FastSnapshot()
+	: m_state(L"FastSnapshot")
+{
+}
+
+FastSnapshot::~FastSnapshot() = default;
+
+void FastSnapshot::Save()
+{
+	Common::Timer total_timer;
+	Common::Timer timer;
+
+	vu1Thread.WaitVU();
+	iopThread.WaitIOP();
+	ipuThread.Wait();
+
+	size_t memory_size = 0;
+	FastSnapshot_ForEachMemoryEntry([&memory_size](const u8*, uint size) { memory_size += size; });
+	if (m_memory.size() != memory_size)
+		m_memory.resize(memory_size);
+
+	u8* dst = m_memory.data();
+	FastSnapshot_ForEachMemoryEntry([&dst](const u8* data, uint size) {
+		std::memcpy(dst, data, size);
+		dst += size;
+	});
+
+	m_save_timings.memory_ms = static_cast<float>(timer.GetTimeMillisecondsAndReset());
+
+	memRawSavingState saveme(m_state);
+	for (const SysState_Component* comp : FastSnapshotComponents)
+	{
+		freezeData fP = {0, nullptr};
+		if (comp->freeze(FreezeAction::Size, &fP) != 0)
+			fP.size = 0;
+
+		u32 size = fP.size;
+		saveme.Freeze(size);
+		saveme.PrepBlock(size);
+
+		fP.data = saveme.GetBlockPtr();
+		if (size > 0 && comp->freeze(FreezeAction::Save, &fP) != 0)
+			throw std::runtime_error(std::string(" * ") + comp->name + std::string(": Error saving state!\n"));
+
+		saveme.CommitBlock(size);
+	}
+
+	m_save_timings.components_ms = static_cast<float>(timer.GetTimeMillisecondsAndReset());
+
+	saveme.FreezeInternals();
+	m_state_size = saveme.GetCurrentPos();
+	m_valid = true;
+
+	m_save_timings.internals_ms = static_cast<float>(timer.GetTimeMilliseconds());
+	m_save_timings.total_ms = static_cast<float>(total_timer.GetTimeMilliseconds());
+	m_save_timings.pages = 0;
+}
+
+void FastSnapshot::Load()
+{
+	pxAssert(m_valid);
+
+	Common::Timer total_timer;
+	Common::Timer timer;
+
+	vu1Thread.WaitVU();
+	iopThread.WaitIOP();
+	ipuThread.Wait();
+
+	// Between two run-ahead frames most of memory is untouched, comparing is a lot cheaper
+	// than writing it back (and faulting on every protected code page).
+	u32 pages = 0;
+	const u8* src = m_memory.data();
+	FastSnapshot_ForEachMemoryEntry([&src, &pages](u8* data, uint size) {
+		for (uint offset = 0; offset < size; offset += FastSnapshotPageSize)
+		{
+			const uint len = std::min(size - offset, FastSnapshotPageSize);
+			if (std::memcmp(data + offset, src + offset, len) == 0)
+				continue;
+
+			FastSnapshot_ClearRecompilers(data, offset, len);
+			std::memcpy(data + offset, src + offset, len);
+			pages++;
+		}
+
+		src += size;
+	});
+
+	m_load_timings.memory_ms = static_cast<float>(timer.GetTimeMillisecondsAndReset());
+
+	memRawLoadingState loadme(m_state);
+	for (const SysState_Component* comp : FastSnapshotComponents)
+	{
+		u32 size;
+		loadme.Freeze(size);
+		loadme.PrepBlock(size);
+
+		freezeData fP = {static_cast<int>(size), loadme.GetBlockPtr()};
+		if (size > 0 && comp->freeze(FreezeAction::Load, &fP) != 0)
+			throw std::runtime_error(std::string(" * ") + comp->name + std::string(": Error loading state!\n"));
+
+		loadme.CommitBlock(size);
+	}
+
+	m_load_timings.components_ms = static_cast<float>(timer.GetTimeMillisecondsAndReset());
+
+	loadme.FreezeInternals();
+
+	m_load_timings.internals_ms = static_cast<float>(timer.GetTimeMilliseconds());
+	m_load_timings.total_ms = static_cast<float>(total_timer.GetTimeMilliseconds());
+	m_load_timings.pages = pages;
+}
+
 std::unique_ptr<SaveStateScreenshotData> SaveState_SaveScreenshot()
 {
 	static constexpr u32 SCREENSHOT_WIDTH = 640;
@@ -754,21 +1000,16 @@ std::unique_ptr<SaveStateScreenshotData> SaveState_SaveScreenshot()
 	return data;
 }
 
-static bool SaveState_CompressScreenshot(SaveStateScreenshotData* data, wxZipOutputStream* gzfp)
+static bool SaveState_CompressScreenshot(SaveStateScreenshotData* data, std::vector<u8>* png)
 {
 	png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
 	png_infop info_ptr = nullptr;
 	if (!png_ptr)
 		return false;
 
-	wxZipEntry* const vent = new wxZipEntry(EntryFilename_Screenshot);
-	vent->SetMethod(wxZIP_METHOD_STORE);
-	gzfp->PutNextEntry(vent);
-
-	ScopedGuard cleanup([&png_ptr, &info_ptr, gzfp]() {
+	ScopedGuard cleanup([&png_ptr, &info_ptr]() {
 		if (png_ptr)
 			png_destroy_write_struct(&png_ptr, info_ptr ? &info_ptr : nullptr);
-		gzfp->CloseEntry();
 	});
 
 	info_ptr = png_create_info_struct(png_ptr);
@@ -778,8 +1019,9 @@ static bool SaveState_CompressScreenshot(SaveStateScreenshotData* data, wxZipOut
 	if (setjmp(png_jmpbuf(png_ptr)))
 		return false;
 
-	png_set_write_fn(png_ptr, gzfp, [](png_structp png_ptr, png_bytep data_ptr, png_size_t size) {
-		((wxZipOutputStream*)png_get_io_ptr(png_ptr))->Write(data_ptr, size);
+	png_set_write_fn(png_ptr, png, [](png_structp png_ptr, png_bytep data_ptr, png_size_t size) {
+		std::vector<u8>* out = static_cast<std::vector<u8>*>(png_get_io_ptr(png_ptr));
+		out->insert(out->end(), data_ptr, data_ptr + size);
 	}, [](png_structp png_ptr) {});
 	png_set_compression_level(png_ptr, 5);
 	png_set_IHDR(png_ptr, info_ptr, data->width, data->height, 8, PNG_COLOR_TYPE_RGBA,
@@ -803,53 +1045,47 @@ static bool SaveState_CompressScreenshot(SaveStateScreenshotData* data, wxZipOut
 // --------------------------------------------------------------------------------------
 //  CompressThread_VmState
 // --------------------------------------------------------------------------------------
-static void ZipStateToDiskOnThread(std::unique_ptr<ArchiveEntryList> srclist, std::unique_ptr<SaveStateScreenshotData> screenshot, std::unique_ptr<wxFFileOutputStream> outbase, wxString filename, wxString tempfile, s32 slot_for_message)
+static void CompressStateToDiskOnThread(std::unique_ptr<ArchiveEntryList> srclist, std::unique_ptr<SaveStateScreenshotData> screenshot, std::FILE* fp, wxString filename, wxString tempfile, s32 slot_for_message)
 {
 #ifndef PCSX2_CORE
 	wxGetApp().StartPendingSave();
 #endif
 
-	std::unique_ptr<pxOutputStream> out(new pxOutputStream(tempfile, new wxZipOutputStream(outbase.release())));
-	wxZipOutputStream* gzfp = (wxZipOutputStream*)out->GetWxStreamBase();
+	std::vector<u8> png;
+	std::vector<SaveStateArchive::WriteEntry> entries;
 
+	// PNG data is already deflated, so it's stored as-is.
+	if (screenshot && SaveState_CompressScreenshot(screenshot.get(), &png))
 	{
-		wxZipEntry* vent = new wxZipEntry(EntryFilename_StateVersion);
-		vent->SetMethod(wxZIP_METHOD_STORE);
-		gzfp->PutNextEntry(vent);
-		out->Write(g_SaveVersion);
-		gzfp->CloseEntry();
+		entries.push_back({StringUtil::wxStringToUTF8String(EntryFilename_Screenshot), png.data(),
+			static_cast<u32>(png.size()), SaveStateArchive::Method::Store});
 	}
 
-	if (screenshot)
-		SaveState_CompressScreenshot(screenshot.get(), gzfp);
-
-	uint listlen = srclist->GetLength();
+	const uint listlen = srclist->GetLength();
 	for (uint i = 0; i < listlen; ++i)
 	{
 		const ArchiveEntry& entry = (*srclist)[i];
 		if (!entry.GetDataSize())
 			continue;
 
-		gzfp->PutNextEntry(entry.GetFilename());
-
-		static const uint BlockSize = 0x64000;
-		uint curidx = 0;
-
-		do
-		{
-			uint thisBlockSize = std::min(BlockSize, entry.GetDataSize() - curidx);
-			gzfp->Write(srclist->GetPtr(entry.GetDataIndex() + curidx), thisBlockSize);
-			curidx += thisBlockSize;
-		} while (curidx < entry.GetDataSize());
-
-		gzfp->CloseEntry();
+		entries.push_back({StringUtil::wxStringToUTF8String(entry.GetFilename()), srclist->GetPtr(entry.GetDataIndex()),
+			static_cast<u32>(entry.GetDataSize()), SaveStateArchive::Method::Deflate});
 	}
 
-	gzfp->Close();
+	const bool written = SaveStateArchive::Write(fp, g_SaveVersion, entries);
+	const bool closed = (std::fclose(fp) == 0);
 
-	if (!wxRenameFile(out->GetStreamName(), filename, true))
+	if (!written || !closed)
 	{
-		Console.Error("Failed to rename save state '%s' to '%s'", static_cast<const char*>(out->GetStreamName().c_str()), static_cast<const char*>(filename.c_str()));
+		Console.Error("Failed to write save state '%s'", static_cast<const char*>(tempfile.c_str()));
+		wxRemoveFile(tempfile);
+#ifndef PCSX2_CORE
+		Msgbox::Alert(_("The savestate was not properly saved. The temporary file could not be written."));
+#endif
+	}
+	else if (!wxRenameFile(tempfile, filename, true))
+	{
+		Console.Error("Failed to rename save state '%s' to '%s'", static_cast<const char*>(tempfile.c_str()), static_cast<const char*>(filename.c_str()));
 #ifndef PCSX2_CORE
 		Msgbox::Alert(_("The savestate was not properly saved. The temporary file was created successfully but could not be moved to its final resting place."));
 #endif
@@ -860,7 +1096,7 @@ static void ZipStateToDiskOnThread(std::unique_ptr<ArchiveEntryList> srclist, st
 	}
 
 #ifdef PCSX2_CORE
-	if (slot_for_message >= 0 && VMManager::HasValidVM())
+	if (written && closed && slot_for_message >= 0 && VMManager::HasValidVM())
 		Host::AddKeyedFormattedOSDMessage(StringUtil::StdStringFromFormat("SaveStateSlot%d", slot_for_message), 10.0f, "State saved to slot %d.", slot_for_message);
 #endif
 
@@ -869,24 +1105,108 @@ static void ZipStateToDiskOnThread(std::unique_ptr<ArchiveEntryList> srclist, st
 #endif
 }
 
-void SaveState_ZipToDisk(ArchiveEntryList* srclist, std::unique_ptr<SaveStateScreenshotData> screenshot, const wxString& filename, s32 slot_for_message)
+void SaveState_WriteToDisk(ArchiveEntryList* srclist, std::unique_ptr<SaveStateScreenshotData> screenshot, const wxString& filename, s32 slot_for_message)
 {
 	// Provisionals for scoped cleanup, in case of exception:
 	std::unique_ptr<ArchiveEntryList> elist(srclist);
 
 	wxString tempfile(filename + L".tmp");
-	std::unique_ptr<wxFFileOutputStream> out = std::make_unique<wxFFileOutputStream>(tempfile);
-	if (!out->IsOk())
+	std::FILE* fp = FileSystem::OpenCFile(StringUtil::wxStringToUTF8String(tempfile).c_str(), "wb");
+	if (!fp)
 		throw Exception::CannotCreateStream(tempfile);
 
-	std::thread threaded_save(ZipStateToDiskOnThread, std::move(elist), std::move(screenshot), std::move(out), filename, tempfile, slot_for_message);
+	std::thread threaded_save(CompressStateToDiskOnThread, std::move(elist), std::move(screenshot), fp, filename, tempfile, slot_for_message);
 	threaded_save.detach();
 }
 
-void SaveState_UnzipFromDisk(const wxString& filename)
+static void LoadStateFromArchive(const wxString& filename, std::FILE* fp)
 {
-	ScopedLock lock(mtx_CompressToDisk);
+	u32 savever;
+	std::string error;
+	std::vector<SaveStateArchive::ReadEntry> entries;
+
+	// Every entry is inflated up front on all cores, the loaders below only copy out of memory.
+	if (!SaveStateArchive::Read(fp, &savever, &entries, &error))
+	{
+		throw Exception::SaveStateLoadError(filename)
+			.SetDiagMsg(fromUTF8(error.c_str()))
+			.SetUserMsg(_("This savestate cannot be loaded because it is corrupted or incomplete.  See the log file for details."));
+	}
+
+	CheckVersion(filename, savever);
+
+	const SaveStateArchive::ReadEntry* foundInternal = nullptr;
+	const SaveStateArchive::ReadEntry* foundEntry[ArraySize(SavestateEntries)] = {};
+
+	for (const SaveStateArchive::ReadEntry& entry : entries)
+	{
+		const wxString name(fromUTF8(entry.name.c_str()));
+
+		if (name.CmpNoCase(EntryFilename_InternalStructures) == 0)
+		{
+			DevCon.WriteLn(Color_Green, L" ... found '%s'", EntryFilename_InternalStructures);
+			foundInternal = &entry;
+			continue;
+		}
 
+		for (uint i = 0; i < ArraySize(SavestateEntries); ++i)
+		{
+			if (name.CmpNoCase(SavestateEntries[i]->GetFilename()) == 0)
+			{
+				DevCon.WriteLn(Color_Green, L" ... found '%s'", WX_STR(SavestateEntries[i]->GetFilename()));
+				foundEntry[i] = &entry;
+				break;
+			}
+		}
+	}
+
+	if (!foundInternal)
+	{
+		throw Exception::SaveStateLoadError(filename)
+			.SetDiagMsg(pxsFmt(L"Savestate file does not contain '%s'", EntryFilename_InternalStructures))
+			.SetUserMsg(_("This file is not a valid PCSX2 savestate.  See the logfile for details."));
+	}
+
+	bool throwIt = false;
+	for (uint i = 0; i < ArraySize(SavestateEntries); ++i)
+	{
+		if (foundEntry[i] || !SavestateEntries[i]->IsRequired())
+			continue;
+
+		throwIt = true;
+		Console.WriteLn(Color_Red, " ... not found '%s'!", WX_STR(SavestateEntries[i]->GetFilename()));
+	}
+
+	if (throwIt)
+		throw Exception::SaveStateLoadError(filename)
+			.SetDiagMsg(L"Savestate cannot be loaded: some required components were not found or are incomplete.")
+			.SetUserMsg(_("This savestate cannot be loaded due to missing critical components.  See the log file for details."));
+
+#ifndef PCSX2_CORE
+	PatchesVerboseReset();
+#endif
+	SysClearExecutionCache();
+
+	for (uint i = 0; i < ArraySize(SavestateEntries); ++i)
+	{
+		if (!foundEntry[i])
+			continue;
+
+		Threading::pxTestCancel();
+
+		const std::vector<u8>& data = foundEntry[i]->data;
+		pxInputStream reader(filename, new wxMemoryInputStream(data.data(), data.size()));
+		SavestateEntries[i]->FreezeIn(reader);
+	}
+
+	VmStateBuffer buffer(foundInternal->data.size(), L"StateBuffer_LoadFromArchive");
+	std::memcpy(buffer.GetPtr(), foundInternal->data.data(), foundInternal->data.size());
+
+	memLoadingState(buffer).FreezeBios().FreezeInternals();
+}
+
+static void UnzipStateFromDisk(const wxString& filename)
+{
 	// Ugh.  Exception handling made crappy because wxWidgets classes don't support scoped pointers yet.
 
 	std::unique_ptr<wxFFileInputStream> woot(new wxFFileInputStream(filename));
@@ -1007,3 +1327,20 @@ void SaveState_UnzipFromDisk(const wxString& filename)
 
 	memLoadingState(buffer).FreezeBios().FreezeInternals();
 }
+
+void SaveState_LoadFromDisk(const wxString& filename)
+{
+	ScopedLock lock(mtx_CompressToDisk);
+
+	// States written before the chunked archive are plain zip files, which are still loaded the old way.
+	std::FILE* fp = FileSystem::OpenCFile(StringUtil::wxStringToUTF8String(filename).c_str(), "rb");
+	if (!fp)
+		throw Exception::CannotCreateStream(filename).SetDiagMsg(L"Cannot open file for reading.");
+
+	ScopedGuard close_fp([fp]() { std::fclose(fp); });
+
+	if (SaveStateArchive::IsArchive(fp))
+		LoadStateFromArchive(filename, fp);
+	else
+		UnzipStateFromDisk(filename);
+}
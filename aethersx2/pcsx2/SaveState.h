@@ -31,7 +31,7 @@ enum class FreezeAction
 //  the lower 16 bit value.  IF the change is breaking of all compatibility with old
 //  states, increment the upper 16 bit value, and clear the lower 16 bits to 0.
 
-static const u32 g_SaveVersion = (0x9A28 << 16) | 0x0000;
+static const u32 g_SaveVersion = (0x9A29 << 16) | 0x0000;
 
 // the freezing data between submodules and core
 // an interesting thing to note is that this dates back from before plugin
@@ -58,8 +58,13 @@ class ArchiveEntryList;
 // These functions assume that the caller has paused the core thread.
 extern void SaveState_DownloadState(ArchiveEntryList* destlist);
 extern std::unique_ptr<SaveStateScreenshotData> SaveState_SaveScreenshot();
-extern void SaveState_ZipToDisk(ArchiveEntryList* srclist, std::unique_ptr<SaveStateScreenshotData> screenshot, const wxString& filename, s32 slot_for_message);
-extern void SaveState_UnzipFromDisk(const wxString& filename);
+extern void SaveState_WriteToDisk(ArchiveEntryList* srclist, std::unique_ptr<SaveStateScreenshotData> screenshot, const wxString& filename, s32 slot_for_message);
+extern void SaveState_LoadFromDisk(const wxString& filename);
+
+// Freezes/defrosts everything except EE and IOP main memory, for in-memory snapshots which
+// track main memory themselves (rewind). The buffer layout is private to these two functions.
+extern void SaveState_FreezeWithoutMainMemory(VmStateBuffer& buffer, uint* size);
+extern void SaveState_DefrostWithoutMainMemory(const VmStateBuffer& buffer);
 
 // --------------------------------------------------------------------------------------
 //  SaveStateBase class
@@ -77,6 +82,8 @@ protected:
 
 	int m_idx;			// current read/write index of the allocation
 
+	bool m_raw;			// no tags and no recompiler reset on load, see FastSnapshot
+
 public:
 	SaveStateBase( VmStateBuffer& memblock );
 	SaveStateBase( VmStateBuffer* memblock );
@@ -344,6 +351,48 @@ public:
 	bool IsFinished() const { return m_idx >= m_memory->GetSizeInBytes(); }
 };
 
+// --------------------------------------------------------------------------------------
+//  FastSnapshot
+// --------------------------------------------------------------------------------------
+// Whole machine snapshot for per-frame use (run-ahead). Everything is copied into buffers
+// which are sized by the first Save() and reused afterwards; no tags, no archive and no
+// console output. Load() only writes back the memory pages which differ from the snapshot,
+// so the recompilers drop the blocks of those pages instead of their whole cache.
+// Both must be called on the CPU thread, outside of Cpu->Execute().
+class FastSnapshot
+{
+public:
+	struct Timings
+	{
+		float memory_ms;
+		float components_ms;
+		float internals_ms;
+		float total_ms;
+		u32 pages; // memory pages written back, Load() only
+	};
+
+	FastSnapshot();
+	~FastSnapshot();
+
+	bool IsValid() const { return m_valid; }
+	u32 GetSize() const { return static_cast<u32>(m_memory.size()) + m_state_size; }
+
+	void Save();
+	void Load();
+
+	const Timings& GetSaveTimings() const { return m_save_timings; }
+	const Timings& GetLoadTimings() const { return m_load_timings; }
+
+private:
+	std::vector<u8> m_memory;
+	VmStateBuffer m_state;
+	uint m_state_size = 0;
+	bool m_valid = false;
+
+	Timings m_save_timings = {};
+	Timings m_load_timings = {};
+};
+
 
 namespace Exception
 {
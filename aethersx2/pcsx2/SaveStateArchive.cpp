@@ -0,0 +1,421 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "SaveStateArchive.h"
+
+#include "common/Console.h"
+#include "common/FileSystem.h"
+#include "common/PersistentThread.h"
+#include "common/StringUtil.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <zlib.h>
+
+namespace SaveStateArchive
+{
+	static constexpr u32 MAX_ENTRIES = 64;
+	static constexpr u32 MAX_NAME_LENGTH = 256;
+	static constexpr u32 MAX_ENTRY_SIZE = 256 * _1mb;
+
+#pragma pack(push, 1)
+	struct FileHeader
+	{
+		u32 magic;
+		u32 version;
+		u32 save_version;
+		u32 entry_count;
+	};
+
+	struct EntryHeader
+	{
+		u32 name_length;
+		u32 method;
+		u32 size;
+		u32 chunk_size;
+		u32 chunk_count;
+		u32 crc;
+	};
+#pragma pack(pop)
+
+	struct Chunk
+	{
+		size_t entry;
+		u32 offset;
+		u32 size;
+		u32 crc;
+		std::vector<u8> packed;
+	};
+
+	// Helper threads of ParallelFor(), started on first use and kept until exit. Rewind runs a
+	// batch every few frames, spawning threads for each one costs more than the work.
+	class WorkerPool
+	{
+	public:
+		~WorkerPool();
+
+		void Run(size_t count, const std::function<void(size_t)>& func);
+
+	private:
+		void WorkerThread();
+		void RunTasks();
+
+		std::mutex m_run_mutex; // one batch at a time
+		std::mutex m_mutex;
+		std::condition_variable m_work_cv;
+		std::condition_variable m_done_cv;
+		std::vector<std::thread> m_threads;
+
+		const std::function<void(size_t)>* m_func = nullptr;
+		size_t m_count = 0;
+		std::atomic<size_t> m_next{0};
+		u32 m_generation = 0;
+		u32 m_active = 0;
+		bool m_shutdown = false;
+	};
+
+	static WorkerPool s_pool;
+
+	static std::vector<Chunk> SplitChunks(const std::vector<u32>& sizes, u32 chunk_size);
+} // namespace SaveStateArchive
+
+SaveStateArchive::WorkerPool::~WorkerPool()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_shutdown = true;
+	}
+	m_work_cv.notify_all();
+
+	for (std::thread& thread : m_threads)
+		thread.join();
+}
+
+void SaveStateArchive::WorkerPool::Run(size_t count, const std::function<void(size_t)>& func)
+{
+	std::unique_lock<std::mutex> run_lock(m_run_mutex);
+
+	if (m_threads.empty())
+	{
+		const u32 workers = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+		for (u32 i = 0; i < workers; i++)
+			m_threads.emplace_back(&WorkerPool::WorkerThread, this);
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_func = &func;
+		m_count = count;
+		m_next.store(0, std::memory_order_relaxed);
+		m_active = static_cast<u32>(m_threads.size());
+		m_generation++;
+	}
+	m_work_cv.notify_all();
+
+	RunTasks();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done_cv.wait(lock, [this]() { return m_active == 0; });
+	m_func = nullptr;
+}
+
+void SaveStateArchive::WorkerPool::WorkerThread()
+{
+	Threading::SetNameOfCurrentThread("SaveState Worker");
+
+	u32 generation = 0;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for (;;)
+	{
+		m_work_cv.wait(lock, [this, generation]() { return m_shutdown || m_generation != generation; });
+		if (m_shutdown)
+			break;
+
+		generation = m_generation;
+		lock.unlock();
+
+		RunTasks();
+
+		lock.lock();
+		if (--m_active == 0)
+			m_done_cv.notify_one();
+	}
+}
+
+void SaveStateArchive::WorkerPool::RunTasks()
+{
+	for (size_t i = m_next.fetch_add(1); i < m_count; i = m_next.fetch_add(1))
+		(*m_func)(i);
+}
+
+void SaveStateArchive::ParallelFor(size_t count, const std::function<void(size_t)>& func)
+{
+	if (count <= 1 || std::thread::hardware_concurrency() <= 1)
+	{
+		for (size_t i = 0; i < count; i++)
+			func(i);
+
+		return;
+	}
+
+	s_pool.Run(count, func);
+}
+
+std::vector<SaveStateArchive::Chunk> SaveStateArchive::SplitChunks(const std::vector<u32>& sizes, u32 chunk_size)
+{
+	std::vector<Chunk> chunks;
+
+	for (size_t i = 0; i < sizes.size(); i++)
+	{
+		for (u32 offset = 0; offset < sizes[i]; offset += chunk_size)
+			chunks.push_back({i, offset, std::min(chunk_size, sizes[i] - offset), 0, {}});
+	}
+
+	return chunks;
+}
+
+bool SaveStateArchive::IsArchive(std::FILE* fp)
+{
+	const s64 pos = FileSystem::FTell64(fp);
+
+	u32 magic = 0;
+	const bool result = (std::fread(&magic, sizeof(magic), 1, fp) == 1 && magic == MAGIC);
+
+	FileSystem::FSeek64(fp, pos, SEEK_SET);
+	return result;
+}
+
+bool SaveStateArchive::Write(std::FILE* fp, u32 save_version, const std::vector<WriteEntry>& entries)
+{
+	std::vector<u32> sizes;
+	sizes.reserve(entries.size());
+	for (const WriteEntry& entry : entries)
+		sizes.push_back(entry.size);
+
+	std::vector<Chunk> chunks(SplitChunks(sizes, CHUNK_SIZE));
+
+	ParallelFor(chunks.size(), [&entries, &chunks](size_t i) {
+		Chunk& chunk = chunks[i];
+		const WriteEntry& entry = entries[chunk.entry];
+		const u8* src = entry.data + chunk.offset;
+
+		chunk.crc = crc32(0L, src, chunk.size);
+
+		if (entry.method == Method::Deflate)
+		{
+			uLongf packed_size = compressBound(chunk.size);
+			chunk.packed.resize(packed_size);
+
+			if (compress2(chunk.packed.data(), &packed_size, src, chunk.size, Z_BEST_SPEED) == Z_OK && packed_size < chunk.size)
+			{
+				chunk.packed.resize(packed_size);
+				return;
+			}
+		}
+
+		// A chunk which doesn't shrink is stored, the reader tells them apart by the packed size.
+		chunk.packed.assign(src, src + chunk.size);
+	});
+
+	const FileHeader header = {MAGIC, VERSION, save_version, static_cast<u32>(entries.size())};
+	if (std::fwrite(&header, sizeof(header), 1, fp) != 1)
+		return false;
+
+	size_t first_chunk = 0;
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		const WriteEntry& entry = entries[i];
+
+		size_t last_chunk = first_chunk;
+		while (last_chunk < chunks.size() && chunks[last_chunk].entry == i)
+			last_chunk++;
+
+		std::vector<u32> packed_sizes;
+		std::vector<u32> crcs;
+		uLong crc = crc32(0L, Z_NULL, 0);
+
+		for (size_t j = first_chunk; j < last_chunk; j++)
+		{
+			packed_sizes.push_back(static_cast<u32>(chunks[j].packed.size()));
+			crcs.push_back(chunks[j].crc);
+			crc = crc32_combine(crc, chunks[j].crc, chunks[j].size);
+		}
+
+		EntryHeader eh;
+		eh.name_length = static_cast<u32>(entry.name.size());
+		eh.method = static_cast<u32>(entry.method);
+		eh.size = entry.size;
+		eh.chunk_size = CHUNK_SIZE;
+		eh.chunk_count = static_cast<u32>(last_chunk - first_chunk);
+		eh.crc = static_cast<u32>(crc);
+
+		if (std::fwrite(&eh, sizeof(eh), 1, fp) != 1 ||
+			std::fwrite(entry.name.data(), entry.name.size(), 1, fp) != 1 ||
+			(eh.chunk_count > 0 && (std::fwrite(packed_sizes.data(), sizeof(u32), eh.chunk_count, fp) != eh.chunk_count ||
+									std::fwrite(crcs.data(), sizeof(u32), eh.chunk_count, fp) != eh.chunk_count)))
+		{
+			return false;
+		}
+
+		for (size_t j = first_chunk; j < last_chunk; j++)
+		{
+			if (std::fwrite(chunks[j].packed.data(), chunks[j].packed.size(), 1, fp) != 1)
+				return false;
+
+			// Drop the packed data as soon as it is on disk, the whole state doesn't need to be held twice.
+			std::vector<u8>().swap(chunks[j].packed);
+		}
+
+		first_chunk = last_chunk;
+	}
+
+	return std::fflush(fp) == 0;
+}
+
+bool SaveStateArchive::Read(std::FILE* fp, u32* save_version, std::vector<ReadEntry>* entries, std::string* error)
+{
+	FileHeader header;
+	if (std::fread(&header, sizeof(header), 1, fp) != 1 || header.magic != MAGIC)
+	{
+		*error = "Not a savestate archive.";
+		return false;
+	}
+
+	if (header.version != VERSION || header.entry_count > MAX_ENTRIES)
+	{
+		*error = StringUtil::StdStringFromFormat("Unsupported savestate archive version %u.", header.version);
+		return false;
+	}
+
+	*save_version = header.save_version;
+
+	std::vector<u32> sizes;
+	std::vector<u32> packed_sizes;
+	std::vector<u32> crcs;
+	std::vector<u32> entry_crcs;
+	std::vector<std::vector<u8>> packed;
+
+	entries->clear();
+	entries->reserve(header.entry_count);
+
+	for (u32 i = 0; i < header.entry_count; i++)
+	{
+		EntryHeader eh;
+		if (std::fread(&eh, sizeof(eh), 1, fp) != 1 || eh.name_length > MAX_NAME_LENGTH || eh.size > MAX_ENTRY_SIZE ||
+			eh.chunk_size != CHUNK_SIZE || eh.chunk_count != (eh.size + CHUNK_SIZE - 1) / CHUNK_SIZE)
+		{
+			*error = "Corrupted savestate archive entry header.";
+			return false;
+		}
+
+		ReadEntry entry;
+		entry.name.resize(eh.name_length);
+		if (eh.name_length > 0 && std::fread(entry.name.data(), eh.name_length, 1, fp) != 1)
+		{
+			*error = "Truncated savestate archive.";
+			return false;
+		}
+
+		const size_t first = packed_sizes.size();
+		packed_sizes.resize(first + eh.chunk_count);
+		crcs.resize(first + eh.chunk_count);
+
+		if (eh.chunk_count > 0 &&
+			(std::fread(&packed_sizes[first], sizeof(u32), eh.chunk_count, fp) != eh.chunk_count ||
+				std::fread(&crcs[first], sizeof(u32), eh.chunk_count, fp) != eh.chunk_count))
+		{
+			*error = "Truncated savestate archive.";
+			return false;
+		}
+
+		for (u32 j = 0; j < eh.chunk_count; j++)
+		{
+			const u32 packed_size = packed_sizes[first + j];
+			if (packed_size > compressBound(CHUNK_SIZE))
+			{
+				*error = "Corrupted savestate archive chunk table.";
+				return false;
+			}
+
+			std::vector<u8> data(packed_size);
+			if (packed_size > 0 && std::fread(data.data(), packed_size, 1, fp) != 1)
+			{
+				*error = StringUtil::StdStringFromFormat("Truncated savestate archive entry '%s'.", entry.name.c_str());
+				return false;
+			}
+
+			packed.push_back(std::move(data));
+		}
+
+		entry.data.resize(eh.size);
+		sizes.push_back(eh.size);
+		entry_crcs.push_back(eh.crc);
+		entries->push_back(std::move(entry));
+	}
+
+	std::vector<Chunk> chunks(SplitChunks(sizes, CHUNK_SIZE));
+	pxAssert(chunks.size() == packed.size());
+
+	std::atomic<bool> failed{false};
+
+	ParallelFor(chunks.size(), [entries, &chunks, &packed, &crcs, &failed](size_t i) {
+		const Chunk& chunk = chunks[i];
+		const std::vector<u8>& src = packed[i];
+		u8* dst = (*entries)[chunk.entry].data.data() + chunk.offset;
+
+		if (src.size() == chunk.size)
+		{
+			std::memcpy(dst, src.data(), chunk.size);
+		}
+		else
+		{
+			uLongf size = chunk.size;
+			if (uncompress(dst, &size, src.data(), static_cast<uLong>(src.size())) != Z_OK || size != chunk.size)
+			{
+				failed.store(true, std::memory_order_relaxed);
+				return;
+			}
+		}
+
+		if (crc32(0L, dst, chunk.size) != crcs[i])
+			failed.store(true, std::memory_order_relaxed);
+	});
+
+	if (failed.load())
+	{
+		*error = "Savestate archive failed the checksum test.";
+		return false;
+	}
+
+	// The per-chunk checksums already cover the data, this catches a chunk table that was shuffled around.
+	for (size_t i = 0, chunk = 0; i < entries->size(); i++)
+	{
+		uLong crc = crc32(0L, Z_NULL, 0);
+		for (; chunk < chunks.size() && chunks[chunk].entry == i; chunk++)
+			crc = crc32_combine(crc, crcs[chunk], chunks[chunk].size);
+
+		if (static_cast<u32>(crc) != entry_crcs[i])
+		{
+			*error = StringUtil::StdStringFromFormat("Savestate archive entry '%s' failed the checksum test.", (*entries)[i].name.c_str());
+			return false;
+		}
+	}
+
+	return true;
+}
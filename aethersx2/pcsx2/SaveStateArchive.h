@@ -0,0 +1,69 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/Pcsx2Defs.h"
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Chunked savestate container. Every entry is split in fixed size chunks which are deflated
+// and inflated independently on all cores, each chunk carries its own CRC32 and the entry
+// header the combined one.
+//
+// Layout (little endian):
+//   FileHeader
+//   for each entry: EntryHeader, name, u32 packed_size[chunk_count], u32 crc[chunk_count], chunk data
+namespace SaveStateArchive
+{
+	static constexpr u32 MAGIC = 0x5A533250; // P2SZ
+	static constexpr u32 VERSION = 1;
+	static constexpr u32 CHUNK_SIZE = 512 * 1024;
+
+	enum class Method : u32
+	{
+		Store = 0,
+		Deflate = 1,
+	};
+
+	struct WriteEntry
+	{
+		std::string name;
+		const u8* data;
+		u32 size;
+		Method method;
+	};
+
+	struct ReadEntry
+	{
+		std::string name;
+		std::vector<u8> data;
+	};
+
+	// Runs func(0..count-1) on a persistent pool of worker threads, the caller thread included.
+	// Calls from several threads are serialized, func must not call ParallelFor() itself.
+	void ParallelFor(size_t count, const std::function<void(size_t)>& func);
+
+	// Returns true if the file starts with the container magic, the file position is restored.
+	bool IsArchive(std::FILE* fp);
+
+	bool Write(std::FILE* fp, u32 save_version, const std::vector<WriteEntry>& entries);
+
+	// Not streamed: every packed chunk is read from the file first, then they are all inflated at once.
+	bool Read(std::FILE* fp, u32* save_version, std::vector<ReadEntry>* entries, std::string* error);
+} // namespace SaveStateArchive
@@ -19,6 +19,7 @@
 
 #include "IopCommon.h"
 #include "Sif.h"
+#include "MTIOP.h"
 
 _sif sif0;
 
@@ -353,6 +354,9 @@ __fi void  EEsif0Interrupt()
 
 __fi void dmaSIF0()
 {
+	// Runs the IOP half of the transfer as well.
+	iopThread.WaitIOP();
+
 	SIF_LOG(wxString(L"dmaSIF0" + sif0ch.cmqt_to_str()).To8BitData());
 
 	if (sif0.fifo.readPos != sif0.fifo.writePos)
@@ -19,6 +19,8 @@
 #include "VUmicro.h"
 #include "newVif.h"
 #include "MTVU.h"
+#include "MTIOP.h"
+#include "IPU/IPUThread.h"
 
 #include "Elfheader.h"
 
@@ -477,6 +479,8 @@ void SysMainMemory::DecommitAll()
 
 	// On linux, the MTVU isn't empty and the thread still uses the m_ee/m_vu memory
 	vu1Thread.WaitVU();
+	iopThread.WaitIOP();
+	ipuThread.Wait();
 	// The EE thread must be stopped here command mustn't be send
 	// to the ring. Let's call it an extra safety valve :)
 	vu1Thread.Reset();
@@ -613,6 +617,7 @@ void SysClearExecutionCache()
 {
 	GetCpuProviders().ApplyConfig();
 
+	iopThread.WaitIOP();
 	Cpu->Reset();
 	psxCpu->Reset();
 
@@ -29,6 +29,8 @@ extern WindowInfo g_gs_window_info;
 #include "Patch.h"
 #include "SysThreads.h"
 #include "MTVU.h"
+#include "MTIOP.h"
+#include "IPU/IPUThread.h"
 #include "IPC.h"
 #include "FW.h"
 #include "SPU2/spu2.h"
@@ -36,6 +38,7 @@ extern WindowInfo g_gs_window_info;
 #include "USB/USB.h"
 #include "MemoryCardFile.h"
 #include "PerformanceMetrics.h"
+#include "Rewind.h"
 #ifdef _WIN32
 #include "PAD/Windows/PAD.h"
 #else
@@ -202,7 +205,7 @@ void SysCoreThread::ApplySettings(const Pcsx2Config& src)
 // --------------------------------------------------------------------------------------
 bool SysCoreThread::HasPendingStateChangeRequest() const
 {
-	return !m_hasActiveMachine || GetMTGS().HasPendingException() || _parent::HasPendingStateChangeRequest();
+	return !m_hasActiveMachine || GetMTGS().HasPendingException() || Rewind::HasPendingLoad() || Rewind::HasPendingCapture() || _parent::HasPendingStateChangeRequest();
 }
 
 void SysCoreThread::_reset_stuff_as_needed()
@@ -261,6 +264,9 @@ void SysCoreThread::VsyncInThread()
 {
 	ApplyLoadedPatches(PPT_CONTINUOUSLY);
 	ApplyLoadedPatches(PPT_COMBINED_0_1);
+
+	if (m_IpcState == ON)
+		m_socketIpc->VSync();
 }
 
 void SysCoreThread::GameStartingInThread()
@@ -289,7 +295,20 @@ void SysCoreThread::GameStartingInThread()
 bool SysCoreThread::StateCheckInThread()
 {
 	GetMTGS().RethrowException();
-	return _parent::StateCheckInThread() && (_reset_stuff_as_needed(), true);
+	if (!_parent::StateCheckInThread())
+		return false;
+
+	_reset_stuff_as_needed();
+
+	// Rewinding swaps the whole machine state and capturing serializes it, both have to happen
+	// between Cpu->Execute() calls.
+	if (m_hasActiveMachine)
+	{
+		Rewind::ProcessPendingLoad();
+		Rewind::ProcessPendingCapture();
+	}
+
+	return true;
 }
 
 // Runs CPU cycles indefinitely, until the user or another thread requests execution to break.
@@ -300,6 +319,10 @@ void SysCoreThread::DoCpuExecute()
 	m_hasActiveMachine = true;
 	UI_EnableSysActions();
 	Cpu->Execute();
+
+	// The last event test may have left an IOP slice or an IPU command running.
+	iopThread.WaitIOP();
+	ipuThread.Wait();
 }
 
 void SysCoreThread::ExecuteTaskInThread()
@@ -359,9 +382,14 @@ void SysCoreThread::OnCleanupInThread()
 	m_hasActiveMachine = false;
 	m_resetVirtualMachine = true;
 
+	iopThread.WaitIOP();
+	iopThread.Shutdown();
+	ipuThread.Wait();
+	ipuThread.Shutdown();
 	R3000A::ioman::reset();
 	// FIXME: temporary workaround for deadlock on exit, which actually should be a crash
 	vu1Thread.WaitVU();
+	Rewind::Shutdown();
 	USBclose();
 	SPU2close();
 	PADclose();
@@ -26,6 +26,12 @@
 #include <vector>
 
 enum class CDVD_SourceType : uint8_t;
+class FastSnapshot;
+
+namespace Rewind
+{
+	struct Stats;
+}
 
 enum class VMState
 {
@@ -121,6 +127,32 @@ namespace VMManager
 	/// Saves state to the specified slot.
 	bool SaveStateToSlot(s32 slot);
 
+	/// Number of in-memory snapshots kept for run-ahead.
+	static constexpr u32 NUM_FAST_SNAPSHOTS = 4;
+
+	/// Captures the machine into an in-memory snapshot without compression or tags. CPU thread only, between Execute() calls.
+	bool SaveFastSnapshot(u32 index);
+
+	/// Restores a snapshot captured by SaveFastSnapshot(). CPU thread only, between Execute() calls.
+	bool LoadFastSnapshot(u32 index);
+
+	/// Returns the snapshot (for its size and save/load timings), or nullptr if it was never captured.
+	const FastSnapshot* GetFastSnapshot(u32 index);
+
+	/// Frees the memory held by all fast snapshots.
+	void ReleaseFastSnapshots();
+
+	/// Steps back to the previous rewind snapshot, dropping any rewind queued by the hotkey. CPU thread only, between Execute() calls.
+	/// Frontends should call this whenever Rewind::HasPendingLoad() is set.
+	bool LoadRewindState();
+
+	/// Takes the rewind snapshot queued at vsync. CPU thread only, between Execute() calls.
+	/// Frontends should leave Execute() and call this whenever Rewind::HasPendingCapture() is set.
+	bool SaveRewindState();
+
+	/// Returns the snapshot count, memory use and capture timings of the rewind buffer.
+	Rewind::Stats GetRewindStats();
+
 	/// Updates the host vsync state, as well as timer frequencies. Call when the speed limiter is adjusted.
 	void SetLimiterMode(LimiterModeType type);
 
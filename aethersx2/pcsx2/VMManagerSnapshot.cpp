@@ -0,0 +1,122 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "VMManager.h"
+#include "Rewind.h"
+#include "SaveState.h"
+
+#include "common/Console.h"
+
+#include <array>
+#include <memory>
+
+namespace VMManager
+{
+	static std::array<std::unique_ptr<FastSnapshot>, NUM_FAST_SNAPSHOTS> s_fast_snapshots;
+} // namespace VMManager
+
+bool VMManager::SaveFastSnapshot(u32 index)
+{
+	if (index >= NUM_FAST_SNAPSHOTS || !HasValidVM())
+		return false;
+
+	std::unique_ptr<FastSnapshot>& snapshot = s_fast_snapshots[index];
+	if (!snapshot)
+		snapshot = std::make_unique<FastSnapshot>();
+
+	try
+	{
+		snapshot->Save();
+	}
+	catch (Exception::BaseException& ex)
+	{
+		Console.Error(L"(VMManager) Failed to save fast snapshot %u: %s", index, WX_STR(ex.FormatDiagnosticMessage()));
+		snapshot.reset();
+		return false;
+	}
+	catch (std::exception& ex)
+	{
+		Console.Error("(VMManager) Failed to save fast snapshot %u: %s", index, ex.what());
+		snapshot.reset();
+		return false;
+	}
+
+	return true;
+}
+
+bool VMManager::LoadFastSnapshot(u32 index)
+{
+	if (index >= NUM_FAST_SNAPSHOTS || !HasValidVM())
+		return false;
+
+	FastSnapshot* snapshot = s_fast_snapshots[index].get();
+	if (!snapshot || !snapshot->IsValid())
+		return false;
+
+	// A failed load leaves the machine half restored, the caller is expected to reset or load a real state.
+	try
+	{
+		snapshot->Load();
+	}
+	catch (Exception::BaseException& ex)
+	{
+		Console.Error(L"(VMManager) Failed to load fast snapshot %u: %s", index, WX_STR(ex.FormatDiagnosticMessage()));
+		return false;
+	}
+	catch (std::exception& ex)
+	{
+		Console.Error("(VMManager) Failed to load fast snapshot %u: %s", index, ex.what());
+		return false;
+	}
+
+	return true;
+}
+
+const FastSnapshot* VMManager::GetFastSnapshot(u32 index)
+{
+	if (index >= NUM_FAST_SNAPSHOTS || !s_fast_snapshots[index] || !s_fast_snapshots[index]->IsValid())
+		return nullptr;
+
+	return s_fast_snapshots[index].get();
+}
+
+void VMManager::ReleaseFastSnapshots()
+{
+	for (std::unique_ptr<FastSnapshot>& snapshot : s_fast_snapshots)
+		snapshot.reset();
+}
+
+bool VMManager::LoadRewindState()
+{
+	if (!HasValidVM())
+		return false;
+
+	Rewind::RequestLoadPrevious();
+	return Rewind::ProcessPendingLoad();
+}
+
+bool VMManager::SaveRewindState()
+{
+	if (!HasValidVM())
+		return false;
+
+	return Rewind::ProcessPendingCapture();
+}
+
+Rewind::Stats VMManager::GetRewindStats()
+{
+	return Rewind::GetStats();
+}
@@ -18,6 +18,7 @@
 #include "ps2/Iop/IopHw_Internal.h"
 #include "ps2/HwInternal.h"
 #include "ps2/pgif.h"
+#include "MTIOP.h"
 
 //NOTES (TODO):
 /*
@@ -317,9 +318,12 @@ void rb_gp0_Get(u32* data)
 }
 
 //PS1 GPU registers I/O handlers:
+// The PGIF state is shared by both CPUs, with the IOP thread the IOP handlers park the EE
+// first and the EE handlers (PGIFr/PGIFw) wait for the IOP.
 
 void psxGPUw(int addr, u32 data)
 {
+	iopThread.WaitEE();
 	REG_LOG("PGPU write 0x%08X = 0x%08X", addr, data);
 	if (addr == HW_PS1_GPU_DATA)
 	{
@@ -345,6 +349,7 @@ void psxGPUw(int addr, u32 data)
 
 u32 psxGPUr(int addr)
 {
+	iopThread.WaitEE();
 	u32 data = 0;
 	if (addr == HW_PS1_GPU_DATA)
 	{
@@ -364,6 +369,7 @@ u32 psxGPUr(int addr)
 
 void PGIFw(int addr, u32 data)
 {
+	iopThread.WaitIOP();
 	//if (((addr != PGIF_CTRL) || (addr != PGPU_STAT) || ((addr == PGIF_CTRL) && (getUpdPgifCtrlReg() != data))) && (addr != PGPU_STAT))
 		REG_LOG("PGIF write 0x%08X = 0x%08X  0x%08X  EEpc= %08X  IOPpc= %08X ", addr, data, getUpdPgifCtrlReg(), cpuRegs.pc, psxRegs.pc);
 
@@ -405,6 +411,7 @@ void PGIFw(int addr, u32 data)
 // Read PGIF Hardware Registers.
 u32 PGIFr(int addr)
 {
+	iopThread.WaitIOP();
 	u32 data = 0;
 	switch (addr)
 	{
@@ -447,6 +454,7 @@ u32 PGIFr(int addr)
 
 void PGIFrQword(u32 addr, void* dat)
 {
+	iopThread.WaitIOP();
 	u32* data = (u32*)dat;
 
 	if (addr == PGPU_CMD_FIFO)
@@ -473,6 +481,7 @@ void PGIFrQword(u32 addr, void* dat)
 
 void PGIFwQword(u32 addr, void* dat)
 {
+	iopThread.WaitIOP();
 	u32* data = (u32*)dat;
 	DevCon.Warning("WARNING PGIF WRITE BY PS1DRV ! - NOT KNOWN TO EVER BE DONE!");
 	Console.WriteLn("PGIF QW write  0x%08X = 0x%08X %08X %08X %08X ", addr, *(u32*)(data + 0), *(u32*)(data + 1), *(u32*)(data + 2), *(u32*)(data + 3));
@@ -698,6 +707,7 @@ void processPgpuDma()
 
 u32 psxDma2GpuR(u32 addr)
 {
+	iopThread.WaitEE();
 	u32 data = 0;
 	addr &= 0x1FFFFFFF;
 	switch (addr)
@@ -726,6 +736,7 @@ u32 psxDma2GpuR(u32 addr)
 
 void psxDma2GpuW(u32 addr, u32 data)
 {
+	iopThread.WaitEE();
 	PGPU_DMA_LOG("PGPU DMA write 0x%08X = 0x%08X", addr, data);
 	addr &= 0x1FFFFFFF;
 	switch (addr)
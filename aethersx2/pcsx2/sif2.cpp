@@ -19,6 +19,7 @@
 
 #include "IopCommon.h"
 #include "Sif.h"
+#include "MTIOP.h"
 
 _sif sif2;
 
@@ -350,6 +351,8 @@ __fi void SIF2Dma()
 
 __fi void  sif2Interrupt()
 {
+	iopThread.WaitEE();
+
 	if (!sif2.iop.end || sif2.iop.counter > 0)
 	{
 		SIF2Dma();
@@ -369,6 +372,8 @@ __fi void  EEsif2Interrupt()
 
 __fi void dmaSIF2()
 {
+	iopThread.WaitIOP();
+
 	DevCon.Warning("SIF2 EE CHCR %x", sif2dma.chcr._u32);
 	SIF_LOG(wxString(L"dmaSIF2" + sif2dma.cmqt_to_str()).To8BitData());
 
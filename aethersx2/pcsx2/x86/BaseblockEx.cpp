@@ -16,6 +16,12 @@
 
 #include "PrecompiledHeader.h"
 #include "BaseblockEx.h"
+#include "common/emitter/x86emitter.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace x86Emitter;
 
 BASEBLOCKEX* BaseBlocks::New(u32 startpc, uptr fnptr)
 {
@@ -80,3 +86,99 @@ void BaseBlocks::Link(u32 pc, s32* jumpptr)
 		*jumpptr = (s32)(recompiler - (sptr)(jumpptr + 1));
 	links.insert(std::pair<u32, uptr>(pc, (uptr)jumpptr));
 }
+
+void BaseBlockProfiler::EmitBlockEntry(u32 startpc)
+{
+	u32 slot;
+	const auto it = m_index.find(startpc);
+	if (it != m_index.end())
+	{
+		slot = it->second;
+	}
+	else
+	{
+		slot = m_used.load(std::memory_order_relaxed);
+		if (slot == MAX_BLOCKS)
+		{
+			m_dropped++;
+			return;
+		}
+
+		m_info[slot] = {startpc, 0, 0, 0};
+		m_index.emplace(startpc, slot);
+		m_used.store(slot + 1, std::memory_order_release);
+	}
+
+	u32* counter = reinterpret_cast<u32*>(&m_counters[slot]);
+	xADD(ptr32[&counter[0]], 1);
+	xADC(ptr32[&counter[1]], 0);
+}
+
+void BaseBlockProfiler::SetBlockInfo(u32 startpc, u32 size, u32 x86size, u32 cycles)
+{
+	const auto it = m_index.find(startpc);
+	if (it == m_index.end())
+		return;
+
+	BlockInfo& info = m_info[it->second];
+	info.size = size;
+	info.x86size = x86size;
+	info.cycles = std::max(cycles, 1u);
+}
+
+void BaseBlockProfiler::Print(u32 count) const
+{
+	const u32 used = m_used.load(std::memory_order_acquire);
+
+	std::vector<u32> slots(used);
+	u64 total_executions = 0;
+	u64 total_cycles = 0;
+	for (u32 i = 0; i < used; i++)
+	{
+		slots[i] = i;
+		total_executions += m_counters[i];
+		total_cycles += m_counters[i] * m_info[i].cycles;
+	}
+
+	Console.WriteLn("%s block profile: %u blocks, %llu executions, %llu cycles", m_name, used,
+		static_cast<unsigned long long>(total_executions), static_cast<unsigned long long>(total_cycles));
+	if (m_dropped > 0)
+		Console.Warning("%s block profile: table full, %u compiled blocks were not counted", m_name, m_dropped);
+
+	if (total_cycles == 0)
+		return;
+
+	count = std::min(count, used);
+	std::partial_sort(slots.begin(), slots.begin() + count, slots.end(), [this](u32 lhs, u32 rhs) {
+		return (m_counters[lhs] * m_info[lhs].cycles) > (m_counters[rhs] * m_info[rhs].cycles);
+	});
+
+	Console.WriteLn("      PC  Insts  x86 size    Executions  Cycles/exec   Share");
+	for (u32 i = 0; i < count; i++)
+	{
+		const BlockInfo& info = m_info[slots[i]];
+		const u64 executions = m_counters[slots[i]];
+		if (executions == 0)
+			break;
+
+		Console.WriteLn("%08x  %5u  %8u  %12llu  %11u  %5.2f%%", info.startpc, info.size, info.x86size,
+			static_cast<unsigned long long>(executions), info.cycles,
+			static_cast<double>(executions * info.cycles) * 100.0 / static_cast<double>(total_cycles));
+	}
+}
+
+void BaseBlockProfiler::ResetCounters()
+{
+	const u32 used = m_used.load(std::memory_order_acquire);
+	std::memset(m_counters, 0, used * sizeof(m_counters[0]));
+}
+
+void BaseBlockProfiler::Reset()
+{
+	const u32 used = m_used.load(std::memory_order_relaxed);
+	std::memset(m_counters, 0, used * sizeof(m_counters[0]));
+
+	m_index.clear();
+	m_used.store(0, std::memory_order_release);
+	m_dropped = 0;
+}
@@ -15,7 +15,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <map> // used by BaseBlockEx
+#include <unordered_map>
 
 // Every potential jump point in the PS2's addressable memory has a BASEBLOCK
 // associated with it. So that means a BASEBLOCK for every 4 bytes of PS2
@@ -35,12 +37,6 @@ struct BASEBLOCKEX
 	uptr fnptr;
 	u16 size;    // The size in dwords (equivalent to the number of instructions)
 	u16 x86size; // The size in byte of the translated x86 instructions
-
-#ifdef PCSX2_DEVBUILD
-	// Could be useful to instrument the block
-	//u32 visited; // number of times called
-	//u64 ltime; // regs it assumes to have set already
-#endif
 };
 
 class BaseBlockArray
@@ -235,6 +231,56 @@ public:
 	}
 };
 
+// Per-block execution counters, enabled by EmuConfig.Profiler.RecBlocks_EE/RecBlocks_IOP.
+//
+// The counters are kept apart from BaseBlockArray (which moves its entries around) because
+// the recompiled code increments them through their absolute address, so the profiler must
+// have static storage duration. Blocks are keyed by guest start pc, a block which gets
+// recompiled after a clear or a recompiler reset keeps counting in the same slot.
+class BaseBlockProfiler
+{
+public:
+	static constexpr u32 MAX_BLOCKS = 0x20000;
+
+	BaseBlockProfiler(const char* name)
+		: m_name(name)
+	{
+	}
+
+	// Emits the counter increment at the entry of the block being compiled. Clobbers the flags.
+	void EmitBlockEntry(u32 startpc);
+
+	// Records the shape of the block once it is compiled. cycles is what one execution of the
+	// block charges to the cpu cycle counter.
+	void SetBlockInfo(u32 startpc, u32 size, u32 x86size, u32 cycles);
+
+	// Prints the blocks which consumed the most guest cycles. Can be called from another
+	// thread while the recompiler is running, figures of a block being compiled may be stale.
+	void Print(u32 count) const;
+
+	// Zeroes the execution counts but keeps the slots, compiled blocks still point at them.
+	void ResetCounters();
+
+	void Reset();
+
+private:
+	struct BlockInfo
+	{
+		u32 startpc;
+		u32 size;
+		u32 x86size;
+		u32 cycles;
+	};
+
+	const char* m_name;
+	std::unordered_map<u32, u32> m_index;
+	std::atomic<u32> m_used{0};
+	u32 m_dropped = 0;
+	// Left to the zero initialization of static storage, so untouched pages are never committed.
+	BlockInfo m_info[MAX_BLOCKS];
+	u64 m_counters[MAX_BLOCKS];
+};
+
 #define PC_GETBLOCK_(x, reclut) ((BASEBLOCK*)(reclut[((u32)(x)) >> 16] + (x) * (sizeof(BASEBLOCK) / 4)))
 
 /**
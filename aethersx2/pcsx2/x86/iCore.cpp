@@ -27,19 +27,20 @@ using namespace x86Emitter;
 __tls_emit u8* j8Ptr[32];
 __tls_emit u32* j32Ptr[32];
 
-u16 g_x86AllocCounter = 0;
-u16 g_xmmAllocCounter = 0;
+__tls_emit u16 g_x86AllocCounter = 0;
+__tls_emit u16 g_xmmAllocCounter = 0;
 
-EEINST* g_pCurInstInfo = NULL;
+__tls_emit EEINST* g_pCurInstInfo = NULL;
 
 // used to make sure regs don't get changed while in recompiler
 // use FreezeXMMRegs
 u32 g_recWriteback = 0;
+u32 g_psxRecWriteback = 0;
 
-_xmmregs xmmregs[iREGCNT_XMM], s_saveXMMregs[iREGCNT_XMM];
+__tls_emit _xmmregs xmmregs[iREGCNT_XMM], s_saveXMMregs[iREGCNT_XMM];
 
 // X86 caching
-_x86regs x86regs[iREGCNT_GPR], s_saveX86regs[iREGCNT_GPR];
+__tls_emit _x86regs x86regs[iREGCNT_GPR], s_saveX86regs[iREGCNT_GPR];
 
 // XMM Caching
 #define VU_VFx_ADDR(x) (uptr)&VU->VF[x].UL[0]
@@ -54,7 +55,7 @@ __aligned16 u64 gprBackup[iREGCNT_GPR];
 __aligned16 u32 gprBackup[iREGCNT_GPR];
 #endif
 
-static int s_xmmchecknext = 0;
+static __tls_emit int s_xmmchecknext = 0;
 
 void _backupNeededXMM()
 {
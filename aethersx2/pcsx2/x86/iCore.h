@@ -91,6 +91,7 @@
 #define X86TYPE_VUPWRITE 8
 #define X86TYPE_PSX 9
 #define X86TYPE_PCWRITEBACK 10
+#define X86TYPE_PSX_PCWRITEBACK 11
 #define X86TYPE_VUJUMP 12 // jump from random mem (g_recWriteback)
 #define X86TYPE_VITEMP 13
 #define X86TYPE_FNARG 14 // function parameter, max is 4
@@ -114,7 +115,9 @@ struct _x86regs
 	u32 extra; // extra info assoc with the reg
 };
 
-extern _x86regs x86regs[iREGCNT_GPR], s_saveX86regs[iREGCNT_GPR];
+// The allocator state is per thread, the IOP recompiler runs on its own thread with
+// Speedhacks.iopThread.
+extern __tls_emit _x86regs x86regs[iREGCNT_GPR], s_saveX86regs[iREGCNT_GPR];
 
 uptr _x86GetAddr(int type, int reg);
 void _initX86regs();
@@ -230,7 +233,7 @@ struct EEINST
 	_VURegsNum vuregs;
 };
 
-extern EEINST* g_pCurInstInfo; // info for the cur instruction
+extern __tls_emit EEINST* g_pCurInstInfo; // info for the cur instruction
 extern void _recClearInst(EEINST* pinst);
 
 // returns the number of insts + 1 until written (0 if not written)
@@ -247,14 +250,15 @@ static __fi bool FPUINST_ISLIVE(u32 reg)   { return !!(g_pCurInstInfo->fpuregs[r
 static __fi bool FPUINST_LASTUSE(u32 reg)  { return !!(g_pCurInstInfo->fpuregs[reg] & EEINST_LASTUSE); }
 
 extern u32 g_recWriteback; // used for jumps (VUrec mess!)
+extern u32 g_psxRecWriteback; // same for the IOP, which may run on another thread
 
-extern _xmmregs xmmregs[iREGCNT_XMM], s_saveXMMregs[iREGCNT_XMM];
+extern __tls_emit _xmmregs xmmregs[iREGCNT_XMM], s_saveXMMregs[iREGCNT_XMM];
 
 extern __tls_emit u8* j8Ptr[32];   // depreciated item.  use local u8* vars instead.
 extern __tls_emit u32* j32Ptr[32]; // depreciated item.  use local u32* vars instead.
 
-extern u16 g_x86AllocCounter;
-extern u16 g_xmmAllocCounter;
+extern __tls_emit u16 g_x86AllocCounter;
+extern __tls_emit u16 g_xmmAllocCounter;
 
 // allocates only if later insts use XMM, otherwise checks
 int _allocCheckGPRtoXMM(EEINST* pinst, int gprreg, int mode);
@@ -61,6 +61,8 @@ static BASEBLOCK* recROM  = NULL; // and here
 static BASEBLOCK* recROM1 = NULL; // also here
 static BASEBLOCK* recROM2 = NULL; // also here
 static BaseBlocks recBlocks;
+static BaseBlockProfiler s_blockProfiler("IOP");
+static bool s_profileBlock = false;
 static u8* recPtr = NULL;
 u32 psxpc; // recompiler psxpc
 int psxbranch; // set for branch
@@ -82,6 +84,7 @@ static EEINST* s_psaveInstInfo = NULL;
 
 u32 s_psxBlockCycles = 0; // cycles of current block recompiling
 static u32 s_savenBlockCycles = 0;
+static u32 s_psxBlockChargedCycles = 0; // largest cycle charge emitted by the current block
 
 static void iPsxBranchTest(u32 newpc, u32 cpuBranch);
 void psxRecompileNextInstruction(int delayslot);
@@ -813,6 +816,17 @@ static void recShutdown()
 
 	// FIXME Warning thread unsafe
 	Perf::dump();
+
+	if (EmuConfig.Profiler.Enabled && EmuConfig.Profiler.RecBlocks_IOP)
+		recPrintBlockProfileIOP();
+	s_blockProfiler.Reset();
+}
+
+void recPrintBlockProfileIOP(u32 count, bool reset_counters)
+{
+	s_blockProfiler.Print(count);
+	if (reset_counters)
+		s_blockProfiler.ResetCounters();
 }
 
 static void iopClearRecLUT(BASEBLOCK* base, int count)
@@ -929,14 +943,14 @@ void psxSetBranchReg(u32 reg)
 
 	if (reg != 0xffffffff)
 	{
-		_allocX86reg(calleeSavedReg2d, X86TYPE_PCWRITEBACK, 0, MODE_WRITE);
+		_allocX86reg(calleeSavedReg2d, X86TYPE_PSX_PCWRITEBACK, 0, MODE_WRITE);
 		_psxMoveGPRtoR(calleeSavedReg2d, reg);
 
 		psxRecompileNextInstruction(1);
 
 		if (x86regs[calleeSavedReg2d.GetId()].inuse)
 		{
-			pxAssert(x86regs[calleeSavedReg2d.GetId()].type == X86TYPE_PCWRITEBACK);
+			pxAssert(x86regs[calleeSavedReg2d.GetId()].type == X86TYPE_PSX_PCWRITEBACK);
 			xMOV(ptr32[&psxRegs.pc], calleeSavedReg2d);
 			x86regs[calleeSavedReg2d.GetId()].inuse = 0;
 #ifdef PCSX2_DEBUG
@@ -945,7 +959,7 @@ void psxSetBranchReg(u32 reg)
 		}
 		else
 		{
-			xMOV(eax, ptr32[&g_recWriteback]);
+			xMOV(eax, ptr32[&g_psxRecWriteback]);
 			xMOV(ptr32[&psxRegs.pc], eax);
 
 #ifdef PCSX2_DEBUG
@@ -981,6 +995,7 @@ void psxSetBranchImm(u32 imm)
 
 static __fi u32 psxScaleBlockCycles()
 {
+	s_psxBlockChargedCycles = std::max(s_psxBlockChargedCycles, s_psxBlockCycles);
 	return s_psxBlockCycles;
 }
 
@@ -1381,6 +1396,11 @@ static void __fastcall iopRecRecompile(const u32 startpc)
 
 	s_pCurBlock->SetFnptr((uptr)x86Ptr);
 	s_psxBlockCycles = 0;
+	s_psxBlockChargedCycles = 0;
+
+	s_profileBlock = EmuConfig.Profiler.Enabled && EmuConfig.Profiler.RecBlocks_IOP;
+	if (s_profileBlock)
+		s_blockProfiler.EmitBlockEntry(startpc);
 
 	// reset recomp state variables
 	psxpc = startpc;
@@ -1578,6 +1598,9 @@ StartRecomp:
 
 	Perf::iop.map(s_pCurBlockEx->fnptr, s_pCurBlockEx->x86size, s_pCurBlockEx->startpc);
 
+	if (s_profileBlock)
+		s_blockProfiler.SetBlockInfo(startpc, s_pCurBlockEx->size, s_pCurBlockEx->x86size, s_psxBlockChargedCycles);
+
 	recPtr = xGetPtr();
 
 	pxAssert((g_psxHasConstReg & g_psxFlushedConstReg) == g_psxHasConstReg);
@@ -37,6 +37,9 @@ extern uptr psxRecLUT[];
 u8 _psxLoadWritesRs(u32 tempcode);
 u8 _psxIsLoadStore(u32 tempcode);
 
+// Prints the hottest blocks when EmuConfig.Profiler.RecBlocks_IOP is set, also done on shutdown.
+void recPrintBlockProfileIOP(u32 count = 50, bool reset_counters = false);
+
 void _psxFlushAllUnused();
 int _psxFlushUnusedConstReg();
 void _psxFlushCachedRegs();
@@ -78,6 +78,12 @@ void recBranchCall(void (*func)());
 void recCall(void (*func)());
 u32 scaleblockcycles_clear();
 
+// Prints the hottest blocks when EmuConfig.Profiler.RecBlocks_EE is set, also done on shutdown.
+void recPrintBlockProfileEE(u32 count = 50, bool reset_counters = false);
+
+// Any thread. Prints the EE and IOP block profiles at the next vsync and restarts their counts.
+void recRequestBlockProfileDump();
+
 namespace R5900
 {
 	namespace Dynarec
@@ -29,7 +29,7 @@ using namespace x86Emitter;
 extern u32 g_psxConstRegs[32];
 
 // X86 caching
-static int g_x86checknext;
+static __tls_emit int g_x86checknext;
 
 // use special x86 register allocation for ia32
 
@@ -101,6 +101,10 @@ uptr _x86GetAddr(int type, int reg)
 			ret = (uptr)&g_recWriteback;
 			break;
 
+		case X86TYPE_PSX_PCWRITEBACK:
+			ret = (uptr)&g_psxRecWriteback;
+			break;
+
 		case X86TYPE_VUJUMP:
 			ret = (uptr)&g_recWriteback;
 			break;
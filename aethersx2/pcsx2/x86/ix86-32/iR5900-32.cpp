@@ -66,6 +66,10 @@ u32 g_cpuHasConstReg = 0, g_cpuFlushedConstReg = 0;
 bool g_cpuFlushedPC, g_cpuFlushedCode, g_recompilingDelaySlot, g_maySignalException;
 
 eeProfiler EE::Profiler;
+static BaseBlockProfiler s_blockProfiler("EE");
+static std::atomic<bool> s_blockProfileDumpRequested(false);
+static bool s_profileBlock = false;
+static u32 s_nBlockChargedCycles = 0; // largest cycle charge emitted by the current block
 
 ////////////////////////////////////////////////////////////////
 // Static Private Variables - R5900 Dynarec
@@ -685,6 +689,41 @@ static void recShutdown()
 
 	// FIXME Warning thread unsafe
 	Perf::dump();
+
+	if (EmuConfig.Profiler.Enabled && EmuConfig.Profiler.RecBlocks_EE)
+		recPrintBlockProfileEE();
+	s_blockProfiler.Reset();
+}
+
+void recPrintBlockProfileEE(u32 count, bool reset_counters)
+{
+	s_blockProfiler.Print(count);
+	if (reset_counters)
+		s_blockProfiler.ResetCounters();
+}
+
+void recRequestBlockProfileDump()
+{
+	s_blockProfileDumpRequested.store(true, std::memory_order_release);
+}
+
+// iR3000A.h can't be pulled in next to the EE recompiler headers.
+extern void recPrintBlockProfileIOP(u32 count, bool reset_counters);
+
+static void recDumpBlockProfiles()
+{
+	if (!EmuConfig.Profiler.Enabled || (!EmuConfig.Profiler.RecBlocks_EE && !EmuConfig.Profiler.RecBlocks_IOP))
+	{
+		Console.Warning("Block profiling is disabled, set Profiler.Enabled and RecBlocks_EE/RecBlocks_IOP.");
+		return;
+	}
+
+	// Counters are bumped by the recompiled code of this thread, so they can be cleared here. The
+	// IOP may run on its own thread, a few of its increments can be lost while it is cleared.
+	if (EmuConfig.Profiler.RecBlocks_EE)
+		recPrintBlockProfileEE(50, true);
+	if (EmuConfig.Profiler.RecBlocks_IOP)
+		recPrintBlockProfileIOP(50, true);
 }
 
 static void recResetEE()
@@ -728,6 +767,10 @@ static void recExitExecution()
 
 static void recCheckExecutionState()
 {
+	// Called once per vsync, between blocks.
+	if (s_blockProfileDumpRequested.exchange(false, std::memory_order_acq_rel))
+		recDumpBlockProfiles();
+
 #ifndef PCSX2_CORE
 	if (SETJMP_CODE(m_cpuException || m_Exception ||) eeRecIsReset || GetCoreThread().HasPendingStateChangeRequest())
 #else
@@ -1070,7 +1113,9 @@ static u32 scaleblockcycles_calculation()
 		scale_cycles = ((5 + (-2 * (cyclerate + 1))) * s_nBlockCycles) >> 5;
 
 	// Ensure block cycle count is never less than 1.
-	return (scale_cycles < 1) ? 1 : scale_cycles;
+	scale_cycles = (scale_cycles < 1) ? 1 : scale_cycles;
+	s_nBlockChargedCycles = std::max(s_nBlockChargedCycles, scale_cycles);
+	return scale_cycles;
 }
 
 static u32 scaleblockcycles()
@@ -1973,10 +2018,15 @@ static void __fastcall recRecompile(const u32 startpc)
 		doPlace0Patches();
 	}
 
+	s_profileBlock = EmuConfig.Profiler.Enabled && EmuConfig.Profiler.RecBlocks_EE;
+	if (s_profileBlock)
+		s_blockProfiler.EmitBlockEntry(startpc);
+
 	g_branch = 0;
 
 	// reset recomp state variables
 	s_nBlockCycles = 0;
+	s_nBlockChargedCycles = 0;
 	pc = startpc;
 	g_cpuHasConstReg = g_cpuFlushedConstReg = 1;
 	pxAssert(g_cpuConstRegs[0].UD[0] == 0);
@@ -2419,6 +2469,9 @@ StartRecomp:
 #endif
 	Perf::ee.map(s_pCurBlockEx->fnptr, s_pCurBlockEx->x86size, s_pCurBlockEx->startpc);
 
+	if (s_profileBlock)
+		s_blockProfiler.SetBlockInfo(startpc, s_pCurBlockEx->size, s_pCurBlockEx->x86size, s_nBlockChargedCycles);
+
 	recPtr = xGetPtr();
 
 	pxAssert((g_cpuHasConstReg & g_cpuFlushedConstReg) == g_cpuHasConstReg);
@@ -0,0 +1,286 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Throughput of the GS memory transfer kernels, for comparing kernel changes and ISA levels on one machine.
+//
+// Block kernels are timed on 256 byte GS blocks, image and texture kernels on a 512x512 area, and CLUT
+// kernels on one palette. The GB/s figure counts GS block bytes for the block kernels, texel data
+// (trbpp) for the image and texture kernels and converted palette bytes for the CLUT kernels.
+//
+// Usage: swizzle_bench_<isa> [filter], only kernels whose name contains filter are run.
+
+#include "PrecompiledHeader.h"
+#include "GSBlock.h"
+#include "GSClut.h"
+#include "GSLocalMemory.h"
+#include "common/Timer.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#if defined(_M_ARM64)
+static constexpr const char* ISA_NAME = "NEON";
+#elif _M_SSE >= 0x501
+static constexpr const char* ISA_NAME = "AVX2";
+#elif _M_SSE >= 0x500
+static constexpr const char* ISA_NAME = "AVX";
+#else
+static constexpr const char* ISA_NAME = "SSE4";
+#endif
+
+static constexpr double MIN_TIME_SECONDS = 0.25;
+
+static constexpr int BLOCK_COUNT = 512;
+static constexpr int BLOCK_STRIDE = 2048; // linear size of the largest block, 32x16 texels expanded to 32 bits
+
+static constexpr int IMAGE_WIDTH = 512;
+static constexpr int IMAGE_HEIGHT = 512;
+
+// Palettes go past the texture area so uploading one doesn't overwrite the image.
+static constexpr uint32 CLUT_BP = 0x3000;
+
+struct PSMInfo
+{
+	uint32 psm;
+	const char* name;
+};
+
+static constexpr PSMInfo s_psms[] = {
+	{PSM_PSMCT32, "PSMCT32"},
+	{PSM_PSMCT24, "PSMCT24"},
+	{PSM_PSMCT16, "PSMCT16"},
+	{PSM_PSMCT16S, "PSMCT16S"},
+	{PSM_PSMT8, "PSMT8"},
+	{PSM_PSMT4, "PSMT4"},
+	{PSM_PSMT8H, "PSMT8H"},
+	{PSM_PSMT4HL, "PSMT4HL"},
+	{PSM_PSMT4HH, "PSMT4HH"},
+	{PSM_PSMZ32, "PSMZ32"},
+	{PSM_PSMZ24, "PSMZ24"},
+	{PSM_PSMZ16, "PSMZ16"},
+	{PSM_PSMZ16S, "PSMZ16S"},
+};
+
+static const char* s_filter = nullptr;
+
+template <typename Fn>
+static void Bench(const std::string& name, size_t bytes, Fn&& fn)
+{
+	if (s_filter && name.find(s_filter) == std::string::npos)
+		return;
+
+	// One untimed pass to fault in the buffers and warm the caches.
+	fn();
+
+	u64 passes = 0;
+	Common::Timer timer;
+	double seconds;
+	do
+	{
+		fn();
+		passes++;
+		seconds = timer.GetTimeSeconds();
+	} while (seconds < MIN_TIME_SECONDS);
+
+	std::printf("%-32s %9.2f GB/s\n", name.c_str(), static_cast<double>(bytes) * passes / seconds / 1e9);
+}
+
+struct Buffer
+{
+	explicit Buffer(size_t size)
+		: data(static_cast<uint8*>(_aligned_malloc(size, 64)))
+	{
+		for (size_t i = 0; i < size; i++)
+			data[i] = static_cast<uint8>(i * 0x9d + (i >> 8));
+	}
+	~Buffer() { _aligned_free(data); }
+
+	Buffer(const Buffer&) = delete;
+	Buffer& operator=(const Buffer&) = delete;
+
+	uint8* data;
+};
+
+template <typename Fn>
+static void BenchBlock(const char* name, uint8* blocks, uint8* linear, Fn&& fn)
+{
+	Bench(std::string("block/") + name, BLOCK_COUNT * 256, [blocks, linear, &fn]() {
+		for (int i = 0; i < BLOCK_COUNT; i++)
+			fn(blocks + i * 256, linear + i * BLOCK_STRIDE);
+	});
+}
+
+static void BenchBlocks()
+{
+	Buffer blocks(BLOCK_COUNT * 256);
+	Buffer linear(BLOCK_COUNT * BLOCK_STRIDE);
+	Buffer clut(256 * sizeof(uint64));
+
+	const uint32* pal32 = reinterpret_cast<const uint32*>(clut.data);
+	const uint64* pal64 = reinterpret_cast<const uint64*>(clut.data);
+	GIFRegTEXA TEXA = {0};
+	TEXA.TA0 = 0x80;
+	TEXA.TA1 = 0xff;
+
+	BenchBlock("ReadBlock32", blocks.data, linear.data, [](uint8* b, uint8* l) { GSBlock::ReadBlock32(b, l, 32); });
+	BenchBlock("ReadBlock16", blocks.data, linear.data, [](uint8* b, uint8* l) { GSBlock::ReadBlock16(b, l, 32); });
+	BenchBlock("ReadBlock8", blocks.data, linear.data, [](uint8* b, uint8* l) { GSBlock::ReadBlock8(b, l, 16); });
+	BenchBlock("ReadBlock4", blocks.data, linear.data, [](uint8* b, uint8* l) { GSBlock::ReadBlock4(b, l, 16); });
+	BenchBlock("ReadBlock4P", blocks.data, linear.data, [](uint8* b, uint8* l) { GSBlock::ReadBlock4P(b, l, 32); });
+	BenchBlock("ReadBlock8HP", blocks.data, linear.data, [](uint8* b, uint8* l) { GSBlock::ReadBlock8HP(b, l, 8); });
+	BenchBlock("ReadBlock4HLP", blocks.data, linear.data, [](uint8* b, uint8* l) { GSBlock::ReadBlock4HLP(b, l, 8); });
+	BenchBlock("ReadBlock4HHP", blocks.data, linear.data, [](uint8* b, uint8* l) { GSBlock::ReadBlock4HHP(b, l, 8); });
+
+	BenchBlock("WriteBlock32", blocks.data, linear.data, [](uint8* b, uint8* l) { GSBlock::WriteBlock32<32, 0xffffffff>(b, l, 32); });
+	BenchBlock("WriteBlock16", blocks.data, linear.data, [](uint8* b, uint8* l) { GSBlock::WriteBlock16<32>(b, l, 32); });
+	BenchBlock("WriteBlock8", blocks.data, linear.data, [](uint8* b, uint8* l) { GSBlock::WriteBlock8<32>(b, l, 16); });
+	BenchBlock("WriteBlock4", blocks.data, linear.data, [](uint8* b, uint8* l) { GSBlock::WriteBlock4<32>(b, l, 16); });
+	BenchBlock("UnpackAndWriteBlock24", blocks.data, linear.data, [](uint8* b, uint8* l) { GSBlock::UnpackAndWriteBlock24(l, 24, b); });
+	BenchBlock("UnpackAndWriteBlock8H", blocks.data, linear.data, [](uint8* b, uint8* l) { GSBlock::UnpackAndWriteBlock8H(l, 8, b); });
+	BenchBlock("UnpackAndWriteBlock4HL", blocks.data, linear.data, [](uint8* b, uint8* l) { GSBlock::UnpackAndWriteBlock4HL(l, 4, b); });
+	BenchBlock("UnpackAndWriteBlock4HH", blocks.data, linear.data, [](uint8* b, uint8* l) { GSBlock::UnpackAndWriteBlock4HH(l, 4, b); });
+
+	BenchBlock("ReadAndExpandBlock24", blocks.data, linear.data, [&TEXA](uint8* b, uint8* l) { GSBlock::ReadAndExpandBlock24<false>(b, l, 32, TEXA); });
+	BenchBlock("ReadAndExpandBlock16", blocks.data, linear.data, [&TEXA](uint8* b, uint8* l) { GSBlock::ReadAndExpandBlock16<false>(b, l, 64, TEXA); });
+	BenchBlock("ReadAndExpandBlock16/AEM", blocks.data, linear.data, [&TEXA](uint8* b, uint8* l) { GSBlock::ReadAndExpandBlock16<true>(b, l, 64, TEXA); });
+	BenchBlock("ReadAndExpandBlock8_32", blocks.data, linear.data, [pal32](uint8* b, uint8* l) { GSBlock::ReadAndExpandBlock8_32(b, l, 64, pal32); });
+	BenchBlock("ReadAndExpandBlock4_32", blocks.data, linear.data, [pal64](uint8* b, uint8* l) { GSBlock::ReadAndExpandBlock4_32(b, l, 128, pal64); });
+	BenchBlock("ReadAndExpandBlock8H_32", blocks.data, linear.data, [pal32](uint8* b, uint8* l) { GSBlock::ReadAndExpandBlock8H_32(b, l, 32, pal32); });
+	BenchBlock("ReadAndExpandBlock4HL_32", blocks.data, linear.data, [pal32](uint8* b, uint8* l) { GSBlock::ReadAndExpandBlock4HL_32(b, l, 32, pal32); });
+	BenchBlock("ReadAndExpandBlock4HH_32", blocks.data, linear.data, [pal32](uint8* b, uint8* l) { GSBlock::ReadAndExpandBlock4HH_32(b, l, 32, pal32); });
+}
+
+static void BenchLocalMemory(GSLocalMemory* mem)
+{
+	Buffer image(IMAGE_WIDTH * IMAGE_HEIGHT * 4);
+	Buffer texture(IMAGE_WIDTH * IMAGE_HEIGHT * 4);
+
+	GIFRegTEXA TEXA = {0};
+	TEXA.TA0 = 0x80;
+	TEXA.TA1 = 0xff;
+
+	for (const PSMInfo& info : s_psms)
+	{
+		const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[info.psm];
+		const size_t bytes = static_cast<size_t>(IMAGE_WIDTH) * IMAGE_HEIGHT * psm.trbpp / 8;
+		const std::string suffix = std::string("/") + info.name;
+
+		GIFRegBITBLTBUF BITBLTBUF = {0};
+		BITBLTBUF.DBP = 0;
+		BITBLTBUF.DBW = IMAGE_WIDTH / 64;
+		BITBLTBUF.DPSM = info.psm;
+		GIFRegTRXPOS TRXPOS = {0};
+		GIFRegTRXREG TRXREG = {0};
+		TRXREG.RRW = IMAGE_WIDTH;
+		TRXREG.RRH = IMAGE_HEIGHT;
+
+		Bench("writeImage" + suffix, bytes, [&]() {
+			int tx = 0, ty = 0;
+			(mem->*psm.wi)(tx, ty, image.data, static_cast<int>(bytes), BITBLTBUF, TRXPOS, TRXREG);
+		});
+
+		const GSOffset off = mem->GetOffset(0, IMAGE_WIDTH / 64, info.psm);
+		const GSVector4i r(0, 0, IMAGE_WIDTH, IMAGE_HEIGHT);
+
+		Bench("readTexture" + suffix, bytes, [&]() {
+			(mem->*psm.rtx)(off, r, texture.data, IMAGE_WIDTH * 4, TEXA);
+		});
+
+		if (psm.rtxP != psm.rtx)
+		{
+			Bench("readTextureP" + suffix, bytes, [&]() {
+				(mem->*psm.rtxP)(off, r, texture.data, IMAGE_WIDTH * 4, TEXA);
+			});
+		}
+
+		// A full-width area is a run of whole pages, so its blocks are numbered from 0 with no gaps.
+		const uint32 blocks = (IMAGE_WIDTH / psm.bs.x) * (IMAGE_HEIGHT / psm.bs.y);
+		const int block_pitch = psm.bs.x * 4;
+
+		Bench("readTextureBlock" + suffix, bytes, [&]() {
+			for (uint32 bp = 0; bp < blocks; bp++)
+				(mem->*psm.rtxb)(bp, texture.data, block_pitch, TEXA);
+		});
+
+		if (psm.rtxbP != psm.rtxb)
+		{
+			Bench("readTextureBlockP" + suffix, bytes, [&]() {
+				for (uint32 bp = 0; bp < blocks; bp++)
+					(mem->*psm.rtxbP)(bp, texture.data, block_pitch, TEXA);
+			});
+		}
+	}
+}
+
+static void BenchClut(GSLocalMemory* mem)
+{
+	static constexpr PSMInfo cpsms[] = {
+		{PSM_PSMCT32, "PSMCT32"},
+		{PSM_PSMCT16, "PSMCT16"},
+		{PSM_PSMCT16S, "PSMCT16S"},
+	};
+	static constexpr PSMInfo psms[] = {
+		{PSM_PSMT8, "PSMT8"},
+		{PSM_PSMT4, "PSMT4"},
+	};
+
+	GIFRegTEXA TEXA = {0};
+	TEXA.TA0 = 0x80;
+	TEXA.TA1 = 0xff;
+	GIFRegTEXCLUT TEXCLUT = {0};
+
+	for (const PSMInfo& cpsm : cpsms)
+	{
+		for (const PSMInfo& psm : psms)
+		{
+			GIFRegTEX0 TEX0 = {0};
+			TEX0.PSM = psm.psm;
+			TEX0.CPSM = cpsm.psm;
+			TEX0.CBP = CLUT_BP;
+			TEX0.CLD = 1;
+
+			// Write() marks the converted palette dirty, so every pass redoes both halves.
+			Bench(std::string("clut/") + cpsm.name + "/" + psm.name, GSLocalMemory::m_psm[psm.psm].pal * sizeof(uint32), [&]() {
+				mem->m_clut.Write(TEX0, TEXCLUT);
+				mem->m_clut.Read32(TEX0, TEXA);
+			});
+		}
+	}
+
+	Buffer src(256 * sizeof(uint32));
+	Buffer dst(256 * sizeof(uint64));
+
+	Bench("clut/ExpandCLUT64_T32_I8", 256 * sizeof(uint64), [&]() {
+		GSClut::ExpandCLUT64_T32_I8(reinterpret_cast<const uint32*>(src.data), reinterpret_cast<uint64*>(dst.data));
+	});
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1)
+		s_filter = argv[1];
+
+	std::printf("GS transfer kernels, %s build\n\n", ISA_NAME);
+
+	BenchBlocks();
+
+	std::unique_ptr<GSLocalMemory> mem = std::make_unique<GSLocalMemory>();
+	BenchLocalMemory(mem.get());
+	BenchClut(mem.get());
+
+	return 0;
+}
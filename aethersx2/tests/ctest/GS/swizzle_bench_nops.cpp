@@ -0,0 +1,53 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2021 PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Stand-ins for the parts of GSLocalMemory which live in GSLocalMemory.cpp and drag in the rest of the GS,
+// the psm table and the transfer kernels come from GSLocalMemoryPSM.cpp and GSLocalMemoryMultiISA.cpp.
+
+#include "PrecompiledHeader.h"
+#include "GSLocalMemory.h"
+
+#include <cstring>
+
+GSLocalMemory::GSLocalMemory()
+	: m_clut(this)
+{
+	m_use_fifo_alloc = false;
+	m_vm8 = (uint8*)vmalloc(m_vmsize * 4, false);
+	m_vm16 = (uint16*)m_vm8;
+	m_vm32 = (uint32*)m_vm8;
+
+	SetupPSMTable();
+	SetupTransferFunctions<GS_CURRENT_ISA>();
+}
+
+GSLocalMemory::~GSLocalMemory()
+{
+	vmfree(m_vm8, m_vmsize * 4);
+}
+
+void* vmalloc(size_t size, bool code)
+{
+	void* ptr = _aligned_malloc(size, 4096);
+	if (ptr)
+		std::memset(ptr, 0, size);
+
+	return ptr;
+}
+
+void vmfree(void* ptr, size_t size)
+{
+	_aligned_free(ptr);
+}